@@ -38,11 +38,26 @@
 #include "throughput_types.h"
 #include "throughput_peripheral.h"
 #include "throughput_central.h"
+#include "throughput_event.h"
 #include "sl_status.h"
 #include "sl_simple_button.h"
 #include "sl_simple_button_instances.h"
 #include "sl_simple_timer.h"
-
+#ifdef SL_CATALOG_CLI_PRESENT
+#include "sl_cli.h"
+#endif // SL_CATALOG_CLI_PRESENT
+#ifdef SL_CATALOG_IOSTREAM_USART_PRESENT
+#include "sl_iostream_usart.h"
+#include "sl_iostream_init_usart_instances.h"
+#include "sl_iostream_usart_vcom_config.h"
+#endif // SL_CATALOG_IOSTREAM_USART_PRESENT
+
+#if defined(SL_CATALOG_IOSTREAM_USART_PRESENT) && defined(LDMA_PRESENT) \
+  && (SL_IOSTREAM_USART_VCOM_TX_DMA_ENABLE || SL_IOSTREAM_USART_VCOM_RX_DMA_ENABLE)
+#define APP_VCOM_DMA      1   ///< VCOM transfers moved to the LDMA
+#else
+#define APP_VCOM_DMA      0
+#endif
 
 #if SL_SIMPLE_BUTTON_COUNT >= 2
 #define PB0               SL_SIMPLE_BUTTON_INSTANCE(0)
@@ -92,6 +107,44 @@ void app_handle_button_press();
 /// Callback for auto send timer
 void app_auto_send_timer_callback(sl_simple_timer_t *timer, void *data);
 
+#ifdef SL_CATALOG_CLI_PRESENT
+/// Command group of the Bluetooth event statistics
+static sl_cli_command_group_t bluetooth_command_group;
+#endif // SL_CATALOG_CLI_PRESENT
+
+#if APP_VCOM_DMA && SL_IOSTREAM_USART_VCOM_TX_DMA_ENABLE
+/// Ring of the VCOM output transmitted by the LDMA
+static uint8_t vcom_tx_buffer[SL_IOSTREAM_USART_VCOM_TX_BUFFER_SIZE];
+#endif
+
+#if APP_VCOM_DMA
+/**************************************************************************//**
+ * Moves the VCOM transfers to the LDMA as set in its configuration.
+ *****************************************************************************/
+static void app_vcom_dma_init(void)
+{
+  sl_status_t sc;
+  sl_iostream_usart_dma_config_t config = {
+#if SL_IOSTREAM_USART_VCOM_TX_DMA_ENABLE
+    .tx_buffer = vcom_tx_buffer,
+    .tx_buffer_length = sizeof(vcom_tx_buffer),
+    .tx_drop_when_full = SL_IOSTREAM_USART_VCOM_TX_DROP_WHEN_FULL,
+    .tx_dma_channel = SL_IOSTREAM_USART_VCOM_TX_DMA_CHANNEL,
+    .tx_dma_signal = SL_IOSTREAM_USART_TX_DMA_SIGNAL(SL_IOSTREAM_USART_VCOM_PERIPHERAL_NO),
+#endif
+#if SL_IOSTREAM_USART_VCOM_RX_DMA_ENABLE
+    .rx_dma_enable = true,
+    .rx_dma_channel = SL_IOSTREAM_USART_VCOM_RX_DMA_CHANNEL,
+    .rx_dma_signal = SL_IOSTREAM_USART_RX_DMA_SIGNAL(SL_IOSTREAM_USART_VCOM_PERIPHERAL_NO),
+    .rx_idle_bits = SL_IOSTREAM_USART_VCOM_RX_IDLE_BITS,
+#endif
+  };
+
+  sc = sl_iostream_usart_enable_dma(sl_iostream_uart_vcom_handle, &config);
+  app_assert_status(sc);
+}
+#endif // APP_VCOM_DMA
+
 /**************************************************************************//**
  * Checks buttons on start.
  * @return the button code that is pressed
@@ -141,8 +194,9 @@ void sl_button_on_change(const sl_button_t *handle)
 /**************************************************************************//**
  * Set test type
  * @param[in] test_type type of the test:
- *  - sl_bt_gatt_notification or
- *  - sl_bt_gatt_indication
+ *  - sl_bt_gatt_notification,
+ *  - sl_bt_gatt_indication or
+ *  - THROUGHPUT_TEST_L2CAP
  *****************************************************************************/
 void app_set_test_type(throughput_notification_t test_type)
 {
@@ -272,6 +326,14 @@ SL_WEAK void app_init(void)
   // This is called once during start-up.                                    //
   /////////////////////////////////////////////////////////////////////////////
 
+#if APP_VCOM_DMA
+  app_vcom_dma_init();
+#endif // APP_VCOM_DMA
+
+#ifdef SL_CATALOG_CLI_PRESENT
+  sl_cli_command_add_command_group(sl_cli_default_handle, &bluetooth_command_group);
+#endif // SL_CATALOG_CLI_PRESENT
+
   // Start auto send timer - send data packet every 1 second
   sl_simple_timer_start(&auto_send_timer,
                        1000,  // 1000ms = 1 second
@@ -300,6 +362,9 @@ SL_WEAK void app_process_action(void)
  *****************************************************************************/
 void sl_bt_on_event(sl_bt_msg_t *evt)
 {
+  // Deliver the event to the components subscribed to its ID
+  throughput_event_dispatch(evt);
+
   switch (SL_BT_MSG_ID(evt->header)) {
     // -------------------------------
     // This event indicates the device has started and the radio is ready.
@@ -405,3 +470,165 @@ void throughput_central_on_finish(throughput_value_t throughput,
   throughput_ui_set_count(count);
   throughput_ui_update();
 }
+
+#ifdef SL_CATALOG_CLI_PRESENT
+/***************************************************************************//**
+ * CLI command for reading Bluetooth event processing statistics
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_bluetooth_events_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  sl_bt_event_pump_stats_t stats;
+  uint32_t limit = 1;
+
+  sl_bt_get_event_pump_stats(&stats);
+  CLI_RESPONSE("event processing\n");
+  CLI_RESPONSE("budget: %lu events %lu ticks" APP_LOG_NEW_LINE,
+               (uint32_t)SL_BT_CONFIG_EVENT_BATCH_MAX_EVENTS,
+               (uint32_t)SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS);
+  CLI_RESPONSE("events: %lu passes: %lu max batch: %lu" APP_LOG_NEW_LINE,
+               stats.events,
+               stats.passes,
+               stats.max_batch);
+  CLI_RESPONSE("max queue depth: %lu max event length: %lu" APP_LOG_NEW_LINE,
+               stats.max_queue_depth,
+               stats.max_event_len);
+  CLI_RESPONSE("budget hits: %lu events %lu ticks, deferred: %lu" APP_LOG_NEW_LINE,
+               stats.event_budget_hits,
+               stats.tick_budget_hits,
+               stats.deferred);
+  CLI_RESPONSE("ticks: %lu max pass ticks: %lu" APP_LOG_NEW_LINE,
+               stats.ticks,
+               stats.max_pass_ticks);
+  CLI_RESPONSE("events per pass:" APP_LOG_NEW_LINE);
+  for (uint8_t i = 0; i < SL_BT_EVENT_PUMP_HISTOGRAM_BINS; i++) {
+    if (i == SL_BT_EVENT_PUMP_HISTOGRAM_BINS - 1) {
+      CLI_RESPONSE("  %3lu+   : %lu" APP_LOG_NEW_LINE,
+                   (limit >> 1) + 1,
+                   stats.histogram[i]);
+    } else if (i < 2) {
+      CLI_RESPONSE("  %3lu    : %lu" APP_LOG_NEW_LINE,
+                   limit,
+                   stats.histogram[i]);
+    } else {
+      CLI_RESPONSE("  %3lu-%-3lu: %lu" APP_LOG_NEW_LINE,
+                   (limit >> 1) + 1,
+                   limit,
+                   stats.histogram[i]);
+    }
+    limit <<= 1;
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for clearing Bluetooth event processing statistics
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_bluetooth_events_clear(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  sl_bt_clear_event_pump_stats();
+  CLI_RESPONSE(CLI_OK);
+}
+
+/***************************************************************************//**
+ * CLI command for reading the Bluetooth event dispatch cost per event ID
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_bluetooth_dispatch_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  throughput_event_stats_t stats[THROUGHPUT_EVENT_SLOTS];
+  uint8_t count;
+
+  count = throughput_event_get_stats(stats, THROUGHPUT_EVENT_SLOTS);
+  CLI_RESPONSE("event dispatch (cycles)" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("event id   | subs | count      | avg      | max" APP_LOG_NEW_LINE);
+  for (uint8_t i = 0; i < count; i++) {
+    CLI_RESPONSE("0x%08lx | %4u | %10lu | %8lu | %lu" APP_LOG_NEW_LINE,
+                 stats[i].event_id,
+                 stats[i].handlers,
+                 stats[i].count,
+                 stats[i].count ? stats[i].cycles / stats[i].count : 0,
+                 stats[i].max_cycles);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for clearing the Bluetooth event dispatch cost
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_bluetooth_dispatch_clear(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  throughput_event_clear_stats();
+  CLI_RESPONSE(CLI_OK);
+}
+
+static const sl_cli_command_info_t cli_cmd_bluetooth_events_get = \
+  SL_CLI_COMMAND(cli_bluetooth_events_get,
+                 "Prints event processing statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_bluetooth_events_clear = \
+  SL_CLI_COMMAND(cli_bluetooth_events_clear,
+                 "Clears event processing statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_bluetooth_dispatch_get = \
+  SL_CLI_COMMAND(cli_bluetooth_dispatch_get,
+                 "Prints event dispatch cost per event ID",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_bluetooth_dispatch_clear = \
+  SL_CLI_COMMAND(cli_bluetooth_dispatch_clear,
+                 "Clears event dispatch cost",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_entry_t bluetooth_events_group_table[] = {
+  { "get", &cli_cmd_bluetooth_events_get, false },
+  { "g", &cli_cmd_bluetooth_events_get, true },
+  { "clear", &cli_cmd_bluetooth_events_clear, false },
+  { "c", &cli_cmd_bluetooth_events_clear, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_bluetooth_events = \
+  SL_CLI_COMMAND_GROUP(bluetooth_events_group_table, "Event processing");
+
+static const sl_cli_command_entry_t bluetooth_dispatch_group_table[] = {
+  { "get", &cli_cmd_bluetooth_dispatch_get, false },
+  { "g", &cli_cmd_bluetooth_dispatch_get, true },
+  { "clear", &cli_cmd_bluetooth_dispatch_clear, false },
+  { "c", &cli_cmd_bluetooth_dispatch_clear, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_bluetooth_dispatch = \
+  SL_CLI_COMMAND_GROUP(bluetooth_dispatch_group_table, "Event dispatch");
+
+static const sl_cli_command_entry_t bluetooth_group_table[] = {
+  { "events", &cli_cmd_grp_bluetooth_events, false },
+  { "e", &cli_cmd_grp_bluetooth_events, true },
+  { "dispatch", &cli_cmd_grp_bluetooth_dispatch, false },
+  { "d", &cli_cmd_grp_bluetooth_dispatch, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_bluetooth = \
+  SL_CLI_COMMAND_GROUP(bluetooth_group_table, "Bluetooth");
+
+static const sl_cli_command_entry_t bluetooth_command_table[] = {
+  { "bluetooth", &cli_cmd_grp_bluetooth, false },
+  { "bt", &cli_cmd_grp_bluetooth, true },
+  { NULL, NULL, false },
+};
+
+static sl_cli_command_group_t bluetooth_command_group = {
+  { NULL },
+  false,
+  bluetooth_command_table
+};
+#endif // SL_CATALOG_CLI_PRESENT
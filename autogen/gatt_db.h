@@ -22,13 +22,17 @@ extern const sli_bt_gattdb_t gattdb;
 #define gattdb_throughput_notifications       25
 #define gattdb_transmission_on                29
 #define gattdb_throughput_result              33
-#define gattdb_ThroughputInformationService   36
-#define gattdb_connection_phy                 38
-#define gattdb_connection_interval            42
-#define gattdb_responder_latency              46
-#define gattdb_supervision_timeout            50
-#define gattdb_pdu_size                       54
-#define gattdb_mtu_size                       58
+#define gattdb_throughput_pipeline            37
+#define gattdb_throughput_pipeline_ack        41
+#define gattdb_throughput_sink                44
+#define gattdb_throughput_echo                47
+#define gattdb_ThroughputInformationService   50
+#define gattdb_connection_phy                 52
+#define gattdb_connection_interval            56
+#define gattdb_responder_latency              60
+#define gattdb_supervision_timeout            64
+#define gattdb_pdu_size                       68
+#define gattdb_mtu_size                       72
 
 
 #endif // __GATT_DB_H
@@ -1,8 +1,10 @@
 
 
+#include <string.h>
 #include <em_common.h>
 #include "sl_bluetooth.h"
 #include "sl_bt_stack_init.h"
+#include "sl_sleeptimer.h"
 
 #ifdef SL_COMPONENT_CATALOG_PRESENT
 #include "sl_component_catalog.h"
@@ -21,6 +23,12 @@ const sli_bt_gattdb_t gattdb = {0};
 
 static const sl_bt_configuration_t config = SL_BT_CONFIG_DEFAULT;
 
+/** @brief Event processing statistics */
+static sl_bt_event_pump_stats_t event_pump_stats;
+
+/** @brief Events processed since the queue was last seen empty */
+static uint32_t event_backlog = 0;
+
 /** @brief Table of used BGAPI classes */
 static const struct sli_bgapi_class * const bt_class_table[] =
 {
@@ -30,6 +38,7 @@ static const struct sli_bgapi_class * const bt_class_table[] =
   SL_BT_BGAPI_CLASS(connection),
   SL_BT_BGAPI_CLASS(gatt),
   SL_BT_BGAPI_CLASS(gatt_server),
+  SL_BT_BGAPI_CLASS(l2cap),
   NULL
 };
 #if !defined(SL_CATALOG_KERNEL_PRESENT)
@@ -82,22 +91,97 @@ SL_WEAK bool sl_bt_can_process_event(uint32_t len)
   return true;
 }
 
+static uint32_t event_pump_histogram_bin(uint32_t batch)
+{
+  uint32_t bin = 0;
+  uint32_t limit = 1;
+
+  while (batch > limit && bin < SL_BT_EVENT_PUMP_HISTOGRAM_BINS - 1) {
+    limit <<= 1;
+    bin++;
+  }
+  return bin;
+}
+
+void sl_bt_get_event_pump_stats(sl_bt_event_pump_stats_t *stats)
+{
+  *stats = event_pump_stats;
+}
+
+void sl_bt_clear_event_pump_stats(void)
+{
+  memset(&event_pump_stats, 0, sizeof(event_pump_stats));
+  event_backlog = 0;
+}
+
 void sl_bt_step(void)
 {
   sl_bt_msg_t evt;
+  uint32_t batch = 0;
+  uint32_t event_len;
+  uint32_t start_tick;
+  uint32_t elapsed = 0;
+  bool pending = false;
 
   sl_bt_run();
-  uint32_t event_len = sl_bt_event_pending_len();
-  // For preventing from data loss, the event will be kept in the stack's queue
-  // if application cannot process it at the moment.
-  if ((event_len == 0) || (!sl_bt_can_process_event(event_len))) {
-    return;
+  start_tick = sl_sleeptimer_get_tick_count();
+
+  // Drain the queue until it is empty or the budget of this pass is spent.
+  while (true) {
+    event_len = sl_bt_event_pending_len();
+    if (event_len == 0) {
+      break;
+    }
+    if (batch >= SL_BT_CONFIG_EVENT_BATCH_MAX_EVENTS) {
+      event_pump_stats.event_budget_hits++;
+      pending = true;
+      break;
+    }
+#if SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS > 0
+    if (batch > 0 && elapsed >= SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS) {
+      event_pump_stats.tick_budget_hits++;
+      pending = true;
+      break;
+    }
+#endif
+    // For preventing from data loss, the event will be kept in the stack's queue
+    // if application cannot process it at the moment.
+    if (!sl_bt_can_process_event(event_len)) {
+      event_pump_stats.deferred++;
+      pending = true;
+      break;
+    }
+
+    // Pop (non-blocking) a Bluetooth stack event from event queue.
+    sl_status_t status = sl_bt_pop_event(&evt);
+    if (status != SL_STATUS_OK) {
+      break;
+    }
+    if (event_len > event_pump_stats.max_event_len) {
+      event_pump_stats.max_event_len = event_len;
+    }
+    sl_bt_process_event(&evt);
+    batch++;
+    elapsed = sl_sleeptimer_get_tick_count() - start_tick;
   }
 
-  // Pop (non-blocking) a Bluetooth stack event from event queue.
-  sl_status_t status = sl_bt_pop_event(&evt);
-  if(status != SL_STATUS_OK){
-    return;
+  if (batch > 0) {
+    event_pump_stats.passes++;
+    event_pump_stats.events += batch;
+    event_pump_stats.ticks += elapsed;
+    event_pump_stats.histogram[event_pump_histogram_bin(batch)]++;
+    if (batch > event_pump_stats.max_batch) {
+      event_pump_stats.max_batch = batch;
+    }
+    if (elapsed > event_pump_stats.max_pass_ticks) {
+      event_pump_stats.max_pass_ticks = elapsed;
+    }
+    event_backlog += batch;
+    if (event_backlog > event_pump_stats.max_queue_depth) {
+      event_pump_stats.max_queue_depth = event_backlog;
+    }
+  }
+  if (!pending) {
+    event_backlog = 0;
   }
-  sl_bt_process_event(&evt);
 }
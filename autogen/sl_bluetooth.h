@@ -12,7 +12,7 @@
 // Initialize Bluetooth core functionality
 void sl_bt_init(void);
 
-// Polls bluetooth stack for an event and processes it
+// Polls bluetooth stack for events and processes them in a batch
 void sl_bt_step(void);
 
 /**
@@ -33,6 +33,37 @@ bool sl_bt_can_process_event(uint32_t len);
 // Processes a single bluetooth event
 void sl_bt_process_event(sl_bt_msg_t *evt);
 
+// Number of bins in the events-per-pass histogram: 1, 2, 3-4, 5-8, 9-16, 17-32, 33+
+#define SL_BT_EVENT_PUMP_HISTOGRAM_BINS 7
+
+/**
+ * Event processing statistics of sl_bt_step().
+ *
+ * The stack does not expose the number of queued events. max_queue_depth is
+ * the most events processed back-to-back before the queue ran empty, counted
+ * over consecutive sl_bt_step() calls that ended with events still pending.
+ * It is a lower bound of the real peak depth.
+ */
+typedef struct {
+  uint32_t passes;            ///< sl_bt_step() calls that processed events
+  uint32_t events;            ///< Events processed
+  uint32_t event_budget_hits; ///< Passes ended by SL_BT_CONFIG_EVENT_BATCH_MAX_EVENTS
+  uint32_t tick_budget_hits;  ///< Passes ended by SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS
+  uint32_t deferred;          ///< Events held back by sl_bt_can_process_event()
+  uint32_t max_batch;         ///< Most events processed in one pass
+  uint32_t max_queue_depth;   ///< Most events processed before the queue ran empty
+  uint32_t max_event_len;     ///< Longest event data seen, in bytes
+  uint32_t ticks;             ///< Sleeptimer ticks spent processing events
+  uint32_t max_pass_ticks;    ///< Longest pass in sleeptimer ticks
+  uint32_t histogram[SL_BT_EVENT_PUMP_HISTOGRAM_BINS]; ///< Passes by events processed
+} sl_bt_event_pump_stats_t;
+
+// Copies the event processing statistics
+void sl_bt_get_event_pump_stats(sl_bt_event_pump_stats_t *stats);
+
+// Clears the event processing statistics
+void sl_bt_clear_event_pump_stats(void);
+
 void sl_bt_on_event(sl_bt_msg_t* evt);
 
 // Power Manager related functions
@@ -52,6 +52,23 @@
 
 // </h> End Bluetooth Stack Configuration
 
+// <h> Event Processing
+
+// <o SL_BT_CONFIG_EVENT_BATCH_MAX_EVENTS> Max number of events processed in one sl_bt_step() call <1-64>
+// <i> Default: 8
+// <i> sl_bt_step() keeps popping events until the queue is empty or this many
+// <i> events have been processed. Use 1 to process one event per main loop pass.
+#define SL_BT_CONFIG_EVENT_BATCH_MAX_EVENTS     (8)
+
+// <o SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS> Max time spent in one sl_bt_step() call in sleeptimer ticks <0-32768>
+// <i> Default: 33
+// <i> The batch ends after the event that exceeds this budget, so other components
+// <i> get their turn in the main loop. 33 ticks are about 1 ms with a 32768 Hz
+// <i> sleeptimer. 0 disables the time budget.
+#define SL_BT_CONFIG_EVENT_BATCH_MAX_TICKS      (33)
+
+// </h> End Event Processing
+
 // <h> TX Power Levels
 
 // <o SL_BT_CONFIG_MIN_TX_POWER> Minimum radiated TX power level in 0.1dBm unit
@@ -79,8 +79,62 @@
 
 // </h>
 
+// <h>Transmit DMA settings
+
+// <q SL_IOSTREAM_USART_VCOM_TX_DMA_ENABLE> Transmit through the LDMA
+// <i> Default: 1
+// <i> A write copies the data in the transmit buffer and returns while an LDMA
+// <i> channel sends it. Applied by the application after the instance init.
+// <i> The channel is allocated by DMADRV instead if the component is present.
+#define SL_IOSTREAM_USART_VCOM_TX_DMA_ENABLE         1
+
+// <o SL_IOSTREAM_USART_VCOM_TX_DMA_CHANNEL> LDMA channel <0-7>
+// <i> Default: 7
+#define SL_IOSTREAM_USART_VCOM_TX_DMA_CHANNEL        7
+
+// <o SL_IOSTREAM_USART_VCOM_TX_BUFFER_SIZE> Transmit buffer size <16-8192>
+// <i> Default: 1024
+#define SL_IOSTREAM_USART_VCOM_TX_BUFFER_SIZE        1024
+
+// <q SL_IOSTREAM_USART_VCOM_TX_DROP_WHEN_FULL> Drop the data that does not fit in the transmit buffer
+// <i> Default: 0
+// <i> Otherwise a write waits until the buffer has room for it.
+#define SL_IOSTREAM_USART_VCOM_TX_DROP_WHEN_FULL     0
+
+// </h>
+
+// <h>Receive DMA settings
+
+// <q SL_IOSTREAM_USART_VCOM_RX_DMA_ENABLE> Receive through the LDMA
+// <i> Default: 1
+// <i> An LDMA channel writes the receive buffer circularly instead of an
+// <i> interrupt per character. Not supported with software or RTS flow control.
+#define SL_IOSTREAM_USART_VCOM_RX_DMA_ENABLE         1
+
+// <o SL_IOSTREAM_USART_VCOM_RX_DMA_CHANNEL> LDMA channel <0-7>
+// <i> Default: 6
+#define SL_IOSTREAM_USART_VCOM_RX_DMA_CHANNEL        6
+
+// <o SL_IOSTREAM_USART_VCOM_RX_DMA_BUFFER_SIZE> Receive buffer size <16-4096:2>
+// <i> Default: 256
+// <i> Replaces the receive buffer size when receiving through the LDMA. Must be even.
+#define SL_IOSTREAM_USART_VCOM_RX_DMA_BUFFER_SIZE    256
+
+// <o SL_IOSTREAM_USART_VCOM_RX_IDLE_BITS> Idle line timeout in bit times <1-255>
+// <i> Default: 20
+// <i> The received data is handed to the read once the line is idle this long.
+#define SL_IOSTREAM_USART_VCOM_RX_IDLE_BITS          20
+
+// </h>
+
 // <<< end of configuration section >>>
 
+#if SL_IOSTREAM_USART_VCOM_RX_DMA_ENABLE
+// The LDMA is serviced twice per turn of the receive buffer and on idle line
+#undef SL_IOSTREAM_USART_VCOM_RX_BUFFER_SIZE
+#define SL_IOSTREAM_USART_VCOM_RX_BUFFER_SIZE    SL_IOSTREAM_USART_VCOM_RX_DMA_BUFFER_SIZE
+#endif
+
 // <<< sl:start pin_tool >>>
 // <usart signal=TX,RX,(CTS),(RTS)> SL_IOSTREAM_USART_VCOM
 // $[USART_SL_IOSTREAM_USART_VCOM]
@@ -2,6 +2,7 @@
 #define THROUGHPUT_CENTRAL_CONFIG_H
 
 #include "throughput_types.h"
+#include "sl_bluetooth_connection_config.h"
 
 // <<< Use Configuration Wizard in Context Menu >>>
 
@@ -10,6 +11,9 @@
 // <o THROUGHPUT_CENTRAL_TEST_TYPE> Default test
 //   <sl_bt_gatt_notification=> Notification
 //   <sl_bt_gatt_indication=> Indication
+//   <THROUGHPUT_TEST_L2CAP=> L2CAP channel
+//   <THROUGHPUT_TEST_DUPLEX=> Duplex
+//   <THROUGHPUT_TEST_UPLOAD=> Upload to the sink
 // <i> Default: sl_bt_gatt_notification
 #define THROUGHPUT_CENTRAL_TEST_TYPE                  sl_bt_gatt_notification
 
@@ -28,6 +32,35 @@
 // <i> Default: 10000
 #define THROUGHPUT_CENTRAL_FIXED_TIME                 10000
 
+// <o THROUGHPUT_CENTRAL_ECHO_INTERVAL> Latency probe interval in ms <0-10000>
+// <i> Default: 20
+// <i> Probes written to the echo characteristic during tests to measure the
+// <i> round trip, 0 disables them.
+#define THROUGHPUT_CENTRAL_ECHO_INTERVAL              20
+
+// <q THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE> Synchronize the peripheral clocks
+// <i> Default: 0
+// <i> The latency probes also fit the offset and drift of the peripheral
+// <i> clocks, which then stamp their packets by the clock of the central and
+// <i> report the one-way latency itself instead of the latency above the floor.
+// <i> Disabling it also removes the estimator and its samples from every link,
+// <i> about 0.45 KB of RAM each.
+#define THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE          0
+
+// <o THROUGHPUT_CENTRAL_CLOCK_SAMPLES> Clock samples kept per link <4-64>
+// <i> Default: 16
+// <i> Each sample is the best echo of 8 probes and takes 24 bytes. The drift is
+// <i> only fitted once the samples span 2 s, 16 samples at the default probe
+// <i> interval span 2.56 s.
+#define THROUGHPUT_CENTRAL_CLOCK_SAMPLES              16
+
+// <o THROUGHPUT_CENTRAL_LATENCY_RANGE_LOG2> Latency histogram range in 2^N us <8-24>
+// <i> Default: 20
+// <i> Each link counts the upstream latency of duplex tests, or the probe round
+// <i> trip of the other tests, in 4 * (N - 1) buckets of 4 bytes. Latencies up to
+// <i> 2^N us have buckets of their own, longer ones are counted in the last.
+#define THROUGHPUT_CENTRAL_LATENCY_RANGE_LOG2         20
+
 // </h>
 
 // <h> Data and PHY settings
@@ -50,10 +83,232 @@
 // <i> Default: sl_bt_gap_1m_phy_uncoded
 #define THROUGHPUT_DEFAULT_PHY                   sl_bt_gap_1m_phy_uncoded
 
+// <q THROUGHPUT_CENTRAL_PIPELINE_ENABLE> Receive pipelined indication tests
+// <i> Default: 1
+// <i> Subscribe to the pipeline characteristic if the peripheral has one, and
+// <i> acknowledge its segments in bulk instead of confirming every indication.
+#define THROUGHPUT_CENTRAL_PIPELINE_ENABLE       1
+
+// <o THROUGHPUT_CENTRAL_INTEGRITY> Integrity trailer
+//   <THROUGHPUT_INTEGRITY_NONE=> None
+//   <THROUGHPUT_INTEGRITY_CRC32=> CRC32
+//   <THROUGHPUT_INTEGRITY_SHA256=> SHA-256 truncated to 8 bytes
+// <i> Default: THROUGHPUT_INTEGRITY_NONE
+// <i> Requested from the peripheral for the tests started by the central, and
+// <i> checked on every packet received.
+#define THROUGHPUT_CENTRAL_INTEGRITY             THROUGHPUT_INTEGRITY_NONE
+
+// <q THROUGHPUT_CENTRAL_CRYPTO_ENABLE> Encrypt the packets with AES-128-CCM
+// <i> Default: 0
+// <i> Requested for the tests started by the central. Notification and
+// <i> indication tests are encrypted, pipelined and L2CAP tests are not.
+#define THROUGHPUT_CENTRAL_CRYPTO_ENABLE         0
+
+// <s.32 THROUGHPUT_CENTRAL_CRYPTO_KEY> AES-128 key as 32 hexadecimal digits
+// <i> Default: "000102030405060708090a0b0c0d0e0f"
+// <i> Shared by both sides, it must match the key of the peripheral.
+#define THROUGHPUT_CENTRAL_CRYPTO_KEY            "000102030405060708090a0b0c0d0e0f"
+
+// </h>
+
+// <h> L2CAP settings
+
+// <q THROUGHPUT_CENTRAL_L2CAP_ENABLE> Open an L2CAP channel for channel tests
+// <i> Default: 0
+// <i> Enabling it adds the SDU reassembly buffers to the RAM.
+#define THROUGHPUT_CENTRAL_L2CAP_ENABLE          0
+
+// <o THROUGHPUT_CENTRAL_L2CAP_MTU> Largest SDU received in bytes <23-1024>
+// <i> Default: 512
+#define THROUGHPUT_CENTRAL_L2CAP_MTU             512
+
+// <o THROUGHPUT_CENTRAL_L2CAP_CHANNELS> L2CAP channels open at the same time <1-32>
+// <i> Default: 1
+// <i> Each channel holds an SDU reassembly buffer of THROUGHPUT_CENTRAL_L2CAP_MTU bytes.
+// <i> Links connected while all channels are in use offer no channel tests.
+#define THROUGHPUT_CENTRAL_L2CAP_CHANNELS        1
+
+// <o THROUGHPUT_CENTRAL_L2CAP_MPS> Largest PDU received in bytes <23-250>
+// <i> Default: 247
+// <i> 247 bytes fill a 251 byte link layer packet.
+#define THROUGHPUT_CENTRAL_L2CAP_MPS             247
+
+// <o THROUGHPUT_CENTRAL_L2CAP_CREDITS> Credits given to the peripheral <1-255>
+// <i> Default: 16
+// <i> Consumed credits are returned to the peripheral in batches of half this amount.
+#define THROUGHPUT_CENTRAL_L2CAP_CREDITS         16
+
+// </h>
+
+// <h> History settings
+
+// <q THROUGHPUT_CENTRAL_HISTORY_ENABLE> Record the time series of the tests
+// <i> Default: 0
+// <i> Disabling it removes the records and the history timer, the history
+// <i> commands then answer with an error.
+#define THROUGHPUT_CENTRAL_HISTORY_ENABLE          0
+
+// <o THROUGHPUT_CENTRAL_HISTORY_WINDOW> Time series window in ms <0-60000>
+// <i> Default: 100
+// <i> The counters of the tests are recorded at the end of every window,
+// <i> 0 disables the recording.
+#define THROUGHPUT_CENTRAL_HISTORY_WINDOW          100
+
+// <o THROUGHPUT_CENTRAL_HISTORY_RECORDS> Records kept <1-4096>
+// <i> Default: 32
+// <i> 16 bytes of RAM each, the oldest records are overwritten. Both roles
+// <i> link into one image, so the two histories share its RAM.
+#define THROUGHPUT_CENTRAL_HISTORY_RECORDS         32
+
+// </h>
+
+// <h> Timeout settings
+
+// <o THROUGHPUT_CENTRAL_RTO_INITIAL_MS> Initial ATT round trip timeout in ms <1-30000>
+// <i> Default: 500
+// <i> The round trip of every link is measured from its latency probes and
+// <i> indications, and the result of a test is waited for two timeouts. This
+// <i> one is used until the first measurement.
+#define THROUGHPUT_CENTRAL_RTO_INITIAL_MS          500
+
+// <o THROUGHPUT_CENTRAL_RTO_MIN_MS> Minimum timeout in ms <1-30000>
+// <i> Default: 20
+// <i> Raised to two connection intervals on slower connections.
+#define THROUGHPUT_CENTRAL_RTO_MIN_MS              20
+
+// <o THROUGHPUT_CENTRAL_RTO_MAX_MS> Maximum timeout in ms <1-30000>
+// <i> Default: 4000
+#define THROUGHPUT_CENTRAL_RTO_MAX_MS              4000
+
+// </h>
+
+// <h> Export settings
+
+// <q THROUGHPUT_CENTRAL_EXPORT_ENABLE> Export the received data
+// <i> Default: 0
+// <i> Every intact packet is written to the log stream as a binary frame with
+// <i> its reception time, connection and sequence number. Disabled, the export
+// <i> queue is not built in and the export commands answer with an error.
+#define THROUGHPUT_CENTRAL_EXPORT_ENABLE           0
+
+// <o THROUGHPUT_CENTRAL_EXPORT_PAYLOAD_MAX> Largest payload exported in bytes <20-1024>
+// <i> Default: 244
+// <i> Larger packets, e.g. L2CAP SDUs, are counted and dropped.
+#define THROUGHPUT_CENTRAL_EXPORT_PAYLOAD_MAX      244
+
+// <o THROUGHPUT_CENTRAL_EXPORT_SLOTS> Export queue size in packets
+// <4=> 4
+// <8=> 8
+// <16=> 16
+// <32=> 32
+// <64=> 64
+// <i> Default: 4
+// <i> Packets arriving on a full queue are dropped. Every slot takes the
+// <i> largest payload exported and 20 bytes of record header and CRC of RAM.
+#define THROUGHPUT_CENTRAL_EXPORT_SLOTS            4
+
+// </h>
+
+// <h> Adaptive PHY settings
+
+// <q THROUGHPUT_CENTRAL_ADAPT_ENABLE> Adapt the PHY to the link conditions
+// <i> Default: 0
+// <i> Every link steps from 2M to 1M and the coded PHYs as its RSSI falls
+// <i> or its loss rises, and back up once the conditions improve.
+#define THROUGHPUT_CENTRAL_ADAPT_ENABLE            0
+
+// <o THROUGHPUT_CENTRAL_ADAPT_RSSI_2M> Leave 2M PHY below RSSI in dBm <-127-20>
+// <i> Default: -80
+#define THROUGHPUT_CENTRAL_ADAPT_RSSI_2M           -80
+
+// <o THROUGHPUT_CENTRAL_ADAPT_RSSI_1M> Leave 1M PHY below RSSI in dBm <-127-20>
+// <i> Default: -88
+#define THROUGHPUT_CENTRAL_ADAPT_RSSI_1M           -88
+
+// <o THROUGHPUT_CENTRAL_ADAPT_RSSI_CODED_500K> Leave coded 500k PHY below RSSI in dBm <-127-20>
+// <i> Default: -94
+#define THROUGHPUT_CENTRAL_ADAPT_RSSI_CODED_500K   -94
+
+// <o THROUGHPUT_CENTRAL_ADAPT_HYSTERESIS> Hysteresis in dB <0-40>
+// <i> Default: 6
+// <i> A link steps up once its RSSI is this far above the threshold of the
+// <i> faster PHY.
+#define THROUGHPUT_CENTRAL_ADAPT_HYSTERESIS        6
+
+// <o THROUGHPUT_CENTRAL_ADAPT_LOSS_HIGH> Loss that forces a step down in permille <1-1000>
+// <i> Default: 50
+#define THROUGHPUT_CENTRAL_ADAPT_LOSS_HIGH         50
+
+// <o THROUGHPUT_CENTRAL_ADAPT_LOSS_LOW> Loss that allows a step up in permille <0-1000>
+// <i> Default: 10
+#define THROUGHPUT_CENTRAL_ADAPT_LOSS_LOW          10
+
+// <o THROUGHPUT_CENTRAL_ADAPT_DOWN_DWELL> Time on a PHY before stepping down in ms <1000-600000>
+// <i> Default: 2000
+#define THROUGHPUT_CENTRAL_ADAPT_DOWN_DWELL        2000
+
+// <o THROUGHPUT_CENTRAL_ADAPT_UP_DWELL> Time on a PHY before stepping up in ms <1000-600000>
+// <i> Default: 10000
+#define THROUGHPUT_CENTRAL_ADAPT_UP_DWELL          10000
+
+// </h>
+
+// <h> Tuner settings
+
+// <o THROUGHPUT_CENTRAL_TUNE_PROBE_TIME> Probe test time in ms <200-60000>
+// <i> Default: 2000
+// <i> Every PHY and connection interval the tuner tries is tested this long.
+#define THROUGHPUT_CENTRAL_TUNE_PROBE_TIME         2000
+
+// <o THROUGHPUT_CENTRAL_TUNE_MARGIN> Required improvement in percent <0-50>
+// <i> Default: 3
+// <i> A setting replaces the best one only if its goodput is this much higher.
+#define THROUGHPUT_CENTRAL_TUNE_MARGIN             3
+
+// <o THROUGHPUT_CENTRAL_TUNE_RSSI_BAND> Signal strength band in dB <1-60>
+// <i> Default: 8
+// <i> The links are tuned again once the weakest RSSI moves this far from the
+// <i> RSSI they were tuned at.
+#define THROUGHPUT_CENTRAL_TUNE_RSSI_BAND          8
+
+// <o THROUGHPUT_CENTRAL_TUNE_LOSS_BAND> Loss band in permille <1-1000>
+// <i> Default: 20
+// <i> The links are tuned again once the loss of a test rises this far above
+// <i> the loss they were tuned at.
+#define THROUGHPUT_CENTRAL_TUNE_LOSS_BAND          20
+
+// </h>
+
+// <h> Soak settings
+
+// <q THROUGHPUT_CENTRAL_SOAK_ENABLE> Soak tests
+// <i> Default: 0
+// <i> Disabling it removes the soak state and its checkpoints, about 1.4 KB of
+// <i> RAM, the soak commands then answer with an error.
+#define THROUGHPUT_CENTRAL_SOAK_ENABLE             0
+
+// <o THROUGHPUT_CENTRAL_SOAK_CHECKPOINT> Checkpoint interval in s <1-86400>
+// <i> Default: 60
+// <i> The results of a soak test are logged and kept at every checkpoint.
+#define THROUGHPUT_CENTRAL_SOAK_CHECKPOINT         60
+
+// <o THROUGHPUT_CENTRAL_SOAK_CHECKPOINTS> Checkpoints kept <1-1024>
+// <i> Default: 8
+// <i> 56 bytes of RAM each, the oldest checkpoints are overwritten. Every
+// <i> checkpoint is logged as well.
+#define THROUGHPUT_CENTRAL_SOAK_CHECKPOINTS        8
+
 // </h>
 
 // <h> Connection settings
 
+// <o THROUGHPUT_CENTRAL_MAX_CONNECTIONS> Maximum number of peripherals received from <1-32>
+// <i> Default: (SL_BT_CONFIG_MAX_CONNECTIONS + 1) / 2
+// <i> Each link holds its own test state, about 1.2 KB of RAM. Must not exceed
+// <i> SL_BT_CONFIG_MAX_CONNECTIONS. The peripheral role links into the same
+// <i> image and takes the other half of the connections.
+#define THROUGHPUT_CENTRAL_MAX_CONNECTIONS                            ((SL_BT_CONFIG_MAX_CONNECTIONS + 1) / 2)
+
 // <o THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MIN> Minimum connection interval (in 1.25 ms steps) <6-3200>
 // <i> Default: 80
 #define THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MIN                   32
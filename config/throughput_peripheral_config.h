@@ -2,6 +2,7 @@
 #define THROUGHPUT_PERIPHERAL_CONFIG_H
 
 #include "throughput_types.h"
+#include "sl_bluetooth_connection_config.h"
 
 // <<< Use Configuration Wizard in Context Menu >>>
 
@@ -38,6 +39,28 @@
 // <i> Default: 0
 #define THROUGHPUT_PERIPHERAL_TX_SLEEP_ENABLE              0
 
+// <q THROUGHPUT_PERIPHERAL_TX_PACING> Pause sending after the stack refused data
+// <i> Default: 1
+// <i> Instead of retrying in every main loop pass, a link that could not send
+// <i> waits for a backoff and the MCU may sleep in between.
+#define THROUGHPUT_PERIPHERAL_TX_PACING                    1
+
+// <o THROUGHPUT_PERIPHERAL_TX_BACKOFF_MIN_US> Minimum backoff in microseconds <31-100000>
+// <i> Default: 1250
+// <i> Doubles on each further refusal, up to one connection interval.
+#define THROUGHPUT_PERIPHERAL_TX_BACKOFF_MIN_US            1250
+
+// </h>
+
+// <h> Connection settings
+
+// <o THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS> Maximum number of concurrent centrals <1-32>
+// <i> Default: (SL_BT_CONFIG_MAX_CONNECTIONS + 1) / 2
+// <i> Each connected central gets its own test session, about 1.2 KB of RAM.
+// <i> Must not exceed SL_BT_CONFIG_MAX_CONNECTIONS. The central role links
+// <i> into the same image and takes the other half of the connections.
+#define THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS            ((SL_BT_CONFIG_MAX_CONNECTIONS + 1) / 2)
+
 // </h>
 
 // <h> Data settings
@@ -53,7 +76,145 @@
 // <o THROUGHPUT_PERIPHERAL_DATA_TRANSFER_SIZE_NOTIFICATIONS> Transfer size for notification <0-255>
 // <i> Default: 0
 // <i> If set to 0 or > MTU-3 then it will send MTU-3 bytes of data, otherwise it will use this value
-#define THROUGHPUT_PERIPHERAL_DATA_TRANSFER_SIZE_NOTIFICATIONS             28
+#define THROUGHPUT_PERIPHERAL_DATA_TRANSFER_SIZE_NOTIFICATIONS             0
+
+// <q THROUGHPUT_PERIPHERAL_FRAME_BATCHING> Pack several sensor frames into one notification
+// <i> Default: 1
+// <i> Each frame holds a timestamp and 7 float values. As many frames are packed
+// <i> behind a small header as fit into the notification size above.
+#define THROUGHPUT_PERIPHERAL_FRAME_BATCHING               1
+
+// <o THROUGHPUT_PERIPHERAL_PATTERN> Payload pattern
+//   <THROUGHPUT_PATTERN_PRBS9=> PRBS9
+//   <THROUGHPUT_PATTERN_PRBS15=> PRBS15
+//   <THROUGHPUT_PATTERN_PRBS23=> PRBS23
+//   <THROUGHPUT_PATTERN_COUNTER=> Byte counter
+// <i> Default: THROUGHPUT_PATTERN_PRBS15
+// <i> Fills the packets that do not carry frames. The receiver regenerates it
+// <i> and counts the errored bits. A user pattern can be set from the CLI.
+#define THROUGHPUT_PERIPHERAL_PATTERN                      THROUGHPUT_PATTERN_PRBS15
+
+// <o THROUGHPUT_PERIPHERAL_INTEGRITY> Integrity trailer
+//   <THROUGHPUT_INTEGRITY_NONE=> None
+//   <THROUGHPUT_INTEGRITY_CRC32=> CRC32
+//   <THROUGHPUT_INTEGRITY_SHA256=> SHA-256 truncated to 8 bytes
+// <i> Default: THROUGHPUT_INTEGRITY_NONE
+// <i> Appended to every packet of the tests started by the peripheral. For
+// <i> tests started by the central, the central selects the trailer.
+#define THROUGHPUT_PERIPHERAL_INTEGRITY                    THROUGHPUT_INTEGRITY_NONE
+
+// <q THROUGHPUT_PERIPHERAL_CRYPTO_ENABLE> Encrypt the packets with AES-128-CCM
+// <i> Default: 0
+// <i> Requested for the tests started by the peripheral. Notification and
+// <i> indication tests are encrypted, pipelined and L2CAP tests are not.
+#define THROUGHPUT_PERIPHERAL_CRYPTO_ENABLE                0
+
+// <s.32 THROUGHPUT_PERIPHERAL_CRYPTO_KEY> AES-128 key as 32 hexadecimal digits
+// <i> Default: "000102030405060708090a0b0c0d0e0f"
+// <i> Shared by both sides, it must match the key of the central.
+#define THROUGHPUT_PERIPHERAL_CRYPTO_KEY                   "000102030405060708090a0b0c0d0e0f"
+
+// <o THROUGHPUT_PERIPHERAL_SAMPLE_RATE> Sampler rate in frames per second <0-8192>
+// <i> Default: 0
+// <i> If set to 0 each notification is generated when the previous one is sent,
+// <i> which measures the maximum throughput. Otherwise a timer interrupt samples
+// <i> frames at this rate into a queue that notifications are sent from.
+// <i> Requires frame batching.
+#define THROUGHPUT_PERIPHERAL_SAMPLE_RATE                  0
+
+// <o THROUGHPUT_PERIPHERAL_SAMPLE_QUEUE_SLOTS> Sample queue size in notifications
+// <2=> 2
+// <4=> 4
+// <8=> 8
+// <16=> 16
+// <i> Default: 4
+#define THROUGHPUT_PERIPHERAL_SAMPLE_QUEUE_SLOTS           4
+
+// <o THROUGHPUT_PERIPHERAL_LATENCY_RANGE_LOG2> Latency histogram range in 2^N us <8-24>
+// <i> Default: 20
+// <i> Each session counts the downstream latency of duplex and upload tests in
+// <i> 4 * (N - 1) buckets of 4 bytes. Latencies up to 2^N us have buckets of
+// <i> their own, longer ones are counted in the last.
+#define THROUGHPUT_PERIPHERAL_LATENCY_RANGE_LOG2           20
+
+// </h>
+
+// <h> Pipeline settings
+
+// <q THROUGHPUT_PERIPHERAL_PIPELINE_ENABLE> Pipeline indication tests
+// <i> Default: 1
+// <i> The stack allows a single outstanding indication per connection. If the
+// <i> client subscribed to the pipeline characteristic, an indication test sends
+// <i> a window of sequence numbered notifications instead, which the client
+// <i> acknowledges in bulk. Unacknowledged segments are sent again.
+#define THROUGHPUT_PERIPHERAL_PIPELINE_ENABLE              1
+
+// <o THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW> Segments in flight <1-32>
+// <i> Default: 8
+#define THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW              8
+
+// <o THROUGHPUT_PERIPHERAL_PIPELINE_TIMEOUT> Retransmission timeout in ms <10-5000>
+// <i> Default: 100
+#define THROUGHPUT_PERIPHERAL_PIPELINE_TIMEOUT             100
+
+// </h>
+
+// <h> L2CAP settings
+
+// <q THROUGHPUT_PERIPHERAL_L2CAP_ENABLE> Accept L2CAP channel tests
+// <i> Default: 0
+// <i> Accept an LE credit based channel on the throughput PSM and stream data
+// <i> over it without the ATT layer when the client selects the L2CAP test.
+// <i> Enabling it adds the SDU buffer to the RAM.
+#define THROUGHPUT_PERIPHERAL_L2CAP_ENABLE                 0
+
+// <o THROUGHPUT_PERIPHERAL_L2CAP_SDU_SIZE> SDU size in bytes <23-1024>
+// <i> Default: 512
+// <i> Limited to the MTU the client announced for the channel.
+#define THROUGHPUT_PERIPHERAL_L2CAP_SDU_SIZE               512
+
+// </h>
+
+// <h> Timeout settings
+
+// <o THROUGHPUT_PERIPHERAL_RTO_INITIAL_MS> Initial indication timeout in ms <1-30000>
+// <i> Default: 500
+// <i> The round trip of the indications of every connection is measured and
+// <i> sets their timeout. This one is used until the first confirmation.
+#define THROUGHPUT_PERIPHERAL_RTO_INITIAL_MS               500
+
+// <o THROUGHPUT_PERIPHERAL_RTO_MIN_MS> Minimum timeout in ms <1-30000>
+// <i> Default: 20
+// <i> Raised to two connection intervals on slower connections.
+#define THROUGHPUT_PERIPHERAL_RTO_MIN_MS                   20
+
+// <o THROUGHPUT_PERIPHERAL_RTO_MAX_MS> Maximum timeout in ms <1-30000>
+// <i> Default: 4000
+// <i> A late confirmation doubles the timeout up to this one, the test ends
+// <i> once the confirmation does not arrive within it.
+#define THROUGHPUT_PERIPHERAL_RTO_MAX_MS                   4000
+
+// </h>
+
+// <h> History settings
+
+// <q THROUGHPUT_PERIPHERAL_HISTORY_ENABLE> Record the time series of the tests
+// <i> Default: 0
+// <i> Disabling it removes the records and the history timer, the history
+// <i> commands then answer with an error.
+#define THROUGHPUT_PERIPHERAL_HISTORY_ENABLE                   0
+
+// <o THROUGHPUT_PERIPHERAL_HISTORY_WINDOW> Time series window in ms <0-60000>
+// <i> Default: 100
+// <i> The counters of the tests are recorded at the end of every window,
+// <i> 0 disables the recording.
+#define THROUGHPUT_PERIPHERAL_HISTORY_WINDOW                   100
+
+// <o THROUGHPUT_PERIPHERAL_HISTORY_RECORDS> Records kept <1-4096>
+// <i> Default: 32
+// <i> 16 bytes of RAM each, the oldest records are overwritten. Both roles
+// <i> link into one image, so the two histories share its RAM.
+#define THROUGHPUT_PERIPHERAL_HISTORY_RECORDS                  32
 
 // </h>
 
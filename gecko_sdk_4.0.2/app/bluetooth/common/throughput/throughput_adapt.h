@@ -0,0 +1,347 @@
+/***************************************************************************//**
+ * @file
+ * @brief Adaptive PHY selection
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_ADAPT_H
+#define THROUGHPUT_ADAPT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_types.h"
+
+/*******************************************************************************
+ * Moves a link along a ladder of PHYs from the fastest to the most robust,
+ * driven by its signal strength and loss. The signal strength is smoothed,
+ * and every step down has an RSSI threshold. The link steps down when the
+ * RSSI falls below the threshold of its PHY or the loss rises above its
+ * limit. It steps back up only when the RSSI clears the threshold of the
+ * faster PHY by the hysteresis and the loss is low.
+ *
+ * A link has to dwell on a PHY for some time before it may leave it again,
+ * longer before stepping up than before stepping down, so a link at the edge
+ * of a threshold does not oscillate. A PHY the peer does not adopt within
+ * THROUGHPUT_ADAPT_PENDING_TIME is skipped for the rest of the connection.
+ ******************************************************************************/
+
+/// PHYs of the ladder
+#define THROUGHPUT_ADAPT_RUNGS                  4
+
+/// Time a requested PHY is waited for in ms
+#define THROUGHPUT_ADAPT_PENDING_TIME           3000
+
+/// Weight of a new RSSI sample in the average, as a power of 2
+#define THROUGHPUT_ADAPT_RSSI_SHIFT             2
+
+/// Fraction bits of the RSSI average
+#define THROUGHPUT_ADAPT_RSSI_FRACTION          4
+
+/// PHYs from the fastest to the most robust
+static const throughput_phy_t throughput_adapt_phy[THROUGHPUT_ADAPT_RUNGS] = {
+  sl_bt_gap_2m_phy_uncoded,
+  sl_bt_gap_1m_phy_uncoded,
+  sl_bt_gap_coded_phy_500k,
+  sl_bt_gap_coded_phy_125k
+};
+
+/// Thresholds and timing of the ladder
+typedef struct {
+  /// RSSI in dBm below which each PHY but the last is left for the next one
+  throughput_rssi_t down_rssi[THROUGHPUT_ADAPT_RUNGS - 1];
+  /// Margin above the threshold of the faster PHY to step up in dB
+  uint8_t hysteresis;
+  /// Loss that forces a step down in permille
+  uint16_t loss_high;
+  /// Loss that still allows a step up in permille
+  uint16_t loss_low;
+  /// Time on a PHY before stepping down in ms
+  uint32_t down_dwell;
+  /// Time on a PHY before stepping up in ms
+  uint32_t up_dwell;
+} throughput_adapt_config_t;
+
+/// Adaptation state of a link
+typedef struct {
+  const throughput_adapt_config_t *config;
+  /// PHY in use and PHY requested, equal if no change is pending
+  uint8_t rung;
+  uint8_t target;
+  bool pending;
+  uint32_t pending_time;
+  /// PHYs the peer adopted or has not refused yet, bit per rung
+  uint8_t supported;
+  /// Smoothed RSSI, see THROUGHPUT_ADAPT_RSSI_FRACTION
+  int32_t rssi;
+  bool rssi_valid;
+  /// Loss of the last window in permille
+  uint16_t loss;
+  /// Time on the PHY in use in ms
+  uint32_t dwell;
+  /// Time on every PHY in ms
+  uint32_t time_in[THROUGHPUT_ADAPT_RUNGS];
+  /// Switches, in both directions and refused
+  uint32_t up;
+  uint32_t down;
+  uint32_t refused;
+} throughput_adapt_t;
+
+/**************************************************************************//**
+ * Position of a PHY on the ladder.
+ * @param[in] phy PHY, the coded PHY as reported by the stack is the 125k one
+ * @return rung, the 1M one for unknown PHYs
+ *****************************************************************************/
+static inline uint8_t throughput_adapt_rung(throughput_phy_t phy)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_ADAPT_RUNGS; i++) {
+    if (throughput_adapt_phy[i] == phy) {
+      return i;
+    }
+  }
+  return 1;
+}
+
+/**************************************************************************//**
+ * Checks whether a rung uses the coded PHY.
+ * @param[in] rung rung
+ * @return true for the coded rungs
+ *****************************************************************************/
+static inline bool throughput_adapt_coded(uint8_t rung)
+{
+  return throughput_adapt_phy[rung] == sl_bt_gap_coded_phy_500k
+         || throughput_adapt_phy[rung] == sl_bt_gap_coded_phy_125k;
+}
+
+/**************************************************************************//**
+ * Initializes the adaptation of a link.
+ * @param[out] adapt adaptation state
+ * @param[in] config thresholds and timing, kept by reference
+ * @param[in] phy PHY in use
+ *****************************************************************************/
+static inline void throughput_adapt_init(throughput_adapt_t *adapt,
+                                         const throughput_adapt_config_t *config,
+                                         throughput_phy_t phy)
+{
+  memset(adapt, 0, sizeof(*adapt));
+  adapt->config = config;
+  adapt->rung = throughput_adapt_rung(phy);
+  adapt->target = adapt->rung;
+  adapt->supported = (1 << THROUGHPUT_ADAPT_RUNGS) - 1;
+}
+
+/**************************************************************************//**
+ * Feeds a signal strength sample.
+ * @param[in,out] adapt adaptation state
+ * @param[in] rssi signal strength in dBm
+ *****************************************************************************/
+static inline void throughput_adapt_rssi(throughput_adapt_t *adapt,
+                                         throughput_rssi_t rssi)
+{
+  int32_t sample = (int32_t)rssi * (1 << THROUGHPUT_ADAPT_RSSI_FRACTION);
+
+  if (!adapt->rssi_valid) {
+    adapt->rssi = sample;
+    adapt->rssi_valid = true;
+    return;
+  }
+  adapt->rssi += (sample - adapt->rssi) / (1 << THROUGHPUT_ADAPT_RSSI_SHIFT);
+}
+
+/**************************************************************************//**
+ * Smoothed signal strength.
+ * @param[in] adapt adaptation state
+ * @return signal strength in dBm
+ *****************************************************************************/
+static inline throughput_rssi_t throughput_adapt_rssi_average(const throughput_adapt_t *adapt)
+{
+  return (throughput_rssi_t)(adapt->rssi / (1 << THROUGHPUT_ADAPT_RSSI_FRACTION));
+}
+
+/**************************************************************************//**
+ * Feeds the packets of a window. Without packets the loss fades out, so an
+ * idle link is not held on a slow PHY by the loss of an old test.
+ * @param[in,out] adapt adaptation state
+ * @param[in] packets packets received in the window
+ * @param[in] lost packets lost in the window
+ *****************************************************************************/
+static inline void throughput_adapt_loss(throughput_adapt_t *adapt,
+                                         uint32_t packets,
+                                         uint32_t lost)
+{
+  if (packets + lost == 0) {
+    adapt->loss /= 2;
+    return;
+  }
+  adapt->loss = (uint16_t)((uint64_t)lost * 1000 / ((uint64_t)packets + lost));
+}
+
+/**************************************************************************//**
+ * Moves the link to a rung.
+ * @param[in,out] adapt adaptation state
+ * @param[in] rung new rung
+ *****************************************************************************/
+static inline void throughput_adapt_enter(throughput_adapt_t *adapt, uint8_t rung)
+{
+  if (rung < adapt->rung) {
+    adapt->up++;
+  } else if (rung > adapt->rung) {
+    adapt->down++;
+  }
+  adapt->rung = rung;
+  adapt->target = rung;
+  adapt->pending = false;
+  adapt->dwell = 0;
+}
+
+/**************************************************************************//**
+ * Marks the requested PHY as requested. Moving between the coded rungs only
+ * changes the coding the controller prefers, no PHY update follows, so the
+ * move completes at once.
+ * @param[in,out] adapt adaptation state
+ *****************************************************************************/
+static inline void throughput_adapt_requested(throughput_adapt_t *adapt)
+{
+  if (throughput_adapt_coded(adapt->rung) && throughput_adapt_coded(adapt->target)) {
+    throughput_adapt_enter(adapt, adapt->target);
+    return;
+  }
+  adapt->pending = true;
+  adapt->pending_time = 0;
+}
+
+/**************************************************************************//**
+ * Skips the requested PHY for the rest of the connection.
+ * @param[in,out] adapt adaptation state
+ *****************************************************************************/
+static inline void throughput_adapt_refuse(throughput_adapt_t *adapt)
+{
+  adapt->supported &= ~(1 << adapt->target);
+  adapt->refused++;
+  adapt->target = adapt->rung;
+  adapt->pending = false;
+  // The link waits for a full dwell before trying another PHY
+  adapt->dwell = 0;
+}
+
+/**************************************************************************//**
+ * Feeds a PHY update of the link.
+ * @param[in,out] adapt adaptation state
+ * @param[in] phy PHY reported by the stack
+ *****************************************************************************/
+static inline void throughput_adapt_phy_update(throughput_adapt_t *adapt,
+                                               throughput_phy_t phy)
+{
+  uint8_t rung = throughput_adapt_rung(phy);
+
+  if (throughput_adapt_coded(rung)) {
+    // The stack does not report the coding
+    if (adapt->pending && throughput_adapt_coded(adapt->target)) {
+      rung = adapt->target;
+    } else if (throughput_adapt_coded(adapt->rung)) {
+      rung = adapt->rung;
+    }
+  }
+  if (rung == adapt->rung && !(adapt->pending && rung == adapt->target)) {
+    return;
+  }
+  // Either the requested PHY or a change requested by someone else
+  throughput_adapt_enter(adapt, rung);
+}
+
+/**************************************************************************//**
+ * Next rung the link may use in a direction.
+ * @param[in] adapt adaptation state
+ * @param[in] down true towards the robust end
+ * @param[out] rung next usable rung
+ * @return false at the end of the ladder
+ *****************************************************************************/
+static inline bool throughput_adapt_next(const throughput_adapt_t *adapt,
+                                         bool down,
+                                         uint8_t *rung)
+{
+  int8_t i = (int8_t)adapt->rung;
+
+  for (;; ) {
+    i += down ? 1 : -1;
+    if (i < 0 || i >= THROUGHPUT_ADAPT_RUNGS) {
+      return false;
+    }
+    if (adapt->supported & (1 << i)) {
+      *rung = (uint8_t)i;
+      return true;
+    }
+  }
+}
+
+/**************************************************************************//**
+ * Advances the time of the link and decides on a switch.
+ * @param[in,out] adapt adaptation state
+ * @param[in] elapsed time since the last call in ms
+ * @param[out] phy PHY to request
+ * @return true if the PHY has to be requested, see throughput_adapt_requested
+ *****************************************************************************/
+static inline bool throughput_adapt_tick(throughput_adapt_t *adapt,
+                                         uint32_t elapsed,
+                                         throughput_phy_t *phy)
+{
+  const throughput_adapt_config_t *config = adapt->config;
+  int32_t rssi = throughput_adapt_rssi_average(adapt);
+  uint8_t rung;
+
+  adapt->time_in[adapt->rung] += elapsed;
+  adapt->dwell += elapsed;
+  if (adapt->pending) {
+    adapt->pending_time += elapsed;
+    if (adapt->pending_time >= THROUGHPUT_ADAPT_PENDING_TIME) {
+      throughput_adapt_refuse(adapt);
+    }
+    return false;
+  }
+  if (!adapt->rssi_valid) {
+    return false;
+  }
+  if (adapt->dwell >= config->down_dwell
+      && (adapt->loss > config->loss_high
+          || (adapt->rung < THROUGHPUT_ADAPT_RUNGS - 1
+              && rssi < config->down_rssi[adapt->rung]))
+      && throughput_adapt_next(adapt, true, &rung)) {
+    adapt->target = rung;
+    *phy = throughput_adapt_phy[rung];
+    return true;
+  }
+  if (adapt->dwell >= config->up_dwell
+      && adapt->loss <= config->loss_low
+      && throughput_adapt_next(adapt, false, &rung)
+      && rssi >= config->down_rssi[rung] + config->hysteresis) {
+    adapt->target = rung;
+    *phy = throughput_adapt_phy[rung];
+    return true;
+  }
+  return false;
+}
+
+#endif // THROUGHPUT_ADAPT_H
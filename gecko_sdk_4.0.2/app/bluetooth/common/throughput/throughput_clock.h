@@ -0,0 +1,389 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput clock synchronization
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_CLOCK_H
+#define THROUGHPUT_CLOCK_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_sequence.h"
+
+/*******************************************************************************
+ * The clock of the central is the common time base of a test. The central
+ * writes latency probes to the echo characteristic, and the peripheral
+ * notifies them back with its own time of reception appended:
+ *
+ *   probe:   sequence (4) | central time (4)
+ *   echo:    sequence (4) | central time (4) | peripheral time (8)
+ *
+ * A probe waits for the next connection event to be sent, and its echo is
+ * sent a whole number of connection intervals later, in the first event after
+ * the peripheral handled it. The time the probe waited makes the round trip
+ * asymmetric by up to an interval, so with the interval known the central time
+ * of reception is the reception of the echo less the intervals that passed.
+ * That leaves only the difference of the handling times of the two sides. The
+ * echo of every slot of probes with the round trip farthest from a whole
+ * number of intervals is kept, its count of intervals is the least ambiguous.
+ * With the interval unknown, the midpoint of the round trip is taken and the
+ * echo with the shortest round trip is kept.
+ *
+ * The offset and the drift of the peripheral clock are fitted to the kept
+ * echoes by linear regression. Fits on a short span give no drift, the
+ * peripheral clock is assumed to run at the nominal rate then. The owner
+ * provides the storage of the kept echoes, see throughput_clock_init().
+ *
+ * The central writes the fitted model to the echo characteristic, and the
+ * peripheral converts its clock to the central base with it:
+ *
+ *   model:   tag (1) | reference (8) | offset (8) | drift (4)
+ *
+ *   central time = peripheral time + offset
+ *                  + (peripheral time - reference) * drift / 10^9
+ ******************************************************************************/
+
+/// Size of a latency probe
+#define THROUGHPUT_CLOCK_PROBE_SIZE             8
+/// Size of the peripheral time appended to the echo of a probe
+#define THROUGHPUT_CLOCK_TIME_SIZE              8
+/// Size of the echo of a probe
+#define THROUGHPUT_CLOCK_ECHO_SIZE              (THROUGHPUT_CLOCK_PROBE_SIZE + THROUGHPUT_CLOCK_TIME_SIZE)
+/// First byte of a packed model
+#define THROUGHPUT_CLOCK_MODEL_TAG              0xC5
+/// Size of a packed model
+#define THROUGHPUT_CLOCK_MODEL_PACKED_SIZE      21
+/// Kept samples before the first fit
+#define THROUGHPUT_CLOCK_MIN_SAMPLES            4
+/// Probes per slot, the one with the shortest round trip is kept
+#define THROUGHPUT_CLOCK_SLOT_PROBES            8
+/// Round trip above the shortest one still used by midpoint fits in microseconds
+#define THROUGHPUT_CLOCK_RTT_SLACK              500
+/// Shortest span of samples the drift is fitted on in microseconds
+#define THROUGHPUT_CLOCK_DRIFT_SPAN             2000000
+/// Largest drift accepted in parts per billion
+#define THROUGHPUT_CLOCK_DRIFT_MAX              1000000
+
+/// Conversion of the peripheral clock to the central base
+typedef struct {
+  /// Peripheral time the offset is valid at in microseconds
+  uint64_t reference;
+  /// Central time minus peripheral time at the reference in microseconds
+  int64_t offset;
+  /// Rate of the central clock relative to the peripheral one in ppb
+  int32_t drift;
+  bool valid;
+} throughput_clock_model_t;
+
+/// Offset measured by an echo
+typedef struct {
+  /// Peripheral time of reception in microseconds
+  uint64_t local;
+  /// Central time minus peripheral time in microseconds
+  int64_t offset;
+  /// Round trip of a midpoint sample in microseconds, 0 if timed by the interval
+  uint32_t rtt;
+} throughput_clock_sample_t;
+
+/// Offset and drift estimator of the central
+typedef struct {
+  /// Kept samples, a ring of the given capacity provided by the owner
+  throughput_clock_sample_t *samples;
+  uint8_t capacity;
+  uint8_t head;
+  uint8_t count;
+  /// Best sample of the slot in progress, lower scores are better
+  throughput_clock_sample_t slot;
+  uint32_t slot_score;
+  uint8_t slot_probes;
+  /// Samples used by the last fit and their RMS residual in microseconds
+  uint8_t used;
+  uint32_t residual;
+  throughput_clock_model_t model;
+} throughput_clock_t;
+
+/**************************************************************************//**
+ * Convert sleeptimer ticks to microseconds without overflowing the product.
+ * @param[in] ticks tick count
+ * @param[in] frequency tick frequency in Hz
+ * @return time in microseconds
+ *****************************************************************************/
+static inline uint64_t throughput_clock_ticks_to_us(uint64_t ticks, uint32_t frequency)
+{
+  return (ticks / frequency) * 1000000
+         + (ticks % frequency) * 1000000 / frequency;
+}
+
+/**************************************************************************//**
+ * Write a 64-bit time in little endian.
+ * @param[out] buffer 8 bytes
+ * @param[in] time time to write
+ *****************************************************************************/
+static inline void throughput_clock_write(uint8_t *buffer, uint64_t time)
+{
+  throughput_sequence_write(buffer, (uint32_t)time);
+  throughput_sequence_write(buffer + 4, (uint32_t)(time >> 32));
+}
+
+/**************************************************************************//**
+ * Read a 64-bit time in little endian.
+ * @param[in] buffer 8 bytes
+ * @return time read
+ *****************************************************************************/
+static inline uint64_t throughput_clock_read(const uint8_t *buffer)
+{
+  return (uint64_t)throughput_sequence_read(buffer)
+         | ((uint64_t)throughput_sequence_read(buffer + 4) << 32);
+}
+
+/**************************************************************************//**
+ * Convert a peripheral time to the central base.
+ * @param[in] model conversion, the time is returned as is if not valid
+ * @param[in] local peripheral time in microseconds
+ * @return central time in microseconds
+ *****************************************************************************/
+static inline uint64_t throughput_clock_convert(const throughput_clock_model_t *model,
+                                                uint64_t local)
+{
+  if (!model->valid) {
+    return local;
+  }
+  return local + (uint64_t)model->offset
+         + (uint64_t)((int64_t)(local - model->reference) * model->drift / 1000000000);
+}
+
+/**************************************************************************//**
+ * One-way delay between synchronized timestamps. Timestamps are the low 32
+ * bits of the time, a packet received before it was sent by the model is
+ * counted with no delay.
+ * @param[in] sent send time in microseconds
+ * @param[in] received receive time in microseconds
+ * @return delay in microseconds
+ *****************************************************************************/
+static inline uint32_t throughput_clock_delay(uint32_t sent, uint32_t received)
+{
+  int32_t delay = (int32_t)(received - sent);
+
+  return delay > 0 ? (uint32_t)delay : 0;
+}
+
+/**************************************************************************//**
+ * Reset the estimator, the kept samples are dropped.
+ * @param[in,out] clock estimator
+ *****************************************************************************/
+static inline void throughput_clock_reset(throughput_clock_t *clock)
+{
+  throughput_clock_sample_t *samples = clock->samples;
+  uint8_t capacity = clock->capacity;
+
+  memset(clock, 0, sizeof(*clock));
+  clock->samples = samples;
+  clock->capacity = capacity;
+}
+
+/**************************************************************************//**
+ * Attach the sample storage to the estimator and reset it. The span of the
+ * samples, capacity * THROUGHPUT_CLOCK_SLOT_PROBES probe intervals, must reach
+ * THROUGHPUT_CLOCK_DRIFT_SPAN for the drift to be fitted.
+ * @param[out] clock estimator
+ * @param[in] samples storage of the kept samples
+ * @param[in] capacity number of samples kept, at least THROUGHPUT_CLOCK_MIN_SAMPLES
+ *****************************************************************************/
+static inline void throughput_clock_init(throughput_clock_t *clock,
+                                         throughput_clock_sample_t *samples,
+                                         uint8_t capacity)
+{
+  clock->samples = samples;
+  clock->capacity = capacity;
+  throughput_clock_reset(clock);
+}
+
+/**************************************************************************//**
+ * Fit the model to the kept samples with a round trip close to the shortest.
+ * The reference is the mean peripheral time of the samples used.
+ * @param[in,out] clock estimator
+ *****************************************************************************/
+static inline void throughput_clock_fit(throughput_clock_t *clock)
+{
+  const throughput_clock_sample_t *first = NULL;
+  uint32_t min_rtt = UINT32_MAX;
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+  double sum_xx = 0.0;
+  double sum_xy = 0.0;
+  double sum_yy = 0.0;
+  double span;
+  double slope = 0.0;
+  double mean_x;
+  double mean_y;
+  double var_x;
+  double var_y;
+  uint8_t n = 0;
+
+  for (uint8_t i = 0; i < clock->count; i++) {
+    if (clock->samples[i].rtt < min_rtt) {
+      min_rtt = clock->samples[i].rtt;
+    }
+  }
+  // Coordinates relative to the first sample used keep the precision
+  for (uint8_t i = 0; i < clock->count; i++) {
+    const throughput_clock_sample_t *sample = &clock->samples[i];
+    double x;
+    double y;
+    if (sample->rtt > min_rtt + THROUGHPUT_CLOCK_RTT_SLACK) {
+      continue;
+    }
+    if (first == NULL) {
+      first = sample;
+    }
+    x = (double)(int64_t)(sample->local - first->local);
+    y = (double)(sample->offset - first->offset);
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+    sum_yy += y * y;
+    n++;
+  }
+  if (n == 0) {
+    return;
+  }
+  mean_x = sum_x / n;
+  mean_y = sum_y / n;
+  var_x = sum_xx / n - mean_x * mean_x;
+  var_y = sum_yy / n - mean_y * mean_y;
+  // The span of uniformly spread samples is sqrt(12) standard deviations
+  span = var_x * 12.0;
+  if (n > 2 && span >= (double)THROUGHPUT_CLOCK_DRIFT_SPAN * THROUGHPUT_CLOCK_DRIFT_SPAN) {
+    slope = (sum_xy / n - mean_x * mean_y) / var_x;
+    if (slope > THROUGHPUT_CLOCK_DRIFT_MAX / 1e9) {
+      slope = THROUGHPUT_CLOCK_DRIFT_MAX / 1e9;
+    } else if (slope < -THROUGHPUT_CLOCK_DRIFT_MAX / 1e9) {
+      slope = -THROUGHPUT_CLOCK_DRIFT_MAX / 1e9;
+    }
+  }
+  // Residual variance of the line through the means
+  var_y -= 2.0 * slope * (sum_xy / n - mean_x * mean_y) - slope * slope * var_x;
+  clock->residual = var_y > 0.0 ? (uint32_t)sqrt(var_y) : 0;
+  clock->used = n;
+  clock->model.reference = first->local + (uint64_t)(int64_t)mean_x;
+  clock->model.offset = first->offset + (int64_t)mean_y;
+  clock->model.drift = (int32_t)(slope * 1e9);
+  clock->model.valid = true;
+}
+
+/**************************************************************************//**
+ * Account the echo of a probe. The best echo of every slot is kept, and the
+ * model is fitted again when a slot completes.
+ * @param[in,out] clock estimator
+ * @param[in] sent central time the probe was sent in microseconds
+ * @param[in] received central time the echo was received in microseconds
+ * @param[in] local peripheral time the probe was received in microseconds
+ * @param[in] interval connection interval in microseconds, 0 if unknown
+ * @return true if the model changed
+ *****************************************************************************/
+static inline bool throughput_clock_add(throughput_clock_t *clock,
+                                        uint64_t sent,
+                                        uint64_t received,
+                                        uint64_t local,
+                                        uint32_t interval)
+{
+  uint32_t rtt = (uint32_t)(received - sent);
+  uint32_t remainder;
+  uint32_t score;
+
+  if (interval > 0 && rtt >= interval) {
+    remainder = rtt % interval;
+    score = remainder > interval / 2 ? remainder - interval / 2 : interval / 2 - remainder;
+    if (clock->slot_probes == 0 || score < clock->slot_score) {
+      clock->slot.local = local;
+      clock->slot.offset = (int64_t)(received - (uint64_t)(rtt / interval) * interval - local);
+      clock->slot.rtt = 0;
+      clock->slot_score = score;
+    }
+  } else if (clock->slot_probes == 0 || rtt < clock->slot_score) {
+    clock->slot.local = local;
+    clock->slot.offset = (int64_t)(sent + rtt / 2 - local);
+    clock->slot.rtt = rtt;
+    clock->slot_score = rtt;
+  }
+  if (++clock->slot_probes < THROUGHPUT_CLOCK_SLOT_PROBES) {
+    return false;
+  }
+  clock->slot_probes = 0;
+  clock->samples[clock->head] = clock->slot;
+  clock->head = (uint8_t)((clock->head + 1) % clock->capacity);
+  if (clock->count < clock->capacity) {
+    clock->count++;
+  }
+  if (clock->count < THROUGHPUT_CLOCK_MIN_SAMPLES) {
+    return false;
+  }
+  throughput_clock_fit(clock);
+  return true;
+}
+
+/**************************************************************************//**
+ * Pack a model for the echo characteristic.
+ * @param[in] model model to pack
+ * @param[out] buffer THROUGHPUT_CLOCK_MODEL_PACKED_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_clock_pack(const throughput_clock_model_t *model,
+                                         uint8_t *buffer)
+{
+  buffer[0] = THROUGHPUT_CLOCK_MODEL_TAG;
+  throughput_clock_write(buffer + 1, model->reference);
+  throughput_clock_write(buffer + 9, (uint64_t)model->offset);
+  throughput_sequence_write(buffer + 17, (uint32_t)model->drift);
+}
+
+/**************************************************************************//**
+ * Unpack a model written to the echo characteristic.
+ * @param[in] buffer written value
+ * @param[in] len length of the value
+ * @param[out] model unpacked model
+ * @return false if the value is not a packed model
+ *****************************************************************************/
+static inline bool throughput_clock_unpack(const uint8_t *buffer,
+                                           uint16_t len,
+                                           throughput_clock_model_t *model)
+{
+  if (len != THROUGHPUT_CLOCK_MODEL_PACKED_SIZE
+      || buffer[0] != THROUGHPUT_CLOCK_MODEL_TAG) {
+    return false;
+  }
+  model->reference = throughput_clock_read(buffer + 1);
+  model->offset = (int64_t)throughput_clock_read(buffer + 9);
+  model->drift = (int32_t)throughput_sequence_read(buffer + 17);
+  model->valid = true;
+  return true;
+}
+
+#endif // THROUGHPUT_CLOCK_H
@@ -39,7 +39,9 @@ typedef enum {
   act_enable_transmission_notification,
   act_enable_notification,
   act_enable_indication,
-  act_subscribe_result
+  act_subscribe_result,
+  act_enable_pipeline,
+  act_enable_echo
 } action_t;
 
 #endif
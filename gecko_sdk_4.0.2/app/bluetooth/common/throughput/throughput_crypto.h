@@ -0,0 +1,327 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput packet encryption
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_CRYPTO_H
+#define THROUGHPUT_CRYPTO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_device.h"
+#include "throughput_integrity.h"
+
+#if defined(CRYPTOACC_PRESENT)
+#include "psa/crypto.h"
+#include "sli_cryptoacc_transparent_functions.h"
+#if defined(PSA_WANT_ALG_CCM) && defined(PSA_WANT_KEY_TYPE_AES)
+/// AES-CCM is computed by the CRYPTOACC AES engine
+#define THROUGHPUT_CRYPTO_PRESENT               1
+#endif
+#endif
+
+#ifndef THROUGHPUT_CRYPTO_PRESENT
+#define THROUGHPUT_CRYPTO_PRESENT               0
+#endif
+
+/*******************************************************************************
+ * Optional application layer encryption of the data packets with AES-128-CCM.
+ * The sender builds the packet in its TX buffer after room for the envelope
+ * header, then encrypts it in place and writes the tag behind it. The receiver
+ * decrypts in place in the received event and checks the inner packet as if
+ * it had been sent in the clear. No packet is copied for the encryption.
+ *
+ *   packet:  epoch (4) | sequence (4) | ciphertext | tag (8)
+ *
+ * The header is sent in the clear and authenticated as associated data. The
+ * 8 byte nonce is the header itself: the epoch is drawn from the TRNG at the
+ * start of every test and the sequence counts the packets of the test, so a
+ * nonce is not used twice with the same key as long as epochs do not repeat.
+ * The key is shared by configuration, change it well before 2^16 tests to
+ * keep the chance of an epoch collision negligible.
+ *
+ * Nothing is sent when the TRNG cannot draw an epoch or a packet fails to
+ * encrypt: the test does not start, or the packet is built again.
+ *
+ * The test initiator selects encryption, it is carried in bit 6 of the value
+ * written to or notified on the transmission characteristic. It covers the
+ * notification and indication tests, not the indication pipeline and L2CAP
+ * channel tests.
+ ******************************************************************************/
+
+/// Encryption flag in the transmission value
+#define THROUGHPUT_CRYPTO_FLAG                  0x40
+/// Key size in bytes
+#define THROUGHPUT_CRYPTO_KEY_SIZE              16
+/// Envelope header size in bytes, the epoch and the sequence
+#define THROUGHPUT_CRYPTO_HEADER_SIZE           8
+/// Authentication tag size in bytes
+#define THROUGHPUT_CRYPTO_TAG_SIZE              8
+/// Bytes added to a packet by the encryption
+#define THROUGHPUT_CRYPTO_OVERHEAD              (THROUGHPUT_CRYPTO_HEADER_SIZE \
+                                                 + THROUGHPUT_CRYPTO_TAG_SIZE)
+
+/// Encryption key
+typedef struct {
+  uint8_t key[THROUGHPUT_CRYPTO_KEY_SIZE];
+#if THROUGHPUT_CRYPTO_PRESENT
+  psa_key_attributes_t attributes;
+#endif
+} throughput_crypto_key_t;
+
+/// Encryption statistics
+typedef struct {
+  /// Packets encrypted or decrypted
+  uint32_t packets;
+  /// Packets that did not authenticate
+  uint32_t failures;
+  /// Plaintext bytes carried by the packets
+  uint64_t plaintext_bytes;
+  /// Bytes of the packets, with the envelope
+  uint64_t bytes;
+  /// CPU cycles spent in the encryption
+  uint64_t cycles;
+} throughput_crypto_stats_t;
+
+/**************************************************************************//**
+ * Check if encryption can be used on this device.
+ * @return true if supported
+ *****************************************************************************/
+static inline bool throughput_crypto_supported(void)
+{
+  return THROUGHPUT_CRYPTO_PRESENT;
+}
+
+/**************************************************************************//**
+ * Read the encryption flag from the transmission value.
+ * @param[in] value transmission value
+ * @return true if the test is encrypted and it is supported
+ *****************************************************************************/
+static inline bool throughput_crypto_decode(uint8_t value)
+{
+  return throughput_crypto_supported() && (value & THROUGHPUT_CRYPTO_FLAG);
+}
+
+/**************************************************************************//**
+ * Load a key.
+ * @param[out] key key to load
+ * @param[in] value key value, THROUGHPUT_CRYPTO_KEY_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_crypto_set_key(throughput_crypto_key_t *key,
+                                             const uint8_t *value)
+{
+  memcpy(key->key, value, THROUGHPUT_CRYPTO_KEY_SIZE);
+#if THROUGHPUT_CRYPTO_PRESENT
+  key->attributes = psa_key_attributes_init();
+  psa_set_key_type(&key->attributes, PSA_KEY_TYPE_AES);
+  psa_set_key_bits(&key->attributes, THROUGHPUT_CRYPTO_KEY_SIZE * 8);
+#endif
+}
+
+/**************************************************************************//**
+ * Parse a key written as hexadecimal digits.
+ * @param[in] str key as 32 hexadecimal digits
+ * @param[out] value key value, THROUGHPUT_CRYPTO_KEY_SIZE bytes
+ * @return true if the string is a valid key
+ *****************************************************************************/
+static inline bool throughput_crypto_parse_key(const char *str, uint8_t *value)
+{
+  if (str == NULL || strlen(str) != 2 * THROUGHPUT_CRYPTO_KEY_SIZE) {
+    return false;
+  }
+  for (uint8_t i = 0; i < 2 * THROUGHPUT_CRYPTO_KEY_SIZE; i++) {
+    char c = str[i];
+    uint8_t nibble;
+    if (c >= '0' && c <= '9') {
+      nibble = (uint8_t)(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      nibble = (uint8_t)(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      nibble = (uint8_t)(c - 'A' + 10);
+    } else {
+      return false;
+    }
+    if (i % 2 == 0) {
+      value[i / 2] = (uint8_t)(nibble << 4);
+    } else {
+      value[i / 2] |= nibble;
+    }
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * Draw the epoch of a new test.
+ * @param[out] epoch random epoch
+ * @return SL_STATUS_OK, or SL_STATUS_FAIL if the TRNG failed, a predictable
+ *         epoch could repeat nonces
+ *****************************************************************************/
+static inline sl_status_t throughput_crypto_epoch(uint32_t *epoch)
+{
+  *epoch = 0;
+#if THROUGHPUT_CRYPTO_PRESENT
+  size_t len = 0;
+  if (mbedtls_psa_external_get_random(NULL,
+                                      (uint8_t *)epoch,
+                                      sizeof(*epoch),
+                                      &len) == PSA_SUCCESS
+      && len == sizeof(*epoch)) {
+    return SL_STATUS_OK;
+  }
+  return SL_STATUS_FAIL;
+#else
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+/**************************************************************************//**
+ * Encrypt a packet in place.
+ * @param[in] key key
+ * @param[in] epoch epoch of the test
+ * @param[in] sequence sequence number of the packet
+ * @param[in,out] buf packet, with the plaintext after the header and room for
+ *                    the tag after the plaintext
+ * @param[in] len plaintext length
+ * @param[in,out] stats statistics to account the cost to, can be NULL
+ * @return packet length with the envelope, 0 on failure
+ *****************************************************************************/
+static inline size_t throughput_crypto_seal(const throughput_crypto_key_t *key,
+                                            uint32_t epoch,
+                                            uint32_t sequence,
+                                            uint8_t *buf,
+                                            size_t len,
+                                            throughput_crypto_stats_t *stats)
+{
+  bool sealed = false;
+  uint32_t start = throughput_integrity_cycles();
+
+  buf[0] = (uint8_t)epoch;
+  buf[1] = (uint8_t)(epoch >> 8);
+  buf[2] = (uint8_t)(epoch >> 16);
+  buf[3] = (uint8_t)(epoch >> 24);
+  buf[4] = (uint8_t)sequence;
+  buf[5] = (uint8_t)(sequence >> 8);
+  buf[6] = (uint8_t)(sequence >> 16);
+  buf[7] = (uint8_t)(sequence >> 24);
+#if THROUGHPUT_CRYPTO_PRESENT
+  {
+    uint8_t *data = buf + THROUGHPUT_CRYPTO_HEADER_SIZE;
+    size_t data_len = 0;
+    size_t tag_len = 0;
+    sealed = sli_cryptoacc_transparent_aead_encrypt_tag(
+      &key->attributes,
+      key->key,
+      sizeof(key->key),
+      PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, THROUGHPUT_CRYPTO_TAG_SIZE),
+      buf,
+      THROUGHPUT_CRYPTO_HEADER_SIZE,
+      buf,
+      THROUGHPUT_CRYPTO_HEADER_SIZE,
+      data,
+      len,
+      data,
+      len,
+      &data_len,
+      data + len,
+      THROUGHPUT_CRYPTO_TAG_SIZE,
+      &tag_len) == PSA_SUCCESS;
+  }
+#else
+  (void)key;
+#endif
+  if (stats != NULL) {
+    stats->cycles += (uint32_t)(throughput_integrity_cycles() - start);
+    stats->packets++;
+    if (sealed) {
+      stats->plaintext_bytes += len;
+      stats->bytes += len + THROUGHPUT_CRYPTO_OVERHEAD;
+    } else {
+      stats->failures++;
+    }
+  }
+  return sealed ? len + THROUGHPUT_CRYPTO_OVERHEAD : 0;
+}
+
+/**************************************************************************//**
+ * Decrypt a packet in place.
+ * @param[in] key key
+ * @param[in,out] buf packet, the plaintext replaces the ciphertext after the
+ *                    header
+ * @param[in] len packet length with the envelope
+ * @param[in,out] stats statistics, can be NULL
+ * @return true if the packet authenticates
+ *****************************************************************************/
+static inline bool throughput_crypto_open(const throughput_crypto_key_t *key,
+                                          uint8_t *buf,
+                                          size_t len,
+                                          throughput_crypto_stats_t *stats)
+{
+  bool opened = false;
+  uint32_t start = throughput_integrity_cycles();
+
+#if THROUGHPUT_CRYPTO_PRESENT
+  if (len >= THROUGHPUT_CRYPTO_OVERHEAD) {
+    uint8_t *data = buf + THROUGHPUT_CRYPTO_HEADER_SIZE;
+    size_t data_len = len - THROUGHPUT_CRYPTO_OVERHEAD;
+    size_t plain_len = 0;
+    opened = sli_cryptoacc_transparent_aead_decrypt_tag(
+      &key->attributes,
+      key->key,
+      sizeof(key->key),
+      PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, THROUGHPUT_CRYPTO_TAG_SIZE),
+      buf,
+      THROUGHPUT_CRYPTO_HEADER_SIZE,
+      buf,
+      THROUGHPUT_CRYPTO_HEADER_SIZE,
+      data,
+      data_len,
+      data + data_len,
+      THROUGHPUT_CRYPTO_TAG_SIZE,
+      data,
+      data_len,
+      &plain_len) == PSA_SUCCESS;
+  }
+#else
+  (void)key;
+  (void)buf;
+#endif
+  if (stats != NULL) {
+    stats->cycles += (uint32_t)(throughput_integrity_cycles() - start);
+    stats->packets++;
+    if (opened) {
+      stats->plaintext_bytes += len - THROUGHPUT_CRYPTO_OVERHEAD;
+      stats->bytes += len;
+    } else {
+      stats->failures++;
+    }
+  }
+  return opened;
+}
+
+#endif // THROUGHPUT_CRYPTO_H
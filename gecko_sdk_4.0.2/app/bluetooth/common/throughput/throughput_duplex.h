@@ -0,0 +1,273 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput full-duplex test
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_DUPLEX_H
+#define THROUGHPUT_DUPLEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "throughput_types.h"
+#include "throughput_sequence.h"
+
+/*******************************************************************************
+ * In a duplex test the peripheral notifies upstream while the central writes
+ * without response to the sink characteristic downstream, so both directions
+ * share the same connection events. Packets of both directions end with the
+ * microsecond timestamp of their sender.
+ *
+ *   packet:  sequence (4) | pattern (1) | payload | timestamp (4)
+ *
+ * Without clock synchronization the one-way latency is measured above the
+ * smallest delay seen in the test. The offset between the clocks cancels out,
+ * the fixed part of the delay is not measured. Once the central synchronized
+ * the peripheral clock, see throughput_clock.h, both sides stamp by the clock
+ * of the central and the latency histograms hold the delay itself.
+ *
+ * The receiver of the downstream reports its results in the result
+ * characteristic after the packed sequence statistics:
+ *
+ *   result:  throughput (4) | latency mean (4) | latency max (4)
+ *
+ * The flag alone, without a test type, starts an upload: the central only
+ * writes to the sink and the peripheral sends nothing but its result, with
+ * the upload throughput in the first field as well.
+ ******************************************************************************/
+
+/// Duplex flag of the transmission state, on top of the notification test
+#define THROUGHPUT_DUPLEX_FLAG                  0x08
+/// Test type bits of the transmission state
+#define THROUGHPUT_DUPLEX_TEST_MASK             (sl_bt_gatt_notification \
+                                                 | sl_bt_gatt_indication \
+                                                 | THROUGHPUT_TEST_L2CAP)
+/// Size of the timestamp field
+#define THROUGHPUT_DUPLEX_TIMESTAMP_SIZE        4
+/// Smallest duplex packet
+#define THROUGHPUT_DUPLEX_MIN_SIZE              (THROUGHPUT_SEQUENCE_SIZE + THROUGHPUT_DUPLEX_TIMESTAMP_SIZE)
+/// Size of the packed downstream results
+#define THROUGHPUT_DUPLEX_PACKED_SIZE           12
+
+/// One-way latency above the smallest delay seen
+typedef struct {
+  uint32_t packets;
+  /// Delay of the first packet, the others are relative to it
+  uint32_t base;
+  /// Smallest relative delay seen
+  int32_t floor;
+  /// Sum and maximum of the delays above the floor in microseconds
+  uint64_t excess_sum;
+  uint32_t excess_max;
+} throughput_duplex_latency_t;
+
+/// Downstream results reported by the peripheral
+typedef struct {
+  uint32_t throughput;
+  uint32_t latency_mean;
+  uint32_t latency_max;
+} throughput_duplex_result_t;
+
+/**************************************************************************//**
+ * Check whether a transmission state starts an upload.
+ * @param[in] transmission transmission state written or notified
+ * @return true if only the sink receives data
+ *****************************************************************************/
+static inline bool throughput_duplex_is_upload(uint8_t transmission)
+{
+  return (transmission & THROUGHPUT_DUPLEX_FLAG)
+         && !(transmission & THROUGHPUT_DUPLEX_TEST_MASK);
+}
+
+/**************************************************************************//**
+ * Write a duplex packet.
+ * @param[out] buffer packet
+ * @param[in] len length of the packet, at least THROUGHPUT_DUPLEX_MIN_SIZE
+ * @param[in] sequence sequence number
+ * @param[in] pattern pattern engine of the sender
+ * @param[in] timestamp send time in microseconds
+ *****************************************************************************/
+static inline void throughput_duplex_write_packet(uint8_t *buffer,
+                                                  uint16_t len,
+                                                  uint32_t sequence,
+                                                  const throughput_pattern_t *pattern,
+                                                  uint32_t timestamp)
+{
+  len = (uint16_t)(len - THROUGHPUT_DUPLEX_TIMESTAMP_SIZE);
+  throughput_sequence_write_packet(buffer, len, sequence, pattern);
+  throughput_sequence_write(buffer + len, timestamp);
+}
+
+/**************************************************************************//**
+ * Check a received duplex packet.
+ * @param[in] buffer packet
+ * @param[in] len length of the packet
+ * @param[in,out] pattern pattern engine of the receiver
+ * @param[in,out] stats bit error statistics
+ * @param[out] timestamp send time in microseconds
+ * @return true if the packet is intact
+ *****************************************************************************/
+static inline bool throughput_duplex_check_packet(const uint8_t *buffer,
+                                                  uint16_t len,
+                                                  throughput_pattern_t *pattern,
+                                                  throughput_pattern_stats_t *stats,
+                                                  uint32_t *timestamp)
+{
+  if (len < THROUGHPUT_DUPLEX_MIN_SIZE) {
+    return false;
+  }
+  len = (uint16_t)(len - THROUGHPUT_DUPLEX_TIMESTAMP_SIZE);
+  *timestamp = throughput_sequence_read(buffer + len);
+  return throughput_sequence_check_packet(buffer, len, pattern, stats);
+}
+
+/**************************************************************************//**
+ * Reset the latency statistics.
+ * @param[out] latency latency statistics
+ *****************************************************************************/
+static inline void throughput_duplex_latency_reset(throughput_duplex_latency_t *latency)
+{
+  memset(latency, 0, sizeof(*latency));
+}
+
+/**************************************************************************//**
+ * Account the delay of a received packet. When a packet arrives faster than
+ * all the ones before, the floor drops and the excess of those is raised by
+ * the difference.
+ * @param[in,out] latency latency statistics
+ * @param[in] sent send time by the clock of the sender in microseconds
+ * @param[in] received receive time by the local clock in microseconds
+ * @return latency of the packet above the floor in microseconds
+ *****************************************************************************/
+static inline uint32_t throughput_duplex_latency_add(throughput_duplex_latency_t *latency,
+                                                 uint32_t sent,
+                                                 uint32_t received)
+{
+  uint32_t delay = received - sent;
+  int32_t relative;
+  uint32_t excess;
+
+  if (latency->packets == 0) {
+    latency->base = delay;
+    latency->floor = 0;
+    latency->packets = 1;
+    return 0;
+  }
+  relative = (int32_t)(delay - latency->base);
+  if (relative < latency->floor) {
+    uint32_t drop = (uint32_t)(latency->floor - relative);
+    latency->excess_sum += (uint64_t)drop * latency->packets;
+    latency->excess_max += drop;
+    latency->floor = relative;
+    excess = 0;
+  } else {
+    excess = (uint32_t)(relative - latency->floor);
+  }
+  latency->excess_sum += excess;
+  if (excess > latency->excess_max) {
+    latency->excess_max = excess;
+  }
+  latency->packets++;
+  return excess;
+}
+
+/**************************************************************************//**
+ * Mean latency above the floor.
+ * @param[in] latency latency statistics
+ * @return mean latency in microseconds
+ *****************************************************************************/
+static inline uint32_t throughput_duplex_latency_mean(const throughput_duplex_latency_t *latency)
+{
+  if (latency->packets == 0) {
+    return 0;
+  }
+  return (uint32_t)(latency->excess_sum / latency->packets);
+}
+
+/**************************************************************************//**
+ * Share of the PHY bit rate carried as application data by both directions.
+ * @param[in] phy connection PHY
+ * @param[in] up upstream throughput in bits/s
+ * @param[in] down downstream throughput in bits/s
+ * @return link utilization in percent
+ *****************************************************************************/
+static inline float throughput_duplex_utilization(throughput_phy_t phy,
+                                                  uint32_t up,
+                                                  uint32_t down)
+{
+  float rate;
+
+  switch (phy) {
+    case sl_bt_gap_2m_phy_uncoded:
+      rate = 2000000.0f;
+      break;
+    case sl_bt_gap_coded_phy_125k:
+      rate = 125000.0f;
+      break;
+    case sl_bt_gap_coded_phy_500k:
+      rate = 500000.0f;
+      break;
+    default:
+      rate = 1000000.0f;
+      break;
+  }
+  return ((float)up + (float)down) * 100.0f / rate;
+}
+
+/**************************************************************************//**
+ * Pack the downstream results for the result characteristic.
+ * @param[in] result downstream results
+ * @param[out] buffer THROUGHPUT_DUPLEX_PACKED_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_duplex_pack(const throughput_duplex_result_t *result,
+                                          uint8_t *buffer)
+{
+  throughput_sequence_write(buffer, result->throughput);
+  throughput_sequence_write(buffer + 4, result->latency_mean);
+  throughput_sequence_write(buffer + 8, result->latency_max);
+}
+
+/**************************************************************************//**
+ * Unpack downstream results received over the result characteristic.
+ * @param[in] buffer packed results
+ * @param[in] len length of the packed results
+ * @param[out] result downstream results
+ * @return false if the buffer does not hold packed results
+ *****************************************************************************/
+static inline bool throughput_duplex_unpack(const uint8_t *buffer,
+                                            uint16_t len,
+                                            throughput_duplex_result_t *result)
+{
+  if (len < THROUGHPUT_DUPLEX_PACKED_SIZE) {
+    return false;
+  }
+  result->throughput = throughput_sequence_read(buffer);
+  result->latency_mean = throughput_sequence_read(buffer + 4);
+  result->latency_max = throughput_sequence_read(buffer + 8);
+  return true;
+}
+
+#endif // THROUGHPUT_DUPLEX_H
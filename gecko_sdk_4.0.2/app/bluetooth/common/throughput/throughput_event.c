@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput Bluetooth event subscriptions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "em_device.h"
+#include "throughput_event.h"
+
+#if THROUGHPUT_EVENT_HANDLERS > 8
+#error "THROUGHPUT_EVENT_HANDLERS must not exceed the 8 bits of a slot"
+#endif
+
+/// Event ID 0 is not used by the stack and marks a free slot
+#define EVENT_FREE                              0
+
+/// Table entry of one event ID
+typedef struct {
+  uint32_t event_id;          ///< Event ID or EVENT_FREE
+  uint32_t count;             ///< Events dispatched
+  uint32_t cycles;            ///< CPU cycles spent in the handlers
+  uint32_t max_cycles;        ///< Most CPU cycles spent on one event
+  uint8_t subscribers;        ///< One bit per entry of handlers[]
+} event_slot_t;
+
+/// Subscribed handlers, the bit of a handler is its index
+static throughput_event_handler_t handlers[THROUGHPUT_EVENT_HANDLERS];
+
+/// Event IDs, open addressing on the ID
+static event_slot_t slots[THROUGHPUT_EVENT_SLOTS];
+
+/**************************************************************************//**
+ * Looks up the slot of an event ID.
+ * @param[in] event_id event ID
+ * @param[in] create take a free slot if the ID has none
+ * @return slot, or NULL if there is none
+ *****************************************************************************/
+static event_slot_t *event_find(uint32_t event_id, bool create)
+{
+  uint32_t index = ((event_id ^ (event_id >> 13)) * 0x9E3779B1u)
+                   % THROUGHPUT_EVENT_SLOTS;
+
+  for (uint32_t i = 0; i < THROUGHPUT_EVENT_SLOTS; i++) {
+    event_slot_t *slot = &slots[index];
+    if (slot->event_id == event_id) {
+      return slot;
+    }
+    if (slot->event_id == EVENT_FREE) {
+      if (!create) {
+        return NULL;
+      }
+      slot->event_id = event_id;
+      return slot;
+    }
+    index = (index + 1) % THROUGHPUT_EVENT_SLOTS;
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Looks up the entry of a handler.
+ * @param[in] handler handler
+ * @param[in] create take a free entry if the handler has none
+ * @return index of the handler, or THROUGHPUT_EVENT_HANDLERS if there is none
+ *****************************************************************************/
+static uint8_t event_handler_find(throughput_event_handler_t handler, bool create)
+{
+  uint8_t index = THROUGHPUT_EVENT_HANDLERS;
+
+  for (uint8_t i = 0; i < THROUGHPUT_EVENT_HANDLERS; i++) {
+    if (handlers[i] == handler) {
+      return i;
+    }
+    if (handlers[i] == NULL && index == THROUGHPUT_EVENT_HANDLERS) {
+      index = i;
+    }
+  }
+  if (!create) {
+    return THROUGHPUT_EVENT_HANDLERS;
+  }
+  if (index < THROUGHPUT_EVENT_HANDLERS) {
+    handlers[index] = handler;
+  }
+  return index;
+}
+
+sl_status_t throughput_event_subscribe(const uint32_t *event_ids,
+                                       uint8_t count,
+                                       throughput_event_handler_t handler)
+{
+  uint8_t index;
+  event_slot_t *slot;
+
+  if (handler == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  index = event_handler_find(handler, true);
+  if (index == THROUGHPUT_EVENT_HANDLERS) {
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  // Cycle counter for the dispatch cost
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (event_ids[i] == EVENT_FREE) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    slot = event_find(event_ids[i], true);
+    if (slot == NULL) {
+      return SL_STATUS_NO_MORE_RESOURCE;
+    }
+    slot->subscribers |= (uint8_t)(1 << index);
+  }
+  return SL_STATUS_OK;
+}
+
+void throughput_event_unsubscribe(const uint32_t *event_ids,
+                                  uint8_t count,
+                                  throughput_event_handler_t handler)
+{
+  uint8_t index = event_handler_find(handler, false);
+  uint8_t bit;
+  event_slot_t *slot;
+
+  if (index == THROUGHPUT_EVENT_HANDLERS) {
+    return;
+  }
+  bit = (uint8_t)(1 << index);
+  for (uint8_t i = 0; i < count; i++) {
+    slot = event_find(event_ids[i], false);
+    if (slot != NULL) {
+      slot->subscribers &= (uint8_t)~bit;
+    }
+  }
+  // Release the handler once no event ID refers to it
+  for (uint32_t i = 0; i < THROUGHPUT_EVENT_SLOTS; i++) {
+    if (slots[i].subscribers & bit) {
+      return;
+    }
+  }
+  handlers[index] = NULL;
+}
+
+void throughput_event_dispatch(sl_bt_msg_t *evt)
+{
+  event_slot_t *slot = event_find(SL_BT_MSG_ID(evt->header), false);
+  uint8_t subscribers;
+  uint32_t start;
+  uint32_t cycles;
+
+  if (slot == NULL || slot->subscribers == 0) {
+    return;
+  }
+  // A handler may unsubscribe while the event is dispatched
+  subscribers = slot->subscribers;
+  start = DWT->CYCCNT;
+  for (uint8_t i = 0; i < THROUGHPUT_EVENT_HANDLERS; i++) {
+    if ((subscribers & (1 << i)) && handlers[i] != NULL) {
+      handlers[i](evt);
+    }
+  }
+  cycles = DWT->CYCCNT - start;
+  slot->count++;
+  slot->cycles += cycles;
+  if (cycles > slot->max_cycles) {
+    slot->max_cycles = cycles;
+  }
+}
+
+uint8_t throughput_event_get_stats(throughput_event_stats_t *stats, uint8_t max)
+{
+  uint8_t written = 0;
+
+  for (uint32_t i = 0; i < THROUGHPUT_EVENT_SLOTS && written < max; i++) {
+    event_slot_t *slot = &slots[i];
+    if (slot->subscribers == 0) {
+      continue;
+    }
+    stats[written].event_id = slot->event_id;
+    stats[written].count = slot->count;
+    stats[written].cycles = slot->cycles;
+    stats[written].max_cycles = slot->max_cycles;
+    stats[written].handlers = 0;
+    for (uint8_t j = 0; j < THROUGHPUT_EVENT_HANDLERS; j++) {
+      if (slot->subscribers & (1 << j)) {
+        stats[written].handlers++;
+      }
+    }
+    written++;
+  }
+  return written;
+}
+
+void throughput_event_clear_stats(void)
+{
+  for (uint32_t i = 0; i < THROUGHPUT_EVENT_SLOTS; i++) {
+    slots[i].count = 0;
+    slots[i].cycles = 0;
+    slots[i].max_cycles = 0;
+  }
+}
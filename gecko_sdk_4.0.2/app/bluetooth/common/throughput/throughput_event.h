@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput Bluetooth event subscriptions
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_EVENT_H
+#define THROUGHPUT_EVENT_H
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "sl_bt_api.h"
+
+/*******************************************************************************
+ * Delivers Bluetooth events to the components that subscribed to their ID,
+ * instead of passing every event through every component handler.
+ *
+ * The registry is fed by one catch-all handler: the application calls
+ * throughput_event_dispatch() from sl_bt_on_event(). Components subscribe
+ * their handler to a list of event IDs when they are enabled and unsubscribe
+ * it when they are disabled, so the generated event handling of the project
+ * is left as it is.
+ *
+ * Event IDs are kept in an open addressing table with one bit per subscribed
+ * handler. An event ID keeps its slot once it was subscribed, so the probe
+ * chains of the other IDs stay intact.
+ *
+ * The cost of every subscribed event ID is measured with the DWT cycle
+ * counter over the subscribed handlers.
+ ******************************************************************************/
+
+/// Number of event IDs the table holds
+#ifndef THROUGHPUT_EVENT_SLOTS
+#define THROUGHPUT_EVENT_SLOTS                  24
+#endif
+
+/// Number of handlers that can subscribe, at most 8
+#ifndef THROUGHPUT_EVENT_HANDLERS
+#define THROUGHPUT_EVENT_HANDLERS               4
+#endif
+
+/// Handler of the events a component subscribed to
+typedef void (*throughput_event_handler_t)(sl_bt_msg_t *evt);
+
+/// Dispatch cost of one event ID
+typedef struct {
+  uint32_t event_id;          ///< Event ID, see SL_BT_MSG_ID()
+  uint32_t count;             ///< Events dispatched
+  uint32_t cycles;            ///< CPU cycles spent in the handlers
+  uint32_t max_cycles;        ///< Most CPU cycles spent on one event
+  uint8_t handlers;           ///< Number of subscribed handlers
+} throughput_event_stats_t;
+
+/**************************************************************************//**
+ * Subscribes a handler to a list of event IDs. The handler is called for
+ * events with these IDs, handlers subscribed earlier first. Subscribing the
+ * same handler again has no effect.
+ * @param[in] event_ids event IDs, e.g. sl_bt_evt_connection_opened_id
+ * @param[in] count number of event IDs
+ * @param[in] handler handler to call
+ * @return SL_STATUS_OK, or SL_STATUS_NO_MORE_RESOURCE if the table is full
+ *****************************************************************************/
+sl_status_t throughput_event_subscribe(const uint32_t *event_ids,
+                                       uint8_t count,
+                                       throughput_event_handler_t handler);
+
+/**************************************************************************//**
+ * Removes a handler from a list of event IDs.
+ * @param[in] event_ids event IDs
+ * @param[in] count number of event IDs
+ * @param[in] handler handler to remove
+ *****************************************************************************/
+void throughput_event_unsubscribe(const uint32_t *event_ids,
+                                  uint8_t count,
+                                  throughput_event_handler_t handler);
+
+/**************************************************************************//**
+ * Calls the handlers subscribed to the ID of an event.
+ * @param[in] evt event coming from the Bluetooth stack
+ *****************************************************************************/
+void throughput_event_dispatch(sl_bt_msg_t *evt);
+
+/**************************************************************************//**
+ * Copies the dispatch cost of the subscribed event IDs.
+ * @param[out] stats array to fill
+ * @param[in] max size of the array
+ * @return number of entries written
+ *****************************************************************************/
+uint8_t throughput_event_get_stats(throughput_event_stats_t *stats, uint8_t max);
+
+/**************************************************************************//**
+ * Clears the dispatch cost, the subscriptions are kept.
+ *****************************************************************************/
+void throughput_event_clear_stats(void);
+
+#endif // THROUGHPUT_EVENT_H
@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * @file
+ * @brief Binary export of received data
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_EXPORT_H
+#define THROUGHPUT_EXPORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_integrity.h"
+
+/*******************************************************************************
+ * Every received value is exported as a record, protected by a CRC32 and
+ * COBS encoded so that a zero byte never occurs inside a frame. Frames start
+ * and end with a zero delimiter, so the host resynchronizes on the next one
+ * after a dropped byte or text written to the same stream. All multi-byte
+ * fields are little-endian.
+ *
+ *   record:  version (1) | connection (1) | length (2) | sequence (4)
+ *            | timestamp (8) | payload (length) | CRC32 (4)
+ *   frame:   0x00 | COBS(record) | 0x00
+ *
+ * The timestamp is the local time of the reception in microseconds. The
+ * sequence is the one the packet carries, see throughput_sequence.h. The
+ * CRC32 is the one of the integrity trailers over the record without it.
+ ******************************************************************************/
+
+/// Record format version
+#define THROUGHPUT_EXPORT_VERSION               1
+/// Frame delimiter
+#define THROUGHPUT_EXPORT_DELIMITER             0x00
+/// Size of the record header
+#define THROUGHPUT_EXPORT_HEADER_SIZE           16
+/// Size of the record CRC
+#define THROUGHPUT_EXPORT_CRC_SIZE              4
+/// Size of a record
+#define THROUGHPUT_EXPORT_RECORD_SIZE(payload_size) \
+  (THROUGHPUT_EXPORT_HEADER_SIZE + (payload_size) + THROUGHPUT_EXPORT_CRC_SIZE)
+/// Largest frame of a record, with the COBS overhead and both delimiters
+#define THROUGHPUT_EXPORT_FRAME_SIZE(record_size) \
+  ((record_size) + (record_size) / 254 + 1 + 2)
+
+/// Export statistics
+typedef struct {
+  /// Frames written and their size
+  uint32_t frames;
+  uint32_t bytes;
+  /// Records dropped on a full queue
+  uint32_t dropped;
+  /// Records dropped for a payload over the limit
+  uint32_t oversize;
+  /// Writes the stream refused
+  uint32_t failures;
+} throughput_export_stats_t;
+
+/**************************************************************************//**
+ * Write a record.
+ * @param[out] record buffer of THROUGHPUT_EXPORT_RECORD_SIZE(len) bytes
+ * @param[in] connection connection handle
+ * @param[in] sequence sequence number
+ * @param[in] timestamp reception time in microseconds
+ * @param[in] payload received data
+ * @param[in] len length of the data
+ * @return size of the record
+ *****************************************************************************/
+static inline uint16_t throughput_export_write_record(uint8_t *record,
+                                                      uint8_t connection,
+                                                      uint32_t sequence,
+                                                      uint64_t timestamp,
+                                                      const uint8_t *payload,
+                                                      uint16_t len)
+{
+  uint16_t size = THROUGHPUT_EXPORT_HEADER_SIZE + len;
+  uint32_t crc;
+
+  record[0] = THROUGHPUT_EXPORT_VERSION;
+  record[1] = connection;
+  record[2] = (uint8_t)len;
+  record[3] = (uint8_t)(len >> 8);
+  for (uint8_t i = 0; i < 4; i++) {
+    record[4 + i] = (uint8_t)(sequence >> (8 * i));
+  }
+  for (uint8_t i = 0; i < 8; i++) {
+    record[8 + i] = (uint8_t)(timestamp >> (8 * i));
+  }
+  memcpy(record + THROUGHPUT_EXPORT_HEADER_SIZE, payload, len);
+  crc = ~throughput_integrity_crc32(0xffffffffUL, record, size);
+  for (uint8_t i = 0; i < 4; i++) {
+    record[size + i] = (uint8_t)(crc >> (8 * i));
+  }
+  return size + THROUGHPUT_EXPORT_CRC_SIZE;
+}
+
+/**************************************************************************//**
+ * Encode a record into a frame. Each run of up to 254 non-zero bytes is
+ * preceded by a code byte, one more than the length of the run; a code
+ * below 0xFF stands for a zero byte after the run.
+ * @param[in] record record
+ * @param[in] len size of the record
+ * @param[out] frame buffer of THROUGHPUT_EXPORT_FRAME_SIZE(len) bytes
+ * @return size of the frame
+ *****************************************************************************/
+static inline size_t throughput_export_encode(const uint8_t *record,
+                                              size_t len,
+                                              uint8_t *frame)
+{
+  size_t out = 0;
+  size_t code_index;
+  uint8_t code = 1;
+
+  frame[out++] = THROUGHPUT_EXPORT_DELIMITER;
+  code_index = out++;
+  for (size_t i = 0; i < len; i++) {
+    if (record[i] != 0) {
+      frame[out++] = record[i];
+      code++;
+    }
+    if (record[i] == 0 || code == 0xFF) {
+      frame[code_index] = code;
+      code = 1;
+      code_index = out++;
+    }
+  }
+  frame[code_index] = code;
+  frame[out++] = THROUGHPUT_EXPORT_DELIMITER;
+  return out;
+}
+
+#endif // THROUGHPUT_EXPORT_H
@@ -0,0 +1,195 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput sensor frame batching
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_FRAME_H
+#define THROUGHPUT_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * A frame batch packs as many sensor frames into one notification as the
+ * notification size allows. All multi-byte fields are little-endian.
+ *
+ *   batch:  packet sequence (4) | magic (1) | frame count (1)
+ *           | first sequence (4) | frame * count
+ *   frame:  timestamp (4) | value * 7 (float, 4 each)
+ *
+ * Frames are numbered continuously, the sequence number of a frame in a batch
+ * is the first sequence plus its index. The packet sequence numbers the
+ * batches themselves, see throughput_sequence.h.
+ *
+ * The packet sequence sits where plain packets carry theirs, and the magic
+ * where plain packets carry their pattern type, which never takes its value.
+ * A batch and a plain packet therefore cannot be taken for one another,
+ * whatever the sequence number or the length.
+ ******************************************************************************/
+
+/// Byte following the packet sequence of a frame batch
+#define THROUGHPUT_FRAME_BATCH_MAGIC            0xB7
+/// Size of the batch header
+#define THROUGHPUT_FRAME_BATCH_HEADER_SIZE      10
+/// Number of values in a frame
+#define THROUGHPUT_FRAME_VALUES                 7
+/// Size of a frame
+#define THROUGHPUT_FRAME_SIZE                   (4 + 4 * THROUGHPUT_FRAME_VALUES)
+/// Values sent by the peripheral in test frames
+#define THROUGHPUT_FRAME_TEST_VALUES            { 1.1f, 2.2f, 3.3f, 4.4f, 5.5f, 6.6f, 7.7f }
+
+/// Sensor frame
+typedef struct {
+  uint32_t timestamp;
+  float values[THROUGHPUT_FRAME_VALUES];
+} throughput_frame_t;
+
+/// Frame batch header
+typedef struct {
+  uint8_t count;
+  uint32_t sequence;
+  uint32_t first_sequence;
+} throughput_frame_batch_header_t;
+
+/**************************************************************************//**
+ * Number of frames that fit into a payload.
+ * @param[in] size payload size in bytes
+ * @return number of frames, 0 if not even one frame fits
+ *****************************************************************************/
+static inline uint8_t throughput_frame_batch_capacity(uint16_t size)
+{
+  if (size < THROUGHPUT_FRAME_BATCH_HEADER_SIZE + THROUGHPUT_FRAME_SIZE) {
+    return 0;
+  }
+  return (uint8_t)((size - THROUGHPUT_FRAME_BATCH_HEADER_SIZE) / THROUGHPUT_FRAME_SIZE);
+}
+
+/**************************************************************************//**
+ * Payload size of a batch.
+ * @param[in] count number of frames
+ * @return size in bytes
+ *****************************************************************************/
+static inline uint16_t throughput_frame_batch_size(uint8_t count)
+{
+  return (uint16_t)(THROUGHPUT_FRAME_BATCH_HEADER_SIZE + count * THROUGHPUT_FRAME_SIZE);
+}
+
+/**************************************************************************//**
+ * Write the batch header.
+ * @param[out] buffer batch payload
+ * @param[in] count number of frames in the batch
+ * @param[in] sequence sequence number of the batch
+ * @param[in] first_sequence sequence number of the first frame
+ *****************************************************************************/
+static inline void throughput_frame_batch_write_header(uint8_t *buffer,
+                                                       uint8_t count,
+                                                       uint32_t sequence,
+                                                       uint32_t first_sequence)
+{
+  buffer[0] = (uint8_t)sequence;
+  buffer[1] = (uint8_t)(sequence >> 8);
+  buffer[2] = (uint8_t)(sequence >> 16);
+  buffer[3] = (uint8_t)(sequence >> 24);
+  buffer[4] = THROUGHPUT_FRAME_BATCH_MAGIC;
+  buffer[5] = count;
+  buffer[6] = (uint8_t)first_sequence;
+  buffer[7] = (uint8_t)(first_sequence >> 8);
+  buffer[8] = (uint8_t)(first_sequence >> 16);
+  buffer[9] = (uint8_t)(first_sequence >> 24);
+}
+
+/**************************************************************************//**
+ * Write a frame into a batch.
+ * @param[out] buffer batch payload
+ * @param[in] index index of the frame in the batch
+ * @param[in] frame frame to write
+ *****************************************************************************/
+static inline void throughput_frame_batch_write_frame(uint8_t *buffer,
+                                                      uint8_t index,
+                                                      const throughput_frame_t *frame)
+{
+  uint8_t *data = buffer + THROUGHPUT_FRAME_BATCH_HEADER_SIZE
+                  + index * THROUGHPUT_FRAME_SIZE;
+
+  data[0] = (uint8_t)frame->timestamp;
+  data[1] = (uint8_t)(frame->timestamp >> 8);
+  data[2] = (uint8_t)(frame->timestamp >> 16);
+  data[3] = (uint8_t)(frame->timestamp >> 24);
+  memcpy(data + 4, frame->values, sizeof(frame->values));
+}
+
+/**************************************************************************//**
+ * Parse and validate the header of a received batch.
+ * @param[in] buffer received payload
+ * @param[in] len length of the payload
+ * @param[out] header batch header
+ * @return true if the payload is a complete frame batch
+ *****************************************************************************/
+static inline bool throughput_frame_batch_parse(const uint8_t *buffer,
+                                                uint16_t len,
+                                                throughput_frame_batch_header_t *header)
+{
+  if (len < THROUGHPUT_FRAME_BATCH_HEADER_SIZE
+      || buffer[4] != THROUGHPUT_FRAME_BATCH_MAGIC
+      || buffer[5] == 0
+      || len != throughput_frame_batch_size(buffer[5])) {
+    return false;
+  }
+  header->count = buffer[5];
+  header->sequence = (uint32_t)buffer[0]
+                     | ((uint32_t)buffer[1] << 8)
+                     | ((uint32_t)buffer[2] << 16)
+                     | ((uint32_t)buffer[3] << 24);
+  header->first_sequence = (uint32_t)buffer[6]
+                           | ((uint32_t)buffer[7] << 8)
+                           | ((uint32_t)buffer[8] << 16)
+                           | ((uint32_t)buffer[9] << 24);
+  return true;
+}
+
+/**************************************************************************//**
+ * Read a frame from a received batch.
+ * @param[in] buffer batch payload, validated by throughput_frame_batch_parse()
+ * @param[in] index index of the frame in the batch
+ * @param[out] frame frame read
+ *****************************************************************************/
+static inline void throughput_frame_batch_read_frame(const uint8_t *buffer,
+                                                     uint8_t index,
+                                                     throughput_frame_t *frame)
+{
+  const uint8_t *data = buffer + THROUGHPUT_FRAME_BATCH_HEADER_SIZE
+                        + index * THROUGHPUT_FRAME_SIZE;
+
+  frame->timestamp = (uint32_t)data[0]
+                     | ((uint32_t)data[1] << 8)
+                     | ((uint32_t)data[2] << 16)
+                     | ((uint32_t)data[3] << 24);
+  memcpy(frame->values, data + 4, sizeof(frame->values));
+}
+
+#endif // THROUGHPUT_FRAME_H
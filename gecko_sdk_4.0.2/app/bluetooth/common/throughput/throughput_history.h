@@ -0,0 +1,245 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput time series history
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_HISTORY_H
+#define THROUGHPUT_HISTORY_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_types.h"
+#include "throughput_sequence.h"
+
+/*******************************************************************************
+ * The counters of a test are sampled at the end of every window into a fixed
+ * size ring of records. Every link keeps the totals it was last sampled at, so
+ * the window counters of several links add up even if they start apart. When the ring is full the oldest record is
+ * overwritten, the statistics of the window throughput cover every window of
+ * the test regardless.
+ *
+ * Records are dumped in binary as 16 bytes in little endian:
+ *
+ *   record:  time (4) | bytes (4) | packets (2) | retries (2) | lost (2)
+ *            | rssi (1) | phy (1)
+ ******************************************************************************/
+
+/// Size of a packed record
+#define THROUGHPUT_HISTORY_PACKED_SIZE          16
+
+/// Counters of one window
+typedef struct {
+  /// End of the window in ms since the test started
+  uint32_t time;
+  uint32_t bytes;
+  uint16_t packets;
+  /// Sends refused by the stack, or retransmissions
+  uint16_t retries;
+  /// Packets lost in reception
+  uint16_t lost;
+  throughput_rssi_t rssi;
+  uint8_t phy;
+} throughput_history_record_t;
+
+/// Counters of a link, running totals or the increase over a window
+typedef struct {
+  throughput_count_t bytes;
+  throughput_count_t packets;
+  throughput_count_t retries;
+  throughput_count_t lost;
+} throughput_history_totals_t;
+
+/// Ring of records and window statistics
+typedef struct {
+  throughput_history_record_t *records;
+  uint16_t capacity;
+  /// Next record written and records kept
+  uint16_t head;
+  uint16_t count;
+  /// Records overwritten before they were dumped
+  uint32_t overwritten;
+  /// End of the last window
+  uint32_t last_time;
+  /// Window throughput in bits/s: count, extremes, mean and sum of squared
+  /// deviations
+  uint32_t windows;
+  uint32_t min;
+  uint32_t max;
+  float mean;
+  float m2;
+} throughput_history_t;
+
+/**************************************************************************//**
+ * Set up a history over caller provided storage.
+ * @param[out] history history
+ * @param[in] records storage of the ring
+ * @param[in] capacity number of records of the storage
+ *****************************************************************************/
+static inline void throughput_history_init(throughput_history_t *history,
+                                           throughput_history_record_t *records,
+                                           uint16_t capacity)
+{
+  memset(history, 0, sizeof(*history));
+  history->records = records;
+  history->capacity = capacity;
+}
+
+/**************************************************************************//**
+ * Clear the records and statistics at the start of a test.
+ * @param[in,out] history history
+ *****************************************************************************/
+static inline void throughput_history_reset(throughput_history_t *history)
+{
+  throughput_history_record_t *records = history->records;
+  uint16_t capacity = history->capacity;
+
+  throughput_history_init(history, records, capacity);
+}
+
+/**************************************************************************//**
+ * Add the increase of the totals of a link since its last sample to the
+ * counters of a window.
+ * @param[in,out] window counters of the window
+ * @param[in,out] last totals of the link at its last sample, updated
+ * @param[in] totals running totals of the link
+ *****************************************************************************/
+static inline void throughput_history_accumulate(throughput_history_totals_t *window,
+                                                 throughput_history_totals_t *last,
+                                                 const throughput_history_totals_t *totals)
+{
+  window->bytes += totals->bytes - last->bytes;
+  window->packets += totals->packets - last->packets;
+  window->retries += totals->retries - last->retries;
+  window->lost += totals->lost - last->lost;
+  *last = *totals;
+}
+
+/**************************************************************************//**
+ * Record a window.
+ * @param[in,out] history history
+ * @param[in] time end of the window in ms since the test started
+ * @param[in] window counters of the window
+ * @param[in] rssi signal strength at the end of the window
+ * @param[in] phy connection PHY at the end of the window
+ *****************************************************************************/
+static inline void throughput_history_sample(throughput_history_t *history,
+                                             uint32_t time,
+                                             const throughput_history_totals_t *window,
+                                             throughput_rssi_t rssi,
+                                             throughput_phy_t phy)
+{
+  throughput_history_record_t *record;
+  uint32_t duration = time - history->last_time;
+  uint32_t bytes = window->bytes;
+  uint32_t rate;
+  float delta;
+
+  if (duration == 0 || history->capacity == 0) {
+    return;
+  }
+  record = &history->records[history->head];
+  record->time = time;
+  record->bytes = bytes;
+  record->packets = (uint16_t)window->packets;
+  record->retries = (uint16_t)window->retries;
+  record->lost = (uint16_t)window->lost;
+  record->rssi = rssi;
+  record->phy = (uint8_t)phy;
+  history->head = (uint16_t)((history->head + 1) % history->capacity);
+  if (history->count < history->capacity) {
+    history->count++;
+  } else {
+    history->overwritten++;
+  }
+  history->last_time = time;
+
+  // Welford's update of the mean and variance of the window throughput
+  rate = (uint32_t)((uint64_t)bytes * 8 * 1000 / duration);
+  if (history->windows == 0 || rate < history->min) {
+    history->min = rate;
+  }
+  if (rate > history->max) {
+    history->max = rate;
+  }
+  history->windows++;
+  delta = (float)rate - history->mean;
+  history->mean += delta / (float)history->windows;
+  history->m2 += delta * ((float)rate - history->mean);
+}
+
+/**************************************************************************//**
+ * Record of the ring, oldest first.
+ * @param[in] history history
+ * @param[in] index index below the count of records kept
+ * @return record
+ *****************************************************************************/
+static inline const throughput_history_record_t *throughput_history_get(const throughput_history_t *history,
+                                                                        uint16_t index)
+{
+  uint16_t oldest = (uint16_t)((history->head + history->capacity - history->count)
+                               % history->capacity);
+
+  return &history->records[(oldest + index) % history->capacity];
+}
+
+/**************************************************************************//**
+ * Standard deviation of the window throughput.
+ * @param[in] history history
+ * @return standard deviation in bits/s
+ *****************************************************************************/
+static inline uint32_t throughput_history_stddev(const throughput_history_t *history)
+{
+  if (history->windows < 2) {
+    return 0;
+  }
+  return (uint32_t)sqrtf(history->m2 / (float)history->windows);
+}
+
+/**************************************************************************//**
+ * Pack a record for a binary dump.
+ * @param[in] record record to pack
+ * @param[out] buffer THROUGHPUT_HISTORY_PACKED_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_history_pack(const throughput_history_record_t *record,
+                                           uint8_t *buffer)
+{
+  throughput_sequence_write(buffer, record->time);
+  throughput_sequence_write(buffer + 4, record->bytes);
+  buffer[8] = (uint8_t)record->packets;
+  buffer[9] = (uint8_t)(record->packets >> 8);
+  buffer[10] = (uint8_t)record->retries;
+  buffer[11] = (uint8_t)(record->retries >> 8);
+  buffer[12] = (uint8_t)record->lost;
+  buffer[13] = (uint8_t)(record->lost >> 8);
+  buffer[14] = (uint8_t)record->rssi;
+  buffer[15] = record->phy;
+}
+
+#endif // THROUGHPUT_HISTORY_H
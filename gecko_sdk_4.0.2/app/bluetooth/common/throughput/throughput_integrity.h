@@ -0,0 +1,428 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput packet integrity trailer
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_INTEGRITY_H
+#define THROUGHPUT_INTEGRITY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_device.h"
+#include "sl_status.h"
+
+#if defined(CRYPTOACC_PRESENT)
+#include "psa/crypto.h"
+#include "sli_cryptoacc_transparent_functions.h"
+#if defined(PSA_WANT_ALG_SHA_256)
+/// SHA-256 is computed by the CRYPTOACC hash engine
+#define THROUGHPUT_INTEGRITY_SHA256_PRESENT     1
+#endif
+#endif
+
+#ifndef THROUGHPUT_INTEGRITY_SHA256_PRESENT
+#define THROUGHPUT_INTEGRITY_SHA256_PRESENT     0
+#endif
+
+/*******************************************************************************
+ * Optional end-to-end integrity check of the data packets. The sender appends
+ * a trailer computed over the whole packet, the receiver computes it again
+ * while the packet comes in and compares. It catches corruption of payloads
+ * that cannot be predicted, like sensor samples, where the pattern compare
+ * does not apply.
+ *
+ *   packet:  content | trailer (0, 4 or 8)
+ *
+ * CRC32 is the IEEE 802.3 CRC, sent little-endian. The CRYPTOACC has no CRC
+ * mode, it is computed in software a byte at a time from a table, in
+ * throughput_integrity.c. SHA-256 is offloaded to the CRYPTOACC hash engine
+ * through its PSA transparent driver and truncated to its first 8 bytes.
+ *
+ * A trailer the hash engine fails to compute is a local error. The sender
+ * does not send the packet, the receiver does not blame the link for it.
+ *
+ * The test initiator selects the mode, it is carried in bits 4-5 of the
+ * value written to or notified on the transmission characteristic.
+ *
+ * The cost is measured with the DWT cycle counter around every computation,
+ * so it can be reported in cycles per byte.
+ ******************************************************************************/
+
+/// Position of the mode in the transmission value
+#define THROUGHPUT_INTEGRITY_SHIFT              4
+/// Mask of the mode in the transmission value
+#define THROUGHPUT_INTEGRITY_MASK               0x30
+/// Largest trailer in bytes
+#define THROUGHPUT_INTEGRITY_SIZE_MAX           8
+
+/// Integrity modes, the value is sent in the transmission value
+typedef enum {
+  /// No trailer
+  THROUGHPUT_INTEGRITY_NONE   = 0,
+  /// CRC32 (IEEE 802.3), 4 bytes
+  THROUGHPUT_INTEGRITY_CRC32  = 1,
+  /// SHA-256 truncated to 8 bytes
+  THROUGHPUT_INTEGRITY_SHA256 = 2,
+  THROUGHPUT_INTEGRITY_COUNT
+} throughput_integrity_type_t;
+
+/// Running computation of a trailer
+typedef struct {
+  throughput_integrity_type_t type;
+  uint32_t crc;
+  /// The hash engine failed, the trailer cannot be computed
+  bool failed;
+#if THROUGHPUT_INTEGRITY_SHA256_PRESENT
+  sli_cryptoacc_transparent_hash_operation_t sha;
+#endif
+} throughput_integrity_ctx_t;
+
+/// Integrity statistics
+typedef struct {
+  /// Packets checked or protected
+  uint32_t packets;
+  /// Packets whose trailer did not match
+  uint32_t failures;
+  /// Trailers that could not be computed, see throughput_integrity_finish()
+  uint32_t errors;
+  /// Bytes run through the computation
+  uint64_t bytes;
+  /// CPU cycles spent in the computation
+  uint64_t cycles;
+} throughput_integrity_stats_t;
+
+/**************************************************************************//**
+ * Name of a mode.
+ * @param[in] type integrity mode
+ * @return name for logs and the CLI
+ *****************************************************************************/
+static inline const char *throughput_integrity_name(throughput_integrity_type_t type)
+{
+  switch (type) {
+    case THROUGHPUT_INTEGRITY_NONE:
+      return "NONE";
+    case THROUGHPUT_INTEGRITY_CRC32:
+      return "CRC32";
+    case THROUGHPUT_INTEGRITY_SHA256:
+      return "SHA256";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+/**************************************************************************//**
+ * Check if a mode can be used on this device.
+ * @param[in] type integrity mode
+ * @return true if supported
+ *****************************************************************************/
+static inline bool throughput_integrity_supported(throughput_integrity_type_t type)
+{
+  return type == THROUGHPUT_INTEGRITY_NONE
+         || type == THROUGHPUT_INTEGRITY_CRC32
+         || (type == THROUGHPUT_INTEGRITY_SHA256 && THROUGHPUT_INTEGRITY_SHA256_PRESENT);
+}
+
+/**************************************************************************//**
+ * Size of the trailer of a mode.
+ * @param[in] type integrity mode
+ * @return trailer size in bytes
+ *****************************************************************************/
+static inline uint8_t throughput_integrity_size(throughput_integrity_type_t type)
+{
+  switch (type) {
+    case THROUGHPUT_INTEGRITY_CRC32:
+      return 4;
+    case THROUGHPUT_INTEGRITY_SHA256:
+      return THROUGHPUT_INTEGRITY_SIZE_MAX;
+    default:
+      return 0;
+  }
+}
+
+/**************************************************************************//**
+ * Place a mode in the transmission value.
+ * @param[in] type integrity mode
+ * @return bits to set in the transmission value
+ *****************************************************************************/
+static inline uint8_t throughput_integrity_encode(throughput_integrity_type_t type)
+{
+  return (uint8_t)((type << THROUGHPUT_INTEGRITY_SHIFT) & THROUGHPUT_INTEGRITY_MASK);
+}
+
+/**************************************************************************//**
+ * Read the mode from the transmission value.
+ * @param[in] value transmission value
+ * @return integrity mode, NONE if not supported
+ *****************************************************************************/
+static inline throughput_integrity_type_t throughput_integrity_decode(uint8_t value)
+{
+  throughput_integrity_type_t type
+    = (throughput_integrity_type_t)((value & THROUGHPUT_INTEGRITY_MASK) >> THROUGHPUT_INTEGRITY_SHIFT);
+  return throughput_integrity_supported(type) ? type : THROUGHPUT_INTEGRITY_NONE;
+}
+
+/**************************************************************************//**
+ * Enable the cycle counter used to measure the cost.
+ *****************************************************************************/
+static inline void throughput_integrity_cycles_init(void)
+{
+#if defined(DWT)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**************************************************************************//**
+ * Read the cycle counter.
+ * @return CPU cycles, wraps around
+ *****************************************************************************/
+static inline uint32_t throughput_integrity_cycles(void)
+{
+#if defined(DWT)
+  return DWT->CYCCNT;
+#else
+  return 0;
+#endif
+}
+
+/**************************************************************************//**
+ * Update a CRC32 with data.
+ * @param[in] crc running CRC, inverted
+ * @param[in] data data
+ * @param[in] len data length
+ * @return updated CRC, inverted
+ *****************************************************************************/
+uint32_t throughput_integrity_crc32(uint32_t crc,
+                                    const uint8_t *data,
+                                    size_t len);
+
+/**************************************************************************//**
+ * Start computing a trailer.
+ * @param[out] ctx running computation
+ * @param[in] type integrity mode
+ *****************************************************************************/
+static inline void throughput_integrity_start(throughput_integrity_ctx_t *ctx,
+                                              throughput_integrity_type_t type)
+{
+  ctx->type = type;
+  ctx->crc = 0xffffffffUL;
+  ctx->failed = false;
+#if THROUGHPUT_INTEGRITY_SHA256_PRESENT
+  if (type == THROUGHPUT_INTEGRITY_SHA256) {
+    ctx->failed = sli_cryptoacc_transparent_hash_setup(&ctx->sha, PSA_ALG_SHA_256) != PSA_SUCCESS;
+  }
+#endif
+}
+
+/**************************************************************************//**
+ * Feed data to a trailer computation.
+ * @param[in,out] ctx running computation
+ * @param[in] data data
+ * @param[in] len data length
+ *****************************************************************************/
+static inline void throughput_integrity_update(throughput_integrity_ctx_t *ctx,
+                                               const uint8_t *data,
+                                               size_t len)
+{
+  switch (ctx->type) {
+    case THROUGHPUT_INTEGRITY_CRC32:
+      ctx->crc = throughput_integrity_crc32(ctx->crc, data, len);
+      break;
+#if THROUGHPUT_INTEGRITY_SHA256_PRESENT
+    case THROUGHPUT_INTEGRITY_SHA256:
+      if (!ctx->failed) {
+        ctx->failed = sli_cryptoacc_transparent_hash_update(&ctx->sha, data, len) != PSA_SUCCESS;
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+}
+
+/**************************************************************************//**
+ * Finish a trailer computation.
+ * @param[in,out] ctx running computation
+ * @param[out] trailer trailer, throughput_integrity_size() bytes
+ * @return false if the hash engine failed, the trailer is not valid
+ *****************************************************************************/
+static inline bool throughput_integrity_finish(throughput_integrity_ctx_t *ctx,
+                                               uint8_t *trailer)
+{
+  switch (ctx->type) {
+    case THROUGHPUT_INTEGRITY_CRC32:
+    {
+      uint32_t crc = ~ctx->crc;
+      trailer[0] = (uint8_t)crc;
+      trailer[1] = (uint8_t)(crc >> 8);
+      trailer[2] = (uint8_t)(crc >> 16);
+      trailer[3] = (uint8_t)(crc >> 24);
+      break;
+    }
+#if THROUGHPUT_INTEGRITY_SHA256_PRESENT
+    case THROUGHPUT_INTEGRITY_SHA256:
+    {
+      uint8_t digest[32];
+      size_t digest_len = 0;
+      if (ctx->failed) {
+        return false;
+      }
+      if (sli_cryptoacc_transparent_hash_finish(&ctx->sha,
+                                                digest,
+                                                sizeof(digest),
+                                                &digest_len) != PSA_SUCCESS) {
+        ctx->failed = true;
+        return false;
+      }
+      memcpy(trailer, digest, THROUGHPUT_INTEGRITY_SIZE_MAX);
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * Append the trailer to a packet.
+ * @param[in] type integrity mode
+ * @param[in,out] buf packet, with room for the trailer after the content
+ * @param[in] len content length
+ * @param[in,out] stats statistics to account the cost to, can be NULL
+ * @param[out] packet_len packet length with the trailer
+ * @return SL_STATUS_FAIL if the trailer could not be computed, the packet
+ *         must not be sent
+ *****************************************************************************/
+static inline sl_status_t throughput_integrity_append(throughput_integrity_type_t type,
+                                                      uint8_t *buf,
+                                                      size_t len,
+                                                      throughput_integrity_stats_t *stats,
+                                                      size_t *packet_len)
+{
+  throughput_integrity_ctx_t ctx;
+  uint32_t start;
+  bool computed;
+
+  *packet_len = len;
+  if (type == THROUGHPUT_INTEGRITY_NONE) {
+    return SL_STATUS_OK;
+  }
+  start = throughput_integrity_cycles();
+  throughput_integrity_start(&ctx, type);
+  throughput_integrity_update(&ctx, buf, len);
+  computed = throughput_integrity_finish(&ctx, buf + len);
+  if (stats != NULL) {
+    stats->cycles += (uint32_t)(throughput_integrity_cycles() - start);
+    stats->bytes += len;
+    if (computed) {
+      stats->packets++;
+    } else {
+      stats->errors++;
+    }
+  }
+  if (!computed) {
+    return SL_STATUS_FAIL;
+  }
+  *packet_len = len + throughput_integrity_size(type);
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Compare the computed trailer with the received one.
+ * @param[in,out] ctx finished computation
+ * @param[in] trailer received trailer
+ * @param[in,out] stats statistics, can be NULL
+ * @return true if the trailer matches, false if it does not or could not be
+ *         computed
+ *****************************************************************************/
+static inline bool throughput_integrity_verify(throughput_integrity_ctx_t *ctx,
+                                               const uint8_t *trailer,
+                                               throughput_integrity_stats_t *stats)
+{
+  uint8_t expected[THROUGHPUT_INTEGRITY_SIZE_MAX];
+  bool match;
+
+  if (!throughput_integrity_finish(ctx, expected)) {
+    // A local error, the packet may well be intact
+    if (stats != NULL) {
+      stats->errors++;
+    }
+    return false;
+  }
+  match = memcmp(expected, trailer, throughput_integrity_size(ctx->type)) == 0;
+  if (stats != NULL) {
+    stats->packets++;
+    if (!match) {
+      stats->failures++;
+    }
+  }
+  return match;
+}
+
+/**************************************************************************//**
+ * Check the trailer of a packet.
+ * @param[in] type integrity mode
+ * @param[in] buf packet
+ * @param[in] len packet length with the trailer
+ * @param[in,out] stats statistics, can be NULL
+ * @return true if the trailer matches or there is none
+ *****************************************************************************/
+static inline bool throughput_integrity_check(throughput_integrity_type_t type,
+                                              const uint8_t *buf,
+                                              size_t len,
+                                              throughput_integrity_stats_t *stats)
+{
+  throughput_integrity_ctx_t ctx;
+  uint8_t size = throughput_integrity_size(type);
+  uint32_t start;
+  bool match;
+
+  if (type == THROUGHPUT_INTEGRITY_NONE) {
+    return true;
+  }
+  if (len < size) {
+    if (stats != NULL) {
+      stats->packets++;
+      stats->failures++;
+    }
+    return false;
+  }
+  start = throughput_integrity_cycles();
+  throughput_integrity_start(&ctx, type);
+  throughput_integrity_update(&ctx, buf, len - size);
+  match = throughput_integrity_verify(&ctx, buf + len - size, stats);
+  if (stats != NULL) {
+    stats->cycles += (uint32_t)(throughput_integrity_cycles() - start);
+    stats->bytes += len - size;
+  }
+  return match;
+}
+
+#endif // THROUGHPUT_INTEGRITY_H
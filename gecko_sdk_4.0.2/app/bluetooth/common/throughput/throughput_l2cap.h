@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput L2CAP connection-oriented channel
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_L2CAP_H
+#define THROUGHPUT_L2CAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * The test channel is an LE credit-based connection-oriented channel opened
+ * by the central. The stack hands single PDUs to the application, so SDUs are
+ * segmented and reassembled here. The first PDU of an SDU starts with the SDU
+ * length (2 bytes, little-endian), every PDU costs the sender one credit.
+ ******************************************************************************/
+
+/// LE protocol/service multiplexer of the test channel, dynamic range
+#define THROUGHPUT_L2CAP_PSM                    0x0080
+/// Size of the SDU length field
+#define THROUGHPUT_L2CAP_SDU_HEADER_SIZE        2
+/// Smallest MTU and MPS allowed by the specification
+#define THROUGHPUT_L2CAP_MIN_SIZE               23
+/// Largest MPS, limited by the BGAPI payload of the data command and event
+#define THROUGHPUT_L2CAP_MAX_MPS                250
+
+/// Result of feeding a PDU into the reassembly
+typedef enum {
+  /// More PDUs of the SDU are expected
+  THROUGHPUT_L2CAP_SDU_PARTIAL,
+  /// The SDU is complete in the buffer
+  THROUGHPUT_L2CAP_SDU_COMPLETE,
+  /// The PDU does not fit the SDU, the SDU is dropped
+  THROUGHPUT_L2CAP_SDU_ERROR
+} throughput_l2cap_sdu_result_t;
+
+/// SDU reassembly state
+typedef struct {
+  /// Reassembly buffer
+  uint8_t *buffer;
+  /// Size of the buffer, the MTU of the receiver
+  uint16_t size;
+  /// Length of the SDU being reassembled, 0 if waiting for a first PDU
+  uint16_t length;
+  /// Bytes of the SDU received so far
+  uint16_t received;
+} throughput_l2cap_rx_t;
+
+/**************************************************************************//**
+ * Number of PDUs, and so credits, an SDU takes.
+ * @param[in] sdu_len length of the SDU
+ * @param[in] mps maximum PDU payload size of the receiver
+ * @return number of PDUs
+ *****************************************************************************/
+static inline uint16_t throughput_l2cap_pdu_count(uint16_t sdu_len, uint16_t mps)
+{
+  uint32_t total = (uint32_t)sdu_len + THROUGHPUT_L2CAP_SDU_HEADER_SIZE;
+
+  return (uint16_t)((total + mps - 1) / mps);
+}
+
+/**************************************************************************//**
+ * Build the next PDU of an SDU.
+ * @param[in] sdu SDU payload
+ * @param[in] sdu_len length of the SDU
+ * @param[in] offset bytes of the SDU already sent
+ * @param[in] mps maximum PDU payload size of the receiver
+ * @param[out] pdu PDU payload, at least mps bytes
+ * @param[out] pdu_len length of the PDU
+ * @return bytes of the SDU carried by the PDU
+ *****************************************************************************/
+static inline uint16_t throughput_l2cap_segment(const uint8_t *sdu,
+                                                uint16_t sdu_len,
+                                                uint16_t offset,
+                                                uint16_t mps,
+                                                uint8_t *pdu,
+                                                uint16_t *pdu_len)
+{
+  uint16_t header = 0;
+  uint16_t chunk;
+
+  if (offset == 0) {
+    pdu[0] = (uint8_t)sdu_len;
+    pdu[1] = (uint8_t)(sdu_len >> 8);
+    header = THROUGHPUT_L2CAP_SDU_HEADER_SIZE;
+  }
+  chunk = sdu_len - offset;
+  if (chunk > mps - header) {
+    chunk = mps - header;
+  }
+  memcpy(pdu + header, sdu + offset, chunk);
+  *pdu_len = header + chunk;
+  return chunk;
+}
+
+/**************************************************************************//**
+ * Initialize the SDU reassembly.
+ * @param[out] rx reassembly state
+ * @param[in] buffer reassembly buffer
+ * @param[in] size size of the buffer
+ *****************************************************************************/
+static inline void throughput_l2cap_rx_init(throughput_l2cap_rx_t *rx,
+                                            uint8_t *buffer,
+                                            uint16_t size)
+{
+  rx->buffer = buffer;
+  rx->size = size;
+  rx->length = 0;
+  rx->received = 0;
+}
+
+/**************************************************************************//**
+ * Feed a received PDU into the SDU reassembly.
+ * @param[in,out] rx reassembly state
+ * @param[in] pdu PDU payload
+ * @param[in] len length of the PDU
+ * @return reassembly result, the SDU is in rx->buffer once complete
+ *****************************************************************************/
+static inline throughput_l2cap_sdu_result_t throughput_l2cap_reassemble(throughput_l2cap_rx_t *rx,
+                                                                        const uint8_t *pdu,
+                                                                        uint16_t len)
+{
+  if (rx->length == 0) {
+    // First PDU of an SDU
+    if (len < THROUGHPUT_L2CAP_SDU_HEADER_SIZE) {
+      return THROUGHPUT_L2CAP_SDU_ERROR;
+    }
+    rx->length = (uint16_t)(pdu[0] | (pdu[1] << 8));
+    rx->received = 0;
+    pdu += THROUGHPUT_L2CAP_SDU_HEADER_SIZE;
+    len -= THROUGHPUT_L2CAP_SDU_HEADER_SIZE;
+    if (rx->length == 0 || rx->length > rx->size) {
+      rx->length = 0;
+      return THROUGHPUT_L2CAP_SDU_ERROR;
+    }
+  }
+  if (len > rx->length - rx->received) {
+    rx->length = 0;
+    return THROUGHPUT_L2CAP_SDU_ERROR;
+  }
+  memcpy(rx->buffer + rx->received, pdu, len);
+  rx->received += len;
+  if (rx->received < rx->length) {
+    return THROUGHPUT_L2CAP_SDU_PARTIAL;
+  }
+  rx->length = 0;
+  return THROUGHPUT_L2CAP_SDU_COMPLETE;
+}
+
+#endif // THROUGHPUT_L2CAP_H
@@ -0,0 +1,288 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput latency histogram
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_LATENCY_H
+#define THROUGHPUT_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_sequence.h"
+
+/*******************************************************************************
+ * Latencies are counted in a fixed size histogram with logarithmic buckets:
+ * every power of two microseconds is split into four buckets of equal width,
+ * so a bucket is at most a quarter of its lower bound wide. Latencies below
+ * four microseconds have a bucket each, latencies beyond the last bucket are
+ * counted in it. Percentiles are reported as the upper bound of their bucket.
+ *
+ * The owner provides the buckets, sized by THROUGHPUT_LATENCY_BUCKETS() for
+ * the range it needs, so each role can trade range for RAM.
+ *
+ * Jitter is the mean difference between the latencies of consecutive samples.
+ *
+ * The summary is sent in the result characteristic as:
+ *
+ *   summary: count (4) | p50 (4) | p90 (4) | p99 (4) | p99.9 (4) | max (4) | jitter (4)
+ ******************************************************************************/
+
+/// Buckets per power of two, as a power of two
+#define THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2     2
+/// Buckets per power of two
+#define THROUGHPUT_LATENCY_SUB_BUCKETS          (1 << THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2)
+/// Number of buckets for latencies up to just below 2^range_log2 us
+#define THROUGHPUT_LATENCY_BUCKETS(range_log2)  (((range_log2) \
+                                                  - THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2 + 1) \
+                                                 * THROUGHPUT_LATENCY_SUB_BUCKETS)
+/// Size of the packed summary
+#define THROUGHPUT_LATENCY_PACKED_SIZE          28
+
+/// Latency histogram
+typedef struct {
+  /// Buckets provided by the owner, see throughput_latency_init()
+  uint32_t *buckets;
+  uint16_t bucket_count;
+  uint32_t count;
+  uint32_t max;
+  uint32_t last;
+  /// Sums of the latencies and of the differences of consecutive ones
+  uint64_t sum;
+  uint64_t jitter_sum;
+} throughput_latency_t;
+
+/// Latency summary in microseconds
+typedef struct {
+  uint32_t count;
+  uint32_t p50;
+  uint32_t p90;
+  uint32_t p99;
+  uint32_t p999;
+  uint32_t max;
+  uint32_t jitter;
+} throughput_latency_summary_t;
+
+/**************************************************************************//**
+ * Reset a histogram.
+ * @param[in,out] latency histogram
+ *****************************************************************************/
+static inline void throughput_latency_reset(throughput_latency_t *latency)
+{
+  memset(latency->buckets, 0, latency->bucket_count * sizeof(latency->buckets[0]));
+  latency->count = 0;
+  latency->max = 0;
+  latency->last = 0;
+  latency->sum = 0;
+  latency->jitter_sum = 0;
+}
+
+/**************************************************************************//**
+ * Attach the buckets to a histogram and reset it.
+ * @param[out] latency histogram
+ * @param[in] buckets buckets, THROUGHPUT_LATENCY_BUCKETS() of the range
+ * @param[in] bucket_count number of buckets
+ *****************************************************************************/
+static inline void throughput_latency_init(throughput_latency_t *latency,
+                                           uint32_t *buckets,
+                                           uint16_t bucket_count)
+{
+  latency->buckets = buckets;
+  latency->bucket_count = bucket_count;
+  throughput_latency_reset(latency);
+}
+
+/**************************************************************************//**
+ * Bucket of a latency.
+ * @param[in] value latency in microseconds
+ * @param[in] bucket_count number of buckets, the last one takes the rest
+ * @return bucket index
+ *****************************************************************************/
+static inline uint16_t throughput_latency_bucket(uint32_t value, uint16_t bucket_count)
+{
+  uint8_t msb = 0;
+  uint16_t bucket;
+
+  if (value < THROUGHPUT_LATENCY_SUB_BUCKETS) {
+    return (uint16_t)value;
+  }
+  while ((value >> msb) > 1) {
+    msb++;
+  }
+  bucket = (uint16_t)((msb - THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2 + 1) * THROUGHPUT_LATENCY_SUB_BUCKETS
+                      + ((value >> (msb - THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2))
+                         & (THROUGHPUT_LATENCY_SUB_BUCKETS - 1)));
+  if (bucket >= bucket_count) {
+    bucket = bucket_count - 1;
+  }
+  return bucket;
+}
+
+/**************************************************************************//**
+ * Upper bound of a bucket.
+ * @param[in] bucket bucket index
+ * @return largest latency counted in the bucket in microseconds
+ *****************************************************************************/
+static inline uint32_t throughput_latency_bucket_limit(uint16_t bucket)
+{
+  uint8_t msb;
+  uint32_t sub;
+
+  if (bucket < THROUGHPUT_LATENCY_SUB_BUCKETS) {
+    return bucket;
+  }
+  msb = (uint8_t)(bucket / THROUGHPUT_LATENCY_SUB_BUCKETS + THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2 - 1);
+  sub = bucket % THROUGHPUT_LATENCY_SUB_BUCKETS;
+  return ((THROUGHPUT_LATENCY_SUB_BUCKETS + sub + 1) << (msb - THROUGHPUT_LATENCY_SUB_BUCKETS_LOG2)) - 1;
+}
+
+/**************************************************************************//**
+ * Count a latency.
+ * @param[in,out] latency histogram
+ * @param[in] value latency in microseconds
+ *****************************************************************************/
+static inline void throughput_latency_add(throughput_latency_t *latency, uint32_t value)
+{
+  if (latency->count > 0) {
+    latency->jitter_sum += (value > latency->last) ? (value - latency->last) : (latency->last - value);
+  }
+  latency->buckets[throughput_latency_bucket(value, latency->bucket_count)]++;
+  latency->count++;
+  latency->sum += value;
+  latency->last = value;
+  if (value > latency->max) {
+    latency->max = value;
+  }
+}
+
+/**************************************************************************//**
+ * Percentile of the latencies counted.
+ * @param[in] latency histogram
+ * @param[in] per_10000 percentile in hundredths of a percent, 9990 for p99.9
+ * @return upper bound of the bucket of the percentile in microseconds, the
+ *         largest latency if it is lower
+ *****************************************************************************/
+static inline uint32_t throughput_latency_percentile(const throughput_latency_t *latency,
+                                                     uint16_t per_10000)
+{
+  uint64_t rank;
+  uint64_t seen = 0;
+  uint32_t limit;
+
+  if (latency->count == 0) {
+    return 0;
+  }
+  // Smallest bucket holding at least the given share of the samples
+  rank = ((uint64_t)latency->count * per_10000 + 9999) / 10000;
+  if (rank == 0) {
+    rank = 1;
+  }
+  for (uint16_t i = 0; i < latency->bucket_count; i++) {
+    seen += latency->buckets[i];
+    if (seen >= rank) {
+      limit = throughput_latency_bucket_limit(i);
+      return (limit < latency->max) ? limit : latency->max;
+    }
+  }
+  return latency->max;
+}
+
+/**************************************************************************//**
+ * Mean of the latencies counted.
+ * @param[in] latency histogram
+ * @return mean latency in microseconds
+ *****************************************************************************/
+static inline uint32_t throughput_latency_mean(const throughput_latency_t *latency)
+{
+  if (latency->count == 0) {
+    return 0;
+  }
+  return (uint32_t)(latency->sum / latency->count);
+}
+
+/**************************************************************************//**
+ * Summarize a histogram.
+ * @param[in] latency histogram
+ * @param[out] summary percentiles, maximum and jitter
+ *****************************************************************************/
+static inline void throughput_latency_summarize(const throughput_latency_t *latency,
+                                                throughput_latency_summary_t *summary)
+{
+  summary->count = latency->count;
+  summary->p50 = throughput_latency_percentile(latency, 5000);
+  summary->p90 = throughput_latency_percentile(latency, 9000);
+  summary->p99 = throughput_latency_percentile(latency, 9900);
+  summary->p999 = throughput_latency_percentile(latency, 9990);
+  summary->max = latency->max;
+  summary->jitter = (latency->count > 1)
+                    ? (uint32_t)(latency->jitter_sum / (latency->count - 1))
+                    : 0;
+}
+
+/**************************************************************************//**
+ * Pack a summary for the result characteristic.
+ * @param[in] summary latency summary
+ * @param[out] buffer THROUGHPUT_LATENCY_PACKED_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_latency_pack(const throughput_latency_summary_t *summary,
+                                           uint8_t *buffer)
+{
+  throughput_sequence_write(buffer, summary->count);
+  throughput_sequence_write(buffer + 4, summary->p50);
+  throughput_sequence_write(buffer + 8, summary->p90);
+  throughput_sequence_write(buffer + 12, summary->p99);
+  throughput_sequence_write(buffer + 16, summary->p999);
+  throughput_sequence_write(buffer + 20, summary->max);
+  throughput_sequence_write(buffer + 24, summary->jitter);
+}
+
+/**************************************************************************//**
+ * Unpack a summary received over the result characteristic.
+ * @param[in] buffer packed summary
+ * @param[in] len length of the packed summary
+ * @param[out] summary latency summary
+ * @return false if the buffer does not hold a packed summary
+ *****************************************************************************/
+static inline bool throughput_latency_unpack(const uint8_t *buffer,
+                                             uint16_t len,
+                                             throughput_latency_summary_t *summary)
+{
+  if (len < THROUGHPUT_LATENCY_PACKED_SIZE) {
+    return false;
+  }
+  summary->count = throughput_sequence_read(buffer);
+  summary->p50 = throughput_sequence_read(buffer + 4);
+  summary->p90 = throughput_sequence_read(buffer + 8);
+  summary->p99 = throughput_sequence_read(buffer + 12);
+  summary->p999 = throughput_sequence_read(buffer + 16);
+  summary->max = throughput_sequence_read(buffer + 20);
+  summary->jitter = throughput_sequence_read(buffer + 24);
+  return true;
+}
+
+#endif // THROUGHPUT_LATENCY_H
@@ -0,0 +1,362 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput payload patterns
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_PATTERN_H
+#define THROUGHPUT_PATTERN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Payload pattern engine shared by the sender and the receiver. The payload
+ * of a packet is generated from a seed, the sequence number of the packet, so
+ * a receiver can regenerate it for any packet regardless of packets lost in
+ * between.
+ *
+ * The PRBS patterns are the maximal length sequences of ITU-T O.150, produced
+ * by a Galois LFSR of the given polynomial, most significant bit first. The
+ * LFSR advances a byte at a time from two 256 entry tables per polynomial,
+ * like a table-driven CRC over zero input. The tables are constant and shared
+ * by every engine, they are generated into throughput_pattern_tables.c by
+ * tools/throughput_pattern_gen.c.
+ *
+ * Payloads are compared 32 bits at a time. Words that match cost a single
+ * XOR, only the set bits of a mismatch are visited to count the errored bits
+ * and their position within the byte.
+ ******************************************************************************/
+
+/// Largest user-supplied pattern in bytes
+#define THROUGHPUT_PATTERN_USER_MAX             16
+/// Bit positions tracked for errors, the bit within the byte
+#define THROUGHPUT_PATTERN_LANES                8
+/// PRBS patterns, the first values of throughput_pattern_type_t
+#define THROUGHPUT_PATTERN_PRBS_COUNT           3
+
+/// Payload patterns, the value is sent in the packet
+typedef enum {
+  /// x^9 + x^5 + 1
+  THROUGHPUT_PATTERN_PRBS9   = 0,
+  /// x^15 + x^14 + 1
+  THROUGHPUT_PATTERN_PRBS15  = 1,
+  /// x^23 + x^18 + 1
+  THROUGHPUT_PATTERN_PRBS23  = 2,
+  /// Byte counter starting from the seed
+  THROUGHPUT_PATTERN_COUNTER = 3,
+  /// User-supplied bytes repeated
+  THROUGHPUT_PATTERN_USER    = 4,
+  THROUGHPUT_PATTERN_COUNT
+} throughput_pattern_type_t;
+
+/// Byte-wise LFSR of a PRBS pattern
+typedef struct {
+  /// LFSR width in bits
+  uint8_t width;
+  /// LFSR state mask
+  uint32_t mask;
+  /// Output byte of the LFSR, indexed by its top byte
+  uint8_t output[256];
+  /// LFSR state after a byte, indexed by its top byte
+  uint32_t feedback[256];
+} throughput_pattern_lfsr_t;
+
+/// Pattern engine
+typedef struct {
+  /// Selected pattern
+  throughput_pattern_type_t type;
+  /// LFSR of the selected PRBS pattern
+  const throughput_pattern_lfsr_t *lfsr;
+  /// Length of the user pattern, 0 if none is set
+  uint8_t user_len;
+  /// Words of the user pattern repeated to a multiple of 4 bytes
+  uint8_t user_words;
+  /// User pattern repeated to a multiple of 4 bytes
+  uint32_t user[THROUGHPUT_PATTERN_USER_MAX];
+} throughput_pattern_t;
+
+/// Generator state while walking a payload
+typedef struct {
+  uint32_t state;
+  uint16_t index;
+} throughput_pattern_stream_t;
+
+/// Bit error statistics
+typedef struct {
+  /// Bits compared
+  uint64_t bits;
+  /// Bits that differed
+  uint32_t errors;
+  /// Packets with at least one errored bit
+  uint32_t errored_packets;
+  /// Errored bits by position within the byte, bit 0 first
+  uint32_t lanes[THROUGHPUT_PATTERN_LANES];
+  /// Bit offset of the first error in the last errored payload
+  uint32_t last_offset;
+} throughput_pattern_stats_t;
+
+/// LFSR tables of the PRBS patterns, indexed by the pattern
+extern const throughput_pattern_lfsr_t throughput_pattern_lfsr[THROUGHPUT_PATTERN_PRBS_COUNT];
+
+/**************************************************************************//**
+ * Name of a pattern.
+ * @param[in] type pattern
+ * @return name for logs and the CLI
+ *****************************************************************************/
+static inline const char *throughput_pattern_name(throughput_pattern_type_t type)
+{
+  switch (type) {
+    case THROUGHPUT_PATTERN_PRBS9:
+      return "PRBS9";
+    case THROUGHPUT_PATTERN_PRBS15:
+      return "PRBS15";
+    case THROUGHPUT_PATTERN_PRBS23:
+      return "PRBS23";
+    case THROUGHPUT_PATTERN_COUNTER:
+      return "COUNTER";
+    case THROUGHPUT_PATTERN_USER:
+      return "USER";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+/**************************************************************************//**
+ * Set the user-supplied pattern. Does not change the selected pattern.
+ * @param[in,out] pattern pattern engine
+ * @param[in] bytes pattern, repeated over the payload
+ * @param[in] len length of the pattern, 1 to THROUGHPUT_PATTERN_USER_MAX
+ * @return false if the length is out of range
+ *****************************************************************************/
+static inline bool throughput_pattern_set_user(throughput_pattern_t *pattern,
+                                               const uint8_t *bytes,
+                                               uint8_t len)
+{
+  uint8_t expanded[4 * THROUGHPUT_PATTERN_USER_MAX];
+  uint8_t size = len;
+
+  if (len == 0 || len > THROUGHPUT_PATTERN_USER_MAX) {
+    return false;
+  }
+  // Repeat the pattern until it ends on a word boundary
+  while (size % 4 != 0) {
+    size += len;
+  }
+  for (uint8_t i = 0; i < size; i++) {
+    expanded[i] = bytes[i % len];
+  }
+  memcpy(pattern->user, expanded, size);
+  pattern->user_words = size / 4;
+  pattern->user_len = len;
+  return true;
+}
+
+/**************************************************************************//**
+ * Select a pattern. Switching between patterns costs no more than keeping
+ * one, the receiver follows the pattern of every packet.
+ * @param[in,out] pattern pattern engine
+ * @param[in] type pattern to select
+ * @return false if the pattern is unknown or no user pattern is set
+ *****************************************************************************/
+static inline bool throughput_pattern_select(throughput_pattern_t *pattern,
+                                             throughput_pattern_type_t type)
+{
+  switch (type) {
+    case THROUGHPUT_PATTERN_PRBS9:
+    case THROUGHPUT_PATTERN_PRBS15:
+    case THROUGHPUT_PATTERN_PRBS23:
+      pattern->lfsr = &throughput_pattern_lfsr[type];
+      break;
+    case THROUGHPUT_PATTERN_COUNTER:
+      break;
+    case THROUGHPUT_PATTERN_USER:
+      if (pattern->user_len == 0) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  pattern->type = type;
+  return true;
+}
+
+/**************************************************************************//**
+ * Start generating the payload for a seed.
+ * @param[in] pattern pattern engine
+ * @param[in] seed seed, the sequence number of the packet
+ * @param[out] stream generator state
+ *****************************************************************************/
+static inline void throughput_pattern_start(const throughput_pattern_t *pattern,
+                                            uint32_t seed,
+                                            throughput_pattern_stream_t *stream)
+{
+  uint32_t base;
+
+  stream->index = 0;
+  switch (pattern->type) {
+    case THROUGHPUT_PATTERN_COUNTER:
+      // Bytes seed, seed + 1, seed + 2, seed + 3 without carries between them
+      base = (seed & 0xFF) * 0x01010101UL;
+      stream->state = ((base & 0x7F7F7F7FUL) + 0x03020100UL) ^ (base & 0x80808080UL);
+      break;
+    case THROUGHPUT_PATTERN_USER:
+      stream->state = 0;
+      break;
+    default:
+      // Spread consecutive seeds over the sequence, the state must not be 0
+      stream->state = ((seed * 0x9E3779B1UL) ^ (seed >> 16)) & pattern->lfsr->mask;
+      if (stream->state == 0) {
+        stream->state = 1;
+      }
+      break;
+  }
+}
+
+/**************************************************************************//**
+ * Generate the next 4 payload bytes.
+ * @param[in] pattern pattern engine
+ * @param[in,out] stream generator state
+ * @return payload bytes, the first one in the least significant byte
+ *****************************************************************************/
+static inline uint32_t throughput_pattern_next(const throughput_pattern_t *pattern,
+                                               throughput_pattern_stream_t *stream)
+{
+  const throughput_pattern_lfsr_t *lfsr = pattern->lfsr;
+  uint32_t word = 0;
+  uint32_t state = stream->state;
+
+  switch (pattern->type) {
+    case THROUGHPUT_PATTERN_COUNTER:
+      // Add 4 to each byte without carries between them
+      stream->state = ((state & 0x7F7F7F7FUL) + 0x04040404UL) ^ (state & 0x80808080UL);
+      return state;
+    case THROUGHPUT_PATTERN_USER:
+      word = pattern->user[stream->index];
+      stream->index = (stream->index + 1 < pattern->user_words) ? stream->index + 1 : 0;
+      return word;
+    default:
+      for (uint8_t i = 0; i < 32; i += 8) {
+        uint32_t top = state >> (lfsr->width - 8);
+        word |= (uint32_t)lfsr->output[top] << i;
+        state = ((state << 8) & lfsr->mask) ^ lfsr->feedback[top];
+      }
+      stream->state = state;
+      return word;
+  }
+}
+
+/**************************************************************************//**
+ * Fill a payload.
+ * @param[in] pattern pattern engine
+ * @param[in] seed seed, the sequence number of the packet
+ * @param[out] buffer payload
+ * @param[in] len length of the payload
+ *****************************************************************************/
+static inline void throughput_pattern_fill(const throughput_pattern_t *pattern,
+                                           uint32_t seed,
+                                           uint8_t *buffer,
+                                           uint16_t len)
+{
+  throughput_pattern_stream_t stream;
+  uint32_t word;
+  uint16_t i;
+
+  throughput_pattern_start(pattern, seed, &stream);
+  for (i = 0; i + 4 <= len; i += 4) {
+    word = throughput_pattern_next(pattern, &stream);
+    memcpy(buffer + i, &word, 4);
+  }
+  if (i < len) {
+    word = throughput_pattern_next(pattern, &stream);
+    memcpy(buffer + i, &word, len - i);
+  }
+}
+
+/**************************************************************************//**
+ * Account the errored bits of a word.
+ * @param[in,out] stats bit error statistics
+ * @param[in] diff XOR of the received and the expected word
+ *****************************************************************************/
+static inline void throughput_pattern_count(throughput_pattern_stats_t *stats,
+                                            uint32_t diff)
+{
+  while (diff != 0) {
+    stats->lanes[__builtin_ctz(diff) % THROUGHPUT_PATTERN_LANES]++;
+    stats->errors++;
+    diff &= diff - 1;
+  }
+}
+
+/**************************************************************************//**
+ * Check a received payload against the pattern.
+ * @param[in] pattern pattern engine
+ * @param[in] seed seed, the sequence number of the packet
+ * @param[in] buffer received payload
+ * @param[in] len length of the payload
+ * @param[in,out] stats bit error statistics
+ * @return number of errored bits
+ *****************************************************************************/
+static inline uint32_t throughput_pattern_check(const throughput_pattern_t *pattern,
+                                                uint32_t seed,
+                                                const uint8_t *buffer,
+                                                uint16_t len,
+                                                throughput_pattern_stats_t *stats)
+{
+  throughput_pattern_stream_t stream;
+  uint32_t errors = stats->errors;
+  uint32_t first = UINT32_MAX;
+  uint32_t word;
+  uint32_t diff;
+  uint16_t i;
+
+  throughput_pattern_start(pattern, seed, &stream);
+  for (i = 0; i < len; i += 4) {
+    word = 0;
+    memcpy(&word, buffer + i, (len - i < 4) ? len - i : 4);
+    diff = word ^ throughput_pattern_next(pattern, &stream);
+    if (len - i < 4) {
+      // Ignore the bytes past the end of the payload
+      diff &= (1UL << (8 * (len - i))) - 1;
+    }
+    if (diff != 0) {
+      if (first == UINT32_MAX) {
+        first = 8UL * i + (uint32_t)__builtin_ctz(diff);
+      }
+      throughput_pattern_count(stats, diff);
+    }
+  }
+  stats->bits += 8UL * len;
+  if (first != UINT32_MAX) {
+    stats->errored_packets++;
+    stats->last_offset = first;
+  }
+  return stats->errors - errors;
+}
+
+#endif // THROUGHPUT_PATTERN_H
@@ -0,0 +1,258 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput PRBS pattern tables
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// Generated by tools/throughput_pattern_gen.c, do not edit.
+
+#include "throughput_pattern.h"
+
+const throughput_pattern_lfsr_t throughput_pattern_lfsr[THROUGHPUT_PATTERN_PRBS_COUNT] = {
+  // PRBS9, x^9 + x^5 + 1
+  {
+    .width = 9,
+    .mask = 0x0001FFUL,
+    .output = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+      0x0C, 0x0D, 0x0E, 0x0F, 0x11, 0x10, 0x13, 0x12, 0x15, 0x14, 0x17, 0x16,
+      0x19, 0x18, 0x1B, 0x1A, 0x1D, 0x1C, 0x1F, 0x1E, 0x22, 0x23, 0x20, 0x21,
+      0x26, 0x27, 0x24, 0x25, 0x2A, 0x2B, 0x28, 0x29, 0x2E, 0x2F, 0x2C, 0x2D,
+      0x33, 0x32, 0x31, 0x30, 0x37, 0x36, 0x35, 0x34, 0x3B, 0x3A, 0x39, 0x38,
+      0x3F, 0x3E, 0x3D, 0x3C, 0x44, 0x45, 0x46, 0x47, 0x40, 0x41, 0x42, 0x43,
+      0x4C, 0x4D, 0x4E, 0x4F, 0x48, 0x49, 0x4A, 0x4B, 0x55, 0x54, 0x57, 0x56,
+      0x51, 0x50, 0x53, 0x52, 0x5D, 0x5C, 0x5F, 0x5E, 0x59, 0x58, 0x5B, 0x5A,
+      0x66, 0x67, 0x64, 0x65, 0x62, 0x63, 0x60, 0x61, 0x6E, 0x6F, 0x6C, 0x6D,
+      0x6A, 0x6B, 0x68, 0x69, 0x77, 0x76, 0x75, 0x74, 0x73, 0x72, 0x71, 0x70,
+      0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x88, 0x89, 0x8A, 0x8B,
+      0x8C, 0x8D, 0x8E, 0x8F, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+      0x99, 0x98, 0x9B, 0x9A, 0x9D, 0x9C, 0x9F, 0x9E, 0x91, 0x90, 0x93, 0x92,
+      0x95, 0x94, 0x97, 0x96, 0xAA, 0xAB, 0xA8, 0xA9, 0xAE, 0xAF, 0xAC, 0xAD,
+      0xA2, 0xA3, 0xA0, 0xA1, 0xA6, 0xA7, 0xA4, 0xA5, 0xBB, 0xBA, 0xB9, 0xB8,
+      0xBF, 0xBE, 0xBD, 0xBC, 0xB3, 0xB2, 0xB1, 0xB0, 0xB7, 0xB6, 0xB5, 0xB4,
+      0xCC, 0xCD, 0xCE, 0xCF, 0xC8, 0xC9, 0xCA, 0xCB, 0xC4, 0xC5, 0xC6, 0xC7,
+      0xC0, 0xC1, 0xC2, 0xC3, 0xDD, 0xDC, 0xDF, 0xDE, 0xD9, 0xD8, 0xDB, 0xDA,
+      0xD5, 0xD4, 0xD7, 0xD6, 0xD1, 0xD0, 0xD3, 0xD2, 0xEE, 0xEF, 0xEC, 0xED,
+      0xEA, 0xEB, 0xE8, 0xE9, 0xE6, 0xE7, 0xE4, 0xE5, 0xE2, 0xE3, 0xE0, 0xE1,
+      0xFF, 0xFE, 0xFD, 0xFC, 0xFB, 0xFA, 0xF9, 0xF8, 0xF7, 0xF6, 0xF5, 0xF4,
+      0xF3, 0xF2, 0xF1, 0xF0,
+    },
+    .feedback = {
+      0x000000UL, 0x000021UL, 0x000042UL, 0x000063UL, 0x000084UL, 0x0000A5UL,
+      0x0000C6UL, 0x0000E7UL, 0x000108UL, 0x000129UL, 0x00014AUL, 0x00016BUL,
+      0x00018CUL, 0x0001ADUL, 0x0001CEUL, 0x0001EFUL, 0x000031UL, 0x000010UL,
+      0x000073UL, 0x000052UL, 0x0000B5UL, 0x000094UL, 0x0000F7UL, 0x0000D6UL,
+      0x000139UL, 0x000118UL, 0x00017BUL, 0x00015AUL, 0x0001BDUL, 0x00019CUL,
+      0x0001FFUL, 0x0001DEUL, 0x000062UL, 0x000043UL, 0x000020UL, 0x000001UL,
+      0x0000E6UL, 0x0000C7UL, 0x0000A4UL, 0x000085UL, 0x00016AUL, 0x00014BUL,
+      0x000128UL, 0x000109UL, 0x0001EEUL, 0x0001CFUL, 0x0001ACUL, 0x00018DUL,
+      0x000053UL, 0x000072UL, 0x000011UL, 0x000030UL, 0x0000D7UL, 0x0000F6UL,
+      0x000095UL, 0x0000B4UL, 0x00015BUL, 0x00017AUL, 0x000119UL, 0x000138UL,
+      0x0001DFUL, 0x0001FEUL, 0x00019DUL, 0x0001BCUL, 0x0000C4UL, 0x0000E5UL,
+      0x000086UL, 0x0000A7UL, 0x000040UL, 0x000061UL, 0x000002UL, 0x000023UL,
+      0x0001CCUL, 0x0001EDUL, 0x00018EUL, 0x0001AFUL, 0x000148UL, 0x000169UL,
+      0x00010AUL, 0x00012BUL, 0x0000F5UL, 0x0000D4UL, 0x0000B7UL, 0x000096UL,
+      0x000071UL, 0x000050UL, 0x000033UL, 0x000012UL, 0x0001FDUL, 0x0001DCUL,
+      0x0001BFUL, 0x00019EUL, 0x000179UL, 0x000158UL, 0x00013BUL, 0x00011AUL,
+      0x0000A6UL, 0x000087UL, 0x0000E4UL, 0x0000C5UL, 0x000022UL, 0x000003UL,
+      0x000060UL, 0x000041UL, 0x0001AEUL, 0x00018FUL, 0x0001ECUL, 0x0001CDUL,
+      0x00012AUL, 0x00010BUL, 0x000168UL, 0x000149UL, 0x000097UL, 0x0000B6UL,
+      0x0000D5UL, 0x0000F4UL, 0x000013UL, 0x000032UL, 0x000051UL, 0x000070UL,
+      0x00019FUL, 0x0001BEUL, 0x0001DDUL, 0x0001FCUL, 0x00011BUL, 0x00013AUL,
+      0x000159UL, 0x000178UL, 0x000188UL, 0x0001A9UL, 0x0001CAUL, 0x0001EBUL,
+      0x00010CUL, 0x00012DUL, 0x00014EUL, 0x00016FUL, 0x000080UL, 0x0000A1UL,
+      0x0000C2UL, 0x0000E3UL, 0x000004UL, 0x000025UL, 0x000046UL, 0x000067UL,
+      0x0001B9UL, 0x000198UL, 0x0001FBUL, 0x0001DAUL, 0x00013DUL, 0x00011CUL,
+      0x00017FUL, 0x00015EUL, 0x0000B1UL, 0x000090UL, 0x0000F3UL, 0x0000D2UL,
+      0x000035UL, 0x000014UL, 0x000077UL, 0x000056UL, 0x0001EAUL, 0x0001CBUL,
+      0x0001A8UL, 0x000189UL, 0x00016EUL, 0x00014FUL, 0x00012CUL, 0x00010DUL,
+      0x0000E2UL, 0x0000C3UL, 0x0000A0UL, 0x000081UL, 0x000066UL, 0x000047UL,
+      0x000024UL, 0x000005UL, 0x0001DBUL, 0x0001FAUL, 0x000199UL, 0x0001B8UL,
+      0x00015FUL, 0x00017EUL, 0x00011DUL, 0x00013CUL, 0x0000D3UL, 0x0000F2UL,
+      0x000091UL, 0x0000B0UL, 0x000057UL, 0x000076UL, 0x000015UL, 0x000034UL,
+      0x00014CUL, 0x00016DUL, 0x00010EUL, 0x00012FUL, 0x0001C8UL, 0x0001E9UL,
+      0x00018AUL, 0x0001ABUL, 0x000044UL, 0x000065UL, 0x000006UL, 0x000027UL,
+      0x0000C0UL, 0x0000E1UL, 0x000082UL, 0x0000A3UL, 0x00017DUL, 0x00015CUL,
+      0x00013FUL, 0x00011EUL, 0x0001F9UL, 0x0001D8UL, 0x0001BBUL, 0x00019AUL,
+      0x000075UL, 0x000054UL, 0x000037UL, 0x000016UL, 0x0000F1UL, 0x0000D0UL,
+      0x0000B3UL, 0x000092UL, 0x00012EUL, 0x00010FUL, 0x00016CUL, 0x00014DUL,
+      0x0001AAUL, 0x00018BUL, 0x0001E8UL, 0x0001C9UL, 0x000026UL, 0x000007UL,
+      0x000064UL, 0x000045UL, 0x0000A2UL, 0x000083UL, 0x0000E0UL, 0x0000C1UL,
+      0x00011FUL, 0x00013EUL, 0x00015DUL, 0x00017CUL, 0x00019BUL, 0x0001BAUL,
+      0x0001D9UL, 0x0001F8UL, 0x000017UL, 0x000036UL, 0x000055UL, 0x000074UL,
+      0x000093UL, 0x0000B2UL, 0x0000D1UL, 0x0000F0UL,
+    },
+  },
+  // PRBS15, x^15 + x^14 + 1
+  {
+    .width = 15,
+    .mask = 0x007FFFUL,
+    .output = {
+      0x00, 0x01, 0x03, 0x02, 0x07, 0x06, 0x04, 0x05, 0x0F, 0x0E, 0x0C, 0x0D,
+      0x08, 0x09, 0x0B, 0x0A, 0x1F, 0x1E, 0x1C, 0x1D, 0x18, 0x19, 0x1B, 0x1A,
+      0x10, 0x11, 0x13, 0x12, 0x17, 0x16, 0x14, 0x15, 0x3F, 0x3E, 0x3C, 0x3D,
+      0x38, 0x39, 0x3B, 0x3A, 0x30, 0x31, 0x33, 0x32, 0x37, 0x36, 0x34, 0x35,
+      0x20, 0x21, 0x23, 0x22, 0x27, 0x26, 0x24, 0x25, 0x2F, 0x2E, 0x2C, 0x2D,
+      0x28, 0x29, 0x2B, 0x2A, 0x7F, 0x7E, 0x7C, 0x7D, 0x78, 0x79, 0x7B, 0x7A,
+      0x70, 0x71, 0x73, 0x72, 0x77, 0x76, 0x74, 0x75, 0x60, 0x61, 0x63, 0x62,
+      0x67, 0x66, 0x64, 0x65, 0x6F, 0x6E, 0x6C, 0x6D, 0x68, 0x69, 0x6B, 0x6A,
+      0x40, 0x41, 0x43, 0x42, 0x47, 0x46, 0x44, 0x45, 0x4F, 0x4E, 0x4C, 0x4D,
+      0x48, 0x49, 0x4B, 0x4A, 0x5F, 0x5E, 0x5C, 0x5D, 0x58, 0x59, 0x5B, 0x5A,
+      0x50, 0x51, 0x53, 0x52, 0x57, 0x56, 0x54, 0x55, 0xFF, 0xFE, 0xFC, 0xFD,
+      0xF8, 0xF9, 0xFB, 0xFA, 0xF0, 0xF1, 0xF3, 0xF2, 0xF7, 0xF6, 0xF4, 0xF5,
+      0xE0, 0xE1, 0xE3, 0xE2, 0xE7, 0xE6, 0xE4, 0xE5, 0xEF, 0xEE, 0xEC, 0xED,
+      0xE8, 0xE9, 0xEB, 0xEA, 0xC0, 0xC1, 0xC3, 0xC2, 0xC7, 0xC6, 0xC4, 0xC5,
+      0xCF, 0xCE, 0xCC, 0xCD, 0xC8, 0xC9, 0xCB, 0xCA, 0xDF, 0xDE, 0xDC, 0xDD,
+      0xD8, 0xD9, 0xDB, 0xDA, 0xD0, 0xD1, 0xD3, 0xD2, 0xD7, 0xD6, 0xD4, 0xD5,
+      0x80, 0x81, 0x83, 0x82, 0x87, 0x86, 0x84, 0x85, 0x8F, 0x8E, 0x8C, 0x8D,
+      0x88, 0x89, 0x8B, 0x8A, 0x9F, 0x9E, 0x9C, 0x9D, 0x98, 0x99, 0x9B, 0x9A,
+      0x90, 0x91, 0x93, 0x92, 0x97, 0x96, 0x94, 0x95, 0xBF, 0xBE, 0xBC, 0xBD,
+      0xB8, 0xB9, 0xBB, 0xBA, 0xB0, 0xB1, 0xB3, 0xB2, 0xB7, 0xB6, 0xB4, 0xB5,
+      0xA0, 0xA1, 0xA3, 0xA2, 0xA7, 0xA6, 0xA4, 0xA5, 0xAF, 0xAE, 0xAC, 0xAD,
+      0xA8, 0xA9, 0xAB, 0xAA,
+    },
+    .feedback = {
+      0x000000UL, 0x004001UL, 0x004003UL, 0x000002UL, 0x004007UL, 0x000006UL,
+      0x000004UL, 0x004005UL, 0x00400FUL, 0x00000EUL, 0x00000CUL, 0x00400DUL,
+      0x000008UL, 0x004009UL, 0x00400BUL, 0x00000AUL, 0x00401FUL, 0x00001EUL,
+      0x00001CUL, 0x00401DUL, 0x000018UL, 0x004019UL, 0x00401BUL, 0x00001AUL,
+      0x000010UL, 0x004011UL, 0x004013UL, 0x000012UL, 0x004017UL, 0x000016UL,
+      0x000014UL, 0x004015UL, 0x00403FUL, 0x00003EUL, 0x00003CUL, 0x00403DUL,
+      0x000038UL, 0x004039UL, 0x00403BUL, 0x00003AUL, 0x000030UL, 0x004031UL,
+      0x004033UL, 0x000032UL, 0x004037UL, 0x000036UL, 0x000034UL, 0x004035UL,
+      0x000020UL, 0x004021UL, 0x004023UL, 0x000022UL, 0x004027UL, 0x000026UL,
+      0x000024UL, 0x004025UL, 0x00402FUL, 0x00002EUL, 0x00002CUL, 0x00402DUL,
+      0x000028UL, 0x004029UL, 0x00402BUL, 0x00002AUL, 0x00407FUL, 0x00007EUL,
+      0x00007CUL, 0x00407DUL, 0x000078UL, 0x004079UL, 0x00407BUL, 0x00007AUL,
+      0x000070UL, 0x004071UL, 0x004073UL, 0x000072UL, 0x004077UL, 0x000076UL,
+      0x000074UL, 0x004075UL, 0x000060UL, 0x004061UL, 0x004063UL, 0x000062UL,
+      0x004067UL, 0x000066UL, 0x000064UL, 0x004065UL, 0x00406FUL, 0x00006EUL,
+      0x00006CUL, 0x00406DUL, 0x000068UL, 0x004069UL, 0x00406BUL, 0x00006AUL,
+      0x000040UL, 0x004041UL, 0x004043UL, 0x000042UL, 0x004047UL, 0x000046UL,
+      0x000044UL, 0x004045UL, 0x00404FUL, 0x00004EUL, 0x00004CUL, 0x00404DUL,
+      0x000048UL, 0x004049UL, 0x00404BUL, 0x00004AUL, 0x00405FUL, 0x00005EUL,
+      0x00005CUL, 0x00405DUL, 0x000058UL, 0x004059UL, 0x00405BUL, 0x00005AUL,
+      0x000050UL, 0x004051UL, 0x004053UL, 0x000052UL, 0x004057UL, 0x000056UL,
+      0x000054UL, 0x004055UL, 0x0040FFUL, 0x0000FEUL, 0x0000FCUL, 0x0040FDUL,
+      0x0000F8UL, 0x0040F9UL, 0x0040FBUL, 0x0000FAUL, 0x0000F0UL, 0x0040F1UL,
+      0x0040F3UL, 0x0000F2UL, 0x0040F7UL, 0x0000F6UL, 0x0000F4UL, 0x0040F5UL,
+      0x0000E0UL, 0x0040E1UL, 0x0040E3UL, 0x0000E2UL, 0x0040E7UL, 0x0000E6UL,
+      0x0000E4UL, 0x0040E5UL, 0x0040EFUL, 0x0000EEUL, 0x0000ECUL, 0x0040EDUL,
+      0x0000E8UL, 0x0040E9UL, 0x0040EBUL, 0x0000EAUL, 0x0000C0UL, 0x0040C1UL,
+      0x0040C3UL, 0x0000C2UL, 0x0040C7UL, 0x0000C6UL, 0x0000C4UL, 0x0040C5UL,
+      0x0040CFUL, 0x0000CEUL, 0x0000CCUL, 0x0040CDUL, 0x0000C8UL, 0x0040C9UL,
+      0x0040CBUL, 0x0000CAUL, 0x0040DFUL, 0x0000DEUL, 0x0000DCUL, 0x0040DDUL,
+      0x0000D8UL, 0x0040D9UL, 0x0040DBUL, 0x0000DAUL, 0x0000D0UL, 0x0040D1UL,
+      0x0040D3UL, 0x0000D2UL, 0x0040D7UL, 0x0000D6UL, 0x0000D4UL, 0x0040D5UL,
+      0x000080UL, 0x004081UL, 0x004083UL, 0x000082UL, 0x004087UL, 0x000086UL,
+      0x000084UL, 0x004085UL, 0x00408FUL, 0x00008EUL, 0x00008CUL, 0x00408DUL,
+      0x000088UL, 0x004089UL, 0x00408BUL, 0x00008AUL, 0x00409FUL, 0x00009EUL,
+      0x00009CUL, 0x00409DUL, 0x000098UL, 0x004099UL, 0x00409BUL, 0x00009AUL,
+      0x000090UL, 0x004091UL, 0x004093UL, 0x000092UL, 0x004097UL, 0x000096UL,
+      0x000094UL, 0x004095UL, 0x0040BFUL, 0x0000BEUL, 0x0000BCUL, 0x0040BDUL,
+      0x0000B8UL, 0x0040B9UL, 0x0040BBUL, 0x0000BAUL, 0x0000B0UL, 0x0040B1UL,
+      0x0040B3UL, 0x0000B2UL, 0x0040B7UL, 0x0000B6UL, 0x0000B4UL, 0x0040B5UL,
+      0x0000A0UL, 0x0040A1UL, 0x0040A3UL, 0x0000A2UL, 0x0040A7UL, 0x0000A6UL,
+      0x0000A4UL, 0x0040A5UL, 0x0040AFUL, 0x0000AEUL, 0x0000ACUL, 0x0040ADUL,
+      0x0000A8UL, 0x0040A9UL, 0x0040ABUL, 0x0000AAUL,
+    },
+  },
+  // PRBS23, x^23 + x^18 + 1
+  {
+    .width = 23,
+    .mask = 0x7FFFFFUL,
+    .output = {
+      0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+      0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+      0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x21, 0x20, 0x23, 0x22,
+      0x25, 0x24, 0x27, 0x26, 0x29, 0x28, 0x2B, 0x2A, 0x2D, 0x2C, 0x2F, 0x2E,
+      0x31, 0x30, 0x33, 0x32, 0x35, 0x34, 0x37, 0x36, 0x39, 0x38, 0x3B, 0x3A,
+      0x3D, 0x3C, 0x3F, 0x3E, 0x42, 0x43, 0x40, 0x41, 0x46, 0x47, 0x44, 0x45,
+      0x4A, 0x4B, 0x48, 0x49, 0x4E, 0x4F, 0x4C, 0x4D, 0x52, 0x53, 0x50, 0x51,
+      0x56, 0x57, 0x54, 0x55, 0x5A, 0x5B, 0x58, 0x59, 0x5E, 0x5F, 0x5C, 0x5D,
+      0x63, 0x62, 0x61, 0x60, 0x67, 0x66, 0x65, 0x64, 0x6B, 0x6A, 0x69, 0x68,
+      0x6F, 0x6E, 0x6D, 0x6C, 0x73, 0x72, 0x71, 0x70, 0x77, 0x76, 0x75, 0x74,
+      0x7B, 0x7A, 0x79, 0x78, 0x7F, 0x7E, 0x7D, 0x7C, 0x84, 0x85, 0x86, 0x87,
+      0x80, 0x81, 0x82, 0x83, 0x8C, 0x8D, 0x8E, 0x8F, 0x88, 0x89, 0x8A, 0x8B,
+      0x94, 0x95, 0x96, 0x97, 0x90, 0x91, 0x92, 0x93, 0x9C, 0x9D, 0x9E, 0x9F,
+      0x98, 0x99, 0x9A, 0x9B, 0xA5, 0xA4, 0xA7, 0xA6, 0xA1, 0xA0, 0xA3, 0xA2,
+      0xAD, 0xAC, 0xAF, 0xAE, 0xA9, 0xA8, 0xAB, 0xAA, 0xB5, 0xB4, 0xB7, 0xB6,
+      0xB1, 0xB0, 0xB3, 0xB2, 0xBD, 0xBC, 0xBF, 0xBE, 0xB9, 0xB8, 0xBB, 0xBA,
+      0xC6, 0xC7, 0xC4, 0xC5, 0xC2, 0xC3, 0xC0, 0xC1, 0xCE, 0xCF, 0xCC, 0xCD,
+      0xCA, 0xCB, 0xC8, 0xC9, 0xD6, 0xD7, 0xD4, 0xD5, 0xD2, 0xD3, 0xD0, 0xD1,
+      0xDE, 0xDF, 0xDC, 0xDD, 0xDA, 0xDB, 0xD8, 0xD9, 0xE7, 0xE6, 0xE5, 0xE4,
+      0xE3, 0xE2, 0xE1, 0xE0, 0xEF, 0xEE, 0xED, 0xEC, 0xEB, 0xEA, 0xE9, 0xE8,
+      0xF7, 0xF6, 0xF5, 0xF4, 0xF3, 0xF2, 0xF1, 0xF0, 0xFF, 0xFE, 0xFD, 0xFC,
+      0xFB, 0xFA, 0xF9, 0xF8,
+    },
+    .feedback = {
+      0x000000UL, 0x040001UL, 0x080002UL, 0x0C0003UL, 0x100004UL, 0x140005UL,
+      0x180006UL, 0x1C0007UL, 0x200008UL, 0x240009UL, 0x28000AUL, 0x2C000BUL,
+      0x30000CUL, 0x34000DUL, 0x38000EUL, 0x3C000FUL, 0x400010UL, 0x440011UL,
+      0x480012UL, 0x4C0013UL, 0x500014UL, 0x540015UL, 0x580016UL, 0x5C0017UL,
+      0x600018UL, 0x640019UL, 0x68001AUL, 0x6C001BUL, 0x70001CUL, 0x74001DUL,
+      0x78001EUL, 0x7C001FUL, 0x040021UL, 0x000020UL, 0x0C0023UL, 0x080022UL,
+      0x140025UL, 0x100024UL, 0x1C0027UL, 0x180026UL, 0x240029UL, 0x200028UL,
+      0x2C002BUL, 0x28002AUL, 0x34002DUL, 0x30002CUL, 0x3C002FUL, 0x38002EUL,
+      0x440031UL, 0x400030UL, 0x4C0033UL, 0x480032UL, 0x540035UL, 0x500034UL,
+      0x5C0037UL, 0x580036UL, 0x640039UL, 0x600038UL, 0x6C003BUL, 0x68003AUL,
+      0x74003DUL, 0x70003CUL, 0x7C003FUL, 0x78003EUL, 0x080042UL, 0x0C0043UL,
+      0x000040UL, 0x040041UL, 0x180046UL, 0x1C0047UL, 0x100044UL, 0x140045UL,
+      0x28004AUL, 0x2C004BUL, 0x200048UL, 0x240049UL, 0x38004EUL, 0x3C004FUL,
+      0x30004CUL, 0x34004DUL, 0x480052UL, 0x4C0053UL, 0x400050UL, 0x440051UL,
+      0x580056UL, 0x5C0057UL, 0x500054UL, 0x540055UL, 0x68005AUL, 0x6C005BUL,
+      0x600058UL, 0x640059UL, 0x78005EUL, 0x7C005FUL, 0x70005CUL, 0x74005DUL,
+      0x0C0063UL, 0x080062UL, 0x040061UL, 0x000060UL, 0x1C0067UL, 0x180066UL,
+      0x140065UL, 0x100064UL, 0x2C006BUL, 0x28006AUL, 0x240069UL, 0x200068UL,
+      0x3C006FUL, 0x38006EUL, 0x34006DUL, 0x30006CUL, 0x4C0073UL, 0x480072UL,
+      0x440071UL, 0x400070UL, 0x5C0077UL, 0x580076UL, 0x540075UL, 0x500074UL,
+      0x6C007BUL, 0x68007AUL, 0x640079UL, 0x600078UL, 0x7C007FUL, 0x78007EUL,
+      0x74007DUL, 0x70007CUL, 0x100084UL, 0x140085UL, 0x180086UL, 0x1C0087UL,
+      0x000080UL, 0x040081UL, 0x080082UL, 0x0C0083UL, 0x30008CUL, 0x34008DUL,
+      0x38008EUL, 0x3C008FUL, 0x200088UL, 0x240089UL, 0x28008AUL, 0x2C008BUL,
+      0x500094UL, 0x540095UL, 0x580096UL, 0x5C0097UL, 0x400090UL, 0x440091UL,
+      0x480092UL, 0x4C0093UL, 0x70009CUL, 0x74009DUL, 0x78009EUL, 0x7C009FUL,
+      0x600098UL, 0x640099UL, 0x68009AUL, 0x6C009BUL, 0x1400A5UL, 0x1000A4UL,
+      0x1C00A7UL, 0x1800A6UL, 0x0400A1UL, 0x0000A0UL, 0x0C00A3UL, 0x0800A2UL,
+      0x3400ADUL, 0x3000ACUL, 0x3C00AFUL, 0x3800AEUL, 0x2400A9UL, 0x2000A8UL,
+      0x2C00ABUL, 0x2800AAUL, 0x5400B5UL, 0x5000B4UL, 0x5C00B7UL, 0x5800B6UL,
+      0x4400B1UL, 0x4000B0UL, 0x4C00B3UL, 0x4800B2UL, 0x7400BDUL, 0x7000BCUL,
+      0x7C00BFUL, 0x7800BEUL, 0x6400B9UL, 0x6000B8UL, 0x6C00BBUL, 0x6800BAUL,
+      0x1800C6UL, 0x1C00C7UL, 0x1000C4UL, 0x1400C5UL, 0x0800C2UL, 0x0C00C3UL,
+      0x0000C0UL, 0x0400C1UL, 0x3800CEUL, 0x3C00CFUL, 0x3000CCUL, 0x3400CDUL,
+      0x2800CAUL, 0x2C00CBUL, 0x2000C8UL, 0x2400C9UL, 0x5800D6UL, 0x5C00D7UL,
+      0x5000D4UL, 0x5400D5UL, 0x4800D2UL, 0x4C00D3UL, 0x4000D0UL, 0x4400D1UL,
+      0x7800DEUL, 0x7C00DFUL, 0x7000DCUL, 0x7400DDUL, 0x6800DAUL, 0x6C00DBUL,
+      0x6000D8UL, 0x6400D9UL, 0x1C00E7UL, 0x1800E6UL, 0x1400E5UL, 0x1000E4UL,
+      0x0C00E3UL, 0x0800E2UL, 0x0400E1UL, 0x0000E0UL, 0x3C00EFUL, 0x3800EEUL,
+      0x3400EDUL, 0x3000ECUL, 0x2C00EBUL, 0x2800EAUL, 0x2400E9UL, 0x2000E8UL,
+      0x5C00F7UL, 0x5800F6UL, 0x5400F5UL, 0x5000F4UL, 0x4C00F3UL, 0x4800F2UL,
+      0x4400F1UL, 0x4000F0UL, 0x7C00FFUL, 0x7800FEUL, 0x7400FDUL, 0x7000FCUL,
+      0x6C00FBUL, 0x6800FAUL, 0x6400F9UL, 0x6000F8UL,
+    },
+  },
+};
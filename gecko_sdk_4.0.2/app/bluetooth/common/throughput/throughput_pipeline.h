@@ -0,0 +1,214 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput pipelined transfer
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_PIPELINE_H
+#define THROUGHPUT_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * The pipeline keeps a window of sequence numbered segments in flight and
+ * lets the client acknowledge them in bulk. All multi-byte fields are
+ * little-endian.
+ *
+ *   segment:  sequence (4) | payload
+ *   ack:      cumulative (4) | bitmap (4)
+ *
+ * The payload byte at index i of a segment is the low byte of its sequence
+ * plus i. The cumulative field of an ack is the next sequence the client
+ * expects, bit i of the bitmap is set if sequence cumulative + 1 + i has
+ * already been received.
+ ******************************************************************************/
+
+/// Size of the segment header
+#define THROUGHPUT_PIPELINE_HEADER_SIZE         4
+/// Size of an acknowledgement
+#define THROUGHPUT_PIPELINE_ACK_SIZE            8
+/// Largest window the acknowledgement bitmap can describe
+#define THROUGHPUT_PIPELINE_MAX_WINDOW          32
+
+/// Classification of a received segment
+typedef enum {
+  /// Next expected segment, delivered together with the buffered ones
+  THROUGHPUT_PIPELINE_SEGMENT_IN_ORDER,
+  /// Segment ahead of a gap, buffered until the gap is filled
+  THROUGHPUT_PIPELINE_SEGMENT_EARLY,
+  /// Segment that has been received before
+  THROUGHPUT_PIPELINE_SEGMENT_DUPLICATE,
+  /// Segment beyond the window, dropped
+  THROUGHPUT_PIPELINE_SEGMENT_OUT_OF_WINDOW,
+  /// Not a segment
+  THROUGHPUT_PIPELINE_SEGMENT_INVALID
+} throughput_pipeline_segment_t;
+
+/// Reorder state of the receiver
+typedef struct {
+  /// Next sequence to be delivered in order
+  uint32_t expected;
+  /// Segments received ahead of expected, bit i is expected + 1 + i
+  uint32_t pending;
+} throughput_pipeline_rx_t;
+
+/**************************************************************************//**
+ * Write a segment.
+ * @param[out] buffer segment payload
+ * @param[in] size size of the segment, at least the header size
+ * @param[in] sequence sequence number of the segment
+ *****************************************************************************/
+static inline void throughput_pipeline_write_segment(uint8_t *buffer,
+                                                     uint16_t size,
+                                                     uint32_t sequence)
+{
+  buffer[0] = (uint8_t)sequence;
+  buffer[1] = (uint8_t)(sequence >> 8);
+  buffer[2] = (uint8_t)(sequence >> 16);
+  buffer[3] = (uint8_t)(sequence >> 24);
+  for (uint16_t i = THROUGHPUT_PIPELINE_HEADER_SIZE; i < size; i++) {
+    buffer[i] = (uint8_t)(sequence + i);
+  }
+}
+
+/**************************************************************************//**
+ * Parse and check a received segment.
+ * @param[in] buffer received payload
+ * @param[in] len length of the payload
+ * @param[out] sequence sequence number of the segment
+ * @return true if the payload is a complete, intact segment
+ *****************************************************************************/
+static inline bool throughput_pipeline_read_segment(const uint8_t *buffer,
+                                                    uint16_t len,
+                                                    uint32_t *sequence)
+{
+  if (len < THROUGHPUT_PIPELINE_HEADER_SIZE) {
+    return false;
+  }
+  *sequence = (uint32_t)buffer[0]
+              | ((uint32_t)buffer[1] << 8)
+              | ((uint32_t)buffer[2] << 16)
+              | ((uint32_t)buffer[3] << 24);
+  for (uint16_t i = THROUGHPUT_PIPELINE_HEADER_SIZE; i < len; i++) {
+    if (buffer[i] != (uint8_t)(*sequence + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * Write an acknowledgement.
+ * @param[out] buffer acknowledgement payload
+ * @param[in] cumulative next sequence expected in order
+ * @param[in] bitmap segments received ahead of it
+ *****************************************************************************/
+static inline void throughput_pipeline_write_ack(uint8_t *buffer,
+                                                 uint32_t cumulative,
+                                                 uint32_t bitmap)
+{
+  for (uint8_t i = 0; i < 4; i++) {
+    buffer[i] = (uint8_t)(cumulative >> (8 * i));
+    buffer[4 + i] = (uint8_t)(bitmap >> (8 * i));
+  }
+}
+
+/**************************************************************************//**
+ * Parse an acknowledgement.
+ * @param[in] buffer received payload
+ * @param[in] len length of the payload
+ * @param[out] cumulative next sequence expected in order
+ * @param[out] bitmap segments received ahead of it
+ * @return true if the payload is an acknowledgement
+ *****************************************************************************/
+static inline bool throughput_pipeline_read_ack(const uint8_t *buffer,
+                                                uint16_t len,
+                                                uint32_t *cumulative,
+                                                uint32_t *bitmap)
+{
+  if (len != THROUGHPUT_PIPELINE_ACK_SIZE) {
+    return false;
+  }
+  *cumulative = 0;
+  *bitmap = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    *cumulative |= (uint32_t)buffer[i] << (8 * i);
+    *bitmap |= (uint32_t)buffer[4 + i] << (8 * i);
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * Reset the reorder state of the receiver.
+ * @param[out] rx receiver state
+ *****************************************************************************/
+static inline void throughput_pipeline_rx_reset(throughput_pipeline_rx_t *rx)
+{
+  rx->expected = 0;
+  rx->pending = 0;
+}
+
+/**************************************************************************//**
+ * Account a received segment in the reorder state.
+ * @param[in,out] rx receiver state
+ * @param[in] sequence sequence number of the segment
+ * @param[out] delivered number of segments that became deliverable in order
+ * @return classification of the segment
+ *****************************************************************************/
+static inline throughput_pipeline_segment_t throughput_pipeline_rx_accept(throughput_pipeline_rx_t *rx,
+                                                                          uint32_t sequence,
+                                                                          uint32_t *delivered)
+{
+  uint32_t offset = sequence - rx->expected;
+
+  *delivered = 0;
+  if (offset == 0) {
+    // Deliver this one and everything buffered right behind it
+    rx->expected++;
+    (*delivered)++;
+    while (rx->pending & 1) {
+      rx->pending >>= 1;
+      rx->expected++;
+      (*delivered)++;
+    }
+    rx->pending >>= 1;
+    return THROUGHPUT_PIPELINE_SEGMENT_IN_ORDER;
+  }
+  if (offset & 0x80000000) {
+    return THROUGHPUT_PIPELINE_SEGMENT_DUPLICATE;
+  }
+  if (offset > THROUGHPUT_PIPELINE_MAX_WINDOW) {
+    return THROUGHPUT_PIPELINE_SEGMENT_OUT_OF_WINDOW;
+  }
+  if (rx->pending & (1UL << (offset - 1))) {
+    return THROUGHPUT_PIPELINE_SEGMENT_DUPLICATE;
+  }
+  rx->pending |= 1UL << (offset - 1);
+  return THROUGHPUT_PIPELINE_SEGMENT_EARLY;
+}
+
+#endif // THROUGHPUT_PIPELINE_H
@@ -0,0 +1,232 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput single-producer single-consumer slot queue
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_RING_H
+#define THROUGHPUT_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Fixed capacity queue of payload slots shared by exactly one producer and one
+ * consumer, e.g. a sampler interrupt and the BLE transmit path. No locks are
+ * taken: the producer only writes head, the consumer only writes tail.
+ *
+ * Both sides work in place. The producer fills the slot returned by
+ * throughput_ring_reserve() and publishes it with throughput_ring_produce().
+ * The consumer reads the oldest slot via throughput_ring_peek() and releases
+ * it with throughput_ring_commit() once it is no longer needed.
+ *
+ * With GCC/Clang the indices are accessed through the atomic builtins, so the
+ * queue also builds for the host, see tools/throughput_ring_stress.c. Other
+ * compilers, e.g. IAR, order the volatile indices with a CMSIS __DMB().
+ ******************************************************************************/
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THROUGHPUT_RING_LOAD_ACQUIRE(ptr)         __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define THROUGHPUT_RING_STORE_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#else
+#include "cmsis_compiler.h"
+#define THROUGHPUT_RING_LOAD_ACQUIRE(ptr)         throughput_ring_load_acquire(ptr)
+#define THROUGHPUT_RING_STORE_RELEASE(ptr, value) throughput_ring_store_release((ptr), (value))
+
+// The barrier keeps the slot accesses after the load of the index
+static inline uint32_t throughput_ring_load_acquire(const volatile uint32_t *ptr)
+{
+  uint32_t value = *ptr;
+  __DMB();
+  return value;
+}
+
+// The barrier completes the slot accesses before the index is published
+static inline void throughput_ring_store_release(volatile uint32_t *ptr, uint32_t value)
+{
+  __DMB();
+  *ptr = value;
+}
+#endif
+
+/// Bytes in front of each slot payload, holds the payload length
+#define THROUGHPUT_RING_SLOT_HEADER             4
+/// Distance of two slots in the storage, keeps payloads word aligned
+#define THROUGHPUT_RING_STRIDE(slot_size) \
+  ((((uint32_t)(slot_size) + THROUGHPUT_RING_SLOT_HEADER) + 3u) & ~3u)
+/// Storage needed for a queue, slot count must be a power of two
+#define THROUGHPUT_RING_STORAGE_SIZE(slot_size, slot_count) \
+  (THROUGHPUT_RING_STRIDE(slot_size) * (slot_count))
+
+/// Queue state
+typedef struct {
+  uint8_t *storage;
+  uint32_t stride;
+  uint32_t mask;
+  uint16_t slot_size;
+  /// Slots published, written by the producer only
+  volatile uint32_t head;
+  /// Slots released, written by the consumer only
+  volatile uint32_t tail;
+  /// Most slots in use at once, written by the producer only
+  uint32_t high_water;
+  /// Reservations refused on a full queue, written by the producer only
+  uint32_t overruns;
+  /// Slots the consumer could not pass on, written by the consumer only
+  uint32_t backpressure;
+} throughput_ring_t;
+
+/**************************************************************************//**
+ * Initialize a queue. Neither side may use the queue during the call.
+ * @param[out] ring queue
+ * @param[in] storage storage of THROUGHPUT_RING_STORAGE_SIZE() bytes, word aligned
+ * @param[in] slot_size payload bytes per slot
+ * @param[in] slot_count number of slots, power of two
+ * @return false if the slot count is not a power of two
+ *****************************************************************************/
+static inline bool throughput_ring_init(throughput_ring_t *ring,
+                                        uint8_t *storage,
+                                        uint16_t slot_size,
+                                        uint32_t slot_count)
+{
+  if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+    return false;
+  }
+  ring->storage = storage;
+  ring->stride = THROUGHPUT_RING_STRIDE(slot_size);
+  ring->mask = slot_count - 1;
+  ring->slot_size = slot_size;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->high_water = 0;
+  ring->overruns = 0;
+  ring->backpressure = 0;
+  return true;
+}
+
+/**************************************************************************//**
+ * Drop all slots and clear the counters. Neither side may use the queue
+ * during the call.
+ * @param[in] ring queue
+ *****************************************************************************/
+static inline void throughput_ring_reset(throughput_ring_t *ring)
+{
+  ring->head = 0;
+  ring->tail = 0;
+  ring->high_water = 0;
+  ring->overruns = 0;
+  ring->backpressure = 0;
+}
+
+/**************************************************************************//**
+ * Number of published slots waiting for the consumer. Exact when called from
+ * either side, a snapshot otherwise.
+ * @param[in] ring queue
+ * @return slots in use
+ *****************************************************************************/
+static inline uint32_t throughput_ring_level(throughput_ring_t *ring)
+{
+  return THROUGHPUT_RING_LOAD_ACQUIRE(&ring->head)
+         - THROUGHPUT_RING_LOAD_ACQUIRE(&ring->tail);
+}
+
+/**************************************************************************//**
+ * Producer: get the slot to fill next. Calling it again before
+ * throughput_ring_produce() returns the same slot.
+ * @param[in] ring queue
+ * @return slot payload of slot_size bytes, NULL if the queue is full
+ *****************************************************************************/
+static inline uint8_t *throughput_ring_reserve(throughput_ring_t *ring)
+{
+  uint32_t head = ring->head;
+
+  if (head - THROUGHPUT_RING_LOAD_ACQUIRE(&ring->tail) > ring->mask) {
+    ring->overruns++;
+    return NULL;
+  }
+  return ring->storage + (head & ring->mask) * ring->stride
+         + THROUGHPUT_RING_SLOT_HEADER;
+}
+
+/**************************************************************************//**
+ * Producer: publish the reserved slot to the consumer.
+ * @param[in] ring queue
+ * @param[in] len payload length, at most slot_size
+ *****************************************************************************/
+static inline void throughput_ring_produce(throughput_ring_t *ring, uint16_t len)
+{
+  uint32_t head = ring->head;
+  uint8_t *slot = ring->storage + (head & ring->mask) * ring->stride;
+  uint32_t level;
+
+  slot[0] = (uint8_t)len;
+  slot[1] = (uint8_t)(len >> 8);
+  THROUGHPUT_RING_STORE_RELEASE(&ring->head, head + 1);
+
+  level = head + 1 - THROUGHPUT_RING_LOAD_ACQUIRE(&ring->tail);
+  if (level > ring->high_water) {
+    ring->high_water = level;
+  }
+}
+
+/**************************************************************************//**
+ * Consumer: get the oldest published slot without releasing it.
+ * @param[in] ring queue
+ * @param[out] len payload length
+ * @return slot payload, NULL if the queue is empty
+ *****************************************************************************/
+static inline const uint8_t *throughput_ring_peek(throughput_ring_t *ring, uint16_t *len)
+{
+  uint32_t tail = ring->tail;
+  const uint8_t *slot;
+
+  if (THROUGHPUT_RING_LOAD_ACQUIRE(&ring->head) == tail) {
+    return NULL;
+  }
+  slot = ring->storage + (tail & ring->mask) * ring->stride;
+  *len = (uint16_t)(slot[0] | (slot[1] << 8));
+  return slot + THROUGHPUT_RING_SLOT_HEADER;
+}
+
+/**************************************************************************//**
+ * Consumer: release the slot returned by throughput_ring_peek().
+ * @param[in] ring queue
+ *****************************************************************************/
+static inline void throughput_ring_commit(throughput_ring_t *ring)
+{
+  THROUGHPUT_RING_STORE_RELEASE(&ring->tail, ring->tail + 1);
+}
+
+/**************************************************************************//**
+ * Consumer: record that the peeked slot could not be passed on and is kept.
+ * @param[in] ring queue
+ *****************************************************************************/
+static inline void throughput_ring_backpressure(throughput_ring_t *ring)
+{
+  ring->backpressure++;
+}
+
+#endif // THROUGHPUT_RING_H
@@ -0,0 +1,225 @@
+/***************************************************************************//**
+ * @file
+ * @brief ATT round trip estimator
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_RTT_H
+#define THROUGHPUT_RTT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Smoothed round trip of the ATT exchanges of a link and the timeout derived
+ * from it, the way TCP derives its retransmission timeout (RFC 6298):
+ *
+ *   first sample:  srtt = r, rttvar = r / 2
+ *   later samples: rttvar = 3/4 rttvar + 1/4 |srtt - r|
+ *                  srtt   = 7/8 srtt + 1/8 r
+ *   timeout:       srtt + max(granularity, 4 rttvar), within the bounds
+ *
+ * A timeout doubles the timeout until the next sample. The lower bound keeps
+ * the timeout above the round trip the connection interval allows, which the
+ * caller raises on long intervals.
+ *
+ * A round trip that is only inferred, not timed from request to response, may
+ * span a timeout of the other side. Such samples are checked against the
+ * timeout first (Karn's rule): one above it is discarded and the timeout is
+ * backed off as after a timeout, so a lasting rise is still followed.
+ ******************************************************************************/
+
+/// Resolution of the timers the timeout is applied with in us
+#define THROUGHPUT_RTT_GRANULARITY_US           1000
+
+/// Round trip state of a link, all times in us
+typedef struct {
+  uint32_t srtt;
+  uint32_t rttvar;
+  /// Timeout, backed off after timeouts
+  uint32_t rto;
+  uint32_t rto_min;
+  uint32_t rto_max;
+  /// Samples, their extremes and the last one
+  uint32_t samples;
+  uint32_t min;
+  uint32_t max;
+  uint32_t last;
+  /// Timeouts, and the consecutive ones the timeout is backed off for
+  uint32_t timeouts;
+  uint8_t backoff;
+  /// Inferred samples discarded for exceeding the timeout
+  uint32_t discarded;
+} throughput_rtt_t;
+
+/**************************************************************************//**
+ * Clamp the timeout into its bounds.
+ * @param[in,out] rtt estimator
+ *****************************************************************************/
+static inline void throughput_rtt_clamp(throughput_rtt_t *rtt)
+{
+  if (rtt->rto < rtt->rto_min) {
+    rtt->rto = rtt->rto_min;
+  }
+  if (rtt->rto > rtt->rto_max) {
+    rtt->rto = rtt->rto_max;
+  }
+}
+
+/**************************************************************************//**
+ * Set up an estimator without samples.
+ * @param[out] rtt estimator
+ * @param[in] initial timeout until the first sample
+ * @param[in] rto_min lower bound of the timeout
+ * @param[in] rto_max upper bound of the timeout
+ *****************************************************************************/
+static inline void throughput_rtt_init(throughput_rtt_t *rtt,
+                                       uint32_t initial,
+                                       uint32_t rto_min,
+                                       uint32_t rto_max)
+{
+  memset(rtt, 0, sizeof(*rtt));
+  rtt->rto = initial;
+  rtt->rto_min = rto_min;
+  rtt->rto_max = rto_max > rto_min ? rto_max : rto_min;
+  throughput_rtt_clamp(rtt);
+}
+
+/**************************************************************************//**
+ * Raise the lower bound of the timeout, for example to a few connection
+ * intervals. The configured bound is kept if it is higher.
+ * @param[in,out] rtt estimator
+ * @param[in] floor lower bound the link requires
+ * @param[in] configured lower bound configured
+ *****************************************************************************/
+static inline void throughput_rtt_set_floor(throughput_rtt_t *rtt,
+                                            uint32_t floor,
+                                            uint32_t configured)
+{
+  rtt->rto_min = floor > configured ? floor : configured;
+  if (rtt->rto_min > rtt->rto_max) {
+    rtt->rto_min = rtt->rto_max;
+  }
+  throughput_rtt_clamp(rtt);
+}
+
+/**************************************************************************//**
+ * Add a round trip sample and derive the timeout again.
+ * @param[in,out] rtt estimator
+ * @param[in] sample round trip
+ *****************************************************************************/
+static inline void throughput_rtt_sample(throughput_rtt_t *rtt, uint32_t sample)
+{
+  uint32_t deviation;
+  uint32_t margin;
+
+  if (rtt->samples == 0) {
+    rtt->srtt = sample;
+    rtt->rttvar = sample / 2;
+    rtt->min = sample;
+    rtt->max = sample;
+  } else {
+    deviation = rtt->srtt > sample ? rtt->srtt - sample : sample - rtt->srtt;
+    rtt->rttvar = rtt->rttvar - rtt->rttvar / 4 + deviation / 4;
+    rtt->srtt = rtt->srtt - rtt->srtt / 8 + sample / 8;
+    if (sample < rtt->min) {
+      rtt->min = sample;
+    }
+    if (sample > rtt->max) {
+      rtt->max = sample;
+    }
+  }
+  rtt->samples++;
+  rtt->last = sample;
+  rtt->backoff = 0;
+
+  margin = 4 * rtt->rttvar;
+  if (margin < THROUGHPUT_RTT_GRANULARITY_US) {
+    margin = THROUGHPUT_RTT_GRANULARITY_US;
+  }
+  rtt->rto = rtt->srtt + margin;
+  throughput_rtt_clamp(rtt);
+}
+
+/**************************************************************************//**
+ * Double the timeout, up to its upper bound.
+ * @param[in,out] rtt estimator
+ * @return true if the timeout had already reached its upper bound
+ *****************************************************************************/
+static inline bool throughput_rtt_backoff(throughput_rtt_t *rtt)
+{
+  if (rtt->rto >= rtt->rto_max) {
+    return true;
+  }
+  rtt->backoff++;
+  rtt->rto = rtt->rto > rtt->rto_max / 2 ? rtt->rto_max : rtt->rto * 2;
+  return false;
+}
+
+/**************************************************************************//**
+ * Back off the timeout after it expired.
+ * @param[in,out] rtt estimator
+ * @return true if the timeout had already reached its upper bound
+ *****************************************************************************/
+static inline bool throughput_rtt_timeout(throughput_rtt_t *rtt)
+{
+  rtt->timeouts++;
+  return throughput_rtt_backoff(rtt);
+}
+
+/**************************************************************************//**
+ * Add an inferred round trip sample, unless it exceeds the timeout and may
+ * span a timeout and retry of the other side.
+ * @param[in,out] rtt estimator
+ * @param[in] sample inferred round trip
+ * @return true if the sample was added
+ *****************************************************************************/
+static inline bool throughput_rtt_sample_inferred(throughput_rtt_t *rtt, uint32_t sample)
+{
+  if (sample > rtt->rto) {
+    rtt->discarded++;
+    (void)throughput_rtt_backoff(rtt);
+    return false;
+  }
+  throughput_rtt_sample(rtt, sample);
+  return true;
+}
+
+/**************************************************************************//**
+ * Timeout for a millisecond timer, rounded up.
+ * @param[in] rtt estimator
+ * @param[in] factor round trips the exchange waited for takes
+ * @return timeout in ms
+ *****************************************************************************/
+static inline uint32_t throughput_rtt_timeout_ms(const throughput_rtt_t *rtt,
+                                                 uint32_t factor)
+{
+  return (uint32_t)(((uint64_t)rtt->rto * factor + 999) / 1000);
+}
+
+#endif // THROUGHPUT_RTT_H
@@ -0,0 +1,349 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput packet sequence numbering and loss detection
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef THROUGHPUT_SEQUENCE_H
+#define THROUGHPUT_SEQUENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_pattern.h"
+
+/*******************************************************************************
+ * Every data packet carries a 32-bit sequence number, incremented by one for
+ * each packet of a test. A frame batch carries it in its header, any other
+ * packet starts with it. All multi-byte fields are little-endian.
+ *
+ *   packet:  sequence (4) | pattern (1) | payload
+ *
+ * The payload is generated by the pattern engine, seeded with the sequence
+ * number, so the receiver can count the errored bits of every packet.
+ *
+ * The receiver keeps a bitmap of the last THROUGHPUT_SEQUENCE_WINDOW
+ * sequence numbers below the highest one received. A gap is counted as lost
+ * when it opens and taken back if the packet arrives later while still in
+ * the window. Holes that leave the window are final and feed the histogram
+ * of loss burst lengths. Packets older than the window are counted as late;
+ * they stay counted as lost, as they cannot be told from duplicates.
+ ******************************************************************************/
+
+/// Size of the sequence field
+#define THROUGHPUT_SEQUENCE_SIZE                4
+/// Packets tracked below the highest sequence received
+#define THROUGHPUT_SEQUENCE_WINDOW              64
+/// Loss burst histogram bins: 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65 and more
+#define THROUGHPUT_SEQUENCE_BURST_BINS          8
+/// Format of the packed statistics
+#define THROUGHPUT_SEQUENCE_PACKED_VERSION      1
+/// Size of the packed statistics
+#define THROUGHPUT_SEQUENCE_PACKED_SIZE         (1 + 5 * 4 + THROUGHPUT_SEQUENCE_BURST_BINS * 2)
+
+/// Offset of the payload in a packet
+#define THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET      (THROUGHPUT_SEQUENCE_SIZE + 1)
+
+/// Classification of a received packet
+typedef enum {
+  /// Next packet after the highest one received
+  THROUGHPUT_SEQUENCE_IN_ORDER,
+  /// Packet ahead of the expected one, the packets in between are missing
+  THROUGHPUT_SEQUENCE_GAP,
+  /// Missing packet that arrived within the window
+  THROUGHPUT_SEQUENCE_REORDERED,
+  /// Packet that has been received before
+  THROUGHPUT_SEQUENCE_DUPLICATE,
+  /// Packet older than the window
+  THROUGHPUT_SEQUENCE_LATE
+} throughput_sequence_result_t;
+
+/// Receiver statistics
+typedef struct {
+  uint32_t received;
+  uint32_t lost;
+  uint32_t reordered;
+  uint32_t duplicates;
+  uint32_t late;
+  uint32_t bursts[THROUGHPUT_SEQUENCE_BURST_BINS];
+} throughput_sequence_stats_t;
+
+/// Receiver state
+typedef struct {
+  /// Highest sequence received, the first packet expected is highest + 1
+  uint32_t highest;
+  /// Received packets, bit i is highest - i
+  uint64_t window;
+  /// Valid bits in the window
+  uint8_t depth;
+  /// Length of the loss burst that is leaving the window
+  uint32_t burst;
+  throughput_sequence_stats_t stats;
+} throughput_sequence_rx_t;
+
+/**************************************************************************//**
+ * Write the sequence field.
+ * @param[out] buffer packet
+ * @param[in] sequence sequence number
+ *****************************************************************************/
+static inline void throughput_sequence_write(uint8_t *buffer, uint32_t sequence)
+{
+  buffer[0] = (uint8_t)sequence;
+  buffer[1] = (uint8_t)(sequence >> 8);
+  buffer[2] = (uint8_t)(sequence >> 16);
+  buffer[3] = (uint8_t)(sequence >> 24);
+}
+
+/**************************************************************************//**
+ * Read the sequence field.
+ * @param[in] buffer packet of at least THROUGHPUT_SEQUENCE_SIZE bytes
+ * @return sequence number
+ *****************************************************************************/
+static inline uint32_t throughput_sequence_read(const uint8_t *buffer)
+{
+  return (uint32_t)buffer[0]
+         | ((uint32_t)buffer[1] << 8)
+         | ((uint32_t)buffer[2] << 16)
+         | ((uint32_t)buffer[3] << 24);
+}
+
+/**************************************************************************//**
+ * Write a packet.
+ * @param[out] buffer packet
+ * @param[in] len length of the packet, at least THROUGHPUT_SEQUENCE_SIZE
+ * @param[in] sequence sequence number
+ * @param[in] pattern pattern engine of the sender
+ *****************************************************************************/
+static inline void throughput_sequence_write_packet(uint8_t *buffer,
+                                                    uint16_t len,
+                                                    uint32_t sequence,
+                                                    const throughput_pattern_t *pattern)
+{
+  throughput_sequence_write(buffer, sequence);
+  if (len > THROUGHPUT_SEQUENCE_SIZE) {
+    buffer[THROUGHPUT_SEQUENCE_SIZE] = (uint8_t)pattern->type;
+  }
+  if (len > THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET) {
+    throughput_pattern_fill(pattern,
+                            sequence,
+                            buffer + THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET,
+                            len - THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET);
+  }
+}
+
+/**************************************************************************//**
+ * Check the payload of a received packet. The receiver follows the pattern
+ * announced by the packet, a user pattern must have been set on both sides.
+ * @param[in] buffer packet
+ * @param[in] len length of the packet
+ * @param[in,out] pattern pattern engine of the receiver
+ * @param[in,out] stats bit error statistics
+ * @return true if the packet is intact
+ *****************************************************************************/
+static inline bool throughput_sequence_check_packet(const uint8_t *buffer,
+                                                    uint16_t len,
+                                                    throughput_pattern_t *pattern,
+                                                    throughput_pattern_stats_t *stats)
+{
+  throughput_pattern_type_t type;
+
+  if (len < THROUGHPUT_SEQUENCE_SIZE) {
+    return false;
+  }
+  if (len == THROUGHPUT_SEQUENCE_SIZE) {
+    return true;
+  }
+  type = (throughput_pattern_type_t)buffer[THROUGHPUT_SEQUENCE_SIZE];
+  if (type != pattern->type && !throughput_pattern_select(pattern, type)) {
+    return false;
+  }
+  return throughput_pattern_check(pattern,
+                                  throughput_sequence_read(buffer),
+                                  buffer + THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET,
+                                  len - THROUGHPUT_SEQUENCE_PAYLOAD_OFFSET,
+                                  stats) == 0;
+}
+
+/**************************************************************************//**
+ * Reset the receiver, the first packet expected is sequence 0.
+ * @param[out] rx receiver state
+ *****************************************************************************/
+static inline void throughput_sequence_rx_reset(throughput_sequence_rx_t *rx)
+{
+  memset(rx, 0, sizeof(*rx));
+  rx->highest = UINT32_MAX;
+}
+
+/**************************************************************************//**
+ * Account a finished loss burst in the histogram.
+ * @param[in,out] rx receiver state
+ *****************************************************************************/
+static inline void throughput_sequence_burst_end(throughput_sequence_rx_t *rx)
+{
+  uint32_t rest;
+  uint8_t bin = 0;
+
+  if (rx->burst == 0) {
+    return;
+  }
+  for (rest = rx->burst - 1; rest != 0 && bin < THROUGHPUT_SEQUENCE_BURST_BINS - 1; rest >>= 1) {
+    bin++;
+  }
+  rx->stats.bursts[bin]++;
+  rx->burst = 0;
+}
+
+/**************************************************************************//**
+ * Account a sequence number that leaves the window.
+ * @param[in,out] rx receiver state
+ * @param[in] received true if the packet was received
+ *****************************************************************************/
+static inline void throughput_sequence_retire(throughput_sequence_rx_t *rx,
+                                              bool received)
+{
+  if (received) {
+    throughput_sequence_burst_end(rx);
+  } else {
+    rx->burst++;
+  }
+}
+
+/**************************************************************************//**
+ * Account a received packet.
+ * @param[in,out] rx receiver state
+ * @param[in] sequence sequence number of the packet
+ * @return classification of the packet
+ *****************************************************************************/
+static inline throughput_sequence_result_t throughput_sequence_rx_accept(throughput_sequence_rx_t *rx,
+                                                                         uint32_t sequence)
+{
+  uint32_t ahead = sequence - rx->highest;
+  uint32_t behind = rx->highest - sequence;
+
+  if (ahead == 0 && rx->depth > 0) {
+    rx->stats.duplicates++;
+    return THROUGHPUT_SEQUENCE_DUPLICATE;
+  }
+  if (ahead != 0 && ahead < 0x80000000UL) {
+    // Slide the window, the oldest bits leave it first
+    for (uint8_t i = rx->depth; i > 0; i--) {
+      if ((uint32_t)(i - 1) + ahead < THROUGHPUT_SEQUENCE_WINDOW) {
+        break;
+      }
+      throughput_sequence_retire(rx, (rx->window >> (i - 1)) & 1);
+    }
+    // Missing packets that do not even enter the window
+    if (ahead > THROUGHPUT_SEQUENCE_WINDOW) {
+      rx->burst += ahead - THROUGHPUT_SEQUENCE_WINDOW;
+    }
+    rx->window = (ahead < THROUGHPUT_SEQUENCE_WINDOW) ? (rx->window << ahead) | 1 : 1;
+    rx->depth = (rx->depth + ahead < THROUGHPUT_SEQUENCE_WINDOW)
+                ? (uint8_t)(rx->depth + ahead) : THROUGHPUT_SEQUENCE_WINDOW;
+    rx->highest = sequence;
+    rx->stats.received++;
+    rx->stats.lost += ahead - 1;
+    return (ahead == 1) ? THROUGHPUT_SEQUENCE_IN_ORDER : THROUGHPUT_SEQUENCE_GAP;
+  }
+  if (behind >= rx->depth) {
+    rx->stats.late++;
+    return THROUGHPUT_SEQUENCE_LATE;
+  }
+  if ((rx->window >> behind) & 1) {
+    rx->stats.duplicates++;
+    return THROUGHPUT_SEQUENCE_DUPLICATE;
+  }
+  rx->window |= (uint64_t)1 << behind;
+  rx->stats.received++;
+  rx->stats.reordered++;
+  rx->stats.lost--;
+  return THROUGHPUT_SEQUENCE_REORDERED;
+}
+
+/**************************************************************************//**
+ * Retire the whole window at the end of a test, so the remaining holes are
+ * accounted in the burst histogram.
+ * @param[in,out] rx receiver state
+ *****************************************************************************/
+static inline void throughput_sequence_rx_finish(throughput_sequence_rx_t *rx)
+{
+  for (uint8_t i = rx->depth; i > 0; i--) {
+    throughput_sequence_retire(rx, (rx->window >> (i - 1)) & 1);
+  }
+  throughput_sequence_burst_end(rx);
+  rx->window = 0;
+  rx->depth = 0;
+}
+
+/**************************************************************************//**
+ * Pack the statistics for the result characteristic. The counters are
+ * written as 32-bit, the histogram bins saturate at 16 bits.
+ * @param[in] stats statistics
+ * @param[out] buffer THROUGHPUT_SEQUENCE_PACKED_SIZE bytes
+ *****************************************************************************/
+static inline void throughput_sequence_pack(const throughput_sequence_stats_t *stats,
+                                            uint8_t *buffer)
+{
+  buffer[0] = THROUGHPUT_SEQUENCE_PACKED_VERSION;
+  throughput_sequence_write(buffer + 1, stats->received);
+  throughput_sequence_write(buffer + 5, stats->lost);
+  throughput_sequence_write(buffer + 9, stats->reordered);
+  throughput_sequence_write(buffer + 13, stats->duplicates);
+  throughput_sequence_write(buffer + 17, stats->late);
+  for (uint8_t i = 0; i < THROUGHPUT_SEQUENCE_BURST_BINS; i++) {
+    uint16_t bin = (stats->bursts[i] > UINT16_MAX) ? UINT16_MAX : (uint16_t)stats->bursts[i];
+    buffer[21 + 2 * i] = (uint8_t)bin;
+    buffer[22 + 2 * i] = (uint8_t)(bin >> 8);
+  }
+}
+
+/**************************************************************************//**
+ * Unpack statistics received over the result characteristic.
+ * @param[in] buffer packed statistics
+ * @param[in] len length of the packed statistics
+ * @param[out] stats statistics
+ * @return false if the buffer does not hold packed statistics
+ *****************************************************************************/
+static inline bool throughput_sequence_unpack(const uint8_t *buffer,
+                                              uint16_t len,
+                                              throughput_sequence_stats_t *stats)
+{
+  if (len < THROUGHPUT_SEQUENCE_PACKED_SIZE
+      || buffer[0] != THROUGHPUT_SEQUENCE_PACKED_VERSION) {
+    return false;
+  }
+  stats->received = throughput_sequence_read(buffer + 1);
+  stats->lost = throughput_sequence_read(buffer + 5);
+  stats->reordered = throughput_sequence_read(buffer + 9);
+  stats->duplicates = throughput_sequence_read(buffer + 13);
+  stats->late = throughput_sequence_read(buffer + 17);
+  for (uint8_t i = 0; i < THROUGHPUT_SEQUENCE_BURST_BINS; i++) {
+    stats->bursts[i] = (uint32_t)buffer[21 + 2 * i]
+                       | ((uint32_t)buffer[22 + 2 * i] << 8);
+  }
+  return true;
+}
+
+#endif // THROUGHPUT_SEQUENCE_H
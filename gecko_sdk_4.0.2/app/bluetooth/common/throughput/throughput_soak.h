@@ -0,0 +1,315 @@
+/***************************************************************************//**
+ * @file
+ * @brief Throughput soak test statistics
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_SOAK_H
+#define THROUGHPUT_SOAK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_types.h"
+#include "throughput_history.h"
+
+/*******************************************************************************
+ * A soak test runs the links for hours or days and survives disconnects. The
+ * counters of the links are 32 bits and start over with every test, so the
+ * soak adds their increase every second to 64-bit totals instead.
+ *
+ * The last minute is kept second by second and the last hour minute by
+ * minute, which gives the rolling 1 s, 1 min and 1 h windows. Every window
+ * reports its throughput and the share of its seconds a link was under test.
+ * Over the whole soak the throughput is reported both per elapsed second and
+ * per second under test, the latter weighted by the uptime of the links.
+ ******************************************************************************/
+
+/// Period the soak is advanced with in ms
+#define THROUGHPUT_SOAK_TICK_MS               1000
+
+/// Slots of the second and minute rings
+#define THROUGHPUT_SOAK_SLOTS                 60
+
+/// 64-bit totals of a soak
+typedef struct {
+  uint64_t bytes;
+  uint64_t packets;
+  uint64_t retries;
+  uint64_t lost;
+} throughput_soak_totals_t;
+
+/// Rolling window
+typedef struct {
+  /// Seconds covered and seconds a link was under test
+  uint32_t seconds;
+  uint32_t tested;
+  uint64_t bytes;
+} throughput_soak_window_t;
+
+/// Results at a checkpoint
+typedef struct {
+  /// Seconds since the soak started and seconds a link was under test
+  uint32_t uptime;
+  uint32_t tested;
+  throughput_soak_totals_t totals;
+  /// Connections lost and tests resumed after them
+  uint32_t disconnects;
+  uint32_t resumes;
+  /// Throughput of the last minute and hour in bits/s
+  uint32_t rate_minute;
+  uint32_t rate_hour;
+} throughput_soak_checkpoint_t;
+
+/// State of a soak
+typedef struct {
+  throughput_soak_totals_t totals;
+  uint32_t uptime;
+  uint32_t tested;
+  uint32_t disconnects;
+  uint32_t resumes;
+  /// Bytes of the last seconds, and whether a link was under test in them
+  uint32_t second_bytes[THROUGHPUT_SOAK_SLOTS];
+  bool second_tested[THROUGHPUT_SOAK_SLOTS];
+  /// Bytes of the last minutes, and their seconds under test
+  uint64_t minute_bytes[THROUGHPUT_SOAK_SLOTS];
+  uint8_t minute_tested[THROUGHPUT_SOAK_SLOTS];
+  /// Minutes completed, the current one is summed from the second ring
+  uint32_t minutes;
+  /// Ring of checkpoints over caller provided storage
+  throughput_soak_checkpoint_t *checkpoints;
+  uint16_t capacity;
+  uint16_t head;
+  uint16_t count;
+} throughput_soak_t;
+
+/**************************************************************************//**
+ * Set up a soak over caller provided checkpoint storage.
+ * @param[out] soak soak
+ * @param[in] checkpoints storage of the checkpoint ring
+ * @param[in] capacity number of checkpoints of the storage
+ *****************************************************************************/
+static inline void throughput_soak_init(throughput_soak_t *soak,
+                                        throughput_soak_checkpoint_t *checkpoints,
+                                        uint16_t capacity)
+{
+  memset(soak, 0, sizeof(*soak));
+  soak->checkpoints = checkpoints;
+  soak->capacity = capacity;
+}
+
+/**************************************************************************//**
+ * Clear the totals, windows and checkpoints at the start of a soak.
+ * @param[in,out] soak soak
+ *****************************************************************************/
+static inline void throughput_soak_reset(throughput_soak_t *soak)
+{
+  throughput_soak_checkpoint_t *checkpoints = soak->checkpoints;
+  uint16_t capacity = soak->capacity;
+
+  throughput_soak_init(soak, checkpoints, capacity);
+}
+
+/**************************************************************************//**
+ * Advance the soak by a second.
+ * @param[in,out] soak soak
+ * @param[in] second increase of the counters of the links over the second
+ * @param[in] tested a link was under test at the end of the second
+ *****************************************************************************/
+static inline void throughput_soak_tick(throughput_soak_t *soak,
+                                        const throughput_history_totals_t *second,
+                                        bool tested)
+{
+  uint32_t slot = soak->uptime % THROUGHPUT_SOAK_SLOTS;
+  uint64_t bytes = 0;
+  uint8_t seconds_tested = 0;
+
+  soak->totals.bytes += second->bytes;
+  soak->totals.packets += second->packets;
+  soak->totals.retries += second->retries;
+  soak->totals.lost += second->lost;
+  soak->second_bytes[slot] = second->bytes;
+  soak->second_tested[slot] = tested;
+  soak->uptime++;
+  if (tested) {
+    soak->tested++;
+  }
+
+  // The second ring holds a full minute now, fold it into the minute ring
+  if (slot == THROUGHPUT_SOAK_SLOTS - 1) {
+    for (uint8_t i = 0; i < THROUGHPUT_SOAK_SLOTS; i++) {
+      bytes += soak->second_bytes[i];
+      seconds_tested += soak->second_tested[i] ? 1 : 0;
+    }
+    slot = soak->minutes % THROUGHPUT_SOAK_SLOTS;
+    soak->minute_bytes[slot] = bytes;
+    soak->minute_tested[slot] = seconds_tested;
+    soak->minutes++;
+  }
+}
+
+/**************************************************************************//**
+ * Rolling window ending with the last second.
+ * @param[in] soak soak
+ * @param[in] seconds length of the window, whole minutes beyond a minute
+ * @param[out] window seconds covered, seconds under test and bytes, shorter
+ *                    than requested early in the soak
+ *****************************************************************************/
+static inline void throughput_soak_window(const throughput_soak_t *soak,
+                                          uint32_t seconds,
+                                          throughput_soak_window_t *window)
+{
+  uint32_t minutes = seconds / THROUGHPUT_SOAK_SLOTS;
+  uint32_t partial = soak->uptime % THROUGHPUT_SOAK_SLOTS;
+  uint32_t slot;
+
+  memset(window, 0, sizeof(*window));
+  if (seconds <= THROUGHPUT_SOAK_SLOTS) {
+    // Seconds straight from the second ring
+    if (seconds > soak->uptime) {
+      seconds = soak->uptime;
+    }
+    for (uint32_t i = 1; i <= seconds; i++) {
+      slot = (soak->uptime - i) % THROUGHPUT_SOAK_SLOTS;
+      window->bytes += soak->second_bytes[slot];
+      window->tested += soak->second_tested[slot] ? 1 : 0;
+    }
+    window->seconds = seconds;
+    return;
+  }
+
+  // The running minute from the second ring, completed minutes before it
+  if (minutes > THROUGHPUT_SOAK_SLOTS) {
+    minutes = THROUGHPUT_SOAK_SLOTS;
+  }
+  if (partial > 0 && minutes > 0) {
+    throughput_soak_window(soak, partial, window);
+    minutes--;
+  }
+  if (minutes > soak->minutes) {
+    minutes = soak->minutes;
+  }
+  for (uint32_t i = 1; i <= minutes; i++) {
+    slot = (soak->minutes - i) % THROUGHPUT_SOAK_SLOTS;
+    window->bytes += soak->minute_bytes[slot];
+    window->tested += soak->minute_tested[slot];
+    window->seconds += THROUGHPUT_SOAK_SLOTS;
+  }
+}
+
+/**************************************************************************//**
+ * Throughput of a rolling window.
+ * @param[in] window window
+ * @return throughput in bits/s over the seconds covered
+ *****************************************************************************/
+static inline uint32_t throughput_soak_rate(const throughput_soak_window_t *window)
+{
+  if (window->seconds == 0) {
+    return 0;
+  }
+  return (uint32_t)(window->bytes * 8 / window->seconds);
+}
+
+/**************************************************************************//**
+ * Share of a span a link was under test.
+ * @param[in] tested seconds under test
+ * @param[in] seconds seconds of the span
+ * @return availability in per mille
+ *****************************************************************************/
+static inline uint32_t throughput_soak_availability(uint32_t tested,
+                                                    uint32_t seconds)
+{
+  if (seconds == 0) {
+    return 0;
+  }
+  return (uint32_t)((uint64_t)tested * 1000 / seconds);
+}
+
+/**************************************************************************//**
+ * Throughput over the whole soak.
+ * @param[in] soak soak
+ * @param[in] weighted per second under test instead of per elapsed second
+ * @return throughput in bits/s
+ *****************************************************************************/
+static inline uint32_t throughput_soak_average(const throughput_soak_t *soak,
+                                               bool weighted)
+{
+  uint32_t seconds = weighted ? soak->tested : soak->uptime;
+
+  if (seconds == 0) {
+    return 0;
+  }
+  return (uint32_t)(soak->totals.bytes * 8 / seconds);
+}
+
+/**************************************************************************//**
+ * Record a checkpoint of the results so far. When the ring is full the
+ * oldest checkpoint is overwritten.
+ * @param[in,out] soak soak
+ * @return checkpoint recorded
+ *****************************************************************************/
+static inline const throughput_soak_checkpoint_t *throughput_soak_checkpoint(throughput_soak_t *soak)
+{
+  throughput_soak_checkpoint_t *checkpoint;
+  throughput_soak_window_t window;
+
+  if (soak->capacity == 0) {
+    return NULL;
+  }
+  checkpoint = &soak->checkpoints[soak->head];
+  checkpoint->uptime = soak->uptime;
+  checkpoint->tested = soak->tested;
+  checkpoint->totals = soak->totals;
+  checkpoint->disconnects = soak->disconnects;
+  checkpoint->resumes = soak->resumes;
+  throughput_soak_window(soak, THROUGHPUT_SOAK_SLOTS, &window);
+  checkpoint->rate_minute = throughput_soak_rate(&window);
+  throughput_soak_window(soak, THROUGHPUT_SOAK_SLOTS * THROUGHPUT_SOAK_SLOTS, &window);
+  checkpoint->rate_hour = throughput_soak_rate(&window);
+  soak->head = (uint16_t)((soak->head + 1) % soak->capacity);
+  if (soak->count < soak->capacity) {
+    soak->count++;
+  }
+  return checkpoint;
+}
+
+/**************************************************************************//**
+ * Checkpoint of the ring, oldest first.
+ * @param[in] soak soak
+ * @param[in] index index below the count of checkpoints kept
+ * @return checkpoint
+ *****************************************************************************/
+static inline const throughput_soak_checkpoint_t *throughput_soak_get(const throughput_soak_t *soak,
+                                                                      uint16_t index)
+{
+  uint16_t oldest = (uint16_t)((soak->head + soak->capacity - soak->count)
+                               % soak->capacity);
+
+  return &soak->checkpoints[(oldest + index) % soak->capacity];
+}
+
+#endif // THROUGHPUT_SOAK_H
@@ -0,0 +1,290 @@
+/***************************************************************************//**
+ * @file
+ * @brief Link parameter tuner
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef THROUGHPUT_TUNE_H
+#define THROUGHPUT_TUNE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "throughput_types.h"
+
+/*******************************************************************************
+ * Searches the PHY and connection interval with the highest goodput by short
+ * probe tests. The search climbs one axis at a time: the PHYs are probed at
+ * the best interval so far, then the intervals at the best PHY, and so on
+ * until a round over both axes no longer moves the best setting. Goodputs
+ * are cached, so a setting is probed once per search. A setting replaces the
+ * best one only if it is better by the margin, which keeps the noise of the
+ * probes from moving the search.
+ *
+ * After the search the conditions it ran under are kept as reference. Once
+ * the signal strength or the loss leave their band around it, the link has
+ * to be tuned again.
+ ******************************************************************************/
+
+/// PHYs and connection intervals searched
+#define THROUGHPUT_TUNE_PHYS                    4
+#define THROUGHPUT_TUNE_INTERVALS               5
+
+/// Rounds over both axes at most
+#define THROUGHPUT_TUNE_ROUNDS                  3
+
+/// PHYs from the fastest to the most robust
+static const throughput_phy_t throughput_tune_phy[THROUGHPUT_TUNE_PHYS] = {
+  sl_bt_gap_2m_phy_uncoded,
+  sl_bt_gap_1m_phy_uncoded,
+  sl_bt_gap_coded_phy_500k,
+  sl_bt_gap_coded_phy_125k
+};
+
+/// Connection intervals in 1.25 ms steps
+static const uint16_t throughput_tune_interval[THROUGHPUT_TUNE_INTERVALS] = {
+  6, 12, 24, 48, 80
+};
+
+/// Axis of the search
+typedef enum {
+  THROUGHPUT_TUNE_AXIS_PHY = 0,
+  THROUGHPUT_TUNE_AXIS_INTERVAL = 1
+} throughput_tune_axis_t;
+
+/// Setting, indices into the PHY and interval tables
+typedef struct {
+  uint8_t phy;
+  uint8_t interval;
+} throughput_tune_point_t;
+
+/// State of a search
+typedef struct {
+  /// Goodput of the settings probed in bits/s
+  uint32_t goodput[THROUGHPUT_TUNE_PHYS][THROUGHPUT_TUNE_INTERVALS];
+  bool probed[THROUGHPUT_TUNE_PHYS][THROUGHPUT_TUNE_INTERVALS];
+  /// PHYs the links accept
+  bool allowed[THROUGHPUT_TUNE_PHYS];
+  throughput_tune_point_t best;
+  /// Required improvement over the best setting in percent
+  uint8_t margin;
+  throughput_tune_axis_t axis;
+  uint8_t index;
+  uint8_t rounds;
+  /// The best setting moved in this round
+  bool moved;
+  uint8_t probes;
+  /// Conditions of the best setting
+  throughput_rssi_t rssi;
+  uint32_t loss;
+} throughput_tune_t;
+
+/**************************************************************************//**
+ * Index of a PHY in the table.
+ * @param[in] phy PHY
+ * @return index, 1M if the PHY is unknown
+ *****************************************************************************/
+static inline uint8_t throughput_tune_phy_index(throughput_phy_t phy)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_TUNE_PHYS; i++) {
+    if (throughput_tune_phy[i] == phy) {
+      return i;
+    }
+  }
+  return 1;
+}
+
+/**************************************************************************//**
+ * Index of the interval in the table closest to a connection interval.
+ * @param[in] interval connection interval in 1.25 ms steps
+ * @return index
+ *****************************************************************************/
+static inline uint8_t throughput_tune_interval_index(uint16_t interval)
+{
+  uint8_t index = 0;
+  uint16_t distance;
+  uint16_t closest = 0xFFFF;
+
+  for (uint8_t i = 0; i < THROUGHPUT_TUNE_INTERVALS; i++) {
+    distance = interval > throughput_tune_interval[i]
+               ? interval - throughput_tune_interval[i]
+               : throughput_tune_interval[i] - interval;
+    if (distance < closest) {
+      closest = distance;
+      index = i;
+    }
+  }
+  return index;
+}
+
+/**************************************************************************//**
+ * Start a search from a setting, which is probed first.
+ * @param[out] tune search
+ * @param[in] start setting in use
+ * @param[in] margin required improvement in percent
+ *****************************************************************************/
+static inline void throughput_tune_start(throughput_tune_t *tune,
+                                         throughput_tune_point_t start,
+                                         uint8_t margin)
+{
+  memset(tune, 0, sizeof(*tune));
+  for (uint8_t i = 0; i < THROUGHPUT_TUNE_PHYS; i++) {
+    tune->allowed[i] = true;
+  }
+  tune->best = start;
+  tune->margin = margin;
+  tune->axis = THROUGHPUT_TUNE_AXIS_PHY;
+}
+
+/**************************************************************************//**
+ * Setting to probe next.
+ * @param[in,out] tune search
+ * @param[out] point setting to probe
+ * @return false if the search converged
+ *****************************************************************************/
+static inline bool throughput_tune_next(throughput_tune_t *tune,
+                                        throughput_tune_point_t *point)
+{
+  throughput_tune_point_t candidate;
+  uint8_t count;
+
+  if (!tune->probed[tune->best.phy][tune->best.interval]) {
+    *point = tune->best;
+    return true;
+  }
+  while (tune->rounds < THROUGHPUT_TUNE_ROUNDS) {
+    count = (tune->axis == THROUGHPUT_TUNE_AXIS_PHY)
+            ? THROUGHPUT_TUNE_PHYS : THROUGHPUT_TUNE_INTERVALS;
+    while (tune->index < count) {
+      candidate = tune->best;
+      if (tune->axis == THROUGHPUT_TUNE_AXIS_PHY) {
+        candidate.phy = tune->index;
+      } else {
+        candidate.interval = tune->index;
+      }
+      tune->index++;
+      if (tune->allowed[candidate.phy]
+          && !tune->probed[candidate.phy][candidate.interval]) {
+        *point = candidate;
+        return true;
+      }
+    }
+    // Axis done, a round ends with the interval axis
+    tune->index = 0;
+    if (tune->axis == THROUGHPUT_TUNE_AXIS_INTERVAL) {
+      tune->rounds++;
+      if (!tune->moved) {
+        break;
+      }
+      tune->moved = false;
+      tune->axis = THROUGHPUT_TUNE_AXIS_PHY;
+    } else {
+      tune->axis = THROUGHPUT_TUNE_AXIS_INTERVAL;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * Record the result of a probe.
+ * @param[in,out] tune search
+ * @param[in] point setting probed
+ * @param[in] goodput goodput in bits/s
+ * @param[in] rssi weakest signal strength of the links
+ * @param[in] loss packets lost in per mille
+ *****************************************************************************/
+static inline void throughput_tune_record(throughput_tune_t *tune,
+                                          throughput_tune_point_t point,
+                                          uint32_t goodput,
+                                          throughput_rssi_t rssi,
+                                          uint32_t loss)
+{
+  uint32_t best = tune->goodput[tune->best.phy][tune->best.interval];
+  bool is_best = point.phy == tune->best.phy && point.interval == tune->best.interval;
+
+  tune->goodput[point.phy][point.interval] = goodput;
+  tune->probed[point.phy][point.interval] = true;
+  tune->probes++;
+  if (is_best
+      || (uint64_t)goodput * 100 > (uint64_t)best * (100 + tune->margin)) {
+    if (!is_best) {
+      tune->best = point;
+      tune->moved = true;
+    }
+    tune->rssi = rssi;
+    tune->loss = loss;
+  }
+}
+
+/**************************************************************************//**
+ * Exclude a PHY the links refused from the search.
+ * @param[in,out] tune search
+ * @param[in] phy index of the PHY
+ *****************************************************************************/
+static inline void throughput_tune_refuse(throughput_tune_t *tune, uint8_t phy)
+{
+  tune->allowed[phy] = false;
+  for (uint8_t i = 0; i < THROUGHPUT_TUNE_INTERVALS; i++) {
+    tune->probed[phy][i] = true;
+    tune->goodput[phy][i] = 0;
+  }
+}
+
+/**************************************************************************//**
+ * Goodput of the best setting.
+ * @param[in] tune search
+ * @return goodput in bits/s
+ *****************************************************************************/
+static inline uint32_t throughput_tune_best_goodput(const throughput_tune_t *tune)
+{
+  return tune->goodput[tune->best.phy][tune->best.interval];
+}
+
+/**************************************************************************//**
+ * Check whether the conditions left the band around the reference.
+ * @param[in] tune converged search
+ * @param[in] rssi weakest signal strength of the links
+ * @param[in] rssi_band allowed change of the signal strength in dB
+ * @param[in] loss packets lost in per mille
+ * @param[in] loss_band allowed increase of the loss in per mille
+ * @return true if the links should be tuned again
+ *****************************************************************************/
+static inline bool throughput_tune_drifted(const throughput_tune_t *tune,
+                                           throughput_rssi_t rssi,
+                                           uint8_t rssi_band,
+                                           uint32_t loss,
+                                           uint32_t loss_band)
+{
+  int16_t change = (int16_t)rssi - (int16_t)tune->rssi;
+
+  if (change > (int16_t)rssi_band || change < -(int16_t)rssi_band) {
+    return true;
+  }
+  return loss > tune->loss + loss_band;
+}
+
+#endif // THROUGHPUT_TUNE_H
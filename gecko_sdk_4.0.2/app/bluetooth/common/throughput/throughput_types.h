@@ -82,6 +82,12 @@ typedef uint16_t throughput_data_size_t;
 typedef sl_bt_gap_phy_and_coding_type_t throughput_phy_t;
 /// Notification/indication type
 typedef sl_bt_gatt_client_config_flag_t throughput_notification_t;
+/// Test type streaming over an L2CAP connection-oriented channel
+#define THROUGHPUT_TEST_L2CAP                       ((throughput_notification_t)0x04)
+/// Test type with notifications upstream and writes downstream at the same time
+#define THROUGHPUT_TEST_DUPLEX                      ((throughput_notification_t)0x09)
+/// Test type with the central writing to the sink only
+#define THROUGHPUT_TEST_UPLOAD                      ((throughput_notification_t)0x08)
 /// Throughput type
 typedef uint32_t throughput_value_t;
 /// Data counter type type
@@ -30,8 +30,10 @@
 #include "sl_simple_timer.h"
 #include "throughput_central_interface.h"
 #include "throughput_types.h"
+#include "throughput_central_config.h"
 #include "app_assert.h"
 #include "sl_sleeptimer.h"
+#include "sl_iostream.h"
 
 /// Time storage variable
 static throughput_count_t time_storage = 0;
@@ -39,6 +41,19 @@ static throughput_count_t time_storage = 0;
 /// RSSI refresh timer
 static sl_simple_timer_t refresh_timer;
 
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+/// History window timer
+static sl_simple_timer_t history_timer;
+#endif
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+/// Soak test timer
+static sl_simple_timer_t soak_timer;
+#endif
+
+/// Tuner timer
+static sl_simple_timer_t tune_timer;
+
 static void refresh_timer_callback(sl_simple_timer_t *timer,
                                    void *data)
 {
@@ -47,6 +62,34 @@ static void refresh_timer_callback(sl_simple_timer_t *timer,
   timer_on_refresh_rssi();
 }
 
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+static void history_timer_callback(sl_simple_timer_t *timer,
+                                   void *data)
+{
+  (void)timer;
+  (void)data;
+  timer_on_history();
+}
+#endif
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+static void soak_timer_callback(sl_simple_timer_t *timer,
+                                void *data)
+{
+  (void)timer;
+  (void)data;
+  timer_on_soak();
+}
+#endif
+
+static void tune_timer_callback(sl_simple_timer_t *timer,
+                                void *data)
+{
+  (void)timer;
+  (void)data;
+  timer_on_tune();
+}
+
 /**************************************************************************//**
  * ASCII graphics for indicating wait status
  *****************************************************************************/
@@ -73,6 +116,28 @@ float timer_end()
           / (float)sl_sleeptimer_get_timer_frequency());
 }
 
+/**************************************************************************//**
+ * Free running microsecond counter, wraps around. Time stamps the duplex
+ * packets.
+ *****************************************************************************/
+uint32_t timer_microseconds(void)
+{
+  return (uint32_t)timer_microseconds64();
+}
+
+/**************************************************************************//**
+ * Free running microsecond counter of the clock synchronization.
+ *****************************************************************************/
+uint64_t timer_microseconds64(void)
+{
+  uint64_t ticks = sl_sleeptimer_get_tick_count64();
+  uint32_t frequency = sl_sleeptimer_get_timer_frequency();
+
+  // Split to keep the product from overflowing on long uptimes
+  return (ticks / frequency) * 1000000
+         + (ticks % frequency) * 1000000 / frequency;
+}
+
 /**************************************************************************//**
  * Start RSSI refresh timer
  *****************************************************************************/
@@ -98,3 +163,88 @@ void timer_refresh_rssi_stop(void)
   sc = sl_simple_timer_stop(&refresh_timer);
   app_assert_status(sc);
 }
+
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+/**************************************************************************//**
+ * Start history timer
+ *****************************************************************************/
+void timer_history_start(uint32_t window)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_start(&history_timer,
+                             window,
+                             history_timer_callback,
+                             NULL,
+                             true);
+  app_assert_status(sc);
+}
+
+/**************************************************************************//**
+ * Stop history timer
+ *****************************************************************************/
+void timer_history_stop(void)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_stop(&history_timer);
+  app_assert_status(sc);
+}
+#endif // THROUGHPUT_CENTRAL_HISTORY_ENABLE
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+/**************************************************************************//**
+ * Start soak timer
+ *****************************************************************************/
+void timer_soak_start(uint32_t period)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_start(&soak_timer,
+                             period,
+                             soak_timer_callback,
+                             NULL,
+                             true);
+  app_assert_status(sc);
+}
+
+/**************************************************************************//**
+ * Stop soak timer
+ *****************************************************************************/
+void timer_soak_stop(void)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_stop(&soak_timer);
+  app_assert_status(sc);
+}
+#endif // THROUGHPUT_CENTRAL_SOAK_ENABLE
+
+/**************************************************************************//**
+ * Write to the export stream
+ *****************************************************************************/
+sl_status_t export_write(const uint8_t *data, size_t len)
+{
+  // The export shares the default stream with the log
+  return sl_iostream_write(SL_IOSTREAM_STDOUT, data, len);
+}
+
+/**************************************************************************//**
+ * Start tuner timer
+ *****************************************************************************/
+void timer_tune_start(uint32_t period)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_start(&tune_timer,
+                             period,
+                             tune_timer_callback,
+                             NULL,
+                             true);
+  app_assert_status(sc);
+}
+
+/**************************************************************************//**
+ * Stop tuner timer
+ *****************************************************************************/
+void timer_tune_stop(void)
+{
+  sl_status_t sc;
+  sc = sl_simple_timer_stop(&tune_timer);
+  app_assert_status(sc);
+}
@@ -37,14 +37,53 @@
 #include "throughput_central_interface.h"
 #include "throughput_ui_types.h"
 #include "throughput_common.h"
+#include "throughput_frame.h"
+#include "throughput_pipeline.h"
+#include "throughput_l2cap.h"
+#include "throughput_pattern.h"
+#include "throughput_sequence.h"
+#include "throughput_integrity.h"
+#include "throughput_crypto.h"
+#include "throughput_duplex.h"
+#include "throughput_latency.h"
+#include "throughput_clock.h"
+#include "throughput_history.h"
+#include "throughput_soak.h"
+#include "throughput_rtt.h"
+#include "throughput_tune.h"
+#include "throughput_adapt.h"
+#include "throughput_ring.h"
+#include "throughput_export.h"
 
 // Platform specific includes
 #include "throughput_central_system.h"
+#ifdef SL_CATALOG_BLUETOOTH_PRESENT
+#include "throughput_event.h"
+#endif // SL_CATALOG_BLUETOOTH_PRESENT
 
 #define CONFIG_KEY_SET_AFH                               12
 
-// Timeout for result indication in seconds
-#define THROUGHPUT_CENTRAL_RESULT_TIMEOUT                1.0f
+// Size of an export record with the largest payload exported
+#define THROUGHPUT_CENTRAL_EXPORT_RECORD_SIZE \
+  THROUGHPUT_EXPORT_RECORD_SIZE(THROUGHPUT_CENTRAL_EXPORT_PAYLOAD_MAX)
+
+// Period of the tuner steps in ms
+#define THROUGHPUT_CENTRAL_TUNE_TICK                     100
+
+// Time the links get to adopt a setting before its probe in ms
+#define THROUGHPUT_CENTRAL_TUNE_SETTLE_TIME              3000
+
+// Time the result of a probe is waited for in ms
+#define THROUGHPUT_CENTRAL_TUNE_RESULT_TIME              10000
+
+// Period the tuned setting is checked against its conditions in ms
+#define THROUGHPUT_CENTRAL_TUNE_MONITOR_PERIOD           1000
+
+// Round trip timeouts the result indication is waited for
+#define THROUGHPUT_CENTRAL_RESULT_ROUND_TRIPS            2
+
+// Connection interval unit in microseconds
+#define CONNECTION_INTERVAL_UNIT_US                      1250
 
 // Maximum data size
 #define THROUGHPUT_CENTRAL_DATA_SIZE_MAX                 255
@@ -52,6 +91,19 @@
 // Number of remote characteristics
 #define THROUGHPUT_CENTRAL_CHARACTERISTICS_COUNT         4
 
+// Downstream packets written per step and link in a duplex test
+#define THROUGHPUT_CENTRAL_DUPLEX_BURST                  4
+
+// Latency probe written to the echo characteristic: sequence and timestamp
+#define THROUGHPUT_CENTRAL_ECHO_PROBE_SIZE               THROUGHPUT_CLOCK_PROBE_SIZE
+
+// A probe not echoed within this time is counted lost, in microseconds
+#define THROUGHPUT_CENTRAL_ECHO_TIMEOUT                  1000000
+
+// L2CAP and GATT headers of a downstream packet
+#define L2CAP_HEADER                                4
+#define WRITE_GATT_HEADER                           3
+
 // connection parameters
 #define CONN_MIN_CE_LENGTH                          0
 #define CONN_MAX_CE_LENGTH                          0x7FFF
@@ -67,26 +119,215 @@
 
 #define CONFIG_TX_POWER_MIN                         -100
 
+// Connection handle of an unused link
+#define CONNECTION_HANDLE_INVALID                   0xFF
+
+#if defined(SL_BT_CONFIG_MAX_CONNECTIONS) \
+  && (THROUGHPUT_CENTRAL_MAX_CONNECTIONS > SL_BT_CONFIG_MAX_CONNECTIONS)
+#error "THROUGHPUT_CENTRAL_MAX_CONNECTIONS exceeds SL_BT_CONFIG_MAX_CONNECTIONS"
+#endif
+
+/// Reception from a single connected peripheral
+typedef struct {
+  /// Connection handle, CONNECTION_HANDLE_INVALID if the slot is free
+  uint8_t connection;
+  /// Address of the peripheral
+  bd_addr address;
+  /// Test state of this link
+  throughput_state_t state;
+  /// Discovery state of this link
+  throughput_discovery_state_t discovery_state;
+  /// Subscription state of the data characteristics
+  throughput_notification_t notifications;
+  throughput_notification_t indications;
+  /// Connection parameters
+  throughput_phy_t phy;
+  throughput_rssi_t rssi;
+  throughput_time_t interval;
+  throughput_time_t responder_latency;
+  throughput_time_t timeout;
+  throughput_pdu_size_t pdu_size;
+  throughput_mtu_size_t mtu_size;
+  throughput_data_size_t data_size;
+  /// Remote GATT database
+  uint32_t service_handle;
+  uint16_t notifications_handle;
+  uint16_t indications_handle;
+  uint16_t transmission_handle;
+  uint16_t result_handle;
+  /// Optional pipeline characteristics, 0xFFFF if not found
+  uint16_t pipeline_handle;
+  uint16_t pipeline_ack_handle;
+  /// Optional sink characteristic of duplex tests, 0xFFFF if not found
+  uint16_t sink_handle;
+  /// Optional echo characteristic of latency probes, 0xFFFF if not found
+  uint16_t echo_handle;
+  bool echo_subscribed;
+  throughput_central_characteristic_found_t characteristic_found;
+  action_t action;
+  /// Reception counters
+  throughput_count_t bytes_received;
+  throughput_count_t operation_count;
+  /// Loss detection, see throughput_sequence.h
+  throughput_sequence_rx_t sequence_rx;
+  /// Bit errors of the received packets, see throughput_pattern.h
+  throughput_pattern_stats_t pattern_stats;
+  /// Integrity trailer of the packets, see throughput_integrity.h
+  throughput_integrity_type_t integrity;
+  throughput_integrity_ctx_t integrity_ctx;
+  throughput_integrity_stats_t integrity_stats;
+  /// Encryption of the packets, see throughput_crypto.h
+  bool encrypted;
+  throughput_crypto_stats_t crypto_stats;
+  /// Loss statistics the peripheral reported for its reception
+  throughput_sequence_stats_t peer_sequence;
+  bool peer_sequence_valid;
+  /// Duplex test, written to the sink while receiving, see throughput_duplex.h
+  bool duplex;
+  /// Upload test, written to the sink while nothing is received
+  bool upload;
+  uint16_t down_size;
+  uint32_t down_sequence;
+  throughput_count_t down_bytes;
+  throughput_count_t down_packets;
+  throughput_count_t down_stalls;
+  throughput_count_t down_failures;
+  throughput_value_t down_throughput;
+  throughput_duplex_latency_t up_latency;
+  /// Downstream results the peripheral reported
+  throughput_duplex_result_t peer_duplex;
+  bool peer_duplex_valid;
+  /// Latency histogram of the test, see latency_is_upstream()
+  throughput_latency_t latency;
+  uint32_t latency_buckets[THROUGHPUT_LATENCY_BUCKETS(THROUGHPUT_CENTRAL_LATENCY_RANGE_LOG2)];
+  /// Downstream latency summary the peripheral reported
+  throughput_latency_summary_t peer_latency;
+  bool peer_latency_valid;
+  /// Latency probes, one in flight at a time
+  uint32_t echo_sequence;
+  uint32_t echo_time;
+  bool echo_pending;
+  throughput_count_t echo_lost;
+  /// Offset and drift of the peripheral clock, and the models written to it
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+  throughput_clock_t clock;
+  throughput_clock_sample_t clock_samples[THROUGHPUT_CENTRAL_CLOCK_SAMPLES];
+#endif
+  throughput_count_t clock_updates;
+  /// The peripheral clock was synchronized when the test started
+  bool clock_synced;
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  /// Counters at the last window of the history
+  throughput_history_totals_t history_last;
+#endif
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  /// Counters at the last second of the soak test
+  throughput_history_totals_t soak_last;
+#endif
+  /// Counters at the last check of the tuned setting
+  throughput_history_totals_t tune_last;
+  /// Adaptive PHY selection, see throughput_adapt.h
+  throughput_adapt_t adapt;
+  throughput_history_totals_t adapt_last;
+  /// Frame batch reception, see throughput_frame.h
+  throughput_count_t frame_count;
+  throughput_count_t frame_lost;
+  uint32_t frame_sequence;
+  bool frame_sequence_valid;
+  /// Pipeline reception, see throughput_pipeline.h
+  throughput_pipeline_rx_t pipe_rx;
+  throughput_count_t pipe_reordered;
+  throughput_count_t pipe_duplicates;
+  throughput_count_t pipe_dropped;
+  /// L2CAP test channel, 0 if not open, see throughput_l2cap.h
+  uint16_t l2cap_cid;
+  throughput_l2cap_rx_t l2cap_rx;
+  /// Credits used by the peripheral and not yet returned
+  uint16_t l2cap_credits_used;
+  throughput_count_t l2cap_pdus;
+  throughput_count_t l2cap_sdu_errors;
+  /// Test control
+  bool finish_test;
+  bool stop_requested;
+  bool throughput_calculated;
+  bool em1_requested;
+  /// Start and finish times in seconds, relative to timer_start()
+  float time_start;
+  float finish_time;
+  /// ATT round trip, sets the timeout of the result handshake
+  throughput_rtt_t rtt;
+  /// Arrival of the last indication of an indication test in us
+  uint32_t indication_time;
+  bool indication_time_valid;
+  /// Results of the last test
+  throughput_value_t throughput;
+  throughput_value_t throughput_peripheral_side;
+  throughput_count_t count;
+  throughput_count_t packet_error;
+  throughput_count_t packet_lost;
+  throughput_time_t time;
+} throughput_central_link_t;
+
+/// Steps of the link tuner, see throughput_tune.h
+typedef enum {
+  tune_idle = 0,
+  tune_apply,
+  tune_probe,
+  tune_result,
+  tune_monitor
+} tune_step_t;
+
 /// Enabled state
 static bool enabled = false;
 
-/// Finish test indicator
-static bool finish_test = false;
+#ifdef SL_CATALOG_BLUETOOTH_PRESENT
+/// Events handled by throughput_central_on_event()
+static const uint32_t central_events[] = {
+  sl_bt_evt_scanner_scan_report_id,
+  sl_bt_evt_connection_opened_id,
+  sl_bt_evt_connection_parameters_id,
+  sl_bt_evt_connection_phy_status_id,
+  sl_bt_evt_connection_rssi_id,
+  sl_bt_evt_connection_closed_id,
+  sl_bt_evt_gatt_procedure_completed_id,
+  sl_bt_evt_gatt_service_id,
+  sl_bt_evt_gatt_characteristic_id,
+  sl_bt_evt_gatt_characteristic_value_id,
+  sl_bt_evt_gatt_mtu_exchanged_id,
+  sl_bt_evt_l2cap_coc_connection_response_id,
+  sl_bt_evt_l2cap_coc_channel_disconnected_id,
+  sl_bt_evt_l2cap_coc_data_id
+};
+#endif // SL_CATALOG_BLUETOOTH_PRESENT
+
+/// Downstream packet of duplex tests, shared by the links as it is generated
+/// again for every write and the stack copies it
+static uint8_t downstream_data[THROUGHPUT_CENTRAL_DATA_SIZE_MAX] = { 0 };
+
+/// Internal state, aggregated over the links
+static throughput_t central_state = { .allowlist.next = NULL };
+
+/// Links to the peripherals
+static throughput_central_link_t links[THROUGHPUT_CENTRAL_MAX_CONNECTIONS];
 
-/// Data for notification
-static uint8_t notification_data[THROUGHPUT_CENTRAL_DATA_SIZE_MAX] = { 0 };
+/// Scanning is held back until every link has been closed
+static bool restart_pending = false;
 
-/// Data for indication
-static uint8_t indication_data[THROUGHPUT_CENTRAL_DATA_SIZE_MAX] = { 0 };
+#if THROUGHPUT_CENTRAL_L2CAP_ENABLE
+/// SDU reassembly buffers, lent to the links while their L2CAP channel is open
+static uint8_t l2cap_sdu[THROUGHPUT_CENTRAL_L2CAP_CHANNELS][THROUGHPUT_CENTRAL_L2CAP_MTU];
+static throughput_central_link_t *l2cap_sdu_owner[THROUGHPUT_CENTRAL_L2CAP_CHANNELS];
+#endif
 
-/// Internal state
-static throughput_t central_state = { .allowlist.next = NULL };
+/// Payload pattern, follows the pattern announced by the received packets
+static throughput_pattern_t rx_pattern;
 
-/// Bit counter variable
-static throughput_count_t bytes_received = 0;
+/// Integrity trailer requested for the tests started by the central
+static throughput_integrity_type_t integrity_type = THROUGHPUT_CENTRAL_INTEGRITY;
 
-/// Operation (indication, notification) counter variable
-static throughput_count_t operation_count = 0;
+/// Encryption requested for the tests started by the central, and its key
+static bool crypto_enabled = THROUGHPUT_CENTRAL_CRYPTO_ENABLE;
+static throughput_crypto_key_t crypto_key;
 
 /// Power control status
 static connection_power_reporting_mode_t power_control_enabled
@@ -101,27 +342,67 @@ static uint32_t fixed_data_size = THROUGHPUT_CENTRAL_FIXED_DATA_SIZE;
 /// Time limit for fixed time mode
 static uint32_t fixed_time = THROUGHPUT_CENTRAL_FIXED_TIME;
 
-/// Finished time
-static float finish_time = 0;
-
-/// Throughput calculated after stop
-static bool throughput_calculated = false;
-
-/// Counter for checking data
-static uint8_t received_counter = 0;
-
-/// Flag for checking counter or accepting remote one
-static bool first_packet = true;
-
-// BLE connection handle
-static uint8_t connection_handle = 0xFF;
-static uint32_t  service_handle = 0xFFFFFFFF;
-static uint16_t  notifications_handle = 0xFFFF;
-static uint16_t  indications_handle = 0xFFFF;
-static uint16_t  transmission_handle = 0xFFFF;
-static throughput_central_characteristic_found_t characteristic_found;
-static action_t action = act_none;
-static uint16_t result_handle = 0xFFFF;
+/// Interval of the latency probes in ms, 0 if disabled
+static uint32_t echo_interval = THROUGHPUT_CENTRAL_ECHO_INTERVAL;
+
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+/// Time series of the test runs, see throughput_history.h
+static throughput_history_record_t history_records[THROUGHPUT_CENTRAL_HISTORY_RECORDS];
+static throughput_history_t history;
+static uint32_t history_window = THROUGHPUT_CENTRAL_HISTORY_WINDOW;
+static uint64_t history_start;
+static bool history_running = false;
+#endif
+
+/// Soak test over reconnects, see throughput_soak.h
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+static throughput_soak_checkpoint_t soak_checkpoints[THROUGHPUT_CENTRAL_SOAK_CHECKPOINTS];
+static throughput_soak_t soak;
+static throughput_history_totals_t soak_second;
+#endif
+static bool soak_running = false;
+
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+/// Binary export of the received data, see throughput_export.h
+static bool export_enabled = true;
+static throughput_ring_t export_ring;
+static uint8_t export_storage[THROUGHPUT_RING_STORAGE_SIZE(THROUGHPUT_CENTRAL_EXPORT_RECORD_SIZE,
+                                                           THROUGHPUT_CENTRAL_EXPORT_SLOTS)]
+__attribute__((aligned(4)));
+static throughput_export_stats_t export_stats;
+#endif
+
+/// Adaptive PHY selection of the links
+static bool adapt_enabled = THROUGHPUT_CENTRAL_ADAPT_ENABLE;
+static const throughput_adapt_config_t adapt_config = {
+  .down_rssi = { THROUGHPUT_CENTRAL_ADAPT_RSSI_2M,
+                 THROUGHPUT_CENTRAL_ADAPT_RSSI_1M,
+                 THROUGHPUT_CENTRAL_ADAPT_RSSI_CODED_500K },
+  .hysteresis = THROUGHPUT_CENTRAL_ADAPT_HYSTERESIS,
+  .loss_high = THROUGHPUT_CENTRAL_ADAPT_LOSS_HIGH,
+  .loss_low = THROUGHPUT_CENTRAL_ADAPT_LOSS_LOW,
+  .down_dwell = THROUGHPUT_CENTRAL_ADAPT_DOWN_DWELL,
+  .up_dwell = THROUGHPUT_CENTRAL_ADAPT_UP_DWELL
+};
+
+/// Link tuner, see throughput_tune.h
+static throughput_tune_t tune;
+static tune_step_t tune_step = tune_idle;
+static throughput_tune_point_t tune_point;
+static uint32_t tune_time;
+static uint32_t tune_retunes;
+static bool tune_pending = false;
+
+/// A test run is in progress on at least one link
+static bool run_active = false;
+
+/// Results of the links finished in the current test run
+static throughput_value_t aggregate_throughput = 0;
+static throughput_value_t aggregate_throughput_peripheral_side = 0;
+static throughput_count_t aggregate_count = 0;
+static throughput_count_t aggregate_lost = 0;
+static throughput_count_t aggregate_error = 0;
+static throughput_time_t aggregate_time = 0;
 
 const char *device_name = "Throughput Test"; // Device name to match against scan results.
 
@@ -140,21 +421,546 @@ const uint8_t transmission_characteristic_uuid[] = { 0x18, 0x77, 0xc6, 0x2b, 0xf
 //adf32227-b00f-400c-9eeb-b903a6cc291b
 const uint8_t result_characteristic_uuid[] = { 0x1b, 0x29, 0xcc, 0xa6, 0x03, 0xb9, 0xeb, 0x9e,
                                                0x0c, 0x40, 0x0f, 0xb0, 0x27, 0x22, 0xf3, 0xad };
+// a7c1e2d4-5b3f-4e8a-9c61-2f0d8b7e4a13
+const uint8_t pipeline_characteristic_uuid[] = { 0x13, 0x4a, 0x7e, 0x8b, 0x0d, 0x2f, 0x61, 0x9c,
+                                                 0x8a, 0x4e, 0x3f, 0x5b, 0xd4, 0xe2, 0xc1, 0xa7 };
+// a7c1e2d5-5b3f-4e8a-9c61-2f0d8b7e4a13
+const uint8_t pipeline_ack_characteristic_uuid[] = { 0x13, 0x4a, 0x7e, 0x8b, 0x0d, 0x2f, 0x61, 0x9c,
+                                                     0x8a, 0x4e, 0x3f, 0x5b, 0xd5, 0xe2, 0xc1, 0xa7 };
+// a7c1e2d6-5b3f-4e8a-9c61-2f0d8b7e4a13
+const uint8_t sink_characteristic_uuid[] = { 0x13, 0x4a, 0x7e, 0x8b, 0x0d, 0x2f, 0x61, 0x9c,
+                                             0x8a, 0x4e, 0x3f, 0x5b, 0xd6, 0xe2, 0xc1, 0xa7 };
+// a7c1e2d7-5b3f-4e8a-9c61-2f0d8b7e4a13
+const uint8_t echo_characteristic_uuid[] = { 0x13, 0x4a, 0x7e, 0x8b, 0x0d, 0x2f, 0x61, 0x9c,
+                                             0x8a, 0x4e, 0x3f, 0x5b, 0xd7, 0xe2, 0xc1, 0xa7 };
 
 // Function deffinitions
 static bool process_scan_response(sl_bt_evt_scanner_scan_report_t *response);
-static void process_procedure_complete_event(sl_bt_msg_t *evt);
-static void check_characteristic_uuid(sl_bt_msg_t *evt);
-static void reset_variables(void);
-static void check_received_data(uint8_t * data, uint8_t len);
-static void handle_throughput_central_stop(bool send_transmission_on);
-static void handle_throughput_central_start(bool send_transmission_on);
+static void process_procedure_complete_event(throughput_central_link_t *link,
+                                             sl_bt_msg_t *evt);
+static void check_characteristic_uuid(throughput_central_link_t *link,
+                                      sl_bt_msg_t *evt);
+static void reset_variables(throughput_central_link_t *link);
+static bool l2cap_sdu_acquire(throughput_central_link_t *link);
+static void l2cap_sdu_release(throughput_central_link_t *link);
+static void check_received_data(throughput_central_link_t *link,
+                                uint8_t * data,
+                                uint16_t len);
+static bool check_received_frames(throughput_central_link_t *link,
+                                  uint8_t * data,
+                                  uint16_t len);
+static void account_received_data(throughput_central_link_t *link,
+                                  uint16_t len,
+                                  uint8_t * content,
+                                  uint16_t content_len,
+                                  bool intact);
+static void check_received_duplex(throughput_central_link_t *link,
+                                  uint8_t * data,
+                                  uint16_t len);
+static uint16_t downstream_size(throughput_central_link_t *link);
+static void send_downstream(throughput_central_link_t *link);
+static void send_echo_probe(throughput_central_link_t *link);
+static void check_echo(throughput_central_link_t *link,
+                       uint8_t * data,
+                       uint16_t len);
+static void check_indication_spacing(throughput_central_link_t *link);
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+static void send_clock_model(throughput_central_link_t *link);
+#endif
+static uint32_t received_sequence(const uint8_t *data, uint16_t len);
+static void check_received_value(throughput_central_link_t *link,
+                                 uint8_t * data,
+                                 uint16_t len);
+static void check_received_pdu(throughput_central_link_t *link,
+                               uint8_t * data,
+                               uint16_t len);
+static void check_received_segment(throughput_central_link_t *link,
+                                   uint8_t * data,
+                                   uint8_t len);
+static void throughput_central_on_event(sl_bt_msg_t *evt);
+static void subscribe_echo(throughput_central_link_t *link);
+static void finish_subscription(throughput_central_link_t *link);
+static void handle_throughput_central_stop(throughput_central_link_t *link,
+                                           bool send_transmission_on);
+static void handle_throughput_central_start(throughput_central_link_t *link,
+                                            bool send_transmission_on);
 static void throughput_central_scanning_restart(void);
 static void throughput_central_scanning_start(void);
 static void throughput_central_scanning_stop(void);
+static void throughput_central_scanning_resume(void);
+static void throughput_central_connect(sl_bt_evt_scanner_scan_report_t *report);
 static sl_status_t throughput_central_apply_phy(throughput_phy_t phy);
 static bool throughput_central_allowlist_apply();
 static bool throughput_address_compare(uint8_t *address1, uint8_t *address2);
+static throughput_central_link_t *throughput_central_find_link(uint8_t connection);
+static throughput_central_link_t *throughput_central_find_link_by_address(uint8_t *address);
+static throughput_central_link_t *throughput_central_open_link(uint8_t connection,
+                                                               bd_addr *address);
+static void throughput_central_close_link(throughput_central_link_t *link);
+static uint8_t throughput_central_link_count(void);
+static bool throughput_central_is_connecting(void);
+static bool throughput_central_is_testing(void);
+static void throughput_central_update_state(void);
+static void throughput_central_history_totals(throughput_central_link_t *link,
+                                              throughput_history_totals_t *totals);
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+static void throughput_central_history_sample(void);
+static void throughput_central_history_update(throughput_state_t state);
+#endif
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+static void throughput_central_soak_collect(throughput_central_link_t *link);
+static void throughput_central_soak_end(void);
+static const char *throughput_central_format_u64(uint64_t value, char *buffer);
+#endif
+static void throughput_central_tune_advance(void);
+static sl_status_t throughput_central_request_phy(throughput_central_link_t *link,
+                                                 throughput_phy_t phy);
+static void throughput_central_adapt(void);
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+static void throughput_central_export(throughput_central_link_t *link,
+                                      const uint8_t *data,
+                                      uint16_t len,
+                                      uint32_t sequence);
+static void throughput_central_export_drain(void);
+#endif
+static float throughput_central_link_elapsed(throughput_central_link_t *link);
+static float throughput_central_link_calculate(throughput_central_link_t *link);
+static throughput_count_t throughput_central_link_rate(throughput_central_link_t *link);
+static void throughput_central_check_run_finished(void);
+static float throughput_central_result_timeout(throughput_central_link_t *link);
+#ifdef SL_CATALOG_CLI_PRESENT
+static void throughput_central_cli_add(void);
+static void throughput_central_cli_remove(void);
+#endif // SL_CATALOG_CLI_PRESENT
+
+/**************************************************************************//**
+ * Finds the link that belongs to a connection.
+ * @param[in] connection connection handle
+ * @return link or NULL if the connection is not served
+ *****************************************************************************/
+static throughput_central_link_t *throughput_central_find_link(uint8_t connection)
+{
+  if (connection == CONNECTION_HANDLE_INVALID) {
+    return NULL;
+  }
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection == connection) {
+      return &links[i];
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Finds the link that is open towards a peripheral.
+ * @param[in] address address of the peripheral
+ * @return link or NULL if the peripheral is not connected
+ *****************************************************************************/
+static throughput_central_link_t *throughput_central_find_link_by_address(uint8_t *address)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID
+        && throughput_address_compare(links[i].address.addr, address)) {
+      return &links[i];
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Allocates and initializes a link for a connection being opened.
+ * @param[in] connection connection handle
+ * @param[in] address address of the peripheral
+ * @return link or NULL if the table is full
+ *****************************************************************************/
+static throughput_central_link_t *throughput_central_open_link(uint8_t connection,
+                                                               bd_addr *address)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      memset(link, 0, sizeof(*link));
+      throughput_rtt_init(&link->rtt,
+                          THROUGHPUT_CENTRAL_RTO_INITIAL_MS * 1000,
+                          THROUGHPUT_CENTRAL_RTO_MIN_MS * 1000,
+                          THROUGHPUT_CENTRAL_RTO_MAX_MS * 1000);
+      link->connection      = connection;
+      link->address         = *address;
+      link->state           = THROUGHPUT_STATE_DISCONNECTED;
+      link->discovery_state = THROUGHPUT_DISCOVERY_STATE_CONN;
+      link->phy             = central_state.phy;
+      link->mtu_size        = central_state.mtu_size;
+      throughput_adapt_init(&link->adapt, &adapt_config, link->phy);
+      reset_variables(link);
+      return link;
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Releases the link of a closed connection.
+ * @param[in] link link to release
+ *****************************************************************************/
+static void throughput_central_close_link(throughput_central_link_t *link)
+{
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  if (link->em1_requested) {
+    // Enable sleep
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  }
+  #endif
+  link->em1_requested = false;
+  link->connection = CONNECTION_HANDLE_INVALID;
+  link->state = THROUGHPUT_STATE_DISCONNECTED;
+  link->discovery_state = THROUGHPUT_DISCOVERY_STATE_IDLE;
+}
+
+/**************************************************************************//**
+ * Counts the links in use, including the one being opened.
+ * @return number of links in use
+ *****************************************************************************/
+static uint8_t throughput_central_link_count(void)
+{
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**************************************************************************//**
+ * Checks whether a connection is being established.
+ * @return true if a link waits for the connection to open
+ *****************************************************************************/
+static bool throughput_central_is_connecting(void)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID
+        && links[i].discovery_state == THROUGHPUT_DISCOVERY_STATE_CONN) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * Checks whether any of the links is receiving.
+ * @return true if a test is in progress on any link
+ *****************************************************************************/
+static bool throughput_central_is_testing(void)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID
+        && links[i].state == THROUGHPUT_STATE_TEST) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * Derives the aggregate state from the links and reports it.
+ *****************************************************************************/
+static void throughput_central_update_state(void)
+{
+  throughput_state_t state = THROUGHPUT_STATE_DISCONNECTED;
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID
+        && links[i].state > state) {
+      state = links[i].state;
+    }
+  }
+  if (state != central_state.state) {
+    central_state.state = state;
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+    throughput_central_history_update(state);
+#endif
+    throughput_central_on_state_change(central_state.state);
+  }
+}
+
+/**************************************************************************//**
+ * Running totals of a link recorded in the history.
+ * @param[in] link link to read
+ * @param[out] totals totals of the current test of the link
+ *****************************************************************************/
+static void throughput_central_history_totals(throughput_central_link_t *link,
+                                              throughput_history_totals_t *totals)
+{
+  totals->bytes = link->bytes_received + link->down_bytes;
+  totals->packets = link->operation_count + link->down_packets;
+  totals->retries = link->down_stalls + link->down_failures + link->pipe_duplicates;
+  totals->lost = link->sequence_rx.stats.lost;
+}
+
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+/**************************************************************************//**
+ * Records a window of all the links in the history. The RSSI is the weakest
+ * of the links under test, refreshed for the next window.
+ *****************************************************************************/
+static void throughput_central_history_sample(void)
+{
+  throughput_history_totals_t window = { 0 };
+  throughput_history_totals_t totals;
+  throughput_rssi_t rssi = central_state.rssi;
+  throughput_phy_t phy = central_state.phy;
+  bool first = true;
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    throughput_central_history_totals(link, &totals);
+    throughput_history_accumulate(&window, &link->history_last, &totals);
+    if (link->state != THROUGHPUT_STATE_TEST) {
+      continue;
+    }
+    if (first || link->rssi < rssi) {
+      rssi = link->rssi;
+    }
+    if (first) {
+      phy = link->phy;
+      first = false;
+    }
+    (void)sl_bt_connection_get_rssi(link->connection);
+  }
+  throughput_history_sample(&history,
+                            (uint32_t)((timer_microseconds64() - history_start) / 1000),
+                            &window,
+                            rssi,
+                            phy);
+}
+
+/**************************************************************************//**
+ * Starts the history with the first link under test, and records the last
+ * window when no link is under test any more.
+ * @param[in] state aggregate state of the links
+ *****************************************************************************/
+static void throughput_central_history_update(throughput_state_t state)
+{
+  if (state == THROUGHPUT_STATE_TEST && !history_running && history_window > 0) {
+    throughput_history_reset(&history);
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      throughput_central_history_totals(&links[i], &links[i].history_last);
+    }
+    history_start = timer_microseconds64();
+    timer_history_start(history_window);
+    history_running = true;
+  } else if (state != THROUGHPUT_STATE_TEST && history_running) {
+    // The last window is recorded as short as it was
+    throughput_central_history_sample();
+    timer_history_stop();
+    history_running = false;
+  }
+}
+#endif // THROUGHPUT_CENTRAL_HISTORY_ENABLE
+
+/**************************************************************************//**
+ * Event handler of the history timer
+ *****************************************************************************/
+void timer_on_history(void)
+{
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  throughput_central_history_sample();
+#endif
+}
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+/**************************************************************************//**
+ * Adds the increase of the counters of a link to the current second of the
+ * soak test. Called before the counters start over or the link is released.
+ * @param[in] link link to read
+ *****************************************************************************/
+static void throughput_central_soak_collect(throughput_central_link_t *link)
+{
+  throughput_history_totals_t totals;
+
+  throughput_central_history_totals(link, &totals);
+  throughput_history_accumulate(&soak_second, &link->soak_last, &totals);
+}
+
+/**************************************************************************//**
+ * Formats a 64-bit counter, the printf of the log has no 64-bit conversions.
+ * @param[in] value value to format
+ * @param[out] buffer at least 21 bytes
+ * @return decimal digits within the buffer
+ *****************************************************************************/
+static const char *throughput_central_format_u64(uint64_t value, char *buffer)
+{
+  char *digit = buffer + 20;
+
+  *digit = '\0';
+  do {
+    *--digit = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  return digit;
+}
+
+/**************************************************************************//**
+ * Records a checkpoint of the soak test and logs it.
+ *****************************************************************************/
+static void throughput_central_soak_checkpoint(void)
+{
+  const throughput_soak_checkpoint_t *checkpoint = throughput_soak_checkpoint(&soak);
+  char bytes[21];
+
+  if (checkpoint == NULL) {
+    return;
+  }
+  app_log_info("Soak %lu s: %s bytes, availability %lu permille, 1 min %lu bps,"
+               " 1 h %lu bps, %lu disconnects" APP_LOG_NEW_LINE,
+               (unsigned long)checkpoint->uptime,
+               throughput_central_format_u64(checkpoint->totals.bytes, bytes),
+               (unsigned long)throughput_soak_availability(checkpoint->tested,
+                                                           checkpoint->uptime),
+               (unsigned long)checkpoint->rate_minute,
+               (unsigned long)checkpoint->rate_hour,
+               (unsigned long)checkpoint->disconnects);
+}
+
+/**************************************************************************//**
+ * Ends the soak test with a last checkpoint. The tests keep running.
+ *****************************************************************************/
+static void throughput_central_soak_end(void)
+{
+  if (!soak_running) {
+    return;
+  }
+  soak_running = false;
+  timer_soak_stop();
+  if (soak.uptime % THROUGHPUT_CENTRAL_SOAK_CHECKPOINT != 0) {
+    throughput_central_soak_checkpoint();
+  }
+}
+#endif // THROUGHPUT_CENTRAL_SOAK_ENABLE
+
+/**************************************************************************//**
+ * Event handler of the soak timer. Advances the soak by a second, and
+ * restarts the test on the links that are ready again after a reconnect or
+ * after their test was stopped.
+ *****************************************************************************/
+void timer_on_soak(void)
+{
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID) {
+      throughput_central_soak_collect(&links[i]);
+    }
+  }
+  throughput_soak_tick(&soak,
+                       &soak_second,
+                       central_state.state == THROUGHPUT_STATE_TEST);
+  memset(&soak_second, 0, sizeof(soak_second));
+  if (soak.uptime % THROUGHPUT_CENTRAL_SOAK_CHECKPOINT == 0) {
+    throughput_central_soak_checkpoint();
+  }
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection != CONNECTION_HANDLE_INVALID
+        && link->state == THROUGHPUT_STATE_SUBSCRIBED) {
+      handle_throughput_central_start(link, true);
+      soak.resumes++;
+    }
+  }
+#endif
+}
+
+/**************************************************************************//**
+ * Time passed since the test started on a link.
+ * @param[in] link link under test
+ * @return elapsed time in seconds
+ *****************************************************************************/
+static float throughput_central_link_elapsed(throughput_central_link_t *link)
+{
+  return timer_end() - link->time_start;
+}
+
+/**************************************************************************//**
+ * Calculates the throughput of a link.
+ * @param[in] link link under test
+ * @return elapsed time in seconds
+ *****************************************************************************/
+static float throughput_central_link_calculate(throughput_central_link_t *link)
+{
+  float time_elapsed;
+
+  time_elapsed = throughput_central_link_elapsed(link);
+  link->time = (throughput_time_t)time_elapsed;
+  link->throughput = (throughput_value_t)((float)link->bytes_received
+                                          * 8
+                                          / time_elapsed);
+  link->down_throughput = (throughput_value_t)((float)link->down_bytes
+                                               * 8
+                                               / time_elapsed);
+  // Nothing is received in an upload, its result is the rate sent
+  if (link->upload) {
+    link->throughput = link->down_throughput;
+  }
+  return time_elapsed;
+}
+
+/**************************************************************************//**
+ * Receive rate of a link, or send rate of an upload: live while testing, the
+ * last result otherwise.
+ * @param[in] link link to check
+ * @return rate in bytes/second
+ *****************************************************************************/
+static throughput_count_t throughput_central_link_rate(throughput_central_link_t *link)
+{
+  float time_elapsed;
+
+  if (link->state == THROUGHPUT_STATE_TEST && !link->throughput_calculated) {
+    time_elapsed = throughput_central_link_elapsed(link);
+    if (time_elapsed > 0.0f) {
+      return (throughput_count_t)((float)(link->upload ? link->down_bytes : link->bytes_received)
+                                  / time_elapsed);
+    }
+    return 0;
+  }
+  return (throughput_count_t)(link->throughput / 8);
+}
+
+/**************************************************************************//**
+ * Time the result of a link is waited for after the stop, derived from its
+ * round trip.
+ * @param[in] link link that requested the stop
+ * @return timeout in seconds
+ *****************************************************************************/
+static float throughput_central_result_timeout(throughput_central_link_t *link)
+{
+  return (float)throughput_rtt_timeout_ms(&link->rtt, THROUGHPUT_CENTRAL_RESULT_ROUND_TRIPS)
+         / 1000.0f;
+}
+
+/**************************************************************************//**
+ * Reports the aggregate result once every link has finished the test.
+ *****************************************************************************/
+static void throughput_central_check_run_finished(void)
+{
+  if (!run_active || throughput_central_is_testing()) {
+    return;
+  }
+  run_active = false;
+
+  central_state.throughput = aggregate_throughput;
+  central_state.throughput_peripheral_side = aggregate_throughput_peripheral_side;
+  central_state.count = aggregate_count;
+  central_state.packet_lost = aggregate_lost;
+  central_state.packet_error = aggregate_error;
+  central_state.time = aggregate_time;
+
+  throughput_central_on_finish(central_state.throughput,
+                               central_state.count,
+                               central_state.packet_lost,
+                               central_state.packet_error,
+                               central_state.time);
+}
 
 /**************************************************************************//**
  * Event handler for timer
@@ -162,22 +968,32 @@ static bool throughput_address_compare(uint8_t *address1, uint8_t *address2);
 void timer_on_refresh_rssi(void)
 {
   sl_status_t sc;
-  if (connection_handle != 0xFF  && central_state.state != THROUGHPUT_STATE_TEST) {
-    sc = sl_bt_connection_get_rssi(connection_handle);
-    app_assert_status(sc);
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    // The adaptive PHY selection needs the RSSI during tests as well
+    if (link->connection != CONNECTION_HANDLE_INVALID
+        && link->state != THROUGHPUT_STATE_DISCONNECTED
+        && (link->state != THROUGHPUT_STATE_TEST || adapt_enabled)) {
+      sc = sl_bt_connection_get_rssi(link->connection);
+      app_assert_status(sc);
+    }
+  }
+  if (adapt_enabled) {
+    throughput_central_adapt();
   }
 }
 
 /**************************************************************************//**
  * Bluetooth stack event handler.
- * This overrides the dummy weak implementation.
+ * On SoC only the subscribed events are delivered, through
+ * throughput_event_dispatch().
  *
  * @param[in] evt Event coming from the Bluetooth stack.
  *****************************************************************************/
-void bt_on_event_central(sl_bt_msg_t *evt)
+static void throughput_central_on_event(sl_bt_msg_t *evt)
 {
   sl_status_t sc;
-  static throughput_t results;
+  throughput_central_link_t *link;
 
   // If the component is not enabled do not handle events
   if (!enabled) {
@@ -191,40 +1007,23 @@ void bt_on_event_central(sl_bt_msg_t *evt)
         if (false == throughput_central_allowlist_apply(evt->data.evt_scanner_scan_report.address.addr)) {
           break;
         }
-
-        // Stop scanning
-        sc = sl_bt_scanner_stop();
-        app_assert_status(sc);
-
-        // Open the connection
-        central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_CONN;
-        throughput_central_on_discovery_state_change(central_state.discovery_state);
-
-        sc = sl_bt_connection_open(evt->data.evt_scanner_scan_report.address,
-                                   evt->data.evt_scanner_scan_report.address_type,
-                                   central_state.phy,
-                                   &connection_handle);
-
-        // Handle if the default PHY is not supported
-        if (sc == SL_STATUS_INVALID_PARAMETER) {
-          app_log_status_warning_f(sc, "Connection PHY is not supported and set to 1M PHY" APP_LOG_NEW_LINE);
-
-          central_state.phy = sl_bt_gap_1m_phy_uncoded;
-          sc = sl_bt_connection_open(evt->data.evt_scanner_scan_report.address,
-                                     evt->data.evt_scanner_scan_report.address_type,
-                                     central_state.phy,
-                                     &connection_handle);
+        // Skip peripherals that are already connected
+        if (throughput_central_find_link_by_address(evt->data.evt_scanner_scan_report.address.addr) != NULL) {
+          break;
         }
-        // Assertion to first or second attempt to connect
-        app_assert_status(sc);
+        throughput_central_connect(&(evt->data.evt_scanner_scan_report));
       } else {
         waiting_indication();
       }
       break;
 
     case sl_bt_evt_connection_opened_id:
+      link = throughput_central_find_link(evt->data.evt_connection_opened.connection);
+      if (link == NULL) {
+        break;
+      }
       //Process the opened connection
-      sc = sl_bt_connection_set_parameters(connection_handle,
+      sc = sl_bt_connection_set_parameters(link->connection,
                                            central_state.connection_interval_min,
                                            central_state.connection_interval_max,
                                            central_state.connection_responder_latency,
@@ -234,169 +1033,860 @@ void bt_on_event_central(sl_bt_msg_t *evt)
       app_assert_status(sc);
 
       // Set remote connection power reporting - needed for Power Control
-      sc = sl_bt_connection_set_remote_power_reporting(connection_handle,
+      sc = sl_bt_connection_set_remote_power_reporting(link->connection,
                                                        power_control_enabled);
       app_assert_status(sc);
 
-      central_state.state = THROUGHPUT_STATE_CONNECTED;
-      throughput_central_on_state_change(central_state.state);
+      link->state = THROUGHPUT_STATE_CONNECTED;
+      throughput_central_update_state();
 
-      central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_SERVICE;
-      throughput_central_on_discovery_state_change(central_state.discovery_state);
+      link->discovery_state = THROUGHPUT_DISCOVERY_STATE_SERVICE;
+      throughput_central_on_discovery_state_change(link->discovery_state);
 
-      sc = sl_bt_gatt_discover_primary_services_by_uuid(connection_handle,
+      sc = sl_bt_gatt_discover_primary_services_by_uuid(link->connection,
                                                         UUID_LEN,
                                                         service_uuid);
 
       app_assert_status(sc);
 
+      // Look for further peripherals while there are free links
+      throughput_central_scanning_resume();
       break;
 
     case sl_bt_evt_connection_parameters_id:
-      central_state.interval = evt->data.evt_connection_parameters.interval;
-      central_state.connection_responder_latency = evt->data.evt_connection_parameters.latency;
-      central_state.connection_timeout = evt->data.evt_connection_parameters.timeout;
-      central_state.pdu_size = evt->data.evt_connection_parameters.txsize;
-
-      throughput_central_on_connection_timings_change(central_state.interval,
-                                                      central_state.connection_responder_latency,
-                                                      central_state.connection_timeout);
-
-      throughput_central_on_connection_settings_change(central_state.pdu_size,
-                                                       central_state.mtu_size);
+      link = throughput_central_find_link(evt->data.evt_connection_parameters.connection);
+      if (link == NULL) {
+        break;
+      }
+      link->interval = evt->data.evt_connection_parameters.interval;
+      link->responder_latency = evt->data.evt_connection_parameters.latency;
+      link->timeout = evt->data.evt_connection_parameters.timeout;
+      link->pdu_size = evt->data.evt_connection_parameters.txsize;
+      // A round trip takes two connection events of the peripheral at least
+      throughput_rtt_set_floor(&link->rtt,
+                               2 * (uint32_t)link->interval * CONNECTION_INTERVAL_UNIT_US
+                               * (1 + (uint32_t)link->responder_latency),
+                               THROUGHPUT_CENTRAL_RTO_MIN_MS * 1000);
+      central_state.interval = link->interval;
+      central_state.pdu_size = link->pdu_size;
+
+      throughput_central_on_connection_timings_change(link->interval,
+                                                      link->responder_latency,
+                                                      link->timeout);
+
+      throughput_central_on_connection_settings_change(link->pdu_size,
+                                                       link->mtu_size);
       break;
     case sl_bt_evt_gatt_procedure_completed_id:
-      process_procedure_complete_event(evt);
+      link = throughput_central_find_link(evt->data.evt_gatt_procedure_completed.connection);
+      if (link != NULL) {
+        process_procedure_complete_event(link, evt);
+      }
       break;
     case sl_bt_evt_gatt_characteristic_id:
-      check_characteristic_uuid(evt);
+      link = throughput_central_find_link(evt->data.evt_gatt_characteristic.connection);
+      if (link != NULL) {
+        check_characteristic_uuid(link, evt);
+      }
       break;
     case sl_bt_evt_gatt_service_id:
+      link = throughput_central_find_link(evt->data.evt_gatt_service.connection);
+      if (link == NULL) {
+        break;
+      }
       if (evt->data.evt_gatt_service.uuid.len == UUID_LEN) {
         if (memcmp(service_uuid, evt->data.evt_gatt_service.uuid.data, UUID_LEN) == 0) {
-          service_handle = evt->data.evt_gatt_service.service;
-          action = act_discover_service;
+          link->service_handle = evt->data.evt_gatt_service.service;
+          link->action = act_discover_service;
         }
       }
       break;
     case sl_bt_evt_gatt_characteristic_value_id:
-      if (evt->data.evt_gatt_characteristic_value.characteristic == transmission_handle) {
+      link = throughput_central_find_link(evt->data.evt_gatt_characteristic_value.connection);
+      if (link == NULL) {
+        break;
+      }
+      if (evt->data.evt_gatt_characteristic_value.characteristic == link->transmission_handle) {
         if (evt->data.evt_gatt_characteristic_value.value.data[0]) {
-          handle_throughput_central_start(false);
+          link->integrity = throughput_integrity_decode(evt->data.evt_gatt_characteristic_value.value.data[0]);
+          link->encrypted = throughput_crypto_decode(evt->data.evt_gatt_characteristic_value.value.data[0]);
+          link->duplex = (evt->data.evt_gatt_characteristic_value.value.data[0] & THROUGHPUT_DUPLEX_FLAG)
+                         && link->sink_handle != 0xFFFF;
+          link->upload = link->duplex
+                         && throughput_duplex_is_upload(evt->data.evt_gatt_characteristic_value.value.data[0]);
+          handle_throughput_central_start(link, false);
         } else {
-          finish_test = true;
+          link->finish_test = true;
         }
-      } else if (evt->data.evt_gatt_characteristic_value.characteristic == result_handle) {
+      } else if (evt->data.evt_gatt_characteristic_value.characteristic == link->result_handle) {
         if (evt->data.evt_gatt_characteristic_value.att_opcode == gatt_handle_value_indication) {
           sl_bt_gatt_send_characteristic_confirmation(evt->data.evt_gatt_characteristic_value.connection);
           // Responder sends indication about result after each test. Data is uint8array LSB first.
-          memcpy(&results.throughput_peripheral_side, evt->data.evt_gatt_characteristic_value.value.data, 4);
-          handle_throughput_central_stop(false);
+          memcpy(&link->throughput_peripheral_side, evt->data.evt_gatt_characteristic_value.value.data, 4);
+          // Followed by the statistics of its reception, if it has room
+          link->peer_sequence_valid = evt->data.evt_gatt_characteristic_value.value.len > 4
+                                      && throughput_sequence_unpack(evt->data.evt_gatt_characteristic_value.value.data + 4,
+                                                                    evt->data.evt_gatt_characteristic_value.value.len - 4,
+                                                                    &link->peer_sequence);
+          // And the downstream results of a duplex test
+          link->peer_duplex_valid = link->peer_sequence_valid
+                                    && throughput_duplex_unpack(evt->data.evt_gatt_characteristic_value.value.data
+                                                                + 4 + THROUGHPUT_SEQUENCE_PACKED_SIZE,
+                                                                evt->data.evt_gatt_characteristic_value.value.len
+                                                                - 4 - THROUGHPUT_SEQUENCE_PACKED_SIZE,
+                                                                &link->peer_duplex);
+          // And the summary of their latency histogram
+          link->peer_latency_valid = link->peer_duplex_valid
+                                     && throughput_latency_unpack(evt->data.evt_gatt_characteristic_value.value.data
+                                                                  + 4 + THROUGHPUT_SEQUENCE_PACKED_SIZE
+                                                                  + THROUGHPUT_DUPLEX_PACKED_SIZE,
+                                                                  evt->data.evt_gatt_characteristic_value.value.len
+                                                                  - 4 - THROUGHPUT_SEQUENCE_PACKED_SIZE
+                                                                  - THROUGHPUT_DUPLEX_PACKED_SIZE,
+                                                                  &link->peer_latency);
+          if (link->state == THROUGHPUT_STATE_TEST) {
+            handle_throughput_central_stop(link, false);
+          }
         }
         break;
+      } else if (evt->data.evt_gatt_characteristic_value.characteristic == link->pipeline_handle) {
+        check_received_segment(link,
+                               evt->data.evt_gatt_characteristic_value.value.data,
+                               evt->data.evt_gatt_characteristic_value.value.len);
+        break;
+      } else if (evt->data.evt_gatt_characteristic_value.characteristic == link->echo_handle) {
+        check_echo(link,
+                   evt->data.evt_gatt_characteristic_value.value.data,
+                   evt->data.evt_gatt_characteristic_value.value.len);
+        break;
       }
 
-      if (evt->data.evt_gatt_characteristic_value.characteristic == indications_handle
-          || evt->data.evt_gatt_characteristic_value.characteristic == notifications_handle) {
+      if (evt->data.evt_gatt_characteristic_value.characteristic == link->indications_handle
+          || evt->data.evt_gatt_characteristic_value.characteristic == link->notifications_handle) {
         // Send confirmation if needed
-        if (evt->data.evt_gatt_characteristic_value.characteristic == indications_handle) {
+        if (evt->data.evt_gatt_characteristic_value.characteristic == link->indications_handle) {
           if (evt->data.evt_gatt_characteristic_value.att_opcode == gatt_handle_value_indication) {
             sl_bt_gatt_send_characteristic_confirmation(evt->data.evt_gatt_characteristic_value.connection);
+            check_indication_spacing(link);
           }
         }
-        // Check data for loss or error
-        check_received_data(evt->data.evt_gatt_characteristic_value.value.data,
-                            evt->data.evt_gatt_characteristic_value.value.len);
-        bytes_received += (evt->data.evt_gatt_characteristic_value.value.len);
-        if (central_state.data_size != evt->data.evt_gatt_characteristic_value.value.len) {
-          central_state.data_size = evt->data.evt_gatt_characteristic_value.value.len;
-          throughput_central_on_data_size_change(central_state.data_size);
-        }
-        operation_count++;
-        // Fixed data mode
-        if (central_state.mode == THROUGHPUT_MODE_FIXED_LENGTH && bytes_received >= (fixed_data_size)) {
-          finish_test = true;
-        }
+        check_received_value(link,
+                             evt->data.evt_gatt_characteristic_value.value.data,
+                             evt->data.evt_gatt_characteristic_value.value.len);
+      }
+      break;
+    case sl_bt_evt_l2cap_coc_connection_response_id:
+      link = throughput_central_find_link(evt->data.evt_l2cap_coc_connection_response.connection);
+      if (link == NULL) {
+        break;
+      }
+      if (evt->data.evt_l2cap_coc_connection_response.l2cap_errorcode == sl_bt_l2cap_connection_successful) {
+        link->l2cap_cid = evt->data.evt_l2cap_coc_connection_response.destination_cid;
+        link->l2cap_credits_used = 0;
+        throughput_l2cap_rx_init(&link->l2cap_rx, link->l2cap_rx.buffer, link->l2cap_rx.size);
+      } else {
+        l2cap_sdu_release(link);
+      }
+      break;
+    case sl_bt_evt_l2cap_coc_channel_disconnected_id:
+      link = throughput_central_find_link(evt->data.evt_l2cap_coc_channel_disconnected.connection);
+      if (link == NULL) {
+        break;
+      }
+      link->l2cap_cid = 0;
+      l2cap_sdu_release(link);
+      break;
+    case sl_bt_evt_l2cap_coc_data_id:
+      link = throughput_central_find_link(evt->data.evt_l2cap_coc_data.connection);
+      if (link == NULL || link->l2cap_cid == 0) {
+        break;
       }
+      check_received_pdu(link,
+                         evt->data.evt_l2cap_coc_data.data.data,
+                         evt->data.evt_l2cap_coc_data.data.len);
       break;
     case sl_bt_evt_gatt_mtu_exchanged_id:
-      central_state.mtu_size = evt->data.evt_gatt_mtu_exchanged.mtu;
-      throughput_central_on_connection_settings_change(central_state.pdu_size,
-                                                       central_state.mtu_size);
+      link = throughput_central_find_link(evt->data.evt_gatt_mtu_exchanged.connection);
+      if (link == NULL) {
+        break;
+      }
+      link->mtu_size = evt->data.evt_gatt_mtu_exchanged.mtu;
+      throughput_central_on_connection_settings_change(link->pdu_size,
+                                                       link->mtu_size);
       break;
 
     case sl_bt_evt_connection_phy_status_id:
-      central_state.phy = (throughput_phy_t)evt->data.evt_connection_phy_status.phy;
-      throughput_central_on_phy_change(central_state.phy);
+      link = throughput_central_find_link(evt->data.evt_connection_phy_status.connection);
+      if (link == NULL) {
+        break;
+      }
+      link->phy = (throughput_phy_t)evt->data.evt_connection_phy_status.phy;
+      throughput_adapt_phy_update(&link->adapt, link->phy);
+      central_state.phy = link->phy;
+      throughput_central_on_phy_change(link->phy);
       break;
 
     case sl_bt_evt_connection_closed_id:
-      // Stop RSSI refresh timer
-      timer_refresh_rssi_stop();
+      link = throughput_central_find_link(evt->data.evt_connection_closed.connection);
+      if (link == NULL) {
+        break;
+      }
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+      if (soak_running) {
+        // Counted up to the disconnect, the test resumes after a reconnect
+        throughput_central_soak_collect(link);
+        soak.disconnects++;
+      }
+#endif
+      throughput_central_close_link(link);
+      if (throughput_central_link_count() == 0) {
+        // Stop RSSI refresh timer
+        timer_refresh_rssi_stop();
+        restart_pending = false;
+      }
       // Notify state change
-      central_state.state = THROUGHPUT_STATE_DISCONNECTED;
-      throughput_central_on_state_change(central_state.state);
-      central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_IDLE;
-      throughput_central_on_discovery_state_change(central_state.discovery_state);
-      // Reset variables
-      reset_variables();
+      throughput_central_update_state();
+      throughput_central_on_discovery_state_change(link->discovery_state);
+      // Results of the remaining links are reported without this one
+      throughput_central_check_run_finished();
       // Start scanning
-      throughput_central_scanning_start();
+      throughput_central_scanning_resume();
       break;
     case sl_bt_evt_connection_rssi_id:
-      central_state.rssi = evt->data.evt_connection_rssi.rssi;
-      throughput_central_on_rssi_change(central_state.rssi);
+      link = throughput_central_find_link(evt->data.evt_connection_rssi.connection);
+      if (link == NULL) {
+        break;
+      }
+      link->rssi = evt->data.evt_connection_rssi.rssi;
+      throughput_adapt_rssi(&link->adapt, link->rssi);
+      // Refreshed for the history during tests, reported between them
+      if (link->state == THROUGHPUT_STATE_TEST) {
+        break;
+      }
+      central_state.rssi = link->rssi;
+      throughput_central_on_rssi_change(link->rssi);
       break;
 
     default:
       break;
   }
 }
+
+/**************************************************************************//**
+ * Bluetooth stack event handler called with every event.
+ * This overrides the dummy weak implementation.
+ *
+ * @param[in] evt Event coming from the Bluetooth stack.
+ *****************************************************************************/
+void bt_on_event_central(sl_bt_msg_t *evt)
+{
+  #ifdef SL_CATALOG_BLUETOOTH_PRESENT
+  // The subscribed events arrive through throughput_event_dispatch()
+  (void)evt;
+  #else
+  throughput_central_on_event(evt);
+  #endif // SL_CATALOG_BLUETOOTH_PRESENT
+}
+
 /***************************************************************************//**
- * Checks received data for lost or error packages
- * @param[in] data received data
- * @param[in] len length of the data
+ * Opens a connection towards a matching peripheral.
+ * @param[in] report scan report of the peripheral
  ******************************************************************************/
-static void check_received_data(uint8_t * data, uint8_t len)
+static void throughput_central_connect(sl_bt_evt_scanner_scan_report_t *report)
 {
-  uint8_t counter;
+  sl_status_t sc;
+  uint8_t connection = CONNECTION_HANDLE_INVALID;
 
-  if (len == 0) {
-    central_state.packet_error++;
+  if (throughput_central_link_count() >= THROUGHPUT_CENTRAL_MAX_CONNECTIONS
+      || throughput_central_is_connecting()) {
     return;
   }
 
-  counter = data[0];
+  // Stop scanning
+  sc = sl_bt_scanner_stop();
+  app_assert_status(sc);
 
-  if (first_packet) {
-    // Accept remote counter
-    received_counter = counter;
-    first_packet = false;
-  } else {
-    // Increment local counter
-    received_counter = (received_counter + 1) % 100;
-  }
-  if (counter != received_counter) {
-    // Lost packet is found
-    uint8_t lost_packet_count = 0;
-    // Calculate lost packet count
-    if (counter > received_counter) {
-      lost_packet_count = counter - received_counter;
-    } else if (counter < received_counter) {
-      lost_packet_count = 100 + counter - received_counter;
-    }
-    central_state.packet_lost += lost_packet_count;
-    // Sync to remote counter
-    received_counter = counter;
-  }
+  // Open the connection
+  central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_CONN;
+  throughput_central_on_discovery_state_change(central_state.discovery_state);
+
+  sc = sl_bt_connection_open(report->address,
+                             report->address_type,
+                             central_state.phy,
+                             &connection);
+
+  // Handle if the default PHY is not supported
+  if (sc == SL_STATUS_INVALID_PARAMETER) {
+    app_log_status_warning_f(sc, "Connection PHY is not supported and set to 1M PHY" APP_LOG_NEW_LINE);
+
+    central_state.phy = sl_bt_gap_1m_phy_uncoded;
+    sc = sl_bt_connection_open(report->address,
+                               report->address_type,
+                               central_state.phy,
+                               &connection);
+  }
+  // Assertion to first or second attempt to connect
+  app_assert_status(sc);
+
+  if (sc == SL_STATUS_OK) {
+    (void)throughput_central_open_link(connection, &report->address);
+  }
+}
+
+/***************************************************************************//**
+ * Checks received data for lost or error packages
+ * @param[in] link link the data was received on
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void check_received_data(throughput_central_link_t *link,
+                                uint8_t * data,
+                                uint16_t len)
+{
+  if (len < THROUGHPUT_SEQUENCE_SIZE) {
+    link->packet_error++;
+    return;
+  }
+  (void)throughput_sequence_rx_accept(&link->sequence_rx, throughput_sequence_read(data));
+  link->packet_lost = link->sequence_rx.stats.lost;
 
   // Check data for bit errors
-  for (int i = 1; i < len; i++) {
-    if ( data[i] != (uint8_t) 'a' + (uint8_t) ((i - 1) % 26) ) {
-      central_state.packet_error++;
+  if (!throughput_sequence_check_packet(data, len, &rx_pattern, &link->pattern_stats)) {
+    link->packet_error++;
+  }
+}
+
+/***************************************************************************//**
+ * Unpacks a frame batch and checks it for lost frames or errors
+ * @param[in] link link the data was received on
+ * @param[in] data received data
+ * @param[in] len length of the data
+ * @return false if the data is not a frame batch
+ ******************************************************************************/
+static bool check_received_frames(throughput_central_link_t *link,
+                                  uint8_t * data,
+                                  uint16_t len)
+{
+  const float test_values[THROUGHPUT_FRAME_VALUES] = THROUGHPUT_FRAME_TEST_VALUES;
+  throughput_frame_batch_header_t header;
+  throughput_frame_t frame;
+  throughput_sequence_result_t result;
+  uint32_t gap;
+
+  if (!throughput_frame_batch_parse(data, len, &header)) {
+    return false;
+  }
+
+  result = throughput_sequence_rx_accept(&link->sequence_rx, header.sequence);
+  link->packet_lost = link->sequence_rx.stats.lost;
+  if (result == THROUGHPUT_SEQUENCE_DUPLICATE) {
+    return true;
+  }
+  link->frame_count += header.count;
+
+  // Frame gaps also show samples the peripheral dropped before sending
+  if (result != THROUGHPUT_SEQUENCE_REORDERED && result != THROUGHPUT_SEQUENCE_LATE) {
+    if (link->frame_sequence_valid && header.first_sequence != link->frame_sequence) {
+      gap = header.first_sequence - link->frame_sequence;
+      if (gap < 0x80000000UL) {
+        link->frame_lost += gap;
+      }
+    }
+    link->frame_sequence = header.first_sequence + header.count;
+    link->frame_sequence_valid = true;
+  }
+
+  for (uint8_t i = 0; i < header.count; i++) {
+    throughput_frame_batch_read_frame(data, i, &frame);
+    if (memcmp(frame.values, test_values, sizeof(test_values)) != 0) {
+      link->packet_error++;
       break;
     }
   }
+  return true;
+}
+
+/***************************************************************************//**
+ * Checks a received duplex packet for loss or errors, and accounts its
+ * upstream latency.
+ * @param[in] link link the data was received on
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void check_received_duplex(throughput_central_link_t *link,
+                                  uint8_t * data,
+                                  uint16_t len)
+{
+  uint32_t received = timer_microseconds();
+  uint32_t sent;
+  uint32_t excess;
+
+  if (len < THROUGHPUT_DUPLEX_MIN_SIZE) {
+    link->packet_error++;
+    return;
+  }
+  (void)throughput_sequence_rx_accept(&link->sequence_rx, throughput_sequence_read(data));
+  link->packet_lost = link->sequence_rx.stats.lost;
+
+  if (!throughput_duplex_check_packet(data, len, &rx_pattern, &link->pattern_stats, &sent)) {
+    link->packet_error++;
+  }
+  excess = throughput_duplex_latency_add(&link->up_latency, sent, received);
+  // The peripheral stamps by the central clock once synchronized
+  throughput_latency_add(&link->latency,
+                         link->clock_synced ? throughput_clock_delay(sent, received) : excess);
+}
+
+/***************************************************************************//**
+ * A link runs one test at a time, its latency histogram holds the upstream
+ * latency of a duplex test and the round trip of the probes otherwise.
+ * @param[in] link link to check
+ * @return true if the histogram holds the upstream latency
+ ******************************************************************************/
+static bool latency_is_upstream(const throughput_central_link_t *link)
+{
+  return link->duplex && !link->upload;
+}
+
+/***************************************************************************//**
+ * Size of the downstream packets, split optimally over the over-the-air
+ * packets like the notifications of the peripheral.
+ * @param[in] link link under test
+ * @return packet size, 0 if the link cannot carry duplex packets
+ ******************************************************************************/
+static uint16_t downstream_size(throughput_central_link_t *link)
+{
+  uint16_t size = link->mtu_size - WRITE_GATT_HEADER;
+
+  if (link->pdu_size != 0 && link->pdu_size <= link->mtu_size) {
+    size = (link->pdu_size - (L2CAP_HEADER + WRITE_GATT_HEADER))
+           + ((link->mtu_size - WRITE_GATT_HEADER - link->pdu_size + (L2CAP_HEADER + WRITE_GATT_HEADER))
+              / link->pdu_size * link->pdu_size);
+  } else if (link->pdu_size != 0 && (link->pdu_size - link->mtu_size) <= L2CAP_HEADER) {
+    size = link->pdu_size - (L2CAP_HEADER + WRITE_GATT_HEADER);
+  }
+  if (size > THROUGHPUT_CENTRAL_DATA_SIZE_MAX) {
+    size = THROUGHPUT_CENTRAL_DATA_SIZE_MAX;
+  }
+  return (size >= THROUGHPUT_DUPLEX_MIN_SIZE) ? size : 0;
+}
+
+/***************************************************************************//**
+ * Writes the next downstream packets of a duplex test to the sink until the
+ * stack runs out of buffers. The payload follows the pattern of the upstream.
+ * @param[in] link link under test
+ ******************************************************************************/
+static void send_downstream(throughput_central_link_t *link)
+{
+  sl_status_t sc;
+  uint16_t sent_len;
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_DUPLEX_BURST; i++) {
+    throughput_duplex_write_packet(downstream_data,
+                                   link->down_size,
+                                   link->down_sequence,
+                                   &rx_pattern,
+                                   timer_microseconds());
+    sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                                link->sink_handle,
+                                                                link->down_size,
+                                                                downstream_data,
+                                                                &sent_len);
+    if (sc != SL_STATUS_OK) {
+      // Buffers are full, the packet is written again in the next step
+      if (sc == SL_STATUS_NO_MORE_RESOURCE
+          || sc == SL_STATUS_ALLOCATION_FAILED
+          || sc == SL_STATUS_BT_CTRL_MEMORY_CAPACITY_EXCEEDED) {
+        link->down_stalls++;
+      } else {
+        link->down_failures++;
+      }
+      return;
+    }
+    link->down_sequence++;
+    link->down_bytes += sent_len;
+    link->down_packets++;
+  }
+}
+
+/***************************************************************************//**
+ * Writes the next latency probe to the echo characteristic once the interval
+ * passed since the last one. A probe is in flight until echoed or timed out.
+ * @param[in] link link under test
+ ******************************************************************************/
+static void send_echo_probe(throughput_central_link_t *link)
+{
+  uint8_t probe[THROUGHPUT_CENTRAL_ECHO_PROBE_SIZE];
+  uint32_t now = timer_microseconds();
+  uint16_t sent_len;
+  sl_status_t sc;
+
+  if (link->echo_pending) {
+    if (now - link->echo_time < THROUGHPUT_CENTRAL_ECHO_TIMEOUT) {
+      return;
+    }
+    // A late echo of this probe is ignored
+    link->echo_pending = false;
+    link->echo_sequence++;
+    link->echo_lost++;
+  } else if (now - link->echo_time < echo_interval * 1000) {
+    return;
+  }
+  throughput_sequence_write(probe, link->echo_sequence);
+  throughput_sequence_write(probe + 4, now);
+  sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                              link->echo_handle,
+                                                              sizeof(probe),
+                                                              probe,
+                                                              &sent_len);
+  // Retried in the next step if the stack is out of buffers
+  if (sc == SL_STATUS_OK) {
+    link->echo_pending = true;
+    link->echo_time = now;
+  }
+}
+
+/***************************************************************************//**
+ * Accounts the round trip of an echoed latency probe, and the offset of the
+ * peripheral clock if the echo carries its time.
+ * @param[in] link link the echo was received on
+ * @param[in] data echoed probe
+ * @param[in] len length of the probe
+ ******************************************************************************/
+static void check_echo(throughput_central_link_t *link,
+                       uint8_t * data,
+                       uint16_t len)
+{
+  uint64_t now = timer_microseconds64();
+  uint32_t rtt;
+
+  if (len < THROUGHPUT_CENTRAL_ECHO_PROBE_SIZE
+      || !link->echo_pending
+      || throughput_sequence_read(data) != link->echo_sequence) {
+    return;
+  }
+  link->echo_pending = false;
+  link->echo_sequence++;
+  rtt = (uint32_t)now - throughput_sequence_read(data + 4);
+  throughput_rtt_sample(&link->rtt, rtt);
+  if (link->state == THROUGHPUT_STATE_TEST && !latency_is_upstream(link)) {
+    throughput_latency_add(&link->latency, rtt);
+  }
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+  if (len >= THROUGHPUT_CLOCK_ECHO_SIZE
+      && throughput_clock_add(&link->clock,
+                              now - rtt,
+                              now,
+                              throughput_clock_read(data + THROUGHPUT_CLOCK_PROBE_SIZE),
+                              (uint32_t)link->interval * 1250)) {
+    send_clock_model(link);
+  }
+#endif
+}
+
+/***************************************************************************//**
+ * Samples the round trip from the spacing of the indications of a test. The
+ * peripheral sends the next indication when the confirmation of the previous
+ * one arrives, so the spacing is its indication round trip. A spacing above
+ * the timeout may hold an indication timeout or a refused indication of the
+ * peripheral, and is not taken as a round trip.
+ * @param[in] link link under test
+ ******************************************************************************/
+static void check_indication_spacing(throughput_central_link_t *link)
+{
+  uint32_t now = timer_microseconds();
+
+  if (link->state != THROUGHPUT_STATE_TEST) {
+    return;
+  }
+  if (link->indication_time_valid) {
+    (void)throughput_rtt_sample_inferred(&link->rtt, now - link->indication_time);
+  }
+  link->indication_time = now;
+  link->indication_time_valid = true;
+}
+
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+/***************************************************************************//**
+ * Writes the fitted clock model to the echo characteristic, so the peripheral
+ * stamps its packets by the central clock.
+ * @param[in] link link of the peripheral
+ ******************************************************************************/
+static void send_clock_model(throughput_central_link_t *link)
+{
+  uint8_t model[THROUGHPUT_CLOCK_MODEL_PACKED_SIZE];
+  uint16_t sent_len;
+  sl_status_t sc;
+
+  throughput_clock_pack(&link->clock.model, model);
+  sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                              link->echo_handle,
+                                                              sizeof(model),
+                                                              model,
+                                                              &sent_len);
+  // The next fit is written if the stack is out of buffers
+  if (sc == SL_STATUS_OK) {
+    link->clock_updates++;
+  }
+}
+#endif // THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+
+/***************************************************************************//**
+ * Bytes of a packet left for its content after the integrity trailer.
+ * @param[in] link link the packet was received on
+ * @param[in] len packet length
+ * @return content length
+ ******************************************************************************/
+static uint16_t content_size(throughput_central_link_t *link, uint16_t len)
+{
+  uint8_t trailer = throughput_integrity_size(link->integrity);
+  return (len > trailer) ? (uint16_t)(len - trailer) : 0;
+}
+
+/***************************************************************************//**
+ * Checks a received notification, indication or SDU and adds it to the
+ * results of the test.
+ * @param[in] link link the data was received on
+ * @param[in] len length of the data as received
+ * @param[in] content content of the data, decrypted
+ * @param[in] content_len length of the content, with the integrity trailer
+ * @param[in] intact the data authenticated and its integrity trailer matched,
+ *                   or there is none
+ ******************************************************************************/
+static void account_received_data(throughput_central_link_t *link,
+                                  uint16_t len,
+                                  uint8_t * content,
+                                  uint16_t content_len,
+                                  bool intact)
+{
+  // Check data for loss or error. The content of a packet failing its
+  // integrity check cannot be trusted, its sequence number included.
+  if (!intact) {
+    link->packet_error++;
+  } else if (link->duplex) {
+    check_received_duplex(link, content, content_size(link, content_len));
+  } else if (!check_received_frames(link, content, content_size(link, content_len))) {
+    check_received_data(link, content, content_size(link, content_len));
+  }
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+  if (intact) {
+    throughput_central_export(link,
+                              content,
+                              content_size(link, content_len),
+                              received_sequence(content, content_size(link, content_len)));
+  }
+#endif
+  link->bytes_received += len;
+  if (link->data_size != len) {
+    link->data_size = len;
+    central_state.data_size = link->data_size;
+    throughput_central_on_data_size_change(link->data_size);
+  }
+  link->operation_count++;
+  // Fixed data mode
+  if (central_state.mode == THROUGHPUT_MODE_FIXED_LENGTH && link->bytes_received >= (fixed_data_size)) {
+    link->finish_test = true;
+  }
+}
+
+/***************************************************************************//**
+ * Sequence number a received packet carries.
+ * @param[in] data packet content
+ * @param[in] len length of the content
+ * @return sequence number, 0 if the packet is too short to carry one
+ ******************************************************************************/
+static uint32_t received_sequence(const uint8_t *data, uint16_t len)
+{
+  // Frame batches carry it in the same place
+  if (len < THROUGHPUT_SEQUENCE_SIZE) {
+    return 0;
+  }
+  return throughput_sequence_read(data);
+}
+
+/***************************************************************************//**
+ * Checks a received notification or indication, decrypting it in place first
+ * if the test is encrypted.
+ * @param[in] link link the data was received on
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void check_received_value(throughput_central_link_t *link,
+                                 uint8_t * data,
+                                 uint16_t len)
+{
+  uint8_t *content = data;
+  uint16_t content_len = len;
+  bool intact = true;
+
+  if (link->encrypted) {
+    intact = throughput_crypto_open(&crypto_key, data, len, &link->crypto_stats);
+    content += THROUGHPUT_CRYPTO_HEADER_SIZE;
+    content_len = intact ? (uint16_t)(len - THROUGHPUT_CRYPTO_OVERHEAD) : 0;
+  }
+  intact = intact && throughput_integrity_check(link->integrity,
+                                                content,
+                                                content_len,
+                                                &link->integrity_stats);
+  account_received_data(link, len, content, content_len, intact);
+}
+
+/***************************************************************************//**
+ * Runs the part of the SDU content a PDU completed through the integrity
+ * computation, so the trailer is ready to compare when the last PDU arrives.
+ * @param[in] link link the PDU was received on
+ * @param[in] start SDU bytes received before the PDU
+ * @param[in] sdu_len length of the SDU, with the integrity trailer
+ ******************************************************************************/
+static void check_received_sdu_part(throughput_central_link_t *link,
+                                    uint16_t start,
+                                    uint16_t sdu_len)
+{
+  uint16_t end = link->l2cap_rx.received;
+  uint32_t cycles;
+
+  if (start == 0) {
+    throughput_integrity_start(&link->integrity_ctx, link->integrity);
+  }
+  if (end > content_size(link, sdu_len)) {
+    end = content_size(link, sdu_len);
+  }
+  if (end <= start) {
+    return;
+  }
+  cycles = throughput_integrity_cycles();
+  throughput_integrity_update(&link->integrity_ctx, link->l2cap_rx.buffer + start, end - start);
+  link->integrity_stats.cycles += (uint32_t)(throughput_integrity_cycles() - cycles);
+  link->integrity_stats.bytes += end - start;
+}
+
+/***************************************************************************//**
+ * Reassembles a PDU of the L2CAP channel into an SDU. The credit of the PDU
+ * is returned to the peripheral once half of the credits are used, so the
+ * peripheral is never stalled by a single outstanding credit update.
+ * @param[in] link link the PDU was received on
+ * @param[in] data PDU payload
+ * @param[in] len length of the PDU
+ ******************************************************************************/
+static void check_received_pdu(throughput_central_link_t *link,
+                               uint8_t * data,
+                               uint16_t len)
+{
+  sl_status_t sc;
+  throughput_l2cap_sdu_result_t result;
+  uint16_t start;
+  uint16_t sdu_len;
+  bool intact = true;
+
+  link->l2cap_pdus++;
+  link->l2cap_credits_used++;
+  if (link->l2cap_credits_used >= (THROUGHPUT_CENTRAL_L2CAP_CREDITS + 1) / 2) {
+    sc = sl_bt_l2cap_coc_send_le_flow_control_credit(link->connection,
+                                                      link->l2cap_cid,
+                                                      link->l2cap_credits_used);
+    if (sc == SL_STATUS_OK) {
+      link->l2cap_credits_used = 0;
+    }
+  }
+
+  start = (link->l2cap_rx.length == 0) ? 0 : link->l2cap_rx.received;
+  result = throughput_l2cap_reassemble(&link->l2cap_rx, data, len);
+  if (result == THROUGHPUT_L2CAP_SDU_ERROR) {
+    if (link->state == THROUGHPUT_STATE_TEST) {
+      link->l2cap_sdu_errors++;
+      link->packet_error++;
+    }
+    return;
+  }
+
+  // The SDU is checked as its PDUs arrive, not once it is complete
+  sdu_len = (result == THROUGHPUT_L2CAP_SDU_PARTIAL) ? link->l2cap_rx.length : link->l2cap_rx.received;
+  if (link->integrity != THROUGHPUT_INTEGRITY_NONE) {
+    check_received_sdu_part(link, start, sdu_len);
+  }
+  if (result == THROUGHPUT_L2CAP_SDU_PARTIAL || link->state != THROUGHPUT_STATE_TEST) {
+    return;
+  }
+  if (link->integrity != THROUGHPUT_INTEGRITY_NONE) {
+    if (sdu_len < throughput_integrity_size(link->integrity)) {
+      link->integrity_stats.packets++;
+      link->integrity_stats.failures++;
+      intact = false;
+    } else {
+      intact = throughput_integrity_verify(&link->integrity_ctx,
+                                           link->l2cap_rx.buffer + content_size(link, sdu_len),
+                                           &link->integrity_stats);
+    }
+  }
+  account_received_data(link,
+                        link->l2cap_rx.received,
+                        link->l2cap_rx.buffer,
+                        link->l2cap_rx.received,
+                        intact);
+}
+
+/***************************************************************************//**
+ * Accounts a pipeline segment and acknowledges everything received so far.
+ * Segments arriving ahead of a gap are buffered in the reorder window and
+ * counted once, duplicates of retransmitted segments are dropped.
+ * @param[in] link link the data was received on
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void check_received_segment(throughput_central_link_t *link,
+                                   uint8_t * data,
+                                   uint8_t len)
+{
+  uint8_t ack[THROUGHPUT_PIPELINE_ACK_SIZE];
+  uint16_t sent_len;
+  uint32_t sequence;
+  uint32_t delivered;
+  sl_status_t sc;
+
+  // A segment failing its check is not acknowledged, so it is sent again
+  if (!throughput_integrity_check(link->integrity, data, len, &link->integrity_stats)
+      || !throughput_pipeline_read_segment(data, content_size(link, len), &sequence)) {
+    link->packet_error++;
+    return;
+  }
+
+  switch (throughput_pipeline_rx_accept(&link->pipe_rx, sequence, &delivered)) {
+    case THROUGHPUT_PIPELINE_SEGMENT_EARLY:
+      link->pipe_reordered++;
+    // fall through
+    case THROUGHPUT_PIPELINE_SEGMENT_IN_ORDER:
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+      throughput_central_export(link, data, content_size(link, len), sequence);
+#endif
+      link->bytes_received += len;
+      link->operation_count++;
+      if (link->data_size != len) {
+        link->data_size = len;
+        central_state.data_size = link->data_size;
+        throughput_central_on_data_size_change(link->data_size);
+      }
+      break;
+    case THROUGHPUT_PIPELINE_SEGMENT_DUPLICATE:
+      link->pipe_duplicates++;
+      break;
+    default:
+      link->pipe_dropped++;
+      break;
+  }
+
+  // A lost acknowledgement is covered by the next one
+  throughput_pipeline_write_ack(ack, link->pipe_rx.expected, link->pipe_rx.pending);
+  sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                              link->pipeline_ack_handle,
+                                                              sizeof(ack),
+                                                              ack,
+                                                              &sent_len);
+  (void)sc;
+
+  // Fixed data mode
+  if (central_state.mode == THROUGHPUT_MODE_FIXED_LENGTH && link->bytes_received >= (fixed_data_size)) {
+    link->finish_test = true;
+  }
 }
 
 // Cycle through advertisement contents and look for matching device name.
@@ -428,78 +1918,100 @@ static bool process_scan_response(sl_bt_evt_scanner_scan_report_t *response)
 
 // Helper function to make the discovery and subscribing flow correct.
 // Action enum values indicate which procedure was completed.
-static void process_procedure_complete_event(sl_bt_msg_t *evt)
+static void process_procedure_complete_event(throughput_central_link_t *link,
+                                             sl_bt_msg_t *evt)
 {
   uint16_t procedure_result =  evt->data.evt_gatt_procedure_completed.result;
   sl_status_t sc;
 
-  switch (action) {
+  switch (link->action) {
     case act_discover_service:
-      action = act_none;
+      link->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
         // Discover successful, start characteristic discovery.
-        sc = sl_bt_gatt_discover_characteristics(connection_handle, service_handle);
+        sc = sl_bt_gatt_discover_characteristics(link->connection, link->service_handle);
         app_assert_status(sc);
-        action = act_discover_characteristics;
-        central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_CHARACTERISTICS;
-        throughput_central_on_discovery_state_change(central_state.discovery_state);
+        link->action = act_discover_characteristics;
+        link->discovery_state = THROUGHPUT_DISCOVERY_STATE_CHARACTERISTICS;
+        throughput_central_on_discovery_state_change(link->discovery_state);
       }
       break;
     case act_discover_characteristics:
-      action = act_none;
+      link->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
-        if (characteristic_found.all == THROUGHPUT_CENTRAL_CHARACTERISTICS_ALL) {
-          central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_FINISHED;
-          throughput_central_on_discovery_state_change(central_state.discovery_state);
-          sc = sl_bt_gatt_set_characteristic_notification(connection_handle, notifications_handle, sl_bt_gatt_notification);
+        if (link->characteristic_found.all == THROUGHPUT_CENTRAL_CHARACTERISTICS_ALL) {
+          link->discovery_state = THROUGHPUT_DISCOVERY_STATE_FINISHED;
+          throughput_central_on_discovery_state_change(link->discovery_state);
+          sc = sl_bt_gatt_set_characteristic_notification(link->connection, link->notifications_handle, sl_bt_gatt_notification);
           app_assert_status(sc);
-          action = act_enable_notification;
+          link->action = act_enable_notification;
         }
       }
       break;
     case act_enable_notification:
-      action = act_none;
+      link->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
         // Notifications turned on, turn on indication
-        central_state.notifications = sl_bt_gatt_notification;
-        throughput_central_on_notification_change(central_state.notifications);
-        sl_bt_gatt_set_characteristic_notification(connection_handle, indications_handle, sl_bt_gatt_indication);
-        action = act_enable_indication;
+        link->notifications = sl_bt_gatt_notification;
+        throughput_central_on_notification_change(link->notifications);
+        sl_bt_gatt_set_characteristic_notification(link->connection, link->indications_handle, sl_bt_gatt_indication);
+        link->action = act_enable_indication;
       }
       break;
     case act_enable_indication:
-      action = act_enable_indication;
+      link->action = act_enable_indication;
       app_assert_status(procedure_result);
       if (!procedure_result) {
         // Subscribe to peripheral result.
-        central_state.indications = sl_bt_gatt_indication;
-        throughput_central_on_indication_change(central_state.indications);
-        sc = sl_bt_gatt_set_characteristic_notification(connection_handle, transmission_handle, sl_bt_gatt_notification);
+        link->indications = sl_bt_gatt_indication;
+        throughput_central_on_indication_change(link->indications);
+        sc = sl_bt_gatt_set_characteristic_notification(link->connection, link->transmission_handle, sl_bt_gatt_notification);
         app_assert_status(sc);
-        action = act_enable_transmission_notification;
+        link->action = act_enable_transmission_notification;
       }
       break;
     case act_enable_transmission_notification:
-      action = act_none;
+      link->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
         // Subscribe to peripheral result.
-        sc = sl_bt_gatt_set_characteristic_notification(connection_handle, result_handle, sl_bt_gatt_indication);
+        sc = sl_bt_gatt_set_characteristic_notification(link->connection, link->result_handle, sl_bt_gatt_indication);
         app_assert_status(sc);
-        action = act_subscribe_result;
+        link->action = act_subscribe_result;
       }
       break;
     case act_subscribe_result:
-      action = act_none;
+      link->action = act_none;
+      app_assert_status(procedure_result);
+      if (!procedure_result) {
+        if (THROUGHPUT_CENTRAL_PIPELINE_ENABLE
+            && link->pipeline_handle != 0xFFFF
+            && link->pipeline_ack_handle != 0xFFFF) {
+          // Peripheral supports pipelining, subscribe to the segments.
+          sc = sl_bt_gatt_set_characteristic_notification(link->connection, link->pipeline_handle, sl_bt_gatt_notification);
+          app_assert_status(sc);
+          link->action = act_enable_pipeline;
+        } else {
+          subscribe_echo(link);
+        }
+      }
+      break;
+    case act_enable_pipeline:
+      link->action = act_none;
+      app_assert_status(procedure_result);
+      if (!procedure_result) {
+        subscribe_echo(link);
+      }
+      break;
+    case act_enable_echo:
+      link->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
-        central_state.state = THROUGHPUT_STATE_SUBSCRIBED;
-        throughput_central_on_state_change(central_state.state);
-        // Start RSSI refresh timer
-        timer_refresh_rssi_start();
+        link->echo_subscribed = true;
+        finish_subscription(link);
       }
       break;
     case act_none:
@@ -509,53 +2021,170 @@ static void process_procedure_complete_event(sl_bt_msg_t *evt)
   }
 }
 
+// Subscribes to the echo of the latency probes if the peripheral has one.
+static void subscribe_echo(throughput_central_link_t *link)
+{
+  sl_status_t sc;
+
+  if (link->echo_handle != 0xFFFF) {
+    sc = sl_bt_gatt_set_characteristic_notification(link->connection, link->echo_handle, sl_bt_gatt_notification);
+    app_assert_status(sc);
+    link->action = act_enable_echo;
+  } else {
+    finish_subscription(link);
+  }
+}
+
+// Subscription to all characteristics completed, the link is ready for tests.
+static void finish_subscription(throughput_central_link_t *link)
+{
+  sl_status_t sc;
+
+  if (THROUGHPUT_CENTRAL_L2CAP_ENABLE && link->l2cap_cid == 0) {
+    // Channel tests are not offered on this link if the peripheral refuses
+    if (l2cap_sdu_acquire(link)) {
+      sc = sl_bt_l2cap_coc_send_connection_request(link->connection,
+                                                   THROUGHPUT_L2CAP_PSM,
+                                                   THROUGHPUT_CENTRAL_L2CAP_MTU,
+                                                   THROUGHPUT_CENTRAL_L2CAP_MPS,
+                                                   THROUGHPUT_CENTRAL_L2CAP_CREDITS);
+      if (sc != SL_STATUS_OK) {
+        l2cap_sdu_release(link);
+        app_log_status_warning_f(sc, "L2CAP channel is not available" APP_LOG_NEW_LINE);
+      }
+    } else {
+      app_log_warning("L2CAP channels are all in use" APP_LOG_NEW_LINE);
+    }
+  }
+  link->state = THROUGHPUT_STATE_SUBSCRIBED;
+  central_state.notifications = link->notifications;
+  central_state.indications = link->indications;
+  throughput_central_update_state();
+  // Start RSSI refresh timer
+  timer_refresh_rssi_start();
+}
+
 // Check if found characteristic matches the UUIDs that we are searching for.
-static void check_characteristic_uuid(sl_bt_msg_t *evt)
+static void check_characteristic_uuid(throughput_central_link_t *link,
+                                      sl_bt_msg_t *evt)
 {
   if (evt->data.evt_gatt_characteristic.uuid.len == UUID_LEN) {
     if (memcmp(notifications_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      notifications_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.notification = true;
-      throughput_central_on_characteristics_found(characteristic_found);
+      link->notifications_handle = evt->data.evt_gatt_characteristic.characteristic;
+      link->characteristic_found.characteristic.notification = true;
+      throughput_central_on_characteristics_found(link->characteristic_found);
     } else if (memcmp(indications_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      indications_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.indication = true;
-      throughput_central_on_characteristics_found(characteristic_found);
+      link->indications_handle = evt->data.evt_gatt_characteristic.characteristic;
+      link->characteristic_found.characteristic.indication = true;
+      throughput_central_on_characteristics_found(link->characteristic_found);
     } else if (memcmp(transmission_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      transmission_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.transmission_on = true;
-      throughput_central_on_characteristics_found(characteristic_found);
+      link->transmission_handle = evt->data.evt_gatt_characteristic.characteristic;
+      link->characteristic_found.characteristic.transmission_on = true;
+      throughput_central_on_characteristics_found(link->characteristic_found);
     } else if (memcmp(result_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      result_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.result = true;
-      throughput_central_on_characteristics_found(characteristic_found);
+      link->result_handle = evt->data.evt_gatt_characteristic.characteristic;
+      link->characteristic_found.characteristic.result = true;
+      throughput_central_on_characteristics_found(link->characteristic_found);
+    } else if (memcmp(pipeline_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
+      link->pipeline_handle = evt->data.evt_gatt_characteristic.characteristic;
+    } else if (memcmp(pipeline_ack_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
+      link->pipeline_ack_handle = evt->data.evt_gatt_characteristic.characteristic;
+    } else if (memcmp(sink_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
+      link->sink_handle = evt->data.evt_gatt_characteristic.characteristic;
+    } else if (memcmp(echo_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
+      link->echo_handle = evt->data.evt_gatt_characteristic.characteristic;
     }
   }
 }
 
-static void reset_variables(void)
+// Lend a free SDU reassembly buffer to the link, false if all are in use.
+static bool l2cap_sdu_acquire(throughput_central_link_t *link)
 {
-  connection_handle = 0xFF;
-  service_handle = 0xFFFFFFFF;
-  notifications_handle = 0xFFFF;
-  indications_handle = 0xFFFF;
-  transmission_handle = 0xFFFF;
-  characteristic_found.all = 0;
-
-  bytes_received = 0;
-  operation_count = 0;
-
-  received_counter = 0;
-  first_packet = true;
+#if THROUGHPUT_CENTRAL_L2CAP_ENABLE
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_L2CAP_CHANNELS; i++) {
+    if (l2cap_sdu_owner[i] == NULL) {
+      l2cap_sdu_owner[i] = link;
+      throughput_l2cap_rx_init(&link->l2cap_rx, l2cap_sdu[i], sizeof(l2cap_sdu[i]));
+      return true;
+    }
+  }
+#else
+  (void)link;
+#endif
+  return false;
+}
 
-  central_state.notifications = sl_bt_gatt_disable;
-  central_state.indications = sl_bt_gatt_disable;
+// Return the SDU reassembly buffer of the link, if it holds one.
+static void l2cap_sdu_release(throughput_central_link_t *link)
+{
+#if THROUGHPUT_CENTRAL_L2CAP_ENABLE
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_L2CAP_CHANNELS; i++) {
+    if (l2cap_sdu_owner[i] == link) {
+      l2cap_sdu_owner[i] = NULL;
+    }
+  }
+#endif
+  throughput_l2cap_rx_init(&link->l2cap_rx, NULL, 0);
+}
 
-  central_state.throughput = 0;
-  central_state.throughput_peripheral_side = 0;
-  central_state.count = 0;
-  central_state.packet_error = 0;
-  central_state.packet_lost = 0;
+static void reset_variables(throughput_central_link_t *link)
+{
+  link->service_handle = 0xFFFFFFFF;
+  link->notifications_handle = 0xFFFF;
+  link->indications_handle = 0xFFFF;
+  link->transmission_handle = 0xFFFF;
+  link->result_handle = 0xFFFF;
+  link->pipeline_handle = 0xFFFF;
+  link->pipeline_ack_handle = 0xFFFF;
+  link->sink_handle = 0xFFFF;
+  link->echo_handle = 0xFFFF;
+  link->echo_subscribed = false;
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+  throughput_clock_init(&link->clock,
+                        link->clock_samples,
+                        sizeof(link->clock_samples) / sizeof(link->clock_samples[0]));
+#endif
+  link->clock_updates = 0;
+  link->clock_synced = false;
+  link->characteristic_found.all = 0;
+  link->action = act_none;
+
+  link->bytes_received = 0;
+  link->operation_count = 0;
+
+  throughput_sequence_rx_reset(&link->sequence_rx);
+  memset(&link->pattern_stats, 0, sizeof(link->pattern_stats));
+  memset(&link->integrity_stats, 0, sizeof(link->integrity_stats));
+  memset(&link->crypto_stats, 0, sizeof(link->crypto_stats));
+  link->peer_sequence_valid = false;
+  link->duplex = false;
+  link->upload = false;
+  link->peer_duplex_valid = false;
+  link->frame_count = 0;
+  link->frame_lost = 0;
+  link->frame_sequence = 0;
+  link->frame_sequence_valid = false;
+  throughput_pipeline_rx_reset(&link->pipe_rx);
+  link->pipe_reordered = 0;
+  link->pipe_duplicates = 0;
+  link->pipe_dropped = 0;
+  link->l2cap_cid = 0;
+  link->l2cap_credits_used = 0;
+  link->l2cap_pdus = 0;
+  link->l2cap_sdu_errors = 0;
+  l2cap_sdu_release(link);
+  throughput_latency_init(&link->latency,
+                          link->latency_buckets,
+                          sizeof(link->latency_buckets) / sizeof(link->latency_buckets[0]));
+
+  link->notifications = sl_bt_gatt_disable;
+  link->indications = sl_bt_gatt_disable;
+
+  link->throughput = 0;
+  link->throughput_peripheral_side = 0;
+  link->count = 0;
+  link->packet_error = 0;
+  link->packet_lost = 0;
 }
 
 bool throughput_central_decode_address(char * addess_str, uint8_t *address)
@@ -677,6 +2306,7 @@ bool throughput_address_compare(uint8_t *address1, uint8_t *address2)
   return ret_val;
 }
 
+
 // Stop scanning
 void throughput_central_scanning_stop(void)
 {
@@ -700,7 +2330,7 @@ sl_status_t throughput_central_apply_phy(throughput_phy_t phy)
   if (sc == SL_STATUS_OK) {
     central_state.scan_phy = phy;
   }
-  throughput_central_scanning_start();
+  throughput_central_scanning_resume();
   return sc;
 }
 
@@ -710,35 +2340,35 @@ void throughput_central_scanning_start(void)
   sl_status_t sc;
   int16_t tx_power_min, tx_power_max;
 
-  // if the power is greater than 10 dBm AFH must be used
-  uint32_t afh_bit = (central_state.tx_power_requested > 10);
-  sc = sl_bt_system_linklayer_configure(CONFIG_KEY_SET_AFH,
-                                        sizeof(afh_bit),
-                                        (uint8_t *)&afh_bit);
-  app_assert_status(sc);
+  // Radio settings can only be changed while there are no connections
+  if (throughput_central_link_count() == 0) {
+    // if the power is greater than 10 dBm AFH must be used
+    uint32_t afh_bit = (central_state.tx_power_requested > 10);
+    sc = sl_bt_system_linklayer_configure(CONFIG_KEY_SET_AFH,
+                                          sizeof(afh_bit),
+                                          (uint8_t *)&afh_bit);
+    app_assert_status(sc);
 
-  app_log_info("Scanning started..." APP_LOG_NEW_LINE);
+    // Convert power to mdBm
+    int16_t power = ( ((int16_t)central_state.tx_power_requested) * 10);
+    sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
+                                   power,
+                                   &tx_power_min,
+                                   &tx_power_max);
+    app_assert_status(sc);
+    central_state.tx_power = tx_power_max / 10;
+    throughput_central_on_transmit_power_change(central_state.tx_power);
+
+    sc = sl_bt_gatt_server_set_max_mtu(central_state.mtu_size, &(central_state.mtu_size));
+    app_assert_status(sc);
+  }
 
-  // Reset found characteristics
-  characteristic_found.all = 0;
+  app_log_info("Scanning started..." APP_LOG_NEW_LINE);
 
   // Reset discovery state
   central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_SCAN;
   throughput_central_on_discovery_state_change(central_state.discovery_state);
 
-  // Convert power to mdBm
-  int16_t power = ( ((int16_t)central_state.tx_power_requested) * 10);
-  sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
-                                 power,
-                                 &tx_power_min,
-                                 &tx_power_max);
-  app_assert_status(sc);
-  central_state.tx_power = tx_power_max / 10;
-  throughput_central_on_transmit_power_change(central_state.tx_power);
-
-  sc = sl_bt_gatt_server_set_max_mtu(central_state.mtu_size, &(central_state.mtu_size));
-  app_assert_status(sc);
-
   // Set passive scanning on selected PHY
   // Check if scanning phy is supported by setting mode
   sc = sl_bt_scanner_set_mode(central_state.scan_phy, SCAN_PASSIVE);
@@ -761,15 +2391,49 @@ void throughput_central_scanning_start(void)
   app_assert_status(sc);
 }
 
-float throughput_central_calculate(throughput_value_t *throughput)
+// Resume scanning if there is room for another peripheral
+void throughput_central_scanning_resume(void)
 {
-  float time_elapsed;
+  if (!enabled
+      || restart_pending
+      || central_state.discovery_state == THROUGHPUT_DISCOVERY_STATE_SCAN
+      || throughput_central_is_connecting()) {
+    return;
+  }
+  if (throughput_central_link_count() < THROUGHPUT_CENTRAL_MAX_CONNECTIONS) {
+    throughput_central_scanning_start();
+  } else if (central_state.discovery_state != THROUGHPUT_DISCOVERY_STATE_IDLE) {
+    // All links are in use
+    central_state.discovery_state = THROUGHPUT_DISCOVERY_STATE_IDLE;
+    throughput_central_on_discovery_state_change(central_state.discovery_state);
+  }
+}
 
-  time_elapsed = timer_end();
+float throughput_central_calculate(throughput_value_t *throughput)
+{
+  float time_elapsed = 0.0f;
+  float link_elapsed;
+  throughput_value_t sum = 0;
+
+  // Receive rates of concurrent links add up
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID
+        || link->state != THROUGHPUT_STATE_TEST) {
+      continue;
+    }
+    if (link->throughput_calculated) {
+      link_elapsed = (float)link->time;
+    } else {
+      link_elapsed = throughput_central_link_calculate(link);
+    }
+    sum += link->throughput;
+    if (link_elapsed > time_elapsed) {
+      time_elapsed = link_elapsed;
+    }
+  }
   central_state.time = (throughput_time_t)time_elapsed;
-  central_state.throughput = (throughput_value_t)((float)bytes_received
-                                                  * 8
-                                                  / time_elapsed);
+  central_state.throughput = sum;
 
   if (throughput != NULL) {
     *throughput = central_state.throughput;
@@ -779,7 +2443,8 @@ float throughput_central_calculate(throughput_value_t *throughput)
 }
 
 // Finish reception
-void handle_throughput_central_stop(bool send_transmission_on)
+void handle_throughput_central_stop(throughput_central_link_t *link,
+                                    bool send_transmission_on)
 {
   sl_status_t sc;
   uint8_t value = TRANSMISSION_OFF;
@@ -787,86 +2452,189 @@ void handle_throughput_central_stop(bool send_transmission_on)
   float time_elapsed = 0.0f;
 
   // Calculate throughput
-  if (!throughput_calculated) {
-    time_elapsed = throughput_central_calculate(NULL);
-    throughput_calculated = true;
+  if (!link->throughput_calculated) {
+    time_elapsed = throughput_central_link_calculate(link);
+    link->throughput_calculated = true;
   }
 
   if (send_transmission_on) {
-    finish_time = time_elapsed;
+    link->finish_time = time_elapsed;
+    link->stop_requested = true;
 
     // Triggers the data transmission end on remote
-    sc = sl_bt_gatt_write_characteristic_value_without_response(connection_handle,
-                                                                transmission_handle,
+    sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                                link->transmission_handle,
                                                                 1,
                                                                 &value,
                                                                 &sent_len);
     app_assert_status(sc);
   } else {
-    finish_test = false;
-    finish_time = 0;
+    link->finish_test = false;
+    link->stop_requested = false;
+    link->finish_time = 0;
 
     #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
-    if (!deep_sleep_enabled) {
+    if (link->em1_requested) {
       // Enable sleep
       sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
     }
     #endif
+    link->em1_requested = false;
+
+    // Holes still in the window are final now
+    throughput_sequence_rx_finish(&link->sequence_rx);
+    link->packet_lost = link->sequence_rx.stats.lost;
+    link->count = link->operation_count;
+    throughput_central_on_link_finish(link->connection,
+                                      link->throughput,
+                                      link->count,
+                                      link->packet_lost,
+                                      link->packet_error,
+                                      link->time);
+
+    aggregate_throughput += link->throughput;
+    aggregate_throughput_peripheral_side += link->throughput_peripheral_side;
+    aggregate_count += link->count;
+    aggregate_lost += link->packet_lost;
+    aggregate_error += link->packet_error;
+    if (link->time > aggregate_time) {
+      aggregate_time = link->time;
+    }
 
-    central_state.count = operation_count;
-    throughput_central_on_finish(central_state.throughput,
-                                 central_state.count,
-                                 central_state.packet_lost,
-                                 central_state.packet_error,
-                                 central_state.time);
-    central_state.state = THROUGHPUT_STATE_SUBSCRIBED;
-    throughput_central_on_state_change(central_state.state);
-
-    // Start RSSI refresh timer
-    timer_refresh_rssi_start();
+    link->state = THROUGHPUT_STATE_SUBSCRIBED;
+    throughput_central_update_state();
+    throughput_central_check_run_finished();
   }
 }
 
 // Start reception
-void handle_throughput_central_start(bool send_transmission_on)
+void handle_throughput_central_start(throughput_central_link_t *link,
+                                     bool send_transmission_on)
 {
   uint8_t value;
   uint16_t sent_len;
   sl_status_t sc;
 
-  // Set test type
-  value = central_state.test_type;
+  // Set test type, and the integrity trailer and encryption if the central
+  // starts the test. Channel tests are sent in the clear.
+  if (send_transmission_on) {
+    link->integrity = integrity_type;
+    link->encrypted = crypto_enabled
+                      && throughput_crypto_supported()
+                      && !(central_state.test_type & THROUGHPUT_TEST_L2CAP);
+    // A peripheral without a sink runs the plain notification test
+    link->duplex = (central_state.test_type == THROUGHPUT_TEST_DUPLEX
+                    || central_state.test_type == THROUGHPUT_TEST_UPLOAD)
+                   && link->sink_handle != 0xFFFF;
+    link->upload = link->duplex && (central_state.test_type == THROUGHPUT_TEST_UPLOAD);
+  }
+  link->down_size = link->duplex ? downstream_size(link) : 0;
+  link->duplex = link->down_size > 0;
+  link->upload = link->upload && link->duplex;
+  value = central_state.test_type & ~THROUGHPUT_DUPLEX_FLAG;
+  if (link->duplex) {
+    value |= THROUGHPUT_DUPLEX_FLAG;
+  } else if (value == sl_bt_gatt_disable) {
+    value = sl_bt_gatt_notification;
+  }
+  value |= throughput_integrity_encode(link->integrity)
+           | (link->encrypted ? THROUGHPUT_CRYPTO_FLAG : 0);
+
+  if (!run_active) {
+    // First link of a new run, results are collected from here on
+    run_active = true;
+    aggregate_throughput = 0;
+    aggregate_throughput_peripheral_side = 0;
+    aggregate_count = 0;
+    aggregate_lost = 0;
+    aggregate_error = 0;
+    aggregate_time = 0;
+    central_state.throughput = 0;
+    central_state.count = 0;
+    central_state.packet_error = 0;
+    central_state.packet_lost = 0;
+
+    // Start timer
+    timer_start();
+    throughput_central_on_start();
+  }
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  // The soak counts the last test up to here, the counters start over
+  if (soak_running) {
+    throughput_central_soak_collect(link);
+  }
+#endif
 
   // Clear results
-  central_state.throughput = 0;
-  central_state.count = 0;
-  central_state.packet_error = 0;
-  central_state.packet_lost = 0;
+  link->throughput = 0;
+  link->throughput_peripheral_side = 0;
+  link->count = 0;
+  link->packet_error = 0;
+  link->packet_lost = 0;
 
   // Clear counters
-  bytes_received = 0;
-  operation_count = 0;
-
-  received_counter = 0;
-  first_packet = true;
-
-  throughput_calculated = false;
-
-  // Stop RSSI refresh timer
-  timer_refresh_rssi_stop();
+  link->bytes_received = 0;
+  link->operation_count = 0;
+
+  throughput_sequence_rx_reset(&link->sequence_rx);
+  memset(&link->pattern_stats, 0, sizeof(link->pattern_stats));
+  memset(&link->integrity_stats, 0, sizeof(link->integrity_stats));
+  memset(&link->crypto_stats, 0, sizeof(link->crypto_stats));
+  link->peer_sequence_valid = false;
+  link->frame_count = 0;
+  link->frame_lost = 0;
+  link->frame_sequence = 0;
+  link->frame_sequence_valid = false;
+  throughput_pipeline_rx_reset(&link->pipe_rx);
+  link->pipe_reordered = 0;
+  link->pipe_duplicates = 0;
+  link->pipe_dropped = 0;
+  link->l2cap_pdus = 0;
+  link->l2cap_sdu_errors = 0;
+  link->down_sequence = 0;
+  link->down_bytes = 0;
+  link->down_packets = 0;
+  link->down_stalls = 0;
+  link->down_failures = 0;
+  link->down_throughput = 0;
+  throughput_duplex_latency_reset(&link->up_latency);
+  link->peer_duplex_valid = false;
+  throughput_latency_reset(&link->latency);
+  link->peer_latency_valid = false;
+  link->echo_pending = false;
+  link->echo_lost = 0;
+  link->echo_time = timer_microseconds() - echo_interval * 1000;
+  link->clock_synced = link->clock_updates > 0;
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  memset(&link->history_last, 0, sizeof(link->history_last));
+#endif
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  memset(&link->soak_last, 0, sizeof(link->soak_last));
+#endif
+  memset(&link->tune_last, 0, sizeof(link->tune_last));
+  memset(&link->adapt_last, 0, sizeof(link->adapt_last));
+  link->indication_time_valid = false;
+
+  link->throughput_calculated = false;
+  link->finish_test = false;
+  link->stop_requested = false;
+  link->finish_time = 0;
+  link->time_start = timer_end();
 
   // Manage power
   #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
-  if (!deep_sleep_enabled) {
+  if (!deep_sleep_enabled && !link->em1_requested) {
     // Disable sleep
     sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+    link->em1_requested = true;
   }
   #endif
 
   if (send_transmission_on) {
     // This triggers the data transmission on remote side
-    sc = sl_bt_gatt_write_characteristic_value_without_response(connection_handle,
-                                                                transmission_handle,
+    sc = sl_bt_gatt_write_characteristic_value_without_response(link->connection,
+                                                                link->transmission_handle,
                                                                 1,
                                                                 &value,
                                                                 &sent_len);
@@ -874,12 +2642,8 @@ void handle_throughput_central_start(bool send_transmission_on)
   }
 
   // Set state and call back
-  central_state.state = THROUGHPUT_STATE_TEST;
-  throughput_central_on_state_change(central_state.state);
-  throughput_central_on_start();
-
-  // Start timer
-  timer_start();
+  link->state = THROUGHPUT_STATE_TEST;
+  throughput_central_update_state();
 }
 
 // Restart scanning
@@ -887,23 +2651,27 @@ void throughput_central_scanning_restart(void)
 {
   sl_status_t sc;
 
-  bool close_required =  (central_state.state != THROUGHPUT_STATE_DISCONNECTED);
+  bool close_required = (throughput_central_link_count() != 0);
 
   if (!enabled) {
     return;
   }
+  throughput_central_scanning_stop();
   if (close_required) {
-    sc = sl_bt_connection_close(connection_handle);
-    app_assert_status(sc);
-  } else {
-    throughput_central_scanning_stop();
+    // Scanning is restarted with the new settings once all links are closed
+    restart_pending = true;
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      if (links[i].connection != CONNECTION_HANDLE_INVALID) {
+        sc = sl_bt_connection_close(links[i].connection);
+        app_assert_status(sc);
+      }
+    }
   }
 
-  memset(notification_data, 0, THROUGHPUT_CENTRAL_DATA_SIZE_MAX);
-  memset(indication_data, 0, THROUGHPUT_CENTRAL_DATA_SIZE_MAX);
-
   central_state.state         = THROUGHPUT_STATE_DISCONNECTED;
   central_state.client_conf_flag = sl_bt_gatt_disable;
+  central_state.notifications = sl_bt_gatt_disable;
+  central_state.indications   = sl_bt_gatt_disable;
 
   // Clear results
   central_state.throughput    = 0;
@@ -911,8 +2679,6 @@ void throughput_central_scanning_restart(void)
   central_state.packet_error  = 0;
   central_state.packet_lost   = 0;
 
-  reset_variables();
-
   if (!close_required) {
     throughput_central_scanning_start();
   }
@@ -929,20 +2695,56 @@ void throughput_central_scanning_restart(void)
  *****************************************************************************/
 void throughput_central_step(void)
 {
-  if (enabled && central_state.state == THROUGHPUT_STATE_TEST) {
+  if (!enabled) {
+    return;
+  }
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+  throughput_central_export_drain();
+#endif
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    // Probes synchronize the clocks of idle links before their first test
+    if (THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+        && link->state == THROUGHPUT_STATE_SUBSCRIBED
+        && link->echo_subscribed && echo_interval > 0
+        && link->clock_updates == 0) {
+      send_echo_probe(link);
+    }
+    if (link->state != THROUGHPUT_STATE_TEST) {
+      continue;
+    }
     if (central_state.mode == THROUGHPUT_MODE_FIXED_TIME) {
-      if ( timer_end() >=  fixed_time ) {
-        finish_test = true;
+      if ( throughput_central_link_elapsed(link) >= fixed_time ) {
+        link->finish_test = true;
       }
     }
+    if (central_state.mode == THROUGHPUT_MODE_FIXED_LENGTH
+        && link->upload
+        && link->down_bytes >= fixed_data_size) {
+      link->finish_test = true;
+    }
+    // Downstream of a duplex or upload test, until the stop is requested
+    if (link->duplex && !link->finish_test && !link->stop_requested) {
+      send_downstream(link);
+    }
+    // Latency probes alongside any test
+    if (link->echo_subscribed && echo_interval > 0
+        && !link->finish_test && !link->stop_requested) {
+      send_echo_probe(link);
+    }
     // Test should be finished
-    if (finish_test) {
-      if (finish_time == 0) {
-        handle_throughput_central_stop(true);
+    if (link->finish_test) {
+      if (!link->stop_requested) {
+        handle_throughput_central_stop(link, true);
       } else {
         // Check timeout for result
-        if ( (timer_end() - finish_time) > THROUGHPUT_CENTRAL_RESULT_TIMEOUT ) {
-          handle_throughput_central_stop(false);
+        if ( (throughput_central_link_elapsed(link) - link->finish_time)
+             > throughput_central_result_timeout(link) ) {
+          (void)throughput_rtt_timeout(&link->rtt);
+          handle_throughput_central_stop(link, false);
         }
       }
     }
@@ -956,7 +2758,7 @@ sl_status_t throughput_central_set_mode(throughput_mode_t mode,
                                         uint32_t amount)
 {
   sl_status_t res = SL_STATUS_OK;
-  if (enabled && central_state.state != THROUGHPUT_STATE_TEST) {
+  if (enabled && central_state.state != THROUGHPUT_STATE_TEST && !soak_running) {
     if (mode == THROUGHPUT_MODE_FIXED_LENGTH) {
       fixed_data_size = amount;
     } else if (mode == THROUGHPUT_MODE_FIXED_TIME) {
@@ -969,6 +2771,91 @@ sl_status_t throughput_central_set_mode(throughput_mode_t mode,
   return res;
 }
 
+/**************************************************************************//**
+ * Sets the user pattern packets are checked against.
+ *****************************************************************************/
+sl_status_t throughput_central_set_pattern_user(const uint8_t *user,
+                                                uint8_t user_len)
+{
+  if (!enabled || central_state.state == THROUGHPUT_STATE_TEST) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (!throughput_pattern_set_user(&rx_pattern, user, user_len)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the integrity trailer of the tests started by the central.
+ *****************************************************************************/
+sl_status_t throughput_central_set_integrity(throughput_integrity_type_t type)
+{
+  if (!enabled || central_state.state == THROUGHPUT_STATE_TEST) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (!throughput_integrity_supported(type)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  integrity_type = type;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the encryption of the tests started by the central.
+ *****************************************************************************/
+sl_status_t throughput_central_set_crypto(bool enable, const uint8_t *key)
+{
+  if (!enabled || central_state.state == THROUGHPUT_STATE_TEST) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (enable && !throughput_crypto_supported()) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  if (key != NULL) {
+    throughput_crypto_set_key(&crypto_key, key);
+  }
+  crypto_enabled = enable;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the window of the history.
+ *****************************************************************************/
+sl_status_t throughput_central_set_history_window(uint32_t window)
+{
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  if (!enabled || central_state.state == THROUGHPUT_STATE_TEST) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  history_window = window;
+  return SL_STATUS_OK;
+#else
+  (void)window;
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+/**************************************************************************//**
+ * Time base the peripherals are synchronized to.
+ *****************************************************************************/
+uint64_t throughput_central_get_time(void)
+{
+  return timer_microseconds64();
+}
+
+/**************************************************************************//**
+ * Sets the interval of the latency probes.
+ *****************************************************************************/
+sl_status_t throughput_central_set_echo_interval(uint32_t interval)
+{
+  if (!enabled || central_state.state == THROUGHPUT_STATE_TEST) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  echo_interval = interval;
+  return SL_STATUS_OK;
+}
+
 /**************************************************************************//**
  * Sets the the data sizes for reception.
  *****************************************************************************/
@@ -1022,15 +2909,21 @@ sl_status_t throughput_central_set_connection_parameters(throughput_time_t min_i
     central_state.connection_responder_latency = latency;
     central_state.connection_timeout = timeout;
 
-    // Set the connection parameters for thic connection
-    res = sl_bt_connection_set_parameters(connection_handle,
-                                          central_state.connection_interval_min,
-                                          central_state.connection_interval_max,
-                                          central_state.connection_responder_latency,
-                                          central_state.connection_timeout,
-                                          CONN_MIN_CE_LENGTH,
-                                          CONN_MAX_CE_LENGTH);
-    app_assert_status(res);
+    // Set the connection parameters for every connection
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      if (links[i].connection == CONNECTION_HANDLE_INVALID
+          || links[i].state == THROUGHPUT_STATE_DISCONNECTED) {
+        continue;
+      }
+      res = sl_bt_connection_set_parameters(links[i].connection,
+                                            central_state.connection_interval_min,
+                                            central_state.connection_interval_max,
+                                            central_state.connection_responder_latency,
+                                            central_state.connection_timeout,
+                                            CONN_MIN_CE_LENGTH,
+                                            CONN_MAX_CE_LENGTH);
+      app_assert_status(res);
+    }
   } else {
     res = SL_STATUS_INVALID_STATE;
   }
@@ -1046,7 +2939,10 @@ sl_status_t throughput_central_set_type(throughput_notification_t type)
   if (enabled && central_state.state != THROUGHPUT_STATE_TEST) {
     central_state.test_type = type;
     if ( (central_state.test_type != sl_bt_gatt_indication)
-         && (central_state.test_type != sl_bt_gatt_notification) ) {
+         && (central_state.test_type != sl_bt_gatt_notification)
+         && (central_state.test_type != THROUGHPUT_TEST_L2CAP)
+         && (central_state.test_type != THROUGHPUT_TEST_DUPLEX)
+         && (central_state.test_type != THROUGHPUT_TEST_UPLOAD) ) {
       res = SL_STATUS_INVALID_TYPE;
     }
   } else {
@@ -1060,11 +2956,16 @@ sl_status_t throughput_central_set_type(throughput_notification_t type)
  *****************************************************************************/
 sl_status_t throughput_central_start(void)
 {
-  sl_status_t res = SL_STATUS_OK;
+  sl_status_t res = SL_STATUS_INVALID_STATE;
   if (enabled && central_state.state == THROUGHPUT_STATE_SUBSCRIBED) {
-    handle_throughput_central_start(true);
-  } else {
-    res = SL_STATUS_INVALID_STATE;
+    // Every subscribed peripheral starts sending
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      if (links[i].connection != CONNECTION_HANDLE_INVALID
+          && links[i].state == THROUGHPUT_STATE_SUBSCRIBED) {
+        handle_throughput_central_start(&links[i], true);
+        res = SL_STATUS_OK;
+      }
+    }
   }
   return res;
 }
@@ -1075,8 +2976,17 @@ sl_status_t throughput_central_start(void)
 sl_status_t throughput_central_stop(void)
 {
   sl_status_t res = SL_STATUS_OK;
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  // Stopped tests would be resumed by a soak
+  throughput_central_soak_end();
+#endif
   if (enabled && central_state.state == THROUGHPUT_STATE_TEST) {
-    finish_test = true;
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      if (links[i].connection != CONNECTION_HANDLE_INVALID
+          && links[i].state == THROUGHPUT_STATE_TEST) {
+        links[i].finish_test = true;
+      }
+    }
   } else {
     res = SL_STATUS_INVALID_STATE;
   }
@@ -1084,159 +2994,667 @@ sl_status_t throughput_central_stop(void)
 }
 
 /**************************************************************************//**
- * Sets the PHY used for scanning
+ * Starts a soak test.
  *****************************************************************************/
-sl_status_t throughput_central_set_scan_phy(throughput_phy_t phy)
+sl_status_t throughput_central_soak_start(void)
 {
-  sl_status_t res = SL_STATUS_OK;
-  if (enabled && central_state.state == THROUGHPUT_STATE_DISCONNECTED) {
-    res = throughput_central_apply_phy(phy);
-  } else {
-    res = SL_STATUS_INVALID_STATE;
+#if !THROUGHPUT_CENTRAL_SOAK_ENABLE
+  return SL_STATUS_NOT_SUPPORTED;
+#else
+  if (!enabled || soak_running
+      || central_state.mode != THROUGHPUT_MODE_CONTINUOUS
+      || (tune_step != tune_idle && tune_step != tune_monitor)) {
+    return SL_STATUS_INVALID_STATE;
   }
-  return res;
+  throughput_soak_reset(&soak);
+  memset(&soak_second, 0, sizeof(soak_second));
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_history_totals(&links[i], &links[i].soak_last);
+  }
+  soak_running = true;
+  timer_soak_start(THROUGHPUT_SOAK_TICK_MS);
+  // Links already under test are counted from here on, the others start
+  (void)throughput_central_start();
+  return SL_STATUS_OK;
+#endif
 }
 
 /**************************************************************************//**
- * Sets the PHY used for the connection
+ * Stops a soak test and the tests of the links.
  *****************************************************************************/
-sl_status_t throughput_central_set_connection_phy(throughput_phy_t phy)
+sl_status_t throughput_central_soak_stop(void)
 {
-  sl_status_t res = SL_STATUS_INVALID_STATE;
-  uint8_t accepted_phy = (uint8_t)phy;
-  if (enabled
-      && (central_state.state == THROUGHPUT_STATE_CONNECTED
-          || central_state.state == THROUGHPUT_STATE_SUBSCRIBED) ) {
-    if (phy == sl_bt_gap_coded_phy_500k) {
-      accepted_phy = sl_bt_gap_coded_phy;
+#if !THROUGHPUT_CENTRAL_SOAK_ENABLE
+  return SL_STATUS_NOT_SUPPORTED;
+#else
+  if (!enabled || !soak_running) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  throughput_central_soak_end();
+  if (central_state.state == THROUGHPUT_STATE_TEST) {
+    (void)throughput_central_stop();
+  }
+  return SL_STATUS_OK;
+#endif
+}
+
+/**************************************************************************//**
+ * Weakest signal strength of the connected links.
+ * @param[out] rssi signal strength
+ * @return false if no link is connected
+ *****************************************************************************/
+static bool throughput_central_tune_rssi(throughput_rssi_t *rssi)
+{
+  bool found = false;
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    if (!found || links[i].rssi < *rssi) {
+      *rssi = links[i].rssi;
     }
-    res = sl_bt_connection_set_preferred_phy(connection_handle,
-                                             phy,
-                                             accepted_phy);
+    found = true;
   }
-  return res;
+  return found;
 }
 
 /**************************************************************************//**
- * Changes PHY to the next one.
+ * Checks whether the links adopted the setting being probed.
+ * @param[out] phy_adopted every link uses the PHY of the setting
+ * @return true if every link uses the PHY and the interval of the setting
  *****************************************************************************/
-sl_status_t throughput_central_change_phy(void)
+static bool throughput_central_tune_settled(bool *phy_adopted)
 {
-  sl_status_t res = SL_STATUS_INVALID_STATE;
-  throughput_phy_t current_phy;
-  if (enabled) {
-    if ((central_state.state == THROUGHPUT_STATE_CONNECTED
-         || central_state.state == THROUGHPUT_STATE_SUBSCRIBED) ) {
-      // If connected
-      current_phy = central_state.phy;
-      switch (current_phy) {
-        case sl_bt_gap_1m_phy_uncoded:
-          res = throughput_central_set_connection_phy(sl_bt_gap_2m_phy_uncoded);
-          // if cannot switch to coded, switch to 1M
-          if (res != SL_STATUS_OK) {
-            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
-          }
-          break;
-        case sl_bt_gap_2m_phy_uncoded:
-          res = throughput_central_set_connection_phy(sl_bt_gap_coded_phy_125k);
-          // if cannot switch to coded, switch to 1M
-          if (res != SL_STATUS_OK) {
-            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
-          }
-          break;
-        case sl_bt_gap_coded_phy_125k:
-          res = throughput_central_set_connection_phy(sl_bt_gap_coded_phy_500k);
-          if (res != SL_STATUS_OK) {
-            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
-          }
-          break;
-        case sl_bt_gap_coded_phy_500k:
-          res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
-          break;
-        default:
-          res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
-          break;
-      }
-    } else if (central_state.state == THROUGHPUT_STATE_DISCONNECTED) {
-      // if disconnected
-      current_phy = central_state.scan_phy;
-      if (current_phy == sl_bt_gap_1m_phy_uncoded) {
-        res = throughput_central_set_scan_phy(sl_bt_gap_coded_phy_125k);
-      } else {
-        res = throughput_central_set_scan_phy(sl_bt_gap_1m_phy_uncoded);
-      }
+  throughput_phy_t phy = throughput_tune_phy[tune_point.phy];
+  bool coded = (phy == sl_bt_gap_coded_phy_125k || phy == sl_bt_gap_coded_phy_500k);
+  bool settled = true;
+
+  *phy_adopted = true;
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    // The PHY events do not tell the coding of the coded PHY apart
+    if (coded ? (link->phy != sl_bt_gap_coded_phy_125k
+                 && link->phy != sl_bt_gap_coded_phy_500k)
+        : link->phy != phy) {
+      *phy_adopted = false;
+      settled = false;
+    }
+    if (link->interval != throughput_tune_interval[tune_point.interval]) {
+      settled = false;
     }
   }
-  return res;
+  return settled;
 }
 
 /**************************************************************************//**
- * Enables the reception.
+ * Applies a setting to every link.
+ * @param[in] point setting to apply
+ * @return status of the operation
  *****************************************************************************/
-void throughput_central_enable(void)
+static sl_status_t throughput_central_tune_apply(throughput_tune_point_t point)
 {
+  uint16_t interval = throughput_tune_interval[point.interval];
   sl_status_t sc;
-  int16_t tx_power_min, tx_power_max;
-  uint8_t address[ADR_LEN];
-  uint32_t afh_bit;
 
-  #ifdef SL_CATALOG_THROUGHPUT_UI_PRESENT
-  throughput_ui_init();
-  #endif // SL_CATALOG_THROUGHPUT_UI_PRESENT
-
-  memset(notification_data, 0, THROUGHPUT_CENTRAL_DATA_SIZE_MAX);
-  memset(indication_data, 0, THROUGHPUT_CENTRAL_DATA_SIZE_MAX);
-
-  central_state.role          = THROUGHPUT_ROLE_CENTRAL;
-  central_state.state         = THROUGHPUT_STATE_DISCONNECTED;
+  sc = throughput_central_set_connection_phy(throughput_tune_phy[point.phy]);
+  if (sc != SL_STATUS_OK) {
+    return sc;
+  }
+  return throughput_central_set_connection_parameters(interval,
+                                                      interval,
+                                                      central_state.connection_responder_latency,
+                                                      central_state.connection_timeout);
+}
 
-  central_state.test_type     = THROUGHPUT_CENTRAL_TEST_TYPE;
+/**************************************************************************//**
+ * Moves the tuner to the next setting to probe, or applies the best setting
+ * once the search converged.
+ *****************************************************************************/
+static void throughput_central_tune_advance(void)
+{
+  while (throughput_tune_next(&tune, &tune_point)) {
+    if (throughput_central_tune_apply(tune_point) == SL_STATUS_OK) {
+      tune_step = tune_apply;
+      tune_time = 0;
+      return;
+    }
+    // The links refuse this PHY
+    throughput_tune_refuse(&tune, tune_point.phy);
+  }
+  (void)throughput_central_tune_apply(tune.best);
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_history_totals(&links[i], &links[i].tune_last);
+  }
+  tune_step = tune_monitor;
+  tune_time = 0;
+  tune_pending = false;
+  app_log_info("Tuned to PHY %d, interval %d, %lu bps after %u probes" APP_LOG_NEW_LINE,
+               (int)throughput_tune_phy[tune.best.phy],
+               (int)throughput_tune_interval[tune.best.interval],
+               (unsigned long)throughput_tune_best_goodput(&tune),
+               (unsigned int)tune.probes);
+}
 
-  central_state.mode          = THROUGHPUT_CENTRAL_MODE_DEFAULT;
-  central_state.client_conf_flag = sl_bt_gatt_disable;
-  central_state.tx_power      = THROUGHPUT_CENTRAL_TX_POWER;
-  central_state.phy           = THROUGHPUT_DEFAULT_PHY;
-  central_state.mtu_size      = THROUGHPUT_CENTRAL_DATA_SIZE_MAX;
+/**************************************************************************//**
+ * Starts a search from the setting in use.
+ *****************************************************************************/
+static void throughput_central_tune_search(void)
+{
+  throughput_tune_point_t start;
 
-  central_state.connection_interval_min = THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MIN;
-  central_state.connection_interval_max = THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MAX;
-  central_state.connection_responder_latency = THROUGHPUT_CENTRAL_CONNECTION_RESPONDER_LATENCY;
-  central_state.connection_timeout = THROUGHPUT_CENTRAL_CONNECTION_TIMEOUT;
+  start.phy = throughput_tune_phy_index(central_state.phy);
+  start.interval = throughput_tune_interval_index(central_state.interval);
+  throughput_tune_start(&tune, start, THROUGHPUT_CENTRAL_TUNE_MARGIN);
+  throughput_central_tune_advance();
+}
 
-  central_state.scan_phy = THROUGHPUT_DEFAULT_SCAN_PHY;
+/**************************************************************************//**
+ * Records the result of the probe that just finished.
+ *****************************************************************************/
+static void throughput_central_tune_record(void)
+{
+  throughput_rssi_t rssi = central_state.rssi;
+  uint32_t goodput = 0;
+  uint32_t loss = 0;
+  throughput_count_t count = central_state.count;
+
+  (void)throughput_central_tune_rssi(&rssi);
+  // Packets that failed their checks do not count
+  if (count > 0 && central_state.packet_error < count) {
+    goodput = (uint32_t)((uint64_t)central_state.throughput
+                         * (count - central_state.packet_error) / count);
+  }
+  if (count + central_state.packet_lost > 0) {
+    loss = (uint32_t)((uint64_t)central_state.packet_lost * 1000
+                      / (count + central_state.packet_lost));
+  }
+  throughput_tune_record(&tune, tune_point, goodput, rssi, loss);
+}
 
-  // Clear results
-  central_state.throughput    = 0;
-  central_state.count         = 0;
-  central_state.packet_error  = 0;
-  central_state.packet_lost   = 0;
+/**************************************************************************//**
+ * Checks the tuned setting against the signal strength and the loss it was
+ * tuned for, and tunes again once they drift out of their bands. A test in
+ * progress is not interrupted, the search waits for its end.
+ *****************************************************************************/
+static void throughput_central_tune_monitor(void)
+{
+  throughput_history_totals_t window = { 0 };
+  throughput_history_totals_t totals;
+  throughput_rssi_t rssi;
+  uint32_t loss = tune.loss;
 
-  if (THROUGHPUT_CENTRAL_POWER_CONTROL_ENABLE) {
-    power_control_enabled = connection_power_reporting_enable;
-  } else {
-    power_control_enabled = connection_power_reporting_disable;
+  if (!throughput_central_tune_rssi(&rssi)) {
+    return;
   }
-  // if the power is greater than 10 dBm AFH must be used
-  afh_bit = (central_state.tx_power_requested > 10);
-  sc = sl_bt_system_linklayer_configure(CONFIG_KEY_SET_AFH,
-                                        sizeof(afh_bit),
-                                        (uint8_t *)&afh_bit);
-  app_assert_status(sc);
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    throughput_central_history_totals(&links[i], &totals);
+    throughput_history_accumulate(&window, &links[i].tune_last, &totals);
+  }
+  if (window.packets + window.lost > 0) {
+    loss = (uint32_t)((uint64_t)window.lost * 1000 / (window.packets + window.lost));
+  }
+  if (throughput_tune_drifted(&tune,
+                              rssi,
+                              THROUGHPUT_CENTRAL_TUNE_RSSI_BAND,
+                              loss,
+                              THROUGHPUT_CENTRAL_TUNE_LOSS_BAND)) {
+    tune_pending = true;
+  }
+  if (tune_pending && !soak_running
+      && central_state.state == THROUGHPUT_STATE_SUBSCRIBED) {
+    tune_retunes++;
+    app_log_info("Link conditions changed, tuning again" APP_LOG_NEW_LINE);
+    throughput_central_tune_search();
+  }
+}
 
-  // Convert power to mdBm
-  int16_t power = ( ((int16_t)central_state.tx_power) * 10);
-  sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
-                                 power,
-                                 &tx_power_min,
-                                 &tx_power_max);
-  app_assert_status(sc);
+/**************************************************************************//**
+ * Event handler of the tuner timer
+ *****************************************************************************/
+void timer_on_tune(void)
+{
+  bool phy_adopted;
+
+  tune_time += THROUGHPUT_CENTRAL_TUNE_TICK;
+  switch (tune_step) {
+    case tune_apply:
+      if (central_state.state != THROUGHPUT_STATE_SUBSCRIBED) {
+        // The links are gone or busy, give up the search
+        (void)throughput_central_tune_stop();
+        app_log_warning("Tuning aborted" APP_LOG_NEW_LINE);
+        break;
+      }
+      if (!throughput_central_tune_settled(&phy_adopted)
+          && tune_time < THROUGHPUT_CENTRAL_TUNE_SETTLE_TIME) {
+        break;
+      }
+      if (!phy_adopted) {
+        // The peripherals did not follow to this PHY
+        throughput_tune_refuse(&tune, tune_point.phy);
+        throughput_central_tune_advance();
+        break;
+      }
+      if (throughput_central_start() == SL_STATUS_OK) {
+        tune_step = tune_probe;
+        tune_time = 0;
+      }
+      break;
+    case tune_probe:
+      if (tune_time >= THROUGHPUT_CENTRAL_TUNE_PROBE_TIME) {
+        (void)throughput_central_stop();
+        tune_step = tune_result;
+        tune_time = 0;
+      }
+      break;
+    case tune_result:
+      if (!run_active && central_state.state != THROUGHPUT_STATE_TEST) {
+        throughput_central_tune_record();
+        throughput_central_tune_advance();
+      } else if (tune_time >= THROUGHPUT_CENTRAL_TUNE_RESULT_TIME) {
+        // No result, the setting counts as unusable
+        throughput_tune_record(&tune, tune_point, 0, central_state.rssi, 1000);
+        throughput_central_tune_advance();
+      }
+      break;
+    case tune_monitor:
+      if (tune_time >= THROUGHPUT_CENTRAL_TUNE_MONITOR_PERIOD) {
+        tune_time = 0;
+        throughput_central_tune_monitor();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**************************************************************************//**
+ * Starts tuning the links.
+ *****************************************************************************/
+sl_status_t throughput_central_tune_start(void)
+{
+  if (!enabled || tune_step != tune_idle || soak_running || adapt_enabled
+      || central_state.state != THROUGHPUT_STATE_SUBSCRIBED
+      || central_state.mode != THROUGHPUT_MODE_CONTINUOUS) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  tune_retunes = 0;
+  timer_tune_start(THROUGHPUT_CENTRAL_TUNE_TICK);
+  throughput_central_tune_search();
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Stops tuning the links.
+ *****************************************************************************/
+sl_status_t throughput_central_tune_stop(void)
+{
+  if (!enabled || tune_step == tune_idle) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (tune_step == tune_probe) {
+    (void)throughput_central_stop();
+  }
+  tune_step = tune_idle;
+  timer_tune_stop();
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the PHY used for scanning
+ *****************************************************************************/
+sl_status_t throughput_central_set_scan_phy(throughput_phy_t phy)
+{
+  sl_status_t res = SL_STATUS_OK;
+  if (enabled && central_state.state != THROUGHPUT_STATE_TEST) {
+    res = throughput_central_apply_phy(phy);
+  } else {
+    res = SL_STATUS_INVALID_STATE;
+  }
+  return res;
+}
+
+/**************************************************************************//**
+ * Sets the PHY used for the connection
+ *****************************************************************************/
+sl_status_t throughput_central_set_connection_phy(throughput_phy_t phy)
+{
+  sl_status_t res = SL_STATUS_INVALID_STATE;
+  sl_status_t sc;
+  if (enabled
+      && (central_state.state == THROUGHPUT_STATE_CONNECTED
+          || central_state.state == THROUGHPUT_STATE_SUBSCRIBED) ) {
+    // Apply to every connection, report the first failure
+    res = SL_STATUS_OK;
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      if (links[i].connection == CONNECTION_HANDLE_INVALID
+          || links[i].state == THROUGHPUT_STATE_DISCONNECTED) {
+        continue;
+      }
+      sc = throughput_central_request_phy(&links[i], phy);
+      if (res == SL_STATUS_OK) {
+        res = sc;
+      }
+    }
+  }
+  return res;
+}
+
+/**************************************************************************//**
+ * Requests a PHY on a single connection.
+ * @param[in] link link to change
+ * @param[in] phy PHY to request
+ * @return status of the operation
+ *****************************************************************************/
+static sl_status_t throughput_central_request_phy(throughput_central_link_t *link,
+                                                 throughput_phy_t phy)
+{
+  uint8_t accepted_phy = (uint8_t)phy;
+  if (phy == sl_bt_gap_coded_phy_500k) {
+    accepted_phy = sl_bt_gap_coded_phy;
+  }
+  return sl_bt_connection_set_preferred_phy(link->connection,
+                                            phy,
+                                            accepted_phy);
+}
+
+/**************************************************************************//**
+ * Moves every link along the PHY ladder, called every
+ * THROUGHPUT_CENTRAL_REFRESH_TIMER_PERIOD with the RSSI requests.
+ *****************************************************************************/
+static void throughput_central_adapt(void)
+{
+  throughput_history_totals_t window;
+  throughput_history_totals_t totals;
+  throughput_phy_t phy;
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID
+        || link->state == THROUGHPUT_STATE_DISCONNECTED) {
+      continue;
+    }
+    memset(&window, 0, sizeof(window));
+    throughput_central_history_totals(link, &totals);
+    throughput_history_accumulate(&window, &link->adapt_last, &totals);
+    throughput_adapt_loss(&link->adapt, window.packets, window.lost);
+    if (!throughput_adapt_tick(&link->adapt,
+                               THROUGHPUT_CENTRAL_REFRESH_TIMER_PERIOD,
+                               &phy)) {
+      continue;
+    }
+    if (throughput_central_request_phy(link, phy) != SL_STATUS_OK) {
+      throughput_adapt_refuse(&link->adapt);
+      continue;
+    }
+    app_log_info("Connection %d: RSSI %d dBm, loss %u permille, PHY %d requested" APP_LOG_NEW_LINE,
+                 (int)link->connection,
+                 (int)throughput_adapt_rssi_average(&link->adapt),
+                 (unsigned int)link->adapt.loss,
+                 (int)phy);
+    throughput_adapt_requested(&link->adapt);
+  }
+}
+
+/**************************************************************************//**
+ * Enables or disables the adaptive PHY selection.
+ *****************************************************************************/
+sl_status_t throughput_central_set_adaptive_phy(bool enable)
+{
+  if (!enabled || (enable && tune_step != tune_idle)) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (enable && !adapt_enabled) {
+    // Start over from the PHY in use, the statistics are kept
+    for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+      links[i].adapt.dwell = 0;
+      links[i].adapt.pending = false;
+      links[i].adapt.target = links[i].adapt.rung;
+    }
+  }
+  adapt_enabled = enable;
+  return SL_STATUS_OK;
+}
+
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+/**************************************************************************//**
+ * Queues a received packet for the binary export. The queue is drained from
+ * the main loop, so a slow stream drops records instead of stalling the
+ * reception.
+ * @param[in] link link the packet was received on
+ * @param[in] data packet content
+ * @param[in] len length of the content
+ * @param[in] sequence sequence number of the packet
+ *****************************************************************************/
+static void throughput_central_export(throughput_central_link_t *link,
+                                      const uint8_t *data,
+                                      uint16_t len,
+                                      uint32_t sequence)
+{
+  uint8_t *record;
+
+  if (!export_enabled) {
+    return;
+  }
+  if (len > THROUGHPUT_CENTRAL_EXPORT_PAYLOAD_MAX) {
+    export_stats.oversize++;
+    return;
+  }
+  record = throughput_ring_reserve(&export_ring);
+  if (record == NULL) {
+    export_stats.dropped++;
+    return;
+  }
+  throughput_ring_produce(&export_ring,
+                          throughput_export_write_record(record,
+                                                         link->connection,
+                                                         sequence,
+                                                         timer_microseconds64(),
+                                                         data,
+                                                         len));
+}
+
+/**************************************************************************//**
+ * Writes the oldest queued record to the export stream.
+ *****************************************************************************/
+static void throughput_central_export_drain(void)
+{
+  static uint8_t frame[THROUGHPUT_EXPORT_FRAME_SIZE(THROUGHPUT_CENTRAL_EXPORT_RECORD_SIZE)];
+  const uint8_t *record;
+  uint16_t len;
+  size_t size;
+
+  record = throughput_ring_peek(&export_ring, &len);
+  if (record == NULL) {
+    return;
+  }
+  size = throughput_export_encode(record, len, frame);
+  if (export_write(frame, size) == SL_STATUS_OK) {
+    export_stats.frames++;
+    export_stats.bytes += size;
+  } else {
+    export_stats.failures++;
+  }
+  throughput_ring_commit(&export_ring);
+}
+#endif // THROUGHPUT_CENTRAL_EXPORT_ENABLE
+
+/**************************************************************************//**
+ * Enables or disables the binary export of the received data.
+ *****************************************************************************/
+sl_status_t throughput_central_set_export(bool enable)
+{
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+  if (!enabled) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (enable && !export_enabled) {
+    memset(&export_stats, 0, sizeof(export_stats));
+    throughput_ring_reset(&export_ring);
+  }
+  export_enabled = enable;
+  return SL_STATUS_OK;
+#else
+  (void)enable;
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+/**************************************************************************//**
+ * Changes PHY to the next one.
+ *****************************************************************************/
+sl_status_t throughput_central_change_phy(void)
+{
+  sl_status_t res = SL_STATUS_INVALID_STATE;
+  throughput_phy_t current_phy;
+  if (enabled) {
+    if ((central_state.state == THROUGHPUT_STATE_CONNECTED
+         || central_state.state == THROUGHPUT_STATE_SUBSCRIBED) ) {
+      // If connected
+      current_phy = central_state.phy;
+      switch (current_phy) {
+        case sl_bt_gap_1m_phy_uncoded:
+          res = throughput_central_set_connection_phy(sl_bt_gap_2m_phy_uncoded);
+          // if cannot switch to coded, switch to 1M
+          if (res != SL_STATUS_OK) {
+            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
+          }
+          break;
+        case sl_bt_gap_2m_phy_uncoded:
+          res = throughput_central_set_connection_phy(sl_bt_gap_coded_phy_125k);
+          // if cannot switch to coded, switch to 1M
+          if (res != SL_STATUS_OK) {
+            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
+          }
+          break;
+        case sl_bt_gap_coded_phy_125k:
+          res = throughput_central_set_connection_phy(sl_bt_gap_coded_phy_500k);
+          if (res != SL_STATUS_OK) {
+            res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
+          }
+          break;
+        case sl_bt_gap_coded_phy_500k:
+          res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
+          break;
+        default:
+          res = throughput_central_set_connection_phy(sl_bt_gap_1m_phy_uncoded);
+          break;
+      }
+    } else if (central_state.state == THROUGHPUT_STATE_DISCONNECTED) {
+      // if disconnected
+      current_phy = central_state.scan_phy;
+      if (current_phy == sl_bt_gap_1m_phy_uncoded) {
+        res = throughput_central_set_scan_phy(sl_bt_gap_coded_phy_125k);
+      } else {
+        res = throughput_central_set_scan_phy(sl_bt_gap_1m_phy_uncoded);
+      }
+    }
+  }
+  return res;
+}
+
+/**************************************************************************//**
+ * Enables the reception.
+ *****************************************************************************/
+void throughput_central_enable(void)
+{
+  sl_status_t sc;
+  int16_t tx_power_min, tx_power_max;
+  uint8_t address[ADR_LEN];
+  uint32_t afh_bit;
+
+  #ifdef SL_CATALOG_THROUGHPUT_UI_PRESENT
+  throughput_ui_init();
+  #endif // SL_CATALOG_THROUGHPUT_UI_PRESENT
+
+  // Build the generator tables, switched when a packet announces another pattern
+  (void)throughput_pattern_select(&rx_pattern, THROUGHPUT_PATTERN_PRBS15);
+
+  // Count cycles to measure the cost of the integrity checks and decryption
+  throughput_integrity_cycles_init();
+
+  // Load the configured key, an invalid one leaves encryption unavailable
+  uint8_t key[THROUGHPUT_CRYPTO_KEY_SIZE];
+  if (throughput_crypto_parse_key(THROUGHPUT_CENTRAL_CRYPTO_KEY, key)) {
+    throughput_crypto_set_key(&crypto_key, key);
+  } else {
+    crypto_enabled = false;
+  }
+
+  central_state.role          = THROUGHPUT_ROLE_CENTRAL;
+  central_state.state         = THROUGHPUT_STATE_DISCONNECTED;
+
+  central_state.test_type     = THROUGHPUT_CENTRAL_TEST_TYPE;
+
+  central_state.mode          = THROUGHPUT_CENTRAL_MODE_DEFAULT;
+  central_state.client_conf_flag = sl_bt_gatt_disable;
+  central_state.tx_power      = THROUGHPUT_CENTRAL_TX_POWER;
+  central_state.phy           = THROUGHPUT_DEFAULT_PHY;
+  central_state.mtu_size      = THROUGHPUT_CENTRAL_DATA_SIZE_MAX;
+
+  central_state.connection_interval_min = THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MIN;
+  central_state.connection_interval_max = THROUGHPUT_CENTRAL_CONNECTION_INTERVAL_MAX;
+  central_state.connection_responder_latency = THROUGHPUT_CENTRAL_CONNECTION_RESPONDER_LATENCY;
+  central_state.connection_timeout = THROUGHPUT_CENTRAL_CONNECTION_TIMEOUT;
+
+  central_state.scan_phy = THROUGHPUT_DEFAULT_SCAN_PHY;
+
+  // Clear results
+  central_state.throughput    = 0;
+  central_state.count         = 0;
+  central_state.packet_error  = 0;
+  central_state.packet_lost   = 0;
+
+  if (THROUGHPUT_CENTRAL_POWER_CONTROL_ENABLE) {
+    power_control_enabled = connection_power_reporting_enable;
+  } else {
+    power_control_enabled = connection_power_reporting_disable;
+  }
+  // if the power is greater than 10 dBm AFH must be used
+  afh_bit = (central_state.tx_power_requested > 10);
+  sc = sl_bt_system_linklayer_configure(CONFIG_KEY_SET_AFH,
+                                        sizeof(afh_bit),
+                                        (uint8_t *)&afh_bit);
+  app_assert_status(sc);
+
+  // Convert power to mdBm
+  int16_t power = ( ((int16_t)central_state.tx_power) * 10);
+  sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
+                                 power,
+                                 &tx_power_min,
+                                 &tx_power_max);
+  app_assert_status(sc);
   central_state.tx_power = tx_power_max / 10;
   throughput_central_on_transmit_power_change(central_state.tx_power);
 
   sc = sl_bt_gatt_server_set_max_mtu(central_state.mtu_size, &(central_state.mtu_size));
   app_assert_status(sc);
 
-  reset_variables();
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    memset(&links[i], 0, sizeof(links[i]));
+    links[i].connection = CONNECTION_HANDLE_INVALID;
+  }
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  throughput_history_init(&history, history_records, THROUGHPUT_CENTRAL_HISTORY_RECORDS);
+#endif
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  throughput_soak_init(&soak, soak_checkpoints, THROUGHPUT_CENTRAL_SOAK_CHECKPOINTS);
+#endif
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+  (void)throughput_ring_init(&export_ring,
+                             export_storage,
+                             THROUGHPUT_CENTRAL_EXPORT_RECORD_SIZE,
+                             THROUGHPUT_CENTRAL_EXPORT_SLOTS);
+#endif
+  soak_running = false;
+  restart_pending = false;
+  run_active = false;
 
   #if defined(THROUGHPUT_CENTRAL_ALLOWLIST_ENABLE) && THROUGHPUT_CENTRAL_ALLOWLIST_ENABLE == 1
   #if defined(THROUGHPUT_CENTRAL_ALLOWLIST_SLOT_1_ENABLE) && THROUGHPUT_CENTRAL_ALLOWLIST_SLOT_1_ENABLE == 1
@@ -1274,12 +3692,59 @@ void throughput_central_enable(void)
     app_log_warning("Default scanning PHY is not supported and set to 1M PHY" APP_LOG_NEW_LINE);
   }
 
+  #ifdef SL_CATALOG_BLUETOOTH_PRESENT
+  // Receive only the events the central handles
+  sc = throughput_event_subscribe(central_events,
+                                  sizeof(central_events) / sizeof(central_events[0]),
+                                  throughput_central_on_event);
+  app_assert_status(sc);
+  #endif // SL_CATALOG_BLUETOOTH_PRESENT
+
+  #ifdef SL_CATALOG_CLI_PRESENT
+  throughput_central_cli_add();
+  #endif // SL_CATALOG_CLI_PRESENT
+
   // Start scanning
   throughput_central_scanning_start();
 
   enabled = true;
 }
 
+/**************************************************************************//**
+ * Disables the reception.
+ *****************************************************************************/
+void throughput_central_disable(void)
+{
+  if (!enabled) {
+    return;
+  }
+
+  #if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  throughput_central_soak_end();
+  #endif
+  (void)throughput_central_tune_stop();
+  throughput_central_scanning_stop();
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    if (links[i].connection != CONNECTION_HANDLE_INVALID) {
+      (void)sl_bt_connection_close(links[i].connection);
+      throughput_central_close_link(&links[i]);
+    }
+  }
+  enabled = false;
+  central_state.state = THROUGHPUT_STATE_DISCONNECTED;
+  throughput_central_on_state_change(central_state.state);
+
+  #ifdef SL_CATALOG_BLUETOOTH_PRESENT
+  throughput_event_unsubscribe(central_events,
+                               sizeof(central_events) / sizeof(central_events[0]),
+                               throughput_central_on_event);
+  #endif // SL_CATALOG_BLUETOOTH_PRESENT
+
+  #ifdef SL_CATALOG_CLI_PRESENT
+  throughput_central_cli_remove();
+  #endif // SL_CATALOG_CLI_PRESENT
+}
+
 #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
 /**************************************************************************//**
  * Checks if it is ok to sleep now
@@ -1287,7 +3752,7 @@ void throughput_central_enable(void)
 bool throughput_central_is_ok_to_sleep(void)
 {
   bool ret = true;
-  if (enabled && !deep_sleep_enabled && (central_state.state == THROUGHPUT_STATE_TEST)) {
+  if (enabled && !deep_sleep_enabled && throughput_central_is_testing()) {
     ret = false;
   }
   return ret;
@@ -1299,7 +3764,7 @@ bool throughput_central_is_ok_to_sleep(void)
 sl_power_manager_on_isr_exit_t throughput_central_sleep_on_isr_exit(void)
 {
   sl_power_manager_on_isr_exit_t ret = SL_POWER_MANAGER_IGNORE;
-  if (enabled && !deep_sleep_enabled && (central_state.state == THROUGHPUT_STATE_TEST)) {
+  if (enabled && !deep_sleep_enabled && throughput_central_is_testing()) {
     ret = SL_POWER_MANAGER_WAKEUP;
   }
   return ret;
@@ -1405,7 +3870,28 @@ SL_WEAK void throughput_central_on_finish(throughput_value_t throughput,
 }
 
 /**************************************************************************//**
- * Weak implementation of callback to handle tx power changed event.
+ * Weak implementation of callback to handle the end of the test on one link.
+ *****************************************************************************/
+SL_WEAK void throughput_central_on_link_finish(uint8_t connection,
+                                               throughput_value_t throughput,
+                                               throughput_count_t count,
+                                               throughput_count_t lost,
+                                               throughput_count_t error,
+                                               throughput_time_t time)
+{
+  app_log_info("LINK %d: " THROUGHPUT_UI_TH_FORMAT " " THROUGHPUT_UI_CNT_FORMAT
+               " " THROUGHPUT_UI_LOST_FORMAT " " THROUGHPUT_UI_ERROR_FORMAT
+               " " THROUGHPUT_UI_TIME_FORMAT APP_LOG_NEW_LINE,
+               (int)connection,
+               (int)throughput,
+               (int)count,
+               (int)lost,
+               (int)error,
+               (int)time);
+}
+
+/**************************************************************************//**
+ * Weak implementation of callback to handle tx power changed event.
  *****************************************************************************/
 SL_WEAK void throughput_central_on_transmit_power_change(throughput_tx_power_t power)
 {
@@ -1614,6 +4100,221 @@ SL_WEAK void throughput_central_on_discovery_state_change(
 }
 
 #ifdef SL_CATALOG_CLI_PRESENT
+/***************************************************************************//**
+ * Prints the text of a test state
+ * @param[in] state state to print
+ ******************************************************************************/
+static void cli_throughput_central_print_state(throughput_state_t state)
+{
+  switch (state) {
+    case THROUGHPUT_STATE_CONNECTED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_CONNECTED_TEXT);
+      break;
+    case THROUGHPUT_STATE_DISCONNECTED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_DISCONNECTED_TEXT);
+      break;
+    case THROUGHPUT_STATE_SUBSCRIBED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_SUBSCRIBED_TEXT);
+      break;
+    case THROUGHPUT_STATE_TEST:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_TEST_TEXT);
+      break;
+    default:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_UNKNOWN_TEXT);
+      break;
+  }
+}
+
+/***************************************************************************//**
+ * Prints the bit errors of a receiving link
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_central_print_pattern(const throughput_pattern_stats_t *stats)
+{
+  CLI_RESPONSE("  BER: %lu errors in %lu kbit (%lu ppb), %lu errored packets, last at bit %lu" APP_LOG_NEW_LINE,
+               (unsigned long)stats->errors,
+               (unsigned long)(stats->bits / 1000),
+               (unsigned long)(((uint64_t)stats->errors * 1000000000ULL) / stats->bits),
+               (unsigned long)stats->errored_packets,
+               (unsigned long)stats->last_offset);
+  CLI_RESPONSE("  BER LANES: %lu %lu %lu %lu %lu %lu %lu %lu" APP_LOG_NEW_LINE,
+               (unsigned long)stats->lanes[0],
+               (unsigned long)stats->lanes[1],
+               (unsigned long)stats->lanes[2],
+               (unsigned long)stats->lanes[3],
+               (unsigned long)stats->lanes[4],
+               (unsigned long)stats->lanes[5],
+               (unsigned long)stats->lanes[6],
+               (unsigned long)stats->lanes[7]);
+}
+
+/***************************************************************************//**
+ * Prints the integrity checks of a receiving link and their cost
+ * @param[in] type integrity mode of the link
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_central_print_integrity(throughput_integrity_type_t type,
+                                                   const throughput_integrity_stats_t *stats)
+{
+  CLI_RESPONSE("  INTEGRITY: %s, %lu packets, %lu failed, %lu not computed, %lu.%02lu cycles/byte" APP_LOG_NEW_LINE,
+               throughput_integrity_name(type),
+               (unsigned long)stats->packets,
+               (unsigned long)stats->failures,
+               (unsigned long)stats->errors,
+               (unsigned long)(stats->bytes ? stats->cycles / stats->bytes : 0),
+               (unsigned long)(stats->bytes ? (stats->cycles * 100 / stats->bytes) % 100 : 0));
+}
+
+/***************************************************************************//**
+ * Prints the decryption of a receiving link and its cost, with the throughput
+ * of the plaintext next to the one of the packets.
+ * @param[in] stats statistics to print
+ * @param[in] throughput throughput of the packets
+ ******************************************************************************/
+static void cli_throughput_central_print_crypto(const throughput_crypto_stats_t *stats,
+                                                throughput_value_t throughput)
+{
+  CLI_RESPONSE("  CRYPTO: AES-CCM, %lu packets, %lu failed, %lu.%02lu cycles/byte,"
+               " plaintext %lu of %lu bps" APP_LOG_NEW_LINE,
+               (unsigned long)stats->packets,
+               (unsigned long)stats->failures,
+               (unsigned long)(stats->plaintext_bytes ? stats->cycles / stats->plaintext_bytes : 0),
+               (unsigned long)(stats->plaintext_bytes
+                               ? (stats->cycles * 100 / stats->plaintext_bytes) % 100 : 0),
+               (unsigned long)(stats->bytes ? throughput * stats->plaintext_bytes / stats->bytes : 0),
+               (unsigned long)throughput);
+}
+
+/***************************************************************************//**
+ * Prints the loss statistics of a receiving link
+ * @param[in] label line label
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_central_print_sequence(const char *label,
+                                                  const throughput_sequence_stats_t *stats)
+{
+  CLI_RESPONSE("  %s: %lu received, %lu lost, %lu reordered, %lu duplicates, %lu late" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)stats->received,
+               (unsigned long)stats->lost,
+               (unsigned long)stats->reordered,
+               (unsigned long)stats->duplicates,
+               (unsigned long)stats->late);
+  CLI_RESPONSE("  %s BURSTS: 1:%lu 2:%lu 3-4:%lu 5-8:%lu 9-16:%lu 17-32:%lu 33-64:%lu 65+:%lu" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)stats->bursts[0],
+               (unsigned long)stats->bursts[1],
+               (unsigned long)stats->bursts[2],
+               (unsigned long)stats->bursts[3],
+               (unsigned long)stats->bursts[4],
+               (unsigned long)stats->bursts[5],
+               (unsigned long)stats->bursts[6],
+               (unsigned long)stats->bursts[7]);
+}
+
+/***************************************************************************//**
+ * Prints the per direction results of a duplex test. The downstream received
+ * is known once the peripheral reported it, until then the rate sent is shown.
+ * @param[in] link link to print
+ ******************************************************************************/
+static void cli_throughput_central_print_duplex(throughput_central_link_t *link)
+{
+  uint32_t down = link->peer_duplex_valid ? link->peer_duplex.throughput : link->down_throughput;
+  float utilization = throughput_duplex_utilization(link->phy, link->throughput, down);
+
+  CLI_RESPONSE("  DUPLEX: up %lu bps, down %lu bps (sent %lu bps, %lu packets,"
+               " %lu stalls, %lu failed)" APP_LOG_NEW_LINE,
+               (unsigned long)link->throughput,
+               (unsigned long)down,
+               (unsigned long)link->down_throughput,
+               (unsigned long)link->down_packets,
+               (unsigned long)link->down_stalls,
+               (unsigned long)link->down_failures);
+  CLI_RESPONSE("  DUPLEX LATENCY: up avg %lu us max %lu us, down avg %lu us max %lu us,"
+               " utilization %lu.%01lu%%" APP_LOG_NEW_LINE,
+               (unsigned long)throughput_duplex_latency_mean(&link->up_latency),
+               (unsigned long)link->up_latency.excess_max,
+               (unsigned long)(link->peer_duplex_valid ? link->peer_duplex.latency_mean : 0),
+               (unsigned long)(link->peer_duplex_valid ? link->peer_duplex.latency_max : 0),
+               (unsigned long)utilization,
+               (unsigned long)(utilization * 10) % 10);
+}
+
+/***************************************************************************//**
+ * Prints a latency histogram summary
+ * @param[in] label name of the latency
+ * @param[in] summary summary to print
+ ******************************************************************************/
+static void cli_throughput_central_print_latency(const char *label,
+                                                 const throughput_latency_summary_t *summary)
+{
+  CLI_RESPONSE("  %s: %lu samples, p50 %lu us, p90 %lu us, p99 %lu us, p99.9 %lu us,"
+               " max %lu us, jitter %lu us" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)summary->count,
+               (unsigned long)summary->p50,
+               (unsigned long)summary->p90,
+               (unsigned long)summary->p99,
+               (unsigned long)summary->p999,
+               (unsigned long)summary->max,
+               (unsigned long)summary->jitter);
+}
+
+/***************************************************************************//**
+ * Prints the latency histograms of a link that have samples: the upstream
+ * latency of a duplex test or the round trip of the probes, and the
+ * downstream latency the peripheral reported.
+ * @param[in] link link to print
+ ******************************************************************************/
+static void cli_throughput_central_print_latencies(throughput_central_link_t *link)
+{
+  throughput_latency_summary_t summary;
+
+  if (latency_is_upstream(link)) {
+    if (link->latency.count > 0) {
+      throughput_latency_summarize(&link->latency, &summary);
+      cli_throughput_central_print_latency("UP LATENCY", &summary);
+    }
+    if (link->echo_lost > 0) {
+      CLI_RESPONSE("  ECHO: %lu probes lost" APP_LOG_NEW_LINE,
+                   (unsigned long)link->echo_lost);
+    }
+  } else if (link->latency.count > 0 || link->echo_lost > 0) {
+    throughput_latency_summarize(&link->latency, &summary);
+    cli_throughput_central_print_latency("ECHO RTT", &summary);
+    CLI_RESPONSE("  ECHO: %lu probes lost, mean %lu us" APP_LOG_NEW_LINE,
+                 (unsigned long)link->echo_lost,
+                 (unsigned long)throughput_latency_mean(&link->latency));
+  }
+  if (link->peer_latency_valid && link->peer_latency.count > 0) {
+    cli_throughput_central_print_latency("DOWN LATENCY", &link->peer_latency);
+  }
+}
+
+/***************************************************************************//**
+ * Prints the results of an upload, the rate received once the peripheral
+ * reported it.
+ * @param[in] link link to print
+ ******************************************************************************/
+static void cli_throughput_central_print_upload(throughput_central_link_t *link)
+{
+  CLI_RESPONSE("  UPLOAD: sent %lu bps (%lu B/s), %lu bytes in %lu packets,"
+               " %lu stalls, %lu failed" APP_LOG_NEW_LINE,
+               (unsigned long)link->down_throughput,
+               (unsigned long)(link->down_throughput / 8),
+               (unsigned long)link->down_bytes,
+               (unsigned long)link->down_packets,
+               (unsigned long)link->down_stalls,
+               (unsigned long)link->down_failures);
+  if (link->peer_duplex_valid) {
+    CLI_RESPONSE("  UPLOAD RECEIVED: %lu bps (%lu B/s), latency avg %lu us max %lu us" APP_LOG_NEW_LINE,
+                 (unsigned long)link->peer_duplex.throughput,
+                 (unsigned long)(link->peer_duplex.throughput / 8),
+                 (unsigned long)link->peer_duplex.latency_mean,
+                 (unsigned long)link->peer_duplex.latency_max);
+  }
+}
+
 /***************************************************************************//**
  * CLI command for central stop
  * @param[in] arguments command line argument list
@@ -1678,23 +4379,7 @@ void cli_throughput_central_status(sl_cli_command_arg_t *arguments)
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  switch (central_state.state) {
-    case THROUGHPUT_STATE_CONNECTED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_CONNECTED_TEXT);
-      break;
-    case THROUGHPUT_STATE_DISCONNECTED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_DISCONNECTED_TEXT);
-      break;
-    case THROUGHPUT_STATE_SUBSCRIBED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_SUBSCRIBED_TEXT);
-      break;
-    case THROUGHPUT_STATE_TEST:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_TEST_TEXT);
-      break;
-    default:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_UNKNOWN_TEXT);
-      break;
-  }
+  cli_throughput_central_print_state(central_state.state);
   CLI_RESPONSE(APP_LOG_NEW_LINE);
 
   if (central_state.role == THROUGHPUT_ROLE_PERIPHERAL) {
@@ -1702,349 +4387,1460 @@ void cli_throughput_central_status(sl_cli_command_arg_t *arguments)
   } else {
     CLI_RESPONSE(THROUGHPUT_UI_ROLE_CENTRAL_TEXT);
   }
-  CLI_RESPONSE(APP_LOG_NEW_LINE);
-
-  CLI_RESPONSE(CLI_OK);
+  CLI_RESPONSE(APP_LOG_NEW_LINE);
+
+  // Per link status and the result of its last test
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    CLI_RESPONSE("LINK %d: ", (int)link->connection);
+    cli_throughput_central_print_state(link->state);
+    CLI_RESPONSE(" " THROUGHPUT_UI_DATA_SIZE_FORMAT
+                 " " THROUGHPUT_UI_TH_FORMAT
+                 " " THROUGHPUT_UI_CNT_FORMAT
+                 " " THROUGHPUT_UI_LOST_FORMAT
+                 " " THROUGHPUT_UI_ERROR_FORMAT APP_LOG_NEW_LINE,
+                 (int)link->data_size,
+                 (int)link->throughput,
+                 (int)link->count,
+                 (int)link->packet_lost,
+                 (int)link->packet_error);
+    if (link->frame_count > 0) {
+      CLI_RESPONSE("  FRAMES: %lu LOST: %lu" APP_LOG_NEW_LINE,
+                   (unsigned long)link->frame_count,
+                   (unsigned long)link->frame_lost);
+    }
+    if (link->pipe_rx.expected > 0) {
+      CLI_RESPONSE("  PIPELINE: %lu in order, %lu reordered, %lu duplicates, %lu dropped" APP_LOG_NEW_LINE,
+                   (unsigned long)link->pipe_rx.expected,
+                   (unsigned long)link->pipe_reordered,
+                   (unsigned long)link->pipe_duplicates,
+                   (unsigned long)link->pipe_dropped);
+    }
+    if (link->sequence_rx.stats.received > 0) {
+      cli_throughput_central_print_sequence("RX", &link->sequence_rx.stats);
+    }
+    if (link->pattern_stats.bits > 0) {
+      cli_throughput_central_print_pattern(&link->pattern_stats);
+    }
+    if (link->integrity_stats.packets > 0 || link->integrity_stats.errors > 0) {
+      cli_throughput_central_print_integrity(link->integrity, &link->integrity_stats);
+    }
+    if (link->crypto_stats.packets > 0) {
+      cli_throughput_central_print_crypto(&link->crypto_stats, link->throughput);
+    }
+    if (link->peer_sequence_valid && link->peer_sequence.received > 0) {
+      cli_throughput_central_print_sequence("PEER RX", &link->peer_sequence);
+    }
+    if (link->upload) {
+      cli_throughput_central_print_upload(link);
+    } else if (link->duplex) {
+      cli_throughput_central_print_duplex(link);
+    }
+    cli_throughput_central_print_latencies(link);
+    if (link->rtt.samples > 0 || link->rtt.timeouts > 0) {
+      CLI_RESPONSE("  RTT: srtt %lu us, rttvar %lu us, min %lu max %lu us, timeout %lu ms,"
+                   " %lu samples, %lu discarded, %lu timeouts" APP_LOG_NEW_LINE,
+                   (unsigned long)link->rtt.srtt,
+                   (unsigned long)link->rtt.rttvar,
+                   (unsigned long)link->rtt.min,
+                   (unsigned long)link->rtt.max,
+                   (unsigned long)throughput_rtt_timeout_ms(&link->rtt, 1),
+                   (unsigned long)link->rtt.samples,
+                   (unsigned long)link->rtt.discarded,
+                   (unsigned long)link->rtt.timeouts);
+    }
+#if THROUGHPUT_CENTRAL_CLOCK_SYNC_ENABLE
+    if (link->clock.model.valid) {
+      CLI_RESPONSE("  CLOCK: offset %ld ms, drift %ld ppb, residual %lu us of %u samples,"
+                   " %lu updates%s" APP_LOG_NEW_LINE,
+                   (long)(link->clock.model.offset / 1000),
+                   (long)link->clock.model.drift,
+                   (unsigned long)link->clock.residual,
+                   (unsigned int)link->clock.used,
+                   (unsigned long)link->clock_updates,
+                   link->clock_synced ? ", latency synchronized" : "");
+    }
+#endif
+    if (link->l2cap_cid != 0) {
+      CLI_RESPONSE("  L2CAP: %lu PDUs, %lu SDU errors" APP_LOG_NEW_LINE,
+                   (unsigned long)link->l2cap_pdus,
+                   (unsigned long)link->l2cap_sdu_errors);
+    }
+  }
+
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  if (history.windows > 0) {
+    CLI_RESPONSE("HISTORY: %lu windows of %lu ms, min %lu max %lu mean %lu stddev %lu bps" APP_LOG_NEW_LINE,
+                 (unsigned long)history.windows,
+                 (unsigned long)history_window,
+                 (unsigned long)history.min,
+                 (unsigned long)history.max,
+                 (unsigned long)history.mean,
+                 (unsigned long)throughput_history_stddev(&history));
+  }
+#endif
+
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  if (soak.uptime > 0) {
+    CLI_RESPONSE("SOAK: %lu s%s, availability %lu permille, %lu bps uptime weighted" APP_LOG_NEW_LINE,
+                 (unsigned long)soak.uptime,
+                 soak_running ? " running" : "",
+                 (unsigned long)throughput_soak_availability(soak.tested, soak.uptime),
+                 (unsigned long)throughput_soak_average(&soak, true));
+  }
+#endif
+
+  // Aggregate result of the last test run
+  CLI_RESPONSE("LINKS: %d/%d " THROUGHPUT_UI_TH_FORMAT
+               " " THROUGHPUT_UI_CNT_FORMAT APP_LOG_NEW_LINE,
+               (int)throughput_central_link_count(),
+               THROUGHPUT_CENTRAL_MAX_CONNECTIONS,
+               (int)central_state.throughput,
+               (int)central_state.count);
+
+  CLI_RESPONSE(CLI_OK);
+}
+
+/***************************************************************************//**
+ * CLI command for reading how the receive bandwidth is shared by the links
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_share_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  throughput_count_t rates[THROUGHPUT_CENTRAL_MAX_CONNECTIONS];
+  throughput_count_t total_rate = 0;
+  throughput_count_t total_lost = 0;
+  throughput_count_t total_error = 0;
+
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    rates[i] = 0;
+    if (links[i].connection != CONNECTION_HANDLE_INVALID) {
+      rates[i] = throughput_central_link_rate(&links[i]);
+      total_rate += rates[i];
+      total_lost += links[i].packet_lost;
+      total_error += links[i].packet_error;
+    }
+  }
+
+  CLI_RESPONSE("bandwidth share\n");
+  CLI_RESPONSE("-------------------------------------------------------------" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("| LINK |      ADDRESS      |   BYTES/S | SHARE |  LOST |  ERR |" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("-------------------------------------------------------------" APP_LOG_NEW_LINE);
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    CLI_RESPONSE("| %4d | %02X:%02X:%02X:%02X:%02X:%02X | %9lu | %3lu %% | %5lu | %4lu |" APP_LOG_NEW_LINE,
+                 (int)link->connection,
+                 link->address.addr[5],
+                 link->address.addr[4],
+                 link->address.addr[3],
+                 link->address.addr[2],
+                 link->address.addr[1],
+                 link->address.addr[0],
+                 (unsigned long)rates[i],
+                 (unsigned long)(total_rate ? (uint64_t)rates[i] * 100 / total_rate : 0),
+                 (unsigned long)link->packet_lost,
+                 (unsigned long)link->packet_error);
+  }
+  CLI_RESPONSE("-------------------------------------------------------------" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("| TOTAL                    | %9lu |       | %5lu | %4lu |" APP_LOG_NEW_LINE,
+               (unsigned long)total_rate,
+               (unsigned long)total_lost,
+               (unsigned long)total_error);
+  CLI_RESPONSE("-------------------------------------------------------------" APP_LOG_NEW_LINE);
+}
+
+/***************************************************************************//**
+ * CLI command for setting reception mode
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_mode_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  sl_status_t sc;
+  uint8_t mode;
+  uint32_t amount;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    mode = sl_cli_get_argument_uint8(arguments, 0);
+    amount = sl_cli_get_argument_uint16(arguments, 1);
+    sc = throughput_central_set_mode((throughput_mode_t)mode, amount);
+    if (sc == SL_STATUS_OK) {
+      CLI_RESPONSE(CLI_OK);
+    } else {
+      CLI_RESPONSE(CLI_ERROR);
+    }
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading reception mode
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_mode_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("mode settings\n");
+  CLI_RESPONSE("%d %lu %lu\n",
+               (int)central_state.mode,
+               (uint32_t)fixed_data_size,
+               (uint32_t)fixed_time);
+}
+
+/***************************************************************************//**
+ * CLI command for setting local transmission power
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_tx_power_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  int16_t power;
+  uint8_t control, sleep;
+  sl_status_t sc;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    power = sl_cli_get_argument_int16(arguments, 0);
+    control = sl_cli_get_argument_uint8(arguments, 1);
+    sleep = sl_cli_get_argument_uint8(arguments, 2);
+    sc = throughput_central_set_tx_power(power,
+                                         control,
+                                         sleep);
+
+    if (sc == SL_STATUS_OK) {
+      CLI_RESPONSE(CLI_OK);
+    } else {
+      app_assert_status(sc);
+      CLI_RESPONSE(CLI_ERROR);
+    }
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading local transmission power settings
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_tx_power_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("TX power settings\n");
+  CLI_RESPONSE("%d %d %d\n",
+               (int)central_state.tx_power,
+               (int)power_control_enabled,
+               (int)deep_sleep_enabled);
+}
+
+/***************************************************************************//**
+ * CLI command for setting data sizes
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_data_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t mtu;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    mtu = sl_cli_get_argument_uint8(arguments, 0);
+    central_state.mtu_size = mtu;
+    CLI_RESPONSE(CLI_OK);
+    throughput_central_scanning_restart();
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading data sizes
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_data_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("data\n");
+  CLI_RESPONSE("%d\n",
+               (int)central_state.mtu_size);
+}
+
+/***************************************************************************//**
+ * CLI command for setting PHY for scanning
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_phy_scan_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t phy_scan;
+  sl_status_t sc;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    phy_scan = sl_cli_get_argument_uint8(arguments, 0);
+    throughput_central_scanning_restart();
+
+    // Set passive scanning on selected PHY
+    sc = sl_bt_scanner_set_mode(phy_scan, SCAN_PASSIVE);
+    if (sc == SL_STATUS_OK) {
+      central_state.scan_phy = (throughput_phy_t)phy_scan;
+    }
+
+    if (sc == SL_STATUS_OK) {
+      CLI_RESPONSE(CLI_OK);
+    } else {
+      CLI_RESPONSE(CLI_ERROR);
+    }
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for setting PHY for connection
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_phy_conn_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t phy_conn;
+  sl_status_t sc;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    phy_conn = sl_cli_get_argument_uint8(arguments, 0);
+    if (central_state.state == THROUGHPUT_STATE_DISCONNECTED) {
+      central_state.phy = (throughput_phy_t)phy_conn;
+      CLI_RESPONSE(CLI_OK);
+    } else {
+      sc = throughput_central_set_connection_phy((throughput_phy_t)phy_conn);
+      if (sc == SL_STATUS_OK) {
+        CLI_RESPONSE(CLI_OK);
+      } else {
+        CLI_RESPONSE(CLI_ERROR);
+      }
+    }
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading PHY settings
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_phy_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("phy settings\n");
+  CLI_RESPONSE("%d %d\n",
+               (int)central_state.scan_phy,
+               (int)central_state.phy);
+}
+
+/***************************************************************************//**
+ * CLI command for setting connection parameters
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_connection_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  throughput_time_t connection_interval_min;
+  throughput_time_t connection_interval_max;
+  throughput_time_t connection_responder_latency;
+  throughput_time_t connection_timeout;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    connection_interval_min = sl_cli_get_argument_uint32(arguments, 0);
+    connection_interval_max = sl_cli_get_argument_uint32(arguments, 1);
+    connection_responder_latency = sl_cli_get_argument_uint32(arguments, 2);
+    connection_timeout = sl_cli_get_argument_uint32(arguments, 3);
+    central_state.connection_interval_min = connection_interval_min;
+    central_state.connection_interval_max = connection_interval_max;
+    central_state.connection_responder_latency = connection_responder_latency;
+    central_state.connection_timeout = connection_timeout;
+    CLI_RESPONSE(CLI_OK);
+    throughput_central_scanning_restart();
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading connection parameters
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_connection_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("connection settings\n");
+  CLI_RESPONSE("%u %u %u %u\n",
+               (uint32_t)central_state.connection_interval_min,
+               (uint32_t)central_state.connection_interval_max,
+               (uint32_t)central_state.connection_responder_latency,
+               (uint32_t)central_state.connection_timeout);
+}
+
+/***************************************************************************//**
+ * CLI command for adding to allowlist
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_allowlist_add(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  bool ret;
+  uint8_t address[ADR_LEN];
+  char *address_str;
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    address_str = sl_cli_get_argument_string(arguments, 0);
+    if (throughput_central_decode_address(address_str, address)) {
+      ret = throughput_central_allowlist_add(address);
+      if (ret) {
+        CLI_RESPONSE(CLI_OK);
+        throughput_central_scanning_restart();
+      } else {
+        CLI_RESPONSE(CLI_ERROR);
+      }
+    } else {
+      CLI_RESPONSE(CLI_ERROR);
+    }
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for clearing allowlist
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_allowlist_clear(sl_cli_command_arg_t *arguments)
+{
+  (void) arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  if (central_state.state != THROUGHPUT_STATE_TEST) {
+    throughput_central_allowlist_clear();
+    CLI_RESPONSE(CLI_OK);
+    throughput_central_scanning_restart();
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading allowlist
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_allowlist_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("allowlist\n");
+  throughput_allowlist_t *allowlist = &central_state.allowlist;
+  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("|      ADDRESS      |" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
+  while (allowlist->next != NULL) {
+    CLI_RESPONSE("| %02X:%02X:%02X:%02X:%02X:%02X |" APP_LOG_NEW_LINE,
+                 allowlist->address.addr[5],
+                 allowlist->address.addr[4],
+                 allowlist->address.addr[3],
+                 allowlist->address.addr[2],
+                 allowlist->address.addr[1],
+                 allowlist->address.addr[0]);
+    allowlist = allowlist->next;
+  }
+  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
+}
+
+/***************************************************************************//**
+ * CLI command for setting the user pattern
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_pattern_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  size_t user_len = 0;
+  uint8_t *user = sl_cli_get_argument_hex(arguments, 0, &user_len);
+  sl_status_t sc;
+  if (user_len > THROUGHPUT_PATTERN_USER_MAX) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  sc = throughput_central_set_pattern_user(user, (uint8_t)user_len);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the pattern the received packets are checked against
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_pattern_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("pattern\n");
+  CLI_RESPONSE("%d %s %d\n",
+               (int)rx_pattern.type,
+               throughput_pattern_name(rx_pattern.type),
+               (int)rx_pattern.user_len);
+}
+
+/***************************************************************************//**
+ * CLI command for setting the integrity trailer
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_integrity_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t type = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_central_set_integrity((throughput_integrity_type_t)type);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the integrity trailer
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_integrity_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("integrity\n");
+  CLI_RESPONSE("%d %s %d\n",
+               (int)integrity_type,
+               throughput_integrity_name(integrity_type),
+               (int)throughput_integrity_size(integrity_type));
+}
+
+/***************************************************************************//**
+ * CLI command for setting the interval of the latency probes
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_latency_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint32_t interval = sl_cli_get_argument_uint32(arguments, 0);
+  sl_status_t sc = throughput_central_set_echo_interval(interval);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the interval of the latency probes
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_latency_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("latency\n");
+  CLI_RESPONSE("%lu\n", (unsigned long)echo_interval);
+}
+
+/***************************************************************************//**
+ * CLI command for reading the round trip statistics of the links
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_rtt_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("rtt\n");
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
+    }
+    CLI_RESPONSE("%d %lu %lu %lu %lu %lu %lu %lu %lu %lu\n",
+                 (int)link->connection,
+                 (unsigned long)link->rtt.srtt,
+                 (unsigned long)link->rtt.rttvar,
+                 (unsigned long)link->rtt.rto,
+                 (unsigned long)link->rtt.min,
+                 (unsigned long)link->rtt.max,
+                 (unsigned long)link->rtt.last,
+                 (unsigned long)link->rtt.samples,
+                 (unsigned long)link->rtt.timeouts,
+                 (unsigned long)link->rtt.discarded);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for enabling the encryption
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_crypto_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t enable = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_central_set_crypto(enable != 0, NULL);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
 }
 
 /***************************************************************************//**
- * CLI command for setting reception mode
+ * CLI command for setting the encryption key
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_mode_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_crypto_key(sl_cli_command_arg_t *arguments)
 {
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  sl_status_t sc;
-  uint8_t mode;
-  uint32_t amount;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    mode = sl_cli_get_argument_uint8(arguments, 0);
-    amount = sl_cli_get_argument_uint16(arguments, 1);
-    sc = throughput_central_set_mode((throughput_mode_t)mode, amount);
-    if (sc == SL_STATUS_OK) {
-      CLI_RESPONSE(CLI_OK);
-    } else {
-      CLI_RESPONSE(CLI_ERROR);
-    }
+  uint8_t key[THROUGHPUT_CRYPTO_KEY_SIZE];
+  if (!throughput_crypto_parse_key(sl_cli_get_argument_string(arguments, 0), key)) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  sl_status_t sc = throughput_central_set_crypto(crypto_enabled, key);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for reading reception mode
+ * CLI command for reading the encryption
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_mode_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_crypto_get(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("mode settings\n");
-  CLI_RESPONSE("%d %lu %lu\n",
-               (int)central_state.mode,
-               (uint32_t)fixed_data_size,
-               (uint32_t)fixed_time);
+  CLI_RESPONSE("crypto\n");
+  CLI_RESPONSE("%d %d\n",
+               (int)crypto_enabled,
+               (int)throughput_crypto_supported());
 }
 
+
 /***************************************************************************//**
- * CLI command for setting local transmission power
+ * CLI command for dumping the history of the last test run
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_tx_power_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_history_dump(sl_cli_command_arg_t *arguments)
 {
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  uint8_t buffer[THROUGHPUT_HISTORY_PACKED_SIZE];
+  uint8_t format;
+
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  int16_t power;
-  uint8_t control, sleep;
-  sl_status_t sc;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    power = sl_cli_get_argument_int16(arguments, 0);
-    control = sl_cli_get_argument_uint8(arguments, 1);
-    sleep = sl_cli_get_argument_uint8(arguments, 2);
-    sc = throughput_central_set_tx_power(power,
-                                         control,
-                                         sleep);
-
-    if (sc == SL_STATUS_OK) {
-      CLI_RESPONSE(CLI_OK);
+  format = sl_cli_get_argument_uint8(arguments, 0);
+  if (format > 1) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("history %u %lu %lu\n",
+               (unsigned int)history.count,
+               (unsigned long)history_window,
+               (unsigned long)history.overwritten);
+  if (format == 0) {
+    CLI_RESPONSE("time,bytes,packets,retries,lost,rssi,phy,throughput\n");
+  }
+  for (uint16_t i = 0; i < history.count; i++) {
+    const throughput_history_record_t *record = throughput_history_get(&history, i);
+    uint32_t duration;
+    if (format == 1) {
+      // Packed records as hexadecimal, one per line
+      throughput_history_pack(record, buffer);
+      for (uint8_t j = 0; j < sizeof(buffer); j++) {
+        CLI_RESPONSE("%02x", buffer[j]);
+      }
+      CLI_RESPONSE("\n");
+      continue;
+    }
+    if (i > 0) {
+      duration = record->time - throughput_history_get(&history, i - 1)->time;
+    } else if (history.overwritten > 0) {
+      duration = history_window;
     } else {
-      app_assert_status(sc);
-      CLI_RESPONSE(CLI_ERROR);
+      duration = record->time;
     }
+    CLI_RESPONSE("%lu,%lu,%u,%u,%u,%d,%u,%lu\n",
+                 (unsigned long)record->time,
+                 (unsigned long)record->bytes,
+                 (unsigned int)record->packets,
+                 (unsigned int)record->retries,
+                 (unsigned int)record->lost,
+                 (int)record->rssi,
+                 (unsigned int)record->phy,
+                 (unsigned long)(duration > 0 ? (uint64_t)record->bytes * 8 * 1000 / duration : 0));
+  }
+  CLI_RESPONSE(CLI_OK);
+#else
+  (void)arguments;
+  CLI_RESPONSE(CLI_ERROR);
+#endif
+}
+
+/***************************************************************************//**
+ * CLI command for setting the history window
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_history_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint32_t window = sl_cli_get_argument_uint32(arguments, 0);
+  sl_status_t sc = throughput_central_set_history_window(window);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for reading local transmission power settings
+ * CLI command for reading the history window
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_tx_power_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_history_get(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("TX power settings\n");
-  CLI_RESPONSE("%d %d %d\n",
-               (int)central_state.tx_power,
-               (int)power_control_enabled,
-               (int)deep_sleep_enabled);
+#if THROUGHPUT_CENTRAL_HISTORY_ENABLE
+  CLI_RESPONSE("history\n");
+  CLI_RESPONSE("%lu %u\n",
+               (unsigned long)history_window,
+               (unsigned int)THROUGHPUT_CENTRAL_HISTORY_RECORDS);
+#else
+  CLI_RESPONSE(CLI_ERROR);
+#endif
 }
 
 /***************************************************************************//**
- * CLI command for setting data sizes
+ * CLI command for enabling the binary export
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_data_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_export_set(sl_cli_command_arg_t *arguments)
 {
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  uint8_t mtu;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    mtu = sl_cli_get_argument_uint8(arguments, 0);
-    central_state.mtu_size = mtu;
+  uint8_t enable = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_central_set_export(enable != 0);
+  if (sc == SL_STATUS_OK) {
     CLI_RESPONSE(CLI_OK);
-    throughput_central_scanning_restart();
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for reading data sizes
+ * CLI command for reading the binary export statistics
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_data_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_export_get(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("data\n");
-  CLI_RESPONSE("%d\n",
-               (int)central_state.mtu_size);
+#if THROUGHPUT_CENTRAL_EXPORT_ENABLE
+  CLI_RESPONSE("export\n");
+  CLI_RESPONSE("%d %lu %lu %lu %lu %lu %lu\n",
+               (int)export_enabled,
+               (unsigned long)export_stats.frames,
+               (unsigned long)export_stats.bytes,
+               (unsigned long)export_stats.dropped,
+               (unsigned long)export_stats.oversize,
+               (unsigned long)export_stats.failures,
+               (unsigned long)export_ring.high_water);
+#else
+  CLI_RESPONSE(CLI_ERROR);
+#endif
 }
 
 /***************************************************************************//**
- * CLI command for setting PHY for scanning
+ * CLI command for enabling the adaptive PHY selection
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_phy_scan_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_adapt_set(sl_cli_command_arg_t *arguments)
 {
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  uint8_t phy_scan;
-  sl_status_t sc;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    phy_scan = sl_cli_get_argument_uint8(arguments, 0);
-    throughput_central_scanning_restart();
-
-    // Set passive scanning on selected PHY
-    sc = sl_bt_scanner_set_mode(phy_scan, SCAN_PASSIVE);
-    if (sc == SL_STATUS_OK) {
-      central_state.scan_phy = (throughput_phy_t)phy_scan;
-    }
-
-    if (sc == SL_STATUS_OK) {
-      CLI_RESPONSE(CLI_OK);
-    } else {
-      CLI_RESPONSE(CLI_ERROR);
-    }
+  uint8_t enable = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_central_set_adaptive_phy(enable != 0);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for setting PHY for connection
+ * CLI command for reading the adaptive PHY selection of the links
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_phy_conn_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_adapt_get(sl_cli_command_arg_t *arguments)
 {
+  (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  uint8_t phy_conn;
-  sl_status_t sc;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    phy_conn = sl_cli_get_argument_uint8(arguments, 0);
-    if (central_state.state == THROUGHPUT_STATE_DISCONNECTED) {
-      central_state.phy = (throughput_phy_t)phy_conn;
-      CLI_RESPONSE(CLI_OK);
-    } else {
-      sc = throughput_central_set_connection_phy((throughput_phy_t)phy_conn);
-      if (sc == SL_STATUS_OK) {
-        CLI_RESPONSE(CLI_OK);
-      } else {
-        CLI_RESPONSE(CLI_ERROR);
-      }
+  CLI_RESPONSE("adapt %d\n", (int)adapt_enabled);
+  for (uint8_t i = 0; i < THROUGHPUT_CENTRAL_MAX_CONNECTIONS; i++) {
+    throughput_central_link_t *link = &links[i];
+    if (link->connection == CONNECTION_HANDLE_INVALID) {
+      continue;
     }
-  } else {
-    CLI_RESPONSE(CLI_ERROR);
+    // Times in ms on 2M, 1M, coded 500k and coded 125k
+    CLI_RESPONSE("%d %d %d %u %lu %lu %lu %lu %lu %lu %lu\n",
+                 (int)link->connection,
+                 (int)throughput_adapt_phy[link->adapt.rung],
+                 (int)throughput_adapt_rssi_average(&link->adapt),
+                 (unsigned int)link->adapt.loss,
+                 (unsigned long)link->adapt.up,
+                 (unsigned long)link->adapt.down,
+                 (unsigned long)link->adapt.refused,
+                 (unsigned long)link->adapt.time_in[0],
+                 (unsigned long)link->adapt.time_in[1],
+                 (unsigned long)link->adapt.time_in[2],
+                 (unsigned long)link->adapt.time_in[3]);
   }
 }
 
 /***************************************************************************//**
- * CLI command for reading PHY settings
+ * CLI command for starting the link tuner
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_phy_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_tune_start(sl_cli_command_arg_t *arguments)
 {
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("phy settings\n");
-  CLI_RESPONSE("%d %d\n",
-               (int)central_state.scan_phy,
-               (int)central_state.phy);
+  sl_status_t sc = throughput_central_tune_start();
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
 }
 
 /***************************************************************************//**
- * CLI command for setting connection parameters
+ * CLI command for stopping the link tuner
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_connection_set(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_tune_stop(sl_cli_command_arg_t *arguments)
 {
+  (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  throughput_time_t connection_interval_min;
-  throughput_time_t connection_interval_max;
-  throughput_time_t connection_responder_latency;
-  throughput_time_t connection_timeout;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    connection_interval_min = sl_cli_get_argument_uint32(arguments, 0);
-    connection_interval_max = sl_cli_get_argument_uint32(arguments, 1);
-    connection_responder_latency = sl_cli_get_argument_uint32(arguments, 2);
-    connection_timeout = sl_cli_get_argument_uint32(arguments, 3);
-    central_state.connection_interval_min = connection_interval_min;
-    central_state.connection_interval_max = connection_interval_max;
-    central_state.connection_responder_latency = connection_responder_latency;
-    central_state.connection_timeout = connection_timeout;
+  sl_status_t sc = throughput_central_tune_stop();
+  if (sc == SL_STATUS_OK) {
     CLI_RESPONSE(CLI_OK);
-    throughput_central_scanning_restart();
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for reading connection parameters
+ * CLI command for the state of the link tuner and the goodputs probed
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_connection_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_tune_status(sl_cli_command_arg_t *arguments)
 {
+  static const char *steps[] = { "idle", "apply", "probe", "result", "monitor" };
+
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("connection settings\n");
-  CLI_RESPONSE("%u %u %u %u\n",
-               (uint32_t)central_state.connection_interval_min,
-               (uint32_t)central_state.connection_interval_max,
-               (uint32_t)central_state.connection_responder_latency,
-               (uint32_t)central_state.connection_timeout);
+  CLI_RESPONSE("TUNE: %s, best PHY %d interval %d, %lu bps, %u probes, %lu retunes" APP_LOG_NEW_LINE,
+               steps[tune_step],
+               (int)throughput_tune_phy[tune.best.phy],
+               (int)throughput_tune_interval[tune.best.interval],
+               (unsigned long)throughput_tune_best_goodput(&tune),
+               (unsigned int)tune.probes,
+               (unsigned long)tune_retunes);
+  CLI_RESPONSE("  REFERENCE: RSSI %d dBm, loss %lu permille" APP_LOG_NEW_LINE,
+               (int)tune.rssi,
+               (unsigned long)tune.loss);
+  for (uint8_t phy = 0; phy < THROUGHPUT_TUNE_PHYS; phy++) {
+    if (!tune.allowed[phy]) {
+      CLI_RESPONSE("  PHY %d: refused" APP_LOG_NEW_LINE, (int)throughput_tune_phy[phy]);
+      continue;
+    }
+    CLI_RESPONSE("  PHY %d:", (int)throughput_tune_phy[phy]);
+    for (uint8_t interval = 0; interval < THROUGHPUT_TUNE_INTERVALS; interval++) {
+      if (tune.probed[phy][interval]) {
+        CLI_RESPONSE(" %d:%lu",
+                     (int)throughput_tune_interval[interval],
+                     (unsigned long)tune.goodput[phy][interval]);
+      } else {
+        CLI_RESPONSE(" %d:-", (int)throughput_tune_interval[interval]);
+      }
+    }
+    CLI_RESPONSE(APP_LOG_NEW_LINE);
+  }
+  CLI_RESPONSE(CLI_OK);
 }
 
 /***************************************************************************//**
- * CLI command for adding to allowlist
+ * CLI command for starting a soak test
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_allowlist_add(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_soak_start(sl_cli_command_arg_t *arguments)
 {
+  (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  bool ret;
-  uint8_t address[ADR_LEN];
-  char *address_str;
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    address_str = sl_cli_get_argument_string(arguments, 0);
-    if (throughput_central_decode_address(address_str, address)) {
-      ret = throughput_central_allowlist_add(address);
-      if (ret) {
-        CLI_RESPONSE(CLI_OK);
-        throughput_central_scanning_restart();
-      } else {
-        CLI_RESPONSE(CLI_ERROR);
-      }
-    } else {
-      CLI_RESPONSE(CLI_ERROR);
-    }
+  sl_status_t sc = throughput_central_soak_start();
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
 /***************************************************************************//**
- * CLI command for clearing allowlist
+ * CLI command for stopping a soak test
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_allowlist_clear(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_soak_stop(sl_cli_command_arg_t *arguments)
 {
-  (void) arguments;
+  (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  if (central_state.state != THROUGHPUT_STATE_TEST) {
-    throughput_central_allowlist_clear();
+  sl_status_t sc = throughput_central_soak_stop();
+  if (sc == SL_STATUS_OK) {
     CLI_RESPONSE(CLI_OK);
-    throughput_central_scanning_restart();
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
 }
 
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
 /***************************************************************************//**
- * CLI command for reading allowlist
+ * Prints a rolling window of the soak test.
+ * @param[in] name name of the window
+ * @param[in] seconds length of the window
+ ******************************************************************************/
+static void cli_throughput_central_print_soak_window(const char *name,
+                                                     uint32_t seconds)
+{
+  throughput_soak_window_t window;
+
+  throughput_soak_window(&soak, seconds, &window);
+  CLI_RESPONSE("  %s: %lu bps, availability %lu permille over %lu s" APP_LOG_NEW_LINE,
+               name,
+               (unsigned long)throughput_soak_rate(&window),
+               (unsigned long)throughput_soak_availability(window.tested, window.seconds),
+               (unsigned long)window.seconds);
+}
+#endif
+
+/***************************************************************************//**
+ * CLI command for the report of the soak test
  * @param[in] arguments command line argument list
  ******************************************************************************/
-void cli_throughput_central_allowlist_get(sl_cli_command_arg_t *arguments)
+void cli_throughput_central_soak_status(sl_cli_command_arg_t *arguments)
 {
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  char digits[21];
+
   (void)arguments;
   if (!enabled) {
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  CLI_RESPONSE("allowlist\n");
-  throughput_allowlist_t *allowlist = &central_state.allowlist;
-  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
-  CLI_RESPONSE("|      ADDRESS      |" APP_LOG_NEW_LINE);
-  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
-  while (allowlist->next != NULL) {
-    CLI_RESPONSE("| %02X:%02X:%02X:%02X:%02X:%02X |" APP_LOG_NEW_LINE,
-                 allowlist->address.addr[5],
-                 allowlist->address.addr[4],
-                 allowlist->address.addr[3],
-                 allowlist->address.addr[2],
-                 allowlist->address.addr[1],
-                 allowlist->address.addr[0]);
-    allowlist = allowlist->next;
+  CLI_RESPONSE("SOAK: %s, %lu s, %lu s under test, availability %lu permille" APP_LOG_NEW_LINE,
+               soak_running ? "running" : "stopped",
+               (unsigned long)soak.uptime,
+               (unsigned long)soak.tested,
+               (unsigned long)throughput_soak_availability(soak.tested, soak.uptime));
+  CLI_RESPONSE("  BYTES: %s" APP_LOG_NEW_LINE,
+               throughput_central_format_u64(soak.totals.bytes, digits));
+  CLI_RESPONSE("  PACKETS: %s", throughput_central_format_u64(soak.totals.packets, digits));
+  CLI_RESPONSE(", lost %s", throughput_central_format_u64(soak.totals.lost, digits));
+  CLI_RESPONSE(", retries %s" APP_LOG_NEW_LINE,
+               throughput_central_format_u64(soak.totals.retries, digits));
+  CLI_RESPONSE("  AVERAGE: %lu bps, %lu bps uptime weighted" APP_LOG_NEW_LINE,
+               (unsigned long)throughput_soak_average(&soak, false),
+               (unsigned long)throughput_soak_average(&soak, true));
+  cli_throughput_central_print_soak_window("1 s", 1);
+  cli_throughput_central_print_soak_window("1 min", THROUGHPUT_SOAK_SLOTS);
+  cli_throughput_central_print_soak_window("1 h", THROUGHPUT_SOAK_SLOTS * THROUGHPUT_SOAK_SLOTS);
+  CLI_RESPONSE("  LINKS: %lu disconnects, %lu tests resumed" APP_LOG_NEW_LINE,
+               (unsigned long)soak.disconnects,
+               (unsigned long)soak.resumes);
+  CLI_RESPONSE(CLI_OK);
+#else
+  (void)arguments;
+  CLI_RESPONSE(CLI_ERROR);
+#endif
+}
+
+/***************************************************************************//**
+ * CLI command for dumping the checkpoints of the soak test
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_central_soak_dump(sl_cli_command_arg_t *arguments)
+{
+#if THROUGHPUT_CENTRAL_SOAK_ENABLE
+  char digits[21];
+
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
   }
-  CLI_RESPONSE("---------------------" APP_LOG_NEW_LINE);
+  CLI_RESPONSE("soak %u %lu\n",
+               (unsigned int)soak.count,
+               (unsigned long)THROUGHPUT_CENTRAL_SOAK_CHECKPOINT);
+  CLI_RESPONSE("uptime_s,tested_s,bytes,packets,lost,retries,disconnects,resumes,minute_bps,hour_bps\n");
+  for (uint16_t i = 0; i < soak.count; i++) {
+    const throughput_soak_checkpoint_t *checkpoint = throughput_soak_get(&soak, i);
+    CLI_RESPONSE("%lu,%lu,",
+                 (unsigned long)checkpoint->uptime,
+                 (unsigned long)checkpoint->tested);
+    CLI_RESPONSE("%s,", throughput_central_format_u64(checkpoint->totals.bytes, digits));
+    CLI_RESPONSE("%s,", throughput_central_format_u64(checkpoint->totals.packets, digits));
+    CLI_RESPONSE("%s,", throughput_central_format_u64(checkpoint->totals.lost, digits));
+    CLI_RESPONSE("%s,", throughput_central_format_u64(checkpoint->totals.retries, digits));
+    CLI_RESPONSE("%lu,%lu,%lu,%lu\n",
+                 (unsigned long)checkpoint->disconnects,
+                 (unsigned long)checkpoint->resumes,
+                 (unsigned long)checkpoint->rate_minute,
+                 (unsigned long)checkpoint->rate_hour);
+  }
+  CLI_RESPONSE(CLI_OK);
+#else
+  (void)arguments;
+  CLI_RESPONSE(CLI_ERROR);
+#endif
+}
+
+/***************************************************************************//**
+ * CLI commands of the test features, in their own command group next to the
+ * generated throughput_central group
+ ******************************************************************************/
+
+static const sl_cli_command_info_t cli_cmd_central_share = \
+  SL_CLI_COMMAND(cli_throughput_central_share_get,
+                 "Prints receive bandwidth share of the links",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_pattern_set = \
+  SL_CLI_COMMAND(cli_throughput_central_pattern_set,
+                 "Set user pattern",
+                  "User pattern, 1-16 bytes" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_HEX, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_pattern_get = \
+  SL_CLI_COMMAND(cli_throughput_central_pattern_get,
+                 "Read payload pattern",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_integrity_set = \
+  SL_CLI_COMMAND(cli_throughput_central_integrity_set,
+                 "Set integrity trailer",
+                  "Trailer: 0: none, 1: CRC32, 2: SHA-256" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_integrity_get = \
+  SL_CLI_COMMAND(cli_throughput_central_integrity_get,
+                 "Read integrity trailer",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_crypto_set = \
+  SL_CLI_COMMAND(cli_throughput_central_crypto_set,
+                 "Set AES-CCM encryption",
+                  "Encryption: 0: off, 1: on" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_crypto_key = \
+  SL_CLI_COMMAND(cli_throughput_central_crypto_key,
+                 "Set AES-128 key",
+                  "Key as 32 hexadecimal digits" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_STRING, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_crypto_get = \
+  SL_CLI_COMMAND(cli_throughput_central_crypto_get,
+                 "Read AES-CCM encryption",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_latency_set = \
+  SL_CLI_COMMAND(cli_throughput_central_latency_set,
+                 "Set latency probe interval",
+                  "Interval in ms, 0: off" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT32, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_latency_get = \
+  SL_CLI_COMMAND(cli_throughput_central_latency_get,
+                 "Read latency probe interval",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_history_dump = \
+  SL_CLI_COMMAND(cli_throughput_central_history_dump,
+                 "Dump time series",
+                  "Format: 0: CSV, 1: binary as hexadecimal" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_history_set = \
+  SL_CLI_COMMAND(cli_throughput_central_history_set,
+                 "Set time series window",
+                  "Window in ms, 0: off" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT32, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_history_get = \
+  SL_CLI_COMMAND(cli_throughput_central_history_get,
+                 "Read time series window",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_rtt_get = \
+  SL_CLI_COMMAND(cli_throughput_central_rtt_get,
+                 "Read round trip statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_export_set = \
+  SL_CLI_COMMAND(cli_throughput_central_export_set,
+                 "Set binary export",
+                  "Export: 0: off, 1: on" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_export_get = \
+  SL_CLI_COMMAND(cli_throughput_central_export_get,
+                 "Read binary export statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_adapt_set = \
+  SL_CLI_COMMAND(cli_throughput_central_adapt_set,
+                 "Set adaptive PHY selection",
+                  "Adaptive PHY: 0: off, 1: on" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_adapt_get = \
+  SL_CLI_COMMAND(cli_throughput_central_adapt_get,
+                 "Read adaptive PHY statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_tune_start = \
+  SL_CLI_COMMAND(cli_throughput_central_tune_start,
+                 "Start link tuner",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_tune_stop = \
+  SL_CLI_COMMAND(cli_throughput_central_tune_stop,
+                 "Stop link tuner",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_tune_status = \
+  SL_CLI_COMMAND(cli_throughput_central_tune_status,
+                 "Report link tuner",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_soak_start = \
+  SL_CLI_COMMAND(cli_throughput_central_soak_start,
+                 "Start soak test",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_soak_stop = \
+  SL_CLI_COMMAND(cli_throughput_central_soak_stop,
+                 "Stop soak test",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_soak_status = \
+  SL_CLI_COMMAND(cli_throughput_central_soak_status,
+                 "Report soak test",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_central_soak_dump = \
+  SL_CLI_COMMAND(cli_throughput_central_soak_dump,
+                 "Dump soak test checkpoints",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_entry_t central_pattern_group_table[] = {
+  { "set", &cli_cmd_central_pattern_set, false },
+  { "s", &cli_cmd_central_pattern_set, true },
+  { "get", &cli_cmd_central_pattern_get, false },
+  { "g", &cli_cmd_central_pattern_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_pattern = \
+  SL_CLI_COMMAND_GROUP(central_pattern_group_table, "Payload pattern");
+
+static const sl_cli_command_entry_t central_integrity_group_table[] = {
+  { "set", &cli_cmd_central_integrity_set, false },
+  { "s", &cli_cmd_central_integrity_set, true },
+  { "get", &cli_cmd_central_integrity_get, false },
+  { "g", &cli_cmd_central_integrity_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_integrity = \
+  SL_CLI_COMMAND_GROUP(central_integrity_group_table, "Integrity trailer");
+
+static const sl_cli_command_entry_t central_crypto_group_table[] = {
+  { "set", &cli_cmd_central_crypto_set, false },
+  { "s", &cli_cmd_central_crypto_set, true },
+  { "key", &cli_cmd_central_crypto_key, false },
+  { "k", &cli_cmd_central_crypto_key, true },
+  { "get", &cli_cmd_central_crypto_get, false },
+  { "g", &cli_cmd_central_crypto_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_crypto = \
+  SL_CLI_COMMAND_GROUP(central_crypto_group_table, "Packet encryption");
+
+static const sl_cli_command_entry_t central_latency_group_table[] = {
+  { "set", &cli_cmd_central_latency_set, false },
+  { "s", &cli_cmd_central_latency_set, true },
+  { "get", &cli_cmd_central_latency_get, false },
+  { "g", &cli_cmd_central_latency_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_latency = \
+  SL_CLI_COMMAND_GROUP(central_latency_group_table, "Latency probes");
+
+static const sl_cli_command_entry_t central_history_group_table[] = {
+  { "dump", &cli_cmd_central_history_dump, false },
+  { "d", &cli_cmd_central_history_dump, true },
+  { "set", &cli_cmd_central_history_set, false },
+  { "s", &cli_cmd_central_history_set, true },
+  { "get", &cli_cmd_central_history_get, false },
+  { "g", &cli_cmd_central_history_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_history = \
+  SL_CLI_COMMAND_GROUP(central_history_group_table, "Throughput time series");
+
+static const sl_cli_command_entry_t central_rtt_group_table[] = {
+  { "get", &cli_cmd_central_rtt_get, false },
+  { "g", &cli_cmd_central_rtt_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_rtt = \
+  SL_CLI_COMMAND_GROUP(central_rtt_group_table, "ATT round trip");
+
+static const sl_cli_command_entry_t central_export_group_table[] = {
+  { "set", &cli_cmd_central_export_set, false },
+  { "s", &cli_cmd_central_export_set, true },
+  { "get", &cli_cmd_central_export_get, false },
+  { "g", &cli_cmd_central_export_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_export = \
+  SL_CLI_COMMAND_GROUP(central_export_group_table, "Binary export");
+
+static const sl_cli_command_entry_t central_adapt_group_table[] = {
+  { "set", &cli_cmd_central_adapt_set, false },
+  { "s", &cli_cmd_central_adapt_set, true },
+  { "get", &cli_cmd_central_adapt_get, false },
+  { "g", &cli_cmd_central_adapt_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_adapt = \
+  SL_CLI_COMMAND_GROUP(central_adapt_group_table, "Adaptive PHY");
+
+static const sl_cli_command_entry_t central_tune_group_table[] = {
+  { "start", &cli_cmd_central_tune_start, false },
+  { "s", &cli_cmd_central_tune_start, true },
+  { "stop", &cli_cmd_central_tune_stop, false },
+  { "x", &cli_cmd_central_tune_stop, true },
+  { "status", &cli_cmd_central_tune_status, false },
+  { "t", &cli_cmd_central_tune_status, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_tune = \
+  SL_CLI_COMMAND_GROUP(central_tune_group_table, "Link tuner");
+
+static const sl_cli_command_entry_t central_soak_group_table[] = {
+  { "start", &cli_cmd_central_soak_start, false },
+  { "s", &cli_cmd_central_soak_start, true },
+  { "stop", &cli_cmd_central_soak_stop, false },
+  { "x", &cli_cmd_central_soak_stop, true },
+  { "status", &cli_cmd_central_soak_status, false },
+  { "t", &cli_cmd_central_soak_status, true },
+  { "dump", &cli_cmd_central_soak_dump, false },
+  { "d", &cli_cmd_central_soak_dump, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_soak = \
+  SL_CLI_COMMAND_GROUP(central_soak_group_table, "Soak test");
+
+static const sl_cli_command_entry_t central_test_group_table[] = {
+  { "share", &cli_cmd_central_share, false },
+  { "b", &cli_cmd_central_share, true },
+  { "pattern", &cli_cmd_grp_central_pattern, false },
+  { "a", &cli_cmd_grp_central_pattern, true },
+  { "integrity", &cli_cmd_grp_central_integrity, false },
+  { "i", &cli_cmd_grp_central_integrity, true },
+  { "crypto", &cli_cmd_grp_central_crypto, false },
+  { "e", &cli_cmd_grp_central_crypto, true },
+  { "latency", &cli_cmd_grp_central_latency, false },
+  { "l", &cli_cmd_grp_central_latency, true },
+  { "history", &cli_cmd_grp_central_history, false },
+  { "h", &cli_cmd_grp_central_history, true },
+  { "rtt", &cli_cmd_grp_central_rtt, false },
+  { "r", &cli_cmd_grp_central_rtt, true },
+  { "export", &cli_cmd_grp_central_export, false },
+  { "o", &cli_cmd_grp_central_export, true },
+  { "adapt", &cli_cmd_grp_central_adapt, false },
+  { "j", &cli_cmd_grp_central_adapt, true },
+  { "tune", &cli_cmd_grp_central_tune, false },
+  { "u", &cli_cmd_grp_central_tune, true },
+  { "soak", &cli_cmd_grp_central_soak, false },
+  { "k", &cli_cmd_grp_central_soak, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_central_test = \
+  SL_CLI_COMMAND_GROUP(central_test_group_table, "Throughput Central tests");
+
+static const sl_cli_command_entry_t central_command_table[] = {
+  { "throughput_central_test", &cli_cmd_grp_central_test, false },
+  { "ct", &cli_cmd_grp_central_test, true },
+  { NULL, NULL, false },
+};
+
+/// Command group of the test features, added while the central is enabled
+static sl_cli_command_group_t central_command_group = {
+  { NULL },
+  false,
+  central_command_table
+};
+
+/***************************************************************************//**
+ * Adds the commands of the test features to the CLI.
+ ******************************************************************************/
+static void throughput_central_cli_add(void)
+{
+  (void)sl_cli_command_add_command_group(sl_cli_default_handle, &central_command_group);
 }
 
+/***************************************************************************//**
+ * Removes the commands of the test features from the CLI.
+ ******************************************************************************/
+static void throughput_central_cli_remove(void)
+{
+  (void)sl_cli_command_remove_command_group(sl_cli_default_handle, &central_command_group);
+}
 #endif // SL_CATALOG_CLI_PRESENT
@@ -39,6 +39,8 @@
 #include "throughput_central_config.h"
 #include "throughput_central_system.h"
 #include "throughput_types.h"
+#include "throughput_integrity.h"
+#include "throughput_crypto.h"
 
 /*******************************************************************************
  ****************************  PUBLIC DEFINITIONS  *****************************
@@ -86,6 +88,11 @@ bool throughput_central_allowlist_clear(void);
  *****************************************************************************/
 void throughput_central_enable(void);
 
+/**************************************************************************//**
+ * Disables the the receiver. Scanning stops and the connections are closed.
+ *****************************************************************************/
+void throughput_central_disable(void);
+
 /**************************************************************************//**
  * Sets the the receiver mode.
  * @param[in] mode the transmission mode is either of:
@@ -98,6 +105,55 @@ void throughput_central_enable(void);
 sl_status_t throughput_central_set_mode(throughput_mode_t mode,
                                         uint32_t amount);
 
+/**************************************************************************//**
+ * Sets the user pattern received packets are checked against. The other
+ * patterns are followed as announced by the packets.
+ * @param[in] user user pattern, as set on the peripheral
+ * @param[in] user_len length of the user pattern
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_pattern_user(const uint8_t *user,
+                                                uint8_t user_len);
+
+/**************************************************************************//**
+ * Sets the integrity trailer of the tests started by the central. Tests
+ * started by the peripheral use the trailer it selects.
+ * @param[in] type integrity mode
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_integrity(throughput_integrity_type_t type);
+
+/**************************************************************************//**
+ * Sets the encryption of the tests started by the central. Tests started by
+ * the peripheral are encrypted if it selects it.
+ * @param[in] enable true to encrypt the notification and indication tests
+ * @param[in] key AES-128 key, NULL to keep the current one
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_crypto(bool enable, const uint8_t *key);
+
+/**************************************************************************//**
+ * Sets the window of the time series recorded during the tests.
+ * @param[in] window window in ms, 0 to stop recording
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_history_window(uint32_t window);
+
+/**************************************************************************//**
+ * Time base of the tests. The central synchronizes the clocks of its
+ * peripherals to its own, so their timestamps are comparable.
+ * @return time in microseconds
+ *****************************************************************************/
+uint64_t throughput_central_get_time(void);
+
+/**************************************************************************//**
+ * Sets the interval of the latency probes written to the echo characteristic
+ * during tests. Their round trip is measured by the clock of the central.
+ * @param[in] interval interval in ms, 0 to disable the probes
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_echo_interval(uint32_t interval);
+
 /**************************************************************************//**
  * Sets the the data sizes for reception.
  * @param[in] mtu MTU size in bytes
@@ -137,17 +193,47 @@ sl_status_t throughput_central_set_connection_parameters(throughput_time_t min_i
 sl_status_t throughput_central_set_type(throughput_notification_t type);
 
 /**************************************************************************//**
- * Starts the reception.
+ * Starts the reception on every subscribed link.
  * @return status of the operation
  *****************************************************************************/
 sl_status_t throughput_central_start(void);
 
 /**************************************************************************//**
- * Stops the reception.
+ * Stops the reception on every link that is receiving.
  * @return status of the operation
  *****************************************************************************/
 sl_status_t throughput_central_stop(void);
 
+/**************************************************************************//**
+ * Starts a soak test in continuous mode. The tests of the links are restarted
+ * after a reconnect, and their counters are added to 64-bit totals and to
+ * rolling 1 s, 1 min and 1 h windows, with periodic checkpoints.
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_soak_start(void);
+
+/**************************************************************************//**
+ * Stops a soak test and the tests of the links. Stopping the tests ends the
+ * soak test as well.
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_soak_stop(void);
+
+/**************************************************************************//**
+ * Starts tuning the PHY and the connection interval of the links in
+ * continuous mode. Short probe tests search the setting with the highest
+ * goodput, which is then applied and kept until the signal strength or the
+ * loss drift out of their bands, when the links are tuned again.
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_tune_start(void);
+
+/**************************************************************************//**
+ * Stops tuning the links, the setting in use is kept.
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_tune_stop(void);
+
 /**************************************************************************//**
  * Sets the PHY used for scanning
  * @param[in] phy PHY used for scanning
@@ -170,13 +256,32 @@ sl_status_t throughput_central_set_connection_phy(throughput_phy_t phy);
  *****************************************************************************/
 sl_status_t throughput_central_change_phy(void);
 
+/**************************************************************************//**
+ * Enables or disables the adaptive PHY selection. Each link steps between
+ * 2M, 1M and the coded PHYs on its own as its RSSI and loss change.
+ * @param[in] enable true to enable
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_adaptive_phy(bool enable);
+
+/**************************************************************************//**
+ * Enables or disables the binary export of the received data. Every intact
+ * packet is written to the export stream as a COBS frame, see
+ * throughput_export.h.
+ * @param[in] enable true to enable
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_central_set_export(bool enable);
+
 /**************************************************************************//**
  * Process step for throughput central.
  *****************************************************************************/
 void throughput_central_step(void);
 
 /**************************************************************************//**
- * Bluetooth stack event handler.
+ * Bluetooth stack event handler, called with every event.
+ * On SoC the enabled receiver subscribes to the events it handles through
+ * throughput_event_subscribe() instead, and this handler ignores them.
  * @param[in] evt Event coming from the Bluetooth stack.
  *****************************************************************************/
 void bt_on_event_central(sl_bt_msg_t *evt);
@@ -230,6 +335,8 @@ void throughput_central_on_start(void);
 
 /**************************************************************************//**
  * Callback to handle transmission finished event.
+ * Called once every link has finished; values are summed over the links and
+ * time is the longest measurement.
  * @param[in] throughput throughput value in bits/second (bps)
  * @param[in] count data volume transmitted, in bytes
  * @param[in] lost number of packets lost
@@ -243,6 +350,23 @@ void throughput_central_on_finish(throughput_value_t throughput,
                                   throughput_count_t error,
                                   throughput_time_t time);
 
+/**************************************************************************//**
+ * Callback to handle the end of the test on a single link.
+ * @param[in] connection connection handle of the link
+ * @param[in] throughput throughput value in bits/second (bps)
+ * @param[in] count number of packets received on the link
+ * @param[in] lost number of packets lost
+ * @param[in] error number of wrong packets
+ * @param[in] time measurement time of the link
+ * @note To be implemented in user code.
+ *****************************************************************************/
+void throughput_central_on_link_finish(uint8_t connection,
+                                       throughput_value_t throughput,
+                                       throughput_count_t count,
+                                       throughput_count_t lost,
+                                       throughput_count_t error,
+                                       throughput_time_t time);
+
 /**************************************************************************//**
  * Callback to handle tx power changed event.
  * @param[in] power tx power in dBm
@@ -329,7 +453,7 @@ void throughput_central_on_discovery_state_change(
   throughput_discovery_state_t state);
 
 /**************************************************************************//**
- * Calculate throughput.
+ * Calculate throughput, summed over the links that are receiving.
  * @param[out] throughput calculated throughput value
  * @return the elapsed time in seconds since measurement started
  *****************************************************************************/
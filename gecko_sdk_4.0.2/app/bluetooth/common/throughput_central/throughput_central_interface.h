@@ -50,6 +50,17 @@ void timer_start();
  *****************************************************************************/
 float timer_end();
 
+/**************************************************************************//**
+ * Free running microsecond counter, wraps around. Time stamps the duplex
+ * packets.
+ *****************************************************************************/
+uint32_t timer_microseconds(void);
+
+/**************************************************************************//**
+ * Free running microsecond counter of the clock synchronization.
+ *****************************************************************************/
+uint64_t timer_microseconds64(void);
+
 /**************************************************************************//**
  * Start RSSI refresh timer
  *****************************************************************************/
@@ -65,4 +76,60 @@ void timer_refresh_rssi_stop(void);
  *****************************************************************************/
 void timer_on_refresh_rssi(void);
 
+/**************************************************************************//**
+ * Start history timer
+ * @param[in] window period in ms
+ *****************************************************************************/
+void timer_history_start(uint32_t window);
+
+/**************************************************************************//**
+ * Stop history timer
+ *****************************************************************************/
+void timer_history_stop(void);
+
+/**************************************************************************//**
+ * Event handler of the history timer
+ *****************************************************************************/
+void timer_on_history(void);
+
+/**************************************************************************//**
+ * Start soak timer
+ * @param[in] period period in ms
+ *****************************************************************************/
+void timer_soak_start(uint32_t period);
+
+/**************************************************************************//**
+ * Stop soak timer
+ *****************************************************************************/
+void timer_soak_stop(void);
+
+/**************************************************************************//**
+ * Event handler of the soak timer
+ *****************************************************************************/
+void timer_on_soak(void);
+
+/**************************************************************************//**
+ * Write to the export stream
+ * @param[in] data data to write
+ * @param[in] len length of the data
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t export_write(const uint8_t *data, size_t len);
+
+/**************************************************************************//**
+ * Start tuner timer
+ * @param[in] period period in ms
+ *****************************************************************************/
+void timer_tune_start(uint32_t period);
+
+/**************************************************************************//**
+ * Stop tuner timer
+ *****************************************************************************/
+void timer_tune_stop(void);
+
+/**************************************************************************//**
+ * Event handler of the tuner timer
+ *****************************************************************************/
+void timer_on_tune(void);
+
 #endif
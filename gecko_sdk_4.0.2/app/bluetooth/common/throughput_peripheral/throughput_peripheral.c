@@ -47,6 +47,20 @@
 #endif // SL_CATALOG_CLI_PRESENT
 #include "throughput_ui_types.h"
 #include "throughput_common.h"
+#include "throughput_event.h"
+#include "throughput_frame.h"
+#include "throughput_ring.h"
+#include "throughput_pipeline.h"
+#include "throughput_l2cap.h"
+#include "throughput_pattern.h"
+#include "throughput_sequence.h"
+#include "throughput_integrity.h"
+#include "throughput_crypto.h"
+#include "throughput_duplex.h"
+#include "throughput_latency.h"
+#include "throughput_clock.h"
+#include "throughput_history.h"
+#include "throughput_rtt.h"
 
 /*******************************************************************************
  *******************************  DEFINITIONS   ********************************
@@ -63,10 +77,22 @@
 #define NOTIFICATION_GATT_HEADER                    3
 // Header byte count
 #define L2CAP_HEADER                                4
-// Indication timeout period
-#define THROUGHPUT_TX_INDICATION_TIMEOUT         500
 // Minimum TX power
 #define CONFIG_TX_POWER_MIN                        -100
+// Connection interval unit in microseconds
+#define CONNECTION_INTERVAL_UNIT_US                 1250
+
+#if THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW > THROUGHPUT_PIPELINE_MAX_WINDOW
+#error "THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW exceeds THROUGHPUT_PIPELINE_MAX_WINDOW"
+#endif
+// Sample queue is filled by the sampler instead of generating data on demand
+#define SAMPLE_QUEUE_ENABLED                        (THROUGHPUT_PERIPHERAL_SAMPLE_RATE > 0)
+// Sample queue storage in words, a single word if the queue is not used
+#define SAMPLE_QUEUE_STORAGE_WORDS                                            \
+  (SAMPLE_QUEUE_ENABLED                                                       \
+   ? THROUGHPUT_RING_STORAGE_SIZE(THROUGHPUT_TX_DATA_SIZE,                    \
+                                  THROUGHPUT_PERIPHERAL_SAMPLE_QUEUE_SLOTS) / 4 \
+   : 1)
 
 /*******************************************************************************
  ********************************  CONSTANTS   *********************************
@@ -92,21 +118,213 @@ const uint8_t peripheral_transmission_characteristic_uuid[] = { 0x18, 0x77, 0xc6
 
 #define UUID_LEN                                    16
 
+#if THROUGHPUT_L2CAP_MAX_MPS > THROUGHPUT_TX_DATA_SIZE
+#error "THROUGHPUT_L2CAP_MAX_MPS exceeds THROUGHPUT_TX_DATA_SIZE"
+#endif
+
+#if THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS > SL_BT_CONFIG_MAX_CONNECTIONS
+#error "THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS exceeds SL_BT_CONFIG_MAX_CONNECTIONS"
+#endif
+
+/*******************************************************************************
+ ******************************  LOCAL TYPES   *********************************
+ ******************************************************************************/
+
+/// Test session bound to a single connected central
+typedef struct {
+  /// Connection handle, 0 if the slot is free
+  uint8_t connection;
+  /// Test state of this link
+  throughput_state_t state;
+  /// Test type running on this link
+  throughput_notification_t test_type;
+  /// Client configuration of the data characteristics
+  throughput_notification_t notifications;
+  throughput_notification_t indications;
+  /// Indication state for result
+  throughput_notification_t result_indicated;
+  /// Indication state for transmission state
+  throughput_notification_t transmission_indicated;
+  /// Connection parameters
+  throughput_phy_t phy;
+  throughput_rssi_t rssi;
+  throughput_time_t interval;
+  throughput_time_t responder_latency;
+  throughput_time_t timeout;
+  throughput_pdu_size_t pdu_size;
+  throughput_mtu_size_t mtu_size;
+  /// Data sizes derived from the PDU and MTU of this link
+  uint16_t notification_data_size;
+  uint16_t indication_data_size;
+  throughput_data_size_t data_size;
+  /// Send timer
+  sl_simple_timer_t send_timer;
+  /// Indication timer
+  sl_simple_timer_t indication_timer;
+  /// Time storage variable
+  uint64_t time_start;
+  /// Byte counter variable
+  throughput_count_t bytes_sent;
+  /// Operation (indication, notification) counter variable
+  throughput_count_t operation_count;
+  /// Results of the last test on this link
+  throughput_value_t throughput;
+  throughput_count_t count;
+  throughput_count_t packet_error;
+  throughput_count_t packet_lost;
+  throughput_time_t time;
+  /// Sequence number of the next packet, see throughput_sequence.h
+  uint32_t send_sequence;
+  /// Frames packed into one notification, 0 if frame batching is not used
+  uint8_t frames_per_notification;
+  /// Sequence number of the next frame
+  uint32_t frame_sequence;
+  /// Frame batches filled by the sampler and sent from the queue memory
+  throughput_ring_t sample_queue;
+  uint32_t sample_queue_storage[SAMPLE_QUEUE_STORAGE_WORDS];
+  /// Sampler timer, runs during a notification test
+  sl_sleeptimer_timer_handle_t sample_timer;
+  /// Frames of the batch being filled by the sampler
+  uint8_t sample_batch_frames;
+  uint8_t sample_batch_fill;
+  bool sampling;
+  /// Transmit pacing, sending pauses for a backoff after the stack refused data
+  volatile bool tx_paused;
+  sl_sleeptimer_timer_handle_t tx_backoff_timer;
+  uint32_t tx_backoff;
+  uint32_t tx_pause_tick;
+  /// Transmit counters of the current test
+  throughput_count_t tx_attempts;
+  throughput_count_t tx_fail_no_buffer;
+  throughput_count_t tx_fail_busy;
+  throughput_count_t tx_fail_other;
+  sl_status_t tx_last_error;
+  volatile uint32_t tx_idle_ticks;
+  /// Client configuration of the pipeline characteristic
+  throughput_notification_t pipeline;
+  /// The indication test runs as a pipeline
+  bool pipeline_active;
+  /// Oldest unacknowledged and next new segment
+  uint32_t pipe_base;
+  uint32_t pipe_next;
+  /// Acknowledged segments, bit i is pipe_base + i
+  uint32_t pipe_acked;
+  /// Send time of the segments in flight, indexed by sequence
+  uint32_t pipe_sent_tick[THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW];
+  /// Pipeline counters of the current test
+  throughput_count_t pipe_retransmits;
+  throughput_count_t pipe_acks;
+  /// L2CAP test channel, 0 if the client did not open one
+  uint16_t l2cap_cid;
+  /// Largest SDU the client accepts
+  uint16_t l2cap_mtu;
+  /// SDU size and PDU size the channel carries, credits left to send
+  uint16_t l2cap_sdu_size;
+  uint16_t l2cap_mps;
+  uint16_t l2cap_credits;
+  /// Bytes of the current SDU already sent and its frame timestamp
+  uint16_t l2cap_sdu_offset;
+  uint32_t l2cap_sdu_timestamp;
+  /// Integrity trailer of the current SDU, computed with its first PDU
+  uint8_t l2cap_trailer[THROUGHPUT_INTEGRITY_SIZE_MAX];
+  /// Channel counters of the current test
+  throughput_count_t l2cap_pdus;
+  throughput_count_t l2cap_credit_stalls;
+  /// Loss detection of the received packets
+  throughput_sequence_rx_t sequence_rx;
+  /// Bit errors of the received packets
+  throughput_pattern_stats_t pattern_stats;
+  /// Integrity trailer of the packets, selected by the side starting the test
+  throughput_integrity_type_t integrity;
+  /// Cost of the trailers sent, and the checks of the ones received
+  throughput_integrity_stats_t integrity_stats;
+  /// Packets encrypted, selected by the side starting the test
+  bool encrypted;
+  /// Epoch of the nonces of the packets sent
+  uint32_t crypto_epoch;
+  /// Cost of the packets encrypted, or decrypted
+  throughput_crypto_stats_t crypto_stats;
+  /// Duplex test, the client writes to the sink while notifications are sent
+  bool duplex;
+  /// Upload test, the client writes to the sink and nothing is sent back
+  bool upload;
+  /// Downstream counters of the current duplex test
+  throughput_count_t down_bytes;
+  throughput_count_t down_packets;
+  throughput_duplex_latency_t down_latency;
+  /// Downstream results of the last duplex test
+  throughput_duplex_result_t down_result;
+  /// Downstream latency histogram, and its summary at the end of the test
+  throughput_latency_t down_histogram;
+  uint32_t down_buckets[THROUGHPUT_LATENCY_BUCKETS(THROUGHPUT_PERIPHERAL_LATENCY_RANGE_LOG2)];
+  throughput_latency_summary_t down_summary;
+  /// Writes to the echo characteristic notified back, and the ones failed
+  throughput_count_t echoes;
+  throughput_count_t echo_failures;
+  /// Conversion to the time base of the central, and the models received
+  throughput_clock_model_t clock;
+  throughput_count_t clock_updates;
+  /// The clock was synchronized when the test started
+  bool clock_synced;
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  /// Counters at the last window of the history
+  throughput_history_totals_t history_last;
+#endif
+  /// Finish test indicator
+  bool finish_test;
+  /// Send transmission state
+  bool send_transmission_state;
+  /// Flag for send timer
+  bool send_timer_rised;
+  /// Flag for indication timer
+  bool indication_timer_rised;
+  /// Flag for indication
+  bool indication_sent;
+  /// Flag for finish notification
+  bool notification_sent;
+  /// Flag for indication confirmation
+  bool indication_confirmed;
+  /// Round trip of the indications, sets their timeout
+  throughput_rtt_t rtt;
+  /// Time the indication waited for was sent in us
+  uint32_t indication_time;
+  /// Indicates that the test is from central to peripheral
+  bool central_test;
+  /// EM1 requirement is held for this link
+  bool em1_requested;
+  /// Service handle
+  uint32_t service_handle;
+  /// Characteristic handles
+  uint16_t notifications_handle;
+  uint16_t indications_handle;
+  uint16_t transmission_handle;
+  /// Stores the found characteristics
+  throughput_peripheral_characteristic_found_t characteristic_found;
+  /// Actions for the state machine
+  action_t action;
+} throughput_peripheral_session_t;
+
 /*******************************************************************************
  *****************************  LOCAL VARIABLES   ******************************
  ******************************************************************************/
 
-/// Internal state
+/// Internal state, mirrors the aggregate of all sessions
 static throughput_t peripheral_state;
 
-/// Connection handle
-static uint8_t connection = 0;
+/// Session table, one entry per connected central
+static throughput_peripheral_session_t sessions[THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS];
 
-/// Indication state for result
-static throughput_notification_t result_indicated = sl_bt_gatt_disable;
+/// Session to be served first in the next step
+static uint8_t session_next = 0;
 
-/// Indication state for transmission state
-static throughput_notification_t transmission_indicated = sl_bt_gatt_disable;
+/// Packet buffer shared by the links, the stack copies the packets it takes.
+/// Notifications, indications, pipeline segments and L2CAP PDUs are built in
+/// it right before they are sent.
+static uint8_t tx_data[THROUGHPUT_TX_DATA_SIZE];
+
+/// Session whose next notification tx_data holds, NULL if none. A refused
+/// notification is sent again from it unless another link took the buffer.
+static throughput_peripheral_session_t *tx_data_session = NULL;
 
 /// Advertising set handle
 static uint8_t advertising_set_handle  = 0xff;
@@ -117,45 +335,29 @@ static uint8_t coded_advertising_set_handle  = 0xff;
 /// Enabled state
 static bool enabled = false;
 
-/// Finish test indicator
-static bool finish_test = false;
-
-/// Send transmission state
-static bool send_transmission_state = false;
-
-/// Data size for indication
-static uint16_t indication_data_size = 0;
-
-/// Data size for notification
-static uint16_t notification_data_size = 0;
-
-/// Data for notification
-static uint8_t notification_data[THROUGHPUT_TX_DATA_SIZE] = { 0 };
-
-/// Data for indication
-static uint8_t indication_data[THROUGHPUT_TX_DATA_SIZE] = { 0 };
+/// Events handled by throughput_peripheral_on_event()
+static const uint32_t peripheral_events[] = {
+  sl_bt_evt_connection_opened_id,
+  sl_bt_evt_connection_parameters_id,
+  sl_bt_evt_connection_phy_status_id,
+  sl_bt_evt_connection_tx_power_id,
+  sl_bt_evt_connection_rssi_id,
+  sl_bt_evt_connection_closed_id,
+  sl_bt_evt_gatt_mtu_exchanged_id,
+  sl_bt_evt_gatt_server_attribute_value_id,
+  sl_bt_evt_gatt_server_characteristic_status_id,
+  sl_bt_evt_gatt_procedure_completed_id,
+  sl_bt_evt_gatt_service_id,
+  sl_bt_evt_gatt_characteristic_id,
+  sl_bt_evt_gatt_characteristic_value_id,
+  sl_bt_evt_l2cap_coc_connection_request_id,
+  sl_bt_evt_l2cap_coc_le_flow_control_credit_id,
+  sl_bt_evt_l2cap_coc_channel_disconnected_id
+};
 
 /// RSSI refresh timer
 static sl_simple_timer_t refresh_timer;
 
-/// Send timer
-static sl_simple_timer_t send_timer;
-
-/// Indication timer
-static sl_simple_timer_t indication_timer;
-
-/// Time storage variable
-static throughput_count_t time_start = 0;
-
-/// Time elapsed since start
-static throughput_count_t time_elapsed = 0;
-
-/// Bit counter variable
-static throughput_count_t bytes_sent = 0;
-
-/// Operation (indication, notification) counter variable
-static throughput_count_t operation_count = 0;
-
 /// Data size limit for fixed data mode
 static uint32_t fixed_data_size = THROUGHPUT_PERIPHERAL_FIXED_DATA_SIZE;
 
@@ -165,25 +367,13 @@ static uint32_t fixed_time = THROUGHPUT_PERIPHERAL_FIXED_TIME;
 /// Deep sleep enabled
 static bool deep_sleep_enabled = THROUGHPUT_PERIPHERAL_TX_SLEEP_ENABLE;
 
-/// Flag for send timer
-static bool send_timer_rised = false;
-
-/// Flag for indication timer
-static bool indication_timer_rised = false;
-
-/// Flag for indication
-static bool indication_sent = false;
-
-/// Flag for finish notification
-static bool notification_sent = false;
-
-/// Flag for indication confirmation
-static bool indication_confirmed = false;
-
 /// Power control status
 static connection_power_reporting_mode_t power_control_enabled
   = connection_power_reporting_disable;
 
+/// Maximum MTU size offered to the centrals
+static throughput_mtu_size_t max_mtu_size = THROUGHPUT_PERIPHERAL_MTU_SIZE;
+
 /// Requested notification data size
 static uint8_t requested_notification_size =
   THROUGHPUT_PERIPHERAL_DATA_TRANSFER_SIZE_NOTIFICATIONS;
@@ -192,72 +382,449 @@ static uint8_t requested_notification_size =
 static uint8_t requested_indication_size =
   THROUGHPUT_PERIPHERAL_DATA_TRANSFER_SIZE_INDICATIONS;
 
-/// Service handle
-static uint32_t  service_handle = 0xFFFFFFFF;
-/// Characteristic handles
-static uint16_t  notifications_handle = 0xFFFF;
-static uint16_t  indications_handle = 0xFFFF;
-static uint16_t  transmission_handle = 0xFFFF;
-
-/// Counter for checking data
-static uint8_t received_counter = 0;
-
-/// Flag for checking counter or accepting remote one
-static bool first_packet = true;
-
-/// Indicates that the test is from central to peripheral
-static bool central_test = false;
-
-/// Stores the found characteristics
-static throughput_peripheral_characteristic_found_t characteristic_found;
-
-/// Actions for the state machine
-static action_t action = act_none;
+#if THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+/// SDU being segmented, shared by the links as the SDU is generated again
+/// before each of its PDUs. The PDUs are built in tx_data.
+static uint8_t l2cap_sdu[THROUGHPUT_PERIPHERAL_L2CAP_SDU_SIZE];
+#endif
+
+/// Payload pattern sent, and the one followed by the received packets
+static throughput_pattern_t tx_pattern;
+static throughput_pattern_t rx_pattern;
+
+/// Integrity trailer requested for the tests started by the peripheral
+static throughput_integrity_type_t integrity_type = THROUGHPUT_PERIPHERAL_INTEGRITY;
+
+/// Encryption requested for the tests started by the peripheral, and its key
+static bool crypto_enabled = THROUGHPUT_PERIPHERAL_CRYPTO_ENABLE;
+static throughput_crypto_key_t crypto_key;
+
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+/// Time series of the test runs, see throughput_history.h
+static throughput_history_record_t history_records[THROUGHPUT_PERIPHERAL_HISTORY_RECORDS];
+static throughput_history_t history;
+static sl_simple_timer_t history_timer;
+static uint32_t history_window = THROUGHPUT_PERIPHERAL_HISTORY_WINDOW;
+static uint64_t history_start;
+static bool history_running = false;
+#endif
+
+/// Aggregate results of the links finished in the current test run
+static throughput_value_t aggregate_throughput = 0;
+static throughput_count_t aggregate_count = 0;
+static throughput_count_t aggregate_lost = 0;
+static throughput_count_t aggregate_error = 0;
+static throughput_time_t aggregate_time = 0;
+static uint8_t aggregate_links = 0;
+static bool aggregate_central_test = true;
 
 /*******************************************************************************
  *******************  FORWARD DECLARATION OF FUNCTIONS   ***********************
  ******************************************************************************/
-static void throughput_peripheral_calculate_notification_size(void);
-static void throughput_peripheral_calculate_indication_size(void);
-static void throughput_peripheral_generate_indications_data(void);
-static void throughput_peripheral_generate_notifications_data(void);
-static void throughput_peripheral_calculate_data_size(void);
+static void throughput_peripheral_calculate_notification_size(throughput_peripheral_session_t *session);
+static void throughput_peripheral_calculate_indication_size(throughput_peripheral_session_t *session);
+static sl_status_t throughput_peripheral_generate_indications_data(throughput_peripheral_session_t *session);
+static sl_status_t throughput_peripheral_generate_notifications_data(throughput_peripheral_session_t *session);
+static void throughput_peripheral_calculate_data_size(throughput_peripheral_session_t *session);
+static void throughput_peripheral_calculate_l2cap_size(throughput_peripheral_session_t *session);
+static uint16_t throughput_peripheral_content_size(throughput_peripheral_session_t *session,
+                                                   uint16_t size);
+static uint16_t throughput_peripheral_content_offset(throughput_peripheral_session_t *session);
+static uint16_t throughput_peripheral_seal(throughput_peripheral_session_t *session,
+                                           uint8_t *packet,
+                                           uint16_t len,
+                                           uint32_t sequence);
 static void throughput_peripheral_advertising_start(void);
-static void throughput_peripheral_refresh_connected_state(void);
+static void throughput_peripheral_refresh_connected_state(throughput_peripheral_session_t *session);
 static void throughput_peripheral_on_refresh_timer_rise(sl_simple_timer_t *timer,
                                                         void *data);
 static void throughput_peripheral_on_send_timer_rise(sl_simple_timer_t *timer,
                                                      void *data);
 static void throughput_peripheral_on_indication_timer_rise(sl_simple_timer_t *timer,
                                                            void *data);
-static void handle_throughput_peripheral_stop(bool send_transmission_on);
-static void handle_throughput_peripheral_start(bool send_transmission_on);
-static void throughput_peripheral_send_notification(void);
-static void throughput_peripheral_indication_confirm(void);
-static void throughput_peripheral_send_indication(void);
-static void process_procedure_complete_event(sl_bt_msg_t *evt);
-static void check_characteristic_uuid(sl_bt_msg_t *evt);
-static void check_received_data(uint8_t * data, uint8_t len);
-
-/// Send counter for package identification
-static uint8_t send_counter = 0;
+static void throughput_peripheral_indication_timer_start(throughput_peripheral_session_t *session);
+static bool throughput_peripheral_indication_timeout(throughput_peripheral_session_t *session);
+static void handle_throughput_peripheral_stop(throughput_peripheral_session_t *session,
+                                              bool send_transmission_on);
+static void handle_throughput_peripheral_start(throughput_peripheral_session_t *session,
+                                               bool send_transmission_on);
+static void throughput_peripheral_send_notification(throughput_peripheral_session_t *session);
+static void throughput_peripheral_send_sample_batch(throughput_peripheral_session_t *session);
+static void throughput_peripheral_sampler_start(throughput_peripheral_session_t *session);
+static void throughput_peripheral_sampler_stop(throughput_peripheral_session_t *session);
+static bool throughput_peripheral_tx_ready(throughput_peripheral_session_t *session);
+static void throughput_peripheral_tx_result(throughput_peripheral_session_t *session,
+                                            sl_status_t sc);
+static void throughput_peripheral_tx_pacing_stop(throughput_peripheral_session_t *session);
+static void throughput_peripheral_indication_confirm(throughput_peripheral_session_t *session);
+static void throughput_peripheral_send_indication(throughput_peripheral_session_t *session);
+static void throughput_peripheral_send_pipeline(throughput_peripheral_session_t *session);
+static void throughput_peripheral_pipeline_ack(throughput_peripheral_session_t *session,
+                                               const uint8_t *data,
+                                               uint16_t len);
+#if THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+static void throughput_peripheral_send_l2cap(throughput_peripheral_session_t *session);
+#endif
+static void throughput_peripheral_l2cap_request(sl_bt_evt_l2cap_coc_connection_request_t *request);
+static void process_procedure_complete_event(throughput_peripheral_session_t *session,
+                                             sl_bt_msg_t *evt);
+static void check_characteristic_uuid(throughput_peripheral_session_t *session,
+                                      sl_bt_msg_t *evt);
+static void check_received_data(throughput_peripheral_session_t *session,
+                                uint8_t * data,
+                                uint16_t len);
+static void throughput_peripheral_sink_write(throughput_peripheral_session_t *session,
+                                             const uint8_t *data,
+                                             uint16_t len);
+static uint64_t throughput_peripheral_local_time(void);
+static uint32_t throughput_peripheral_timestamp(throughput_peripheral_session_t *session);
+static void throughput_peripheral_check_upload(throughput_peripheral_session_t *session);
+static void throughput_peripheral_echo(throughput_peripheral_session_t *session,
+                                       const uint8_t *data,
+                                       uint16_t len);
+static throughput_peripheral_session_t *throughput_peripheral_find_session(uint8_t connection);
+static throughput_peripheral_session_t *throughput_peripheral_open_session(uint8_t connection);
+static void throughput_peripheral_close_session(throughput_peripheral_session_t *session);
+static uint8_t throughput_peripheral_session_count(void);
+static bool throughput_peripheral_is_testing(void);
+static bool throughput_peripheral_is_busy(void);
+static bool throughput_peripheral_session_is_busy(throughput_peripheral_session_t *session);
+static void throughput_peripheral_update_state(void);
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+static void throughput_peripheral_history_totals(throughput_peripheral_session_t *session,
+                                                 throughput_history_totals_t *totals);
+static void throughput_peripheral_history_sample(void);
+static void throughput_peripheral_history_update(throughput_state_t state);
+static void throughput_peripheral_on_history_timer_rise(sl_simple_timer_t *timer,
+                                                        void *data);
+#endif
+static void throughput_peripheral_finish_session(throughput_peripheral_session_t *session);
+static void throughput_peripheral_check_run_finished(void);
+static void throughput_peripheral_publish_value(throughput_peripheral_session_t *session,
+                                                uint16_t characteristic,
+                                                size_t len,
+                                                const uint8_t *value);
+static void throughput_peripheral_on_event(sl_bt_msg_t *evt);
+#ifdef SL_CATALOG_CLI_PRESENT
+static void throughput_peripheral_cli_add(void);
+static void throughput_peripheral_cli_remove(void);
+#endif // SL_CATALOG_CLI_PRESENT
 
 /*******************************************************************************
  **************************   LOCAL FUNCTIONS   ********************************
  ******************************************************************************/
 
+/**************************************************************************//**
+ * Finds the session that belongs to a connection.
+ * @param[in] connection connection handle
+ * @return session or NULL if the connection is not served
+ *****************************************************************************/
+static throughput_peripheral_session_t *throughput_peripheral_find_session(uint8_t connection)
+{
+  if (connection == 0) {
+    return NULL;
+  }
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection == connection) {
+      return &sessions[i];
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Allocates and initializes a session for a new connection.
+ * @param[in] connection connection handle
+ * @return session or NULL if the table is full
+ *****************************************************************************/
+static throughput_peripheral_session_t *throughput_peripheral_open_session(uint8_t connection)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session = &sessions[i];
+    if (session->connection == 0) {
+      memset(session, 0, sizeof(*session));
+      throughput_rtt_init(&session->rtt,
+                          THROUGHPUT_PERIPHERAL_RTO_INITIAL_MS * 1000,
+                          THROUGHPUT_PERIPHERAL_RTO_MIN_MS * 1000,
+                          THROUGHPUT_PERIPHERAL_RTO_MAX_MS * 1000);
+      throughput_latency_init(&session->down_histogram,
+                              session->down_buckets,
+                              sizeof(session->down_buckets) / sizeof(session->down_buckets[0]));
+      session->connection             = connection;
+      session->state                  = THROUGHPUT_STATE_CONNECTED;
+      session->test_type              = sl_bt_gatt_disable;
+      session->notifications          = sl_bt_gatt_disable;
+      session->indications            = sl_bt_gatt_disable;
+      session->result_indicated       = sl_bt_gatt_disable;
+      session->transmission_indicated = sl_bt_gatt_disable;
+      session->phy                    = sl_bt_gap_1m_phy_uncoded;
+      session->mtu_size               = max_mtu_size;
+      session->service_handle         = 0xFFFFFFFF;
+      session->notifications_handle   = 0xFFFF;
+      session->indications_handle     = 0xFFFF;
+      session->transmission_handle    = 0xFFFF;
+      session->action                 = act_none;
+      throughput_ring_init(&session->sample_queue,
+                           (uint8_t *)session->sample_queue_storage,
+                           THROUGHPUT_TX_DATA_SIZE,
+                           THROUGHPUT_PERIPHERAL_SAMPLE_QUEUE_SLOTS);
+      throughput_peripheral_calculate_data_size(session);
+      return session;
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Releases the session of a closed connection.
+ * @param[in] session session to release
+ *****************************************************************************/
+static void throughput_peripheral_close_session(throughput_peripheral_session_t *session)
+{
+  throughput_peripheral_sampler_stop(session);
+  throughput_peripheral_tx_pacing_stop(session);
+  sl_simple_timer_stop(&session->send_timer);
+  sl_simple_timer_stop(&session->indication_timer);
+  if (session->em1_requested) {
+    // Enable sleep
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+    session->em1_requested = false;
+  }
+  if (tx_data_session == session) {
+    tx_data_session = NULL;
+  }
+  session->connection = 0;
+  session->l2cap_cid = 0;
+  session->state = THROUGHPUT_STATE_DISCONNECTED;
+}
+
+/**************************************************************************//**
+ * Takes the packet buffer shared by the links. A notification another link
+ * left in it is built again before that link sends it.
+ * @return the buffer
+ *****************************************************************************/
+static uint8_t *throughput_peripheral_tx_data(void)
+{
+  tx_data_session = NULL;
+  return tx_data;
+}
+
+/**************************************************************************//**
+ * Counts the connected sessions.
+ * @return number of sessions in use
+ *****************************************************************************/
+static uint8_t throughput_peripheral_session_count(void)
+{
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection != 0) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**************************************************************************//**
+ * Checks whether any of the sessions is running or finishing a test.
+ * @return true if a test is in progress on any link
+ *****************************************************************************/
+static bool throughput_peripheral_is_testing(void)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection != 0
+        && (sessions[i].state == THROUGHPUT_STATE_TEST
+            || sessions[i].state == THROUGHPUT_STATE_TEST_FINISH)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * Checks if any link has work for the CPU.
+ * @return true if the main loop must keep running
+ *****************************************************************************/
+static bool throughput_peripheral_is_busy(void)
+{
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (throughput_peripheral_session_is_busy(&sessions[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************************************************************************//**
+ * Derives the aggregate state from the sessions and reports it.
+ *****************************************************************************/
+static void throughput_peripheral_update_state(void)
+{
+  throughput_state_t state = THROUGHPUT_STATE_DISCONNECTED;
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_state_t session_state = sessions[i].state;
+    if (sessions[i].connection == 0) {
+      continue;
+    }
+    if (session_state == THROUGHPUT_STATE_TEST_FINISH) {
+      session_state = THROUGHPUT_STATE_TEST;
+    }
+    if (session_state > state) {
+      state = session_state;
+    }
+  }
+  peripheral_state.state = state;
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  throughput_peripheral_history_update(state);
+#endif
+  throughput_peripheral_on_state_change(peripheral_state.state);
+}
+
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+/**************************************************************************//**
+ * Running totals of a session recorded in the history.
+ * @param[in] session session to read
+ * @param[out] totals totals of the current test of the session
+ *****************************************************************************/
+static void throughput_peripheral_history_totals(throughput_peripheral_session_t *session,
+                                                 throughput_history_totals_t *totals)
+{
+  totals->bytes = session->bytes_sent + session->down_bytes;
+  totals->packets = session->operation_count + session->down_packets;
+  totals->retries = session->tx_fail_no_buffer + session->tx_fail_busy
+                    + session->pipe_retransmits + session->l2cap_credit_stalls;
+  totals->lost = session->sequence_rx.stats.lost;
+}
+
+/**************************************************************************//**
+ * Records a window of all the sessions in the history. The RSSI is the
+ * weakest of the links under test, refreshed for the next window.
+ *****************************************************************************/
+static void throughput_peripheral_history_sample(void)
+{
+  throughput_history_totals_t window = { 0 };
+  throughput_history_totals_t totals;
+  throughput_rssi_t rssi = peripheral_state.rssi;
+  throughput_phy_t phy = peripheral_state.phy;
+  bool first = true;
+  uint32_t time;
+
+  time = (uint32_t)throughput_clock_ticks_to_us(sl_sleeptimer_get_tick_count64() - history_start,
+                                                sl_sleeptimer_get_timer_frequency()) / 1000;
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session = &sessions[i];
+    if (session->connection == 0) {
+      continue;
+    }
+    throughput_peripheral_history_totals(session, &totals);
+    throughput_history_accumulate(&window, &session->history_last, &totals);
+    if (session->state != THROUGHPUT_STATE_TEST
+        && session->state != THROUGHPUT_STATE_TEST_FINISH) {
+      continue;
+    }
+    if (first || session->rssi < rssi) {
+      rssi = session->rssi;
+    }
+    if (first) {
+      phy = session->phy;
+      first = false;
+    }
+    (void)sl_bt_connection_get_rssi(session->connection);
+  }
+  throughput_history_sample(&history, time, &window, rssi, phy);
+}
+
+/**************************************************************************//**
+ * Starts the history with the first session under test, and records the last
+ * window when no session is under test any more.
+ * @param[in] state aggregate state of the sessions
+ *****************************************************************************/
+static void throughput_peripheral_history_update(throughput_state_t state)
+{
+  sl_status_t sc;
+
+  if (state == THROUGHPUT_STATE_TEST && !history_running && history_window > 0) {
+    throughput_history_reset(&history);
+    for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+      throughput_peripheral_history_totals(&sessions[i], &sessions[i].history_last);
+    }
+    history_start = sl_sleeptimer_get_tick_count64();
+    sc = sl_simple_timer_start(&history_timer,
+                               history_window,
+                               throughput_peripheral_on_history_timer_rise,
+                               NULL,
+                               true);
+    app_assert_status(sc);
+    history_running = true;
+  } else if (state != THROUGHPUT_STATE_TEST && history_running) {
+    // The last window is recorded as short as it was
+    throughput_peripheral_history_sample();
+    sc = sl_simple_timer_stop(&history_timer);
+    app_assert_status(sc);
+    history_running = false;
+  }
+}
+
+/**************************************************************************//**
+ * History timer callback.
+ *****************************************************************************/
+static void throughput_peripheral_on_history_timer_rise(sl_simple_timer_t *timer,
+                                                        void *data)
+{
+  (void)timer;
+  (void)data;
+  throughput_peripheral_history_sample();
+}
+#endif // THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+
+/**************************************************************************//**
+ * Writes a value of the information service and notifies the owning link.
+ * The local attribute value is shared and holds the value of the link that
+ * changed last; the notification only goes to the link the value belongs to.
+ * @param[in] session session the value belongs to
+ * @param[in] characteristic characteristic handle
+ * @param[in] len length of the value
+ * @param[in] value value to publish
+ *****************************************************************************/
+static void throughput_peripheral_publish_value(throughput_peripheral_session_t *session,
+                                                uint16_t characteristic,
+                                                size_t len,
+                                                const uint8_t *value)
+{
+  sl_status_t sc;
+
+  sc = sl_bt_gatt_server_write_attribute_value(characteristic,
+                                               0,
+                                               len,
+                                               value);
+  app_assert_status(sc);
+
+  // Fails if the peer did not subscribe, which is not an error here.
+  (void)sl_bt_gatt_server_send_notification(session->connection,
+                                            characteristic,
+                                            len,
+                                            value);
+}
+
 /**************************************************************************//**
  * Calculates and sets the indication and notification data size
  *****************************************************************************/
-static void throughput_peripheral_calculate_data_size(void)
+static void throughput_peripheral_calculate_data_size(throughput_peripheral_session_t *session)
 {
-  throughput_peripheral_calculate_indication_size();
-  throughput_peripheral_calculate_notification_size();
-  if (peripheral_state.test_type & sl_bt_gatt_indication) {
-    peripheral_state.data_size = indication_data_size;
+  throughput_peripheral_calculate_indication_size(session);
+  throughput_peripheral_calculate_notification_size(session);
+  if (session->l2cap_cid != 0) {
+    throughput_peripheral_calculate_l2cap_size(session);
+  }
+  if (session->test_type & THROUGHPUT_TEST_L2CAP) {
+    session->data_size = session->l2cap_sdu_size;
+  } else if (session->test_type & sl_bt_gatt_indication) {
+    session->data_size = session->indication_data_size;
   } else {
-    peripheral_state.data_size = notification_data_size;
+    session->data_size = session->notification_data_size;
   }
+  peripheral_state.pdu_size = session->pdu_size;
+  peripheral_state.mtu_size = session->mtu_size;
+  peripheral_state.data_size = session->data_size;
 }
 
 /**************************************************************************//**
@@ -272,16 +839,19 @@ static void throughput_peripheral_advertising_start(void)
   sl_bt_advertiser_stop(advertising_set_handle);
   sl_bt_advertiser_stop(coded_advertising_set_handle);
 
-  // Convert power to mdBm
-  int16_t power = ( ((int16_t)peripheral_state.tx_power_requested) * 10);
-  sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
-                                 power,
-                                 &tx_power_min,
-                                 &tx_power_max);
-  app_assert_status(sc);
-  peripheral_state.tx_power = tx_power_max / 10;
+  // TX power can only be changed while no link is open.
+  if (throughput_peripheral_session_count() == 0) {
+    // Convert power to mdBm
+    int16_t power = ( ((int16_t)peripheral_state.tx_power_requested) * 10);
+    sc = sl_bt_system_set_tx_power(CONFIG_TX_POWER_MIN,
+                                   power,
+                                   &tx_power_min,
+                                   &tx_power_max);
+    app_assert_status(sc);
+    peripheral_state.tx_power = tx_power_max / 10;
 
-  throughput_peripheral_on_power_change(peripheral_state.tx_power);
+    throughput_peripheral_on_power_change(peripheral_state.tx_power);
+  }
 
   // Delete sets.
   sl_bt_advertiser_delete_set(advertising_set_handle);
@@ -354,292 +924,927 @@ static void throughput_peripheral_advertising_start(void)
 /**************************************************************************//**
  * Calculate optimal notification size given current PDU and MTU sizes.
  *****************************************************************************/
-static void throughput_peripheral_calculate_notification_size(void)
+static void throughput_peripheral_calculate_notification_size(throughput_peripheral_session_t *session)
 {
   if (requested_notification_size == 0
       || requested_notification_size
-      > (peripheral_state.mtu_size - NOTIFICATION_GATT_HEADER)) {
-    if ((peripheral_state.pdu_size != 0) && (peripheral_state.mtu_size != 0)) {
+      > (session->mtu_size - NOTIFICATION_GATT_HEADER)) {
+    if ((session->pdu_size != 0) && (session->mtu_size != 0)) {
       // Optimally split over multiple over-the-air packets.
-      if (peripheral_state.pdu_size <= peripheral_state.mtu_size) {
-        notification_data_size = (peripheral_state.pdu_size
-                                  - (L2CAP_HEADER + NOTIFICATION_GATT_HEADER))
-                                 + ((peripheral_state.mtu_size - NOTIFICATION_GATT_HEADER
-                                     - peripheral_state.pdu_size + (L2CAP_HEADER
-                                                                    + NOTIFICATION_GATT_HEADER))
-                                    / peripheral_state.pdu_size
-                                    * peripheral_state.pdu_size);
+      if (session->pdu_size <= session->mtu_size) {
+        session->notification_data_size = (session->pdu_size
+                                           - (L2CAP_HEADER + NOTIFICATION_GATT_HEADER))
+                                          + ((session->mtu_size - NOTIFICATION_GATT_HEADER
+                                              - session->pdu_size + (L2CAP_HEADER
+                                                                     + NOTIFICATION_GATT_HEADER))
+                                             / session->pdu_size
+                                             * session->pdu_size);
       } else {
         // Single over-the-air packet, but accommodate room for headers.
-        if ((peripheral_state.pdu_size - peripheral_state.mtu_size) <= L2CAP_HEADER) {
+        if ((session->pdu_size - session->mtu_size) <= L2CAP_HEADER) {
           // LL PDU size - (L2CAP+GATT Headers)
-          notification_data_size = peripheral_state.pdu_size
-                                   - (L2CAP_HEADER + NOTIFICATION_GATT_HEADER);
+          session->notification_data_size = session->pdu_size
+                                            - (L2CAP_HEADER + NOTIFICATION_GATT_HEADER);
         } else {
           // Room for the whole MTU, so data payload is MTU - Header of operation.
-          notification_data_size = peripheral_state.mtu_size - NOTIFICATION_GATT_HEADER;
+          session->notification_data_size = session->mtu_size - NOTIFICATION_GATT_HEADER;
         }
       }
     }
   } else {
-    notification_data_size = requested_notification_size;
+    session->notification_data_size = requested_notification_size;
+  }
+
+  session->frames_per_notification = 0;
+  // Duplex packets carry their own timestamp instead of frames
+  if (THROUGHPUT_PERIPHERAL_FRAME_BATCHING && !session->duplex) {
+    // Trim to whole frames, the rest of the payload would be padding
+    uint8_t frames = throughput_frame_batch_capacity(
+      throughput_peripheral_content_size(session, session->notification_data_size));
+    if (frames > 0) {
+      session->frames_per_notification = frames;
+      session->notification_data_size = throughput_frame_batch_size(frames)
+                                        + throughput_integrity_size(session->integrity)
+                                        + (session->encrypted ? THROUGHPUT_CRYPTO_OVERHEAD : 0);
+    }
   }
 }
 
 /**************************************************************************//**
  * Calculate indication size given current MTU size.
  *****************************************************************************/
-static void throughput_peripheral_calculate_indication_size(void)
+static void throughput_peripheral_calculate_indication_size(throughput_peripheral_session_t *session)
 {
   // MTU - 3B for indication GATT operation header.
   if (requested_indication_size == 0
       || requested_indication_size
-      > (peripheral_state.mtu_size - INDICATION_GATT_HEADER)) {
+      > (session->mtu_size - INDICATION_GATT_HEADER)) {
     // If larger than max, use max for operation.
-    indication_data_size = peripheral_state.mtu_size - INDICATION_GATT_HEADER;
+    session->indication_data_size = session->mtu_size - INDICATION_GATT_HEADER;
   } else {
     // If smaller, use given.
-    indication_data_size = requested_indication_size;
+    session->indication_data_size = requested_indication_size;
+  }
+}
+
+/**************************************************************************//**
+ * Calculate the SDU size of the L2CAP channel given the client's MTU.
+ *****************************************************************************/
+static void throughput_peripheral_calculate_l2cap_size(throughput_peripheral_session_t *session)
+{
+  uint16_t sdu_size = session->l2cap_mtu;
+  uint8_t frames;
+
+  if (sdu_size > THROUGHPUT_PERIPHERAL_L2CAP_SDU_SIZE) {
+    sdu_size = THROUGHPUT_PERIPHERAL_L2CAP_SDU_SIZE;
+  }
+  if (THROUGHPUT_PERIPHERAL_FRAME_BATCHING) {
+    // Trim to whole frames, the rest of the SDU would be padding
+    frames = throughput_frame_batch_capacity(throughput_peripheral_content_size(session, sdu_size));
+    if (frames > 0) {
+      sdu_size = throughput_frame_batch_size(frames)
+                 + throughput_integrity_size(session->integrity);
+    }
+  }
+  session->l2cap_sdu_size = sdu_size;
+}
+
+/**************************************************************************//**
+ * Bytes of a packet left for its content after the integrity trailer and the
+ * encryption envelope.
+ * @param[in] session session sending the packet
+ * @param[in] size packet size
+ * @return content size
+ *****************************************************************************/
+static uint16_t throughput_peripheral_content_size(throughput_peripheral_session_t *session,
+                                                   uint16_t size)
+{
+  uint8_t overhead = throughput_integrity_size(session->integrity)
+                     + (session->encrypted ? THROUGHPUT_CRYPTO_OVERHEAD : 0);
+  return (size > overhead) ? (uint16_t)(size - overhead) : 0;
+}
+
+/**************************************************************************//**
+ * Offset of the content in a packet, after the envelope header.
+ * @param[in] session session sending the packet
+ * @return content offset
+ *****************************************************************************/
+static uint16_t throughput_peripheral_content_offset(throughput_peripheral_session_t *session)
+{
+  return session->encrypted ? THROUGHPUT_CRYPTO_HEADER_SIZE : 0;
+}
+
+/**************************************************************************//**
+ * Encrypts a packet in place if the test is encrypted.
+ * @param[in] session session sending the packet
+ * @param[in,out] packet packet, its content at the content offset
+ * @param[in] len content length with the integrity trailer
+ * @param[in] sequence sequence number of the packet
+ * @return packet length, 0 if the packet failed to encrypt and must not be
+ *         sent
+ *****************************************************************************/
+static uint16_t throughput_peripheral_seal(throughput_peripheral_session_t *session,
+                                           uint8_t *packet,
+                                           uint16_t len,
+                                           uint32_t sequence)
+{
+  if (!session->encrypted) {
+    return len;
   }
+  return (uint16_t)throughput_crypto_seal(&crypto_key,
+                                          session->crypto_epoch,
+                                          sequence,
+                                          packet,
+                                          len,
+                                          &session->crypto_stats);
 }
 
 /***************************************************************************//**
  * Checks received data for lost or error packages
+ * @param[in] session session that received the data
  * @param[in] data received data
  * @param[in] len length of the data
  ******************************************************************************/
-static void check_received_data(uint8_t * data, uint8_t len)
+static void check_received_data(throughput_peripheral_session_t *session,
+                                uint8_t * data,
+                                uint16_t len)
 {
-  uint8_t counter;
+  throughput_frame_batch_header_t header;
+  uint32_t sequence;
+
+  // Decrypt in place, the checks below run on the content
+  if (session->encrypted) {
+    if (!throughput_crypto_open(&crypto_key, data, len, &session->crypto_stats)) {
+      session->packet_error++;
+      return;
+    }
+    data += THROUGHPUT_CRYPTO_HEADER_SIZE;
+    len -= THROUGHPUT_CRYPTO_OVERHEAD;
+  }
 
-  if (len == 0) {
-    peripheral_state.packet_error++;
+  // The content of a packet failing its integrity check cannot be trusted,
+  // its sequence number included
+  if (!throughput_integrity_check(session->integrity, data, len, &session->integrity_stats)) {
+    session->packet_error++;
     return;
   }
-
-  counter = data[0];
-
-  if (first_packet) {
-    // Accept remote counter
-    received_counter = counter;
-    first_packet = false;
-  } else {
-    // Increment local counter
-    received_counter = (received_counter + 1) % 100;
-  }
-  if (counter != received_counter) {
-    // Lost packet is found
-    uint8_t lost_packet_count = 0;
-    // Calculate lost packet count
-    if (counter > received_counter) {
-      lost_packet_count = counter - received_counter;
-    } else if (counter < received_counter) {
-      lost_packet_count = 100 + counter - received_counter;
-    }
-    peripheral_state.packet_lost += lost_packet_count;
-    // Sync to remote counter
-    received_counter = counter;
-  }
-
-  // Check data for bit errors
-  for (int i = 1; i < len; i++) {
-    if ( data[i] != (uint8_t) 'a' + (uint8_t) ((i - 1) % 26) ) {
-      peripheral_state.packet_error++;
-      break;
+  len = (uint16_t)(len - throughput_integrity_size(session->integrity));
+
+  if (throughput_frame_batch_parse(data, len, &header)) {
+    sequence = header.sequence;
+  } else if (len >= THROUGHPUT_SEQUENCE_SIZE) {
+    sequence = throughput_sequence_read(data);
+    if (!throughput_sequence_check_packet(data, len, &rx_pattern, &session->pattern_stats)) {
+      session->packet_error++;
     }
+  } else {
+    session->packet_error++;
+    return;
   }
+  (void)throughput_sequence_rx_accept(&session->sequence_rx, sequence);
+  session->packet_lost = session->sequence_rx.stats.lost;
 }
 
 /**************************************************************************//**
- * Function to generate payload
+ * Free running microsecond time of the peripheral.
+ * @return time in microseconds
  *****************************************************************************/
-static void throughput_peripheral_generate_notifications_data(void)
+static uint64_t throughput_peripheral_local_time(void)
 {
-  // Define the 7 float values: 1.1, 2.2, 3.3, 4.4, 5.5, 6.6, 7.7
-  const float float_values[7] = {1.1f, 2.2f, 3.3f, 4.4f, 5.5f, 6.6f, 7.7f};
-  uint8_t *data_ptr = notification_data;
-
-  // Copy float values to byte array (little-endian)
-  for (int i = 0; i < 7; i++) {
-    memcpy(data_ptr, &float_values[i], sizeof(float));
-    data_ptr += sizeof(float);
-  }
-
-  send_counter = (send_counter + 1) % 100;
+  return throughput_clock_ticks_to_us(sl_sleeptimer_get_tick_count64(),
+                                      sl_sleeptimer_get_timer_frequency());
 }
 
 /**************************************************************************//**
- * Function to generate payload
+ * Microsecond time stamping the duplex packets, in the time base of the
+ * central once it synchronized the session.
+ * @param[in] session session of the packets
+ * @return time in microseconds, wraps around
  *****************************************************************************/
-static void throughput_peripheral_generate_indications_data(void)
+static uint32_t throughput_peripheral_timestamp(throughput_peripheral_session_t *session)
+{
+  return (uint32_t)throughput_clock_convert(&session->clock,
+                                            throughput_peripheral_local_time());
+}
+
+/***************************************************************************//**
+ * Accounts a packet written to the sink by the client in a duplex or upload
+ * test. The downstream is sent in the clear, without an integrity trailer.
+ * @param[in] session session that received the data
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void throughput_peripheral_sink_write(throughput_peripheral_session_t *session,
+                                             const uint8_t *data,
+                                             uint16_t len)
+{
+  uint32_t received = throughput_peripheral_timestamp(session);
+  uint32_t sent;
+  uint32_t excess;
+
+  if (session->state != THROUGHPUT_STATE_TEST || !(session->duplex || session->upload)) {
+    return;
+  }
+  session->down_bytes += len;
+  session->down_packets++;
+  if (len < THROUGHPUT_DUPLEX_MIN_SIZE) {
+    session->packet_error++;
+    return;
+  }
+  if (!throughput_duplex_check_packet(data, len, &rx_pattern, &session->pattern_stats, &sent)) {
+    session->packet_error++;
+  }
+  excess = throughput_duplex_latency_add(&session->down_latency, sent, received);
+  // Synchronized clocks give the one-way latency itself
+  throughput_latency_add(&session->down_histogram,
+                         session->clock_synced ? throughput_clock_delay(sent, received) : excess);
+  (void)throughput_sequence_rx_accept(&session->sequence_rx, throughput_sequence_read(data));
+  session->packet_lost = session->sequence_rx.stats.lost;
+}
+
+/***************************************************************************//**
+ * Notifies a value written to the echo characteristic back to the client, so
+ * that it measures the round trip by its own clock. Latency probes are echoed
+ * with the local time of reception for the clock synchronization, and clock
+ * models written by the client are applied instead of echoed.
+ * @param[in] session session that received the data
+ * @param[in] data received data
+ * @param[in] len length of the data
+ ******************************************************************************/
+static void throughput_peripheral_echo(throughput_peripheral_session_t *session,
+                                       const uint8_t *data,
+                                       uint16_t len)
 {
-  // Define the 7 float values: 1.1, 2.2, 3.3, 4.4, 5.5, 6.6, 7.7
-  const float float_values[7] = {1.1f, 2.2f, 3.3f, 4.4f, 5.5f, 6.6f, 7.7f};
-  uint8_t *data_ptr = indication_data;
+  uint8_t reply[THROUGHPUT_CLOCK_ECHO_SIZE];
+  uint64_t received = throughput_peripheral_local_time();
+  sl_status_t sc;
 
-  // Copy float values to byte array (little-endian)
-  for (int i = 0; i < 7; i++) {
-    memcpy(data_ptr, &float_values[i], sizeof(float));
-    data_ptr += sizeof(float);
+  if (throughput_clock_unpack(data, len, &session->clock)) {
+    session->clock_updates++;
+    return;
+  }
+  if (len == THROUGHPUT_CLOCK_PROBE_SIZE) {
+    memcpy(reply, data, THROUGHPUT_CLOCK_PROBE_SIZE);
+    throughput_clock_write(reply + THROUGHPUT_CLOCK_PROBE_SIZE, received);
+    data = reply;
+    len = sizeof(reply);
+  }
+  sc = sl_bt_gatt_server_send_notification(session->connection,
+                                           gattdb_throughput_echo,
+                                           len,
+                                           data);
+  if (sc == SL_STATUS_OK) {
+    session->echoes++;
+  } else {
+    session->echo_failures++;
   }
+}
 
-  send_counter = (send_counter + 1) % 100;
+/***************************************************************************//**
+ * Ends an upload at the fixed time or length, the data is written by the
+ * client.
+ * @param[in] session session under test
+ ******************************************************************************/
+static void throughput_peripheral_check_upload(throughput_peripheral_session_t *session)
+{
+  if (session->finish_test || session->send_timer_rised) {
+    session->send_timer_rised = false;
+    handle_throughput_peripheral_stop(session, true);
+  } else if ((peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
+             && (session->down_bytes >= fixed_data_size)) {
+    handle_throughput_peripheral_stop(session, true);
+  }
 }
 
 /**************************************************************************//**
- * Refresh throughput state
+ * Function to generate payload. Builds the next notification of the session
+ * in tx_data, its sequence numbers only advance once it was sent.
+ * @return SL_STATUS_FAIL if the integrity trailer could not be computed or the
+ *         packet failed to encrypt, it is built again before the next
+ *         notification
  *****************************************************************************/
-static void throughput_peripheral_refresh_connected_state(void)
+static sl_status_t throughput_peripheral_generate_notifications_data(throughput_peripheral_session_t *session)
 {
-  if ( ( (peripheral_state.notifications == sl_bt_gatt_notification)
-         || (peripheral_state.indications == sl_bt_gatt_indication) )
-       && (result_indicated != sl_bt_gatt_disable)
-       && (transmission_indicated != sl_bt_gatt_disable)) {
-    peripheral_state.state = THROUGHPUT_STATE_SUBSCRIBED;
+  uint8_t *packet = throughput_peripheral_tx_data();
+  uint8_t *data_ptr = packet + throughput_peripheral_content_offset(session);
+  size_t packet_len;
+  uint16_t len;
+  sl_status_t sc;
+
+  if (session->frames_per_notification > 0) {
+    // Pack as many timestamped frames as the notification holds
+    const float float_values[THROUGHPUT_FRAME_VALUES] = THROUGHPUT_FRAME_TEST_VALUES;
+    throughput_frame_t frame;
+    frame.timestamp = sl_sleeptimer_get_tick_count();
+    memcpy(frame.values, float_values, sizeof(frame.values));
+    throughput_frame_batch_write_header(data_ptr,
+                                        session->frames_per_notification,
+                                        session->send_sequence,
+                                        session->frame_sequence);
+    for (uint8_t i = 0; i < session->frames_per_notification; i++) {
+      throughput_frame_batch_write_frame(data_ptr, i, &frame);
+    }
+    sc = throughput_integrity_append(session->integrity,
+                                     data_ptr,
+                                     throughput_frame_batch_size(session->frames_per_notification),
+                                     &session->integrity_stats,
+                                     &packet_len);
+    if (sc == SL_STATUS_OK
+        && throughput_peripheral_seal(session,
+                                      packet,
+                                      (uint16_t)packet_len,
+                                      session->send_sequence) == 0) {
+      sc = SL_STATUS_FAIL;
+    }
+    if (sc == SL_STATUS_OK) {
+      tx_data_session = session;
+    }
+    return sc;
+  }
+
+  // Sequence number followed by the payload pattern, and the send time in
+  // a duplex test
+  len = throughput_peripheral_content_size(session, session->notification_data_size);
+  if (session->duplex && len >= THROUGHPUT_DUPLEX_MIN_SIZE) {
+    throughput_duplex_write_packet(data_ptr,
+                                   len,
+                                   session->send_sequence,
+                                   &tx_pattern,
+                                   throughput_peripheral_timestamp(session));
   } else {
-    peripheral_state.state = THROUGHPUT_STATE_CONNECTED;
+    throughput_sequence_write_packet(data_ptr,
+                                     len,
+                                     session->send_sequence,
+                                     &tx_pattern);
   }
-  throughput_peripheral_on_state_change(peripheral_state.state);
+  sc = throughput_integrity_append(session->integrity,
+                                   data_ptr,
+                                   len,
+                                   &session->integrity_stats,
+                                   &packet_len);
+  if (sc == SL_STATUS_OK
+      && throughput_peripheral_seal(session,
+                                    packet,
+                                    (uint16_t)packet_len,
+                                    session->send_sequence) == 0) {
+    sc = SL_STATUS_FAIL;
+  }
+  if (sc == SL_STATUS_OK) {
+    tx_data_session = session;
+  }
+  return sc;
 }
 
 /**************************************************************************//**
- * Refresh RSSI timer callback.
+ * Function to generate payload
+ * @return SL_STATUS_FAIL if the integrity trailer could not be computed or the
+ *         packet failed to encrypt, the indication must not be sent
  *****************************************************************************/
-static void throughput_peripheral_on_refresh_timer_rise(sl_simple_timer_t *timer,
-                                                        void *data)
+static sl_status_t throughput_peripheral_generate_indications_data(throughput_peripheral_session_t *session)
 {
-  (void) data;
-  (void) timer;
+  uint8_t *packet = throughput_peripheral_tx_data();
+  uint8_t *data_ptr = packet + throughput_peripheral_content_offset(session);
+  uint16_t len = throughput_peripheral_content_size(session, session->indication_data_size);
+  size_t packet_len;
   sl_status_t sc;
-  if (connection && peripheral_state.state != THROUGHPUT_STATE_TEST) {
-    sc = sl_bt_connection_get_rssi(connection);
-    app_assert_status(sc);
+
+  // Sequence number followed by the payload pattern. The sequence only
+  // advances once the indication is confirmed.
+  throughput_sequence_write_packet(data_ptr,
+                                   len,
+                                   session->send_sequence,
+                                   &tx_pattern);
+  sc = throughput_integrity_append(session->integrity,
+                                   data_ptr,
+                                   len,
+                                   &session->integrity_stats,
+                                   &packet_len);
+  if (sc != SL_STATUS_OK) {
+    return sc;
   }
+  if (throughput_peripheral_seal(session,
+                                 packet,
+                                 (uint16_t)packet_len,
+                                 session->send_sequence) == 0) {
+    return SL_STATUS_FAIL;
+  }
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
- * Send timer callback.
+ * Sampler timer callback, runs in interrupt context. Adds one frame to the
+ * batch in the sample queue and publishes the batch once it is full. The
+ * sample is dropped if the queue is full.
  *****************************************************************************/
-static void throughput_peripheral_on_send_timer_rise(sl_simple_timer_t *timer,
-                                                     void *data)
+static void throughput_peripheral_on_sample(sl_sleeptimer_timer_handle_t *handle,
+                                            void *data)
 {
-  (void) data;
-  (void) timer;
-  send_timer_rised = true;
+  (void)handle;
+  const float float_values[THROUGHPUT_FRAME_VALUES] = THROUGHPUT_FRAME_TEST_VALUES;
+  throughput_peripheral_session_t *session = (throughput_peripheral_session_t *)data;
+  throughput_frame_t frame;
+  uint8_t *batch;
+
+  batch = throughput_ring_reserve(&session->sample_queue);
+  if (batch == NULL) {
+    // Overrun, the central sees the gap in the sequence
+    session->frame_sequence++;
+    return;
+  }
+  if (session->sample_batch_fill == 0) {
+    session->sample_batch_frames = session->frames_per_notification;
+    throughput_frame_batch_write_header(batch,
+                                        session->sample_batch_frames,
+                                        session->send_sequence,
+                                        session->frame_sequence);
+    session->send_sequence++;
+  }
+  frame.timestamp = sl_sleeptimer_get_tick_count();
+  memcpy(frame.values, float_values, sizeof(frame.values));
+  throughput_frame_batch_write_frame(batch, session->sample_batch_fill, &frame);
+  session->frame_sequence++;
+  session->sample_batch_fill++;
+  if (session->sample_batch_fill >= session->sample_batch_frames) {
+    throughput_ring_produce(&session->sample_queue,
+                            throughput_frame_batch_size(session->sample_batch_frames));
+    session->sample_batch_fill = 0;
+  }
 }
 
 /**************************************************************************//**
- * Indication timer callback.
+ * Starts the sampler of a notification test with an empty queue.
  *****************************************************************************/
-static void throughput_peripheral_on_indication_timer_rise(sl_simple_timer_t *timer,
-                                                           void *data)
+static void throughput_peripheral_sampler_start(throughput_peripheral_session_t *session)
 {
-  (void) data;
-  (void) timer;
-  indication_timer_rised = true;
+  sl_status_t sc;
+  uint32_t rate = THROUGHPUT_PERIPHERAL_SAMPLE_RATE;
+  uint32_t period = sl_sleeptimer_get_timer_frequency() / rate;
+
+  throughput_ring_reset(&session->sample_queue);
+  session->sample_batch_fill = 0;
+  session->frame_sequence = 0;
+  sc = sl_sleeptimer_start_periodic_timer(&session->sample_timer,
+                                          period > 0 ? period : 1,
+                                          throughput_peripheral_on_sample,
+                                          session,
+                                          0,
+                                          0);
+  app_assert_status(sc);
+  session->sampling = true;
 }
 
 /**************************************************************************//**
- * Finishes throughput test.
+ * Stops the sampler. Frames not yet sent stay in the queue until the next
+ * start.
  *****************************************************************************/
-static void handle_throughput_peripheral_stop(bool send_transmission_on)
+static void throughput_peripheral_sampler_stop(throughput_peripheral_session_t *session)
 {
-  sl_status_t sc;
+  if (session->sampling) {
+    (void)sl_sleeptimer_stop_timer(&session->sample_timer);
+    session->sampling = false;
+  }
+}
+
+/**************************************************************************//**
+ * Backoff timer callback, runs in interrupt context. Lets the link send again.
+ *****************************************************************************/
+static void throughput_peripheral_on_tx_backoff(sl_sleeptimer_timer_handle_t *handle,
+                                                void *data)
+{
+  (void)handle;
+  throughput_peripheral_session_t *session = (throughput_peripheral_session_t *)data;
+
+  session->tx_idle_ticks += sl_sleeptimer_get_tick_count() - session->tx_pause_tick;
+  session->tx_paused = false;
+}
+
+/**************************************************************************//**
+ * Checks if a link may try to send, and counts the attempt.
+ * @param[in] session session to send on
+ * @return false while the link waits for its backoff to expire
+ *****************************************************************************/
+static bool throughput_peripheral_tx_ready(throughput_peripheral_session_t *session)
+{
+  if (session->tx_paused) {
+    return false;
+  }
+  session->tx_attempts++;
+  return true;
+}
+
+/**************************************************************************//**
+ * Records the result of a send attempt. A refused send pauses the link for a
+ * backoff that starts at the configured minimum and doubles on each further
+ * refusal, up to one connection interval, by which time the connection event
+ * has freed buffers.
+ * @param[in] session session that was sent on
+ * @param[in] sc result of the send
+ *****************************************************************************/
+static void throughput_peripheral_tx_result(throughput_peripheral_session_t *session,
+                                            sl_status_t sc)
+{
+  uint32_t frequency;
+  uint32_t backoff_min;
+  uint32_t backoff_max;
+
+  if (sc == SL_STATUS_OK) {
+    session->tx_backoff = 0;
+    return;
+  }
+
+  session->tx_last_error = sc;
+  switch (sc) {
+    case SL_STATUS_NO_MORE_RESOURCE:
+    case SL_STATUS_ALLOCATION_FAILED:
+    case SL_STATUS_BT_CTRL_MEMORY_CAPACITY_EXCEEDED:
+      session->tx_fail_no_buffer++;
+      break;
+    case SL_STATUS_BUSY:
+    case SL_STATUS_TRANSMIT_BUSY:
+      session->tx_fail_busy++;
+      break;
+    default:
+      session->tx_fail_other++;
+      break;
+  }
+
+  if (!THROUGHPUT_PERIPHERAL_TX_PACING) {
+    return;
+  }
+
+  frequency = sl_sleeptimer_get_timer_frequency();
+  backoff_min = (uint32_t)(((uint64_t)THROUGHPUT_PERIPHERAL_TX_BACKOFF_MIN_US * frequency)
+                           / 1000000);
+  backoff_max = (uint32_t)(((uint64_t)session->interval * CONNECTION_INTERVAL_UNIT_US * frequency)
+                           / 1000000);
+  if (backoff_min == 0) {
+    backoff_min = 1;
+  }
+  if (backoff_max < backoff_min) {
+    backoff_max = backoff_min;
+  }
+  if (session->tx_backoff == 0) {
+    session->tx_backoff = backoff_min;
+  } else if (session->tx_backoff < backoff_max / 2) {
+    session->tx_backoff *= 2;
+  } else {
+    session->tx_backoff = backoff_max;
+  }
+
+  session->tx_pause_tick = sl_sleeptimer_get_tick_count();
+  session->tx_paused = true;
+  sc = sl_sleeptimer_start_timer(&session->tx_backoff_timer,
+                                 session->tx_backoff,
+                                 throughput_peripheral_on_tx_backoff,
+                                 session,
+                                 0,
+                                 0);
+  if (sc != SL_STATUS_OK) {
+    session->tx_paused = false;
+  }
+}
+
+/**************************************************************************//**
+ * Cancels a pending backoff.
+ * @param[in] session session to stop
+ *****************************************************************************/
+static void throughput_peripheral_tx_pacing_stop(throughput_peripheral_session_t *session)
+{
+  (void)sl_sleeptimer_stop_timer(&session->tx_backoff_timer);
+  if (session->tx_paused) {
+    session->tx_idle_ticks += sl_sleeptimer_get_tick_count() - session->tx_pause_tick;
+    session->tx_paused = false;
+  }
+  session->tx_backoff = 0;
+}
+
+/**************************************************************************//**
+ * Checks if a link has work for the CPU. A notification test waiting for its
+ * backoff or for the sampler has none.
+ * @param[in] session session to check
+ * @return true if the link needs the main loop to run
+ *****************************************************************************/
+static bool throughput_peripheral_session_is_busy(throughput_peripheral_session_t *session)
+{
+  if (session->connection == 0) {
+    return false;
+  }
+  if (session->state == THROUGHPUT_STATE_TEST_FINISH) {
+    return true;
+  }
+  if (session->state != THROUGHPUT_STATE_TEST) {
+    return false;
+  }
+  if (session->upload) {
+    // Woken by the writes of the client, only the end of the test to serve
+    return session->finish_test || session->send_timer_rised;
+  }
+  if (!session->central_test
+      && (session->test_type & THROUGHPUT_TEST_L2CAP)
+      && !session->finish_test
+      && !session->send_timer_rised) {
+    // Nothing to do while out of credits, the next credit event wakes the loop
+    return session->l2cap_credits > 0 && !session->tx_paused;
+  }
+  if (session->central_test
+      || !(session->test_type & sl_bt_gatt_notification)
+      || session->finish_test
+      || session->send_timer_rised) {
+    return true;
+  }
+  if (session->tx_paused) {
+    return false;
+  }
+  if (session->sampling && throughput_ring_level(&session->sample_queue) == 0) {
+    return false;
+  }
+  return true;
+}
+
+/**************************************************************************//**
+ * Refresh throughput state
+ *****************************************************************************/
+static void throughput_peripheral_refresh_connected_state(throughput_peripheral_session_t *session)
+{
+  if ( ( (session->notifications == sl_bt_gatt_notification)
+         || (session->indications == sl_bt_gatt_indication) )
+       && (session->result_indicated != sl_bt_gatt_disable)
+       && (session->transmission_indicated != sl_bt_gatt_disable)) {
+    session->state = THROUGHPUT_STATE_SUBSCRIBED;
+  } else {
+    session->state = THROUGHPUT_STATE_CONNECTED;
+  }
+  peripheral_state.notifications = session->notifications;
+  peripheral_state.indications = session->indications;
+  throughput_peripheral_update_state();
+}
+
+/**************************************************************************//**
+ * Refresh RSSI timer callback.
+ *****************************************************************************/
+static void throughput_peripheral_on_refresh_timer_rise(sl_simple_timer_t *timer,
+                                                        void *data)
+{
+  (void) data;
+  (void) timer;
+  sl_status_t sc;
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection
+        && sessions[i].state != THROUGHPUT_STATE_TEST
+        && sessions[i].state != THROUGHPUT_STATE_TEST_FINISH) {
+      sc = sl_bt_connection_get_rssi(sessions[i].connection);
+      app_assert_status(sc);
+    }
+  }
+}
+
+/**************************************************************************//**
+ * Send timer callback.
+ *****************************************************************************/
+static void throughput_peripheral_on_send_timer_rise(sl_simple_timer_t *timer,
+                                                     void *data)
+{
+  (void) timer;
+  throughput_peripheral_session_t *session = (throughput_peripheral_session_t *)data;
+  session->send_timer_rised = true;
+}
+
+/**************************************************************************//**
+ * Indication timer callback.
+ *****************************************************************************/
+static void throughput_peripheral_on_indication_timer_rise(sl_simple_timer_t *timer,
+                                                           void *data)
+{
+  (void) timer;
+  throughput_peripheral_session_t *session = (throughput_peripheral_session_t *)data;
+  session->indication_timer_rised = true;
+}
+
+/**************************************************************************//**
+ * Starts the timeout of the indication waited for, one round trip timeout.
+ * @param[in] session session that sent the indication
+ *****************************************************************************/
+static void throughput_peripheral_indication_timer_start(throughput_peripheral_session_t *session)
+{
+  sl_status_t sc;
+
+  session->indication_timer_rised = false;
+  sc = sl_simple_timer_start(&session->indication_timer,
+                             throughput_rtt_timeout_ms(&session->rtt, 1),
+                             throughput_peripheral_on_indication_timer_rise,
+                             session,
+                             false);
+  app_assert_status(sc);
+}
+
+/**************************************************************************//**
+ * Handles an expired indication timeout. A late confirmation backs the
+ * timeout off and is waited for again, up to the longest timeout.
+ * @param[in] session session waiting for the confirmation
+ * @return true if the confirmation is not waited for any longer
+ *****************************************************************************/
+static bool throughput_peripheral_indication_timeout(throughput_peripheral_session_t *session)
+{
+  if (throughput_rtt_timeout(&session->rtt)) {
+    return true;
+  }
+  throughput_peripheral_indication_timer_start(session);
+  return false;
+}
+
+/**************************************************************************//**
+ * Reports the result of a finished link and adds it to the aggregate.
+ * @param[in] session session that finished its test
+ *****************************************************************************/
+static void throughput_peripheral_finish_session(throughput_peripheral_session_t *session)
+{
+  throughput_peripheral_on_link_finish(session->connection,
+                                       session->throughput,
+                                       session->count,
+                                       session->packet_lost,
+                                       session->packet_error,
+                                       session->time);
+
+  // Links run in parallel, so the aggregate throughput is the sum.
+  aggregate_throughput += session->throughput;
+  aggregate_count += session->count;
+  aggregate_lost += session->packet_lost;
+  aggregate_error += session->packet_error;
+  if (session->time > aggregate_time) {
+    aggregate_time = session->time;
+  }
+  aggregate_central_test = aggregate_central_test && session->central_test;
+  aggregate_links++;
+
+  throughput_peripheral_check_run_finished();
+}
+
+/**************************************************************************//**
+ * Reports the aggregate result once no link is testing any more.
+ *****************************************************************************/
+static void throughput_peripheral_check_run_finished(void)
+{
+  if (aggregate_links == 0 || throughput_peripheral_is_testing()) {
+    return;
+  }
+
+  peripheral_state.throughput   = aggregate_throughput;
+  peripheral_state.count        = aggregate_count;
+  peripheral_state.packet_lost  = aggregate_lost;
+  peripheral_state.packet_error = aggregate_error;
+  peripheral_state.time         = aggregate_time;
+
+  // Indicate the state change
+  if (aggregate_central_test) {
+    throughput_peripheral_on_finish(peripheral_state.throughput,
+                                    peripheral_state.count);
+  } else {
+    throughput_peripheral_on_finish_reception(peripheral_state.throughput,
+                                              peripheral_state.count,
+                                              peripheral_state.packet_lost,
+                                              peripheral_state.packet_error,
+                                              peripheral_state.time);
+  }
+
+  aggregate_throughput = 0;
+  aggregate_count = 0;
+  aggregate_lost = 0;
+  aggregate_error = 0;
+  aggregate_time = 0;
+  aggregate_links = 0;
+  aggregate_central_test = true;
+}
+
+/**************************************************************************//**
+ * Finishes throughput test.
+ *****************************************************************************/
+static void handle_throughput_peripheral_stop(throughput_peripheral_session_t *session,
+                                              bool send_transmission_on)
+{
+  sl_status_t sc;
 
   // If first called finish
-  if (peripheral_state.state != THROUGHPUT_STATE_TEST_FINISH) {
+  if (session->state != THROUGHPUT_STATE_TEST_FINISH) {
     // Set state to finish
-    peripheral_state.state = THROUGHPUT_STATE_TEST_FINISH;
+    session->state = THROUGHPUT_STATE_TEST_FINISH;
     // Test type off state
-    peripheral_state.test_type = sl_bt_gatt_disable;
+    session->test_type = sl_bt_gatt_disable;
+    session->pipeline_active = false;
 
     // stop timer
-    sl_simple_timer_stop(&indication_timer);
+    sl_simple_timer_stop(&session->indication_timer);
+    throughput_peripheral_sampler_stop(session);
+    throughput_peripheral_tx_pacing_stop(session);
 
-    send_transmission_state = send_transmission_on;
+    session->send_transmission_state = send_transmission_on;
 
-    notification_sent = false;
-    indication_sent = false;
-    indication_confirmed = false;
-    send_timer_rised = false;
-    indication_timer_rised = false;
+    session->notification_sent = false;
+    session->indication_sent = false;
+    session->indication_confirmed = false;
+    session->send_timer_rised = false;
+    session->indication_timer_rised = false;
 
-    finish_test = false;
+    session->finish_test = false;
   }
-  if (send_transmission_on && !notification_sent) {
+  if (send_transmission_on && !session->notification_sent) {
     // Send out notification
-    sc = sl_bt_gatt_server_send_notification(connection,
+    sc = sl_bt_gatt_server_send_notification(session->connection,
                                              gattdb_transmission_on,
                                              1,
                                              &TRANSMISSION_OFF);
     if (sc == SL_STATUS_OK) {
-      notification_sent = true;
-      indication_sent = false;
+      session->notification_sent = true;
+      session->indication_sent = false;
     }
-  } else if (!send_transmission_on || notification_sent) {
-    if (!indication_sent) {
+  } else if (!send_transmission_on || session->notification_sent) {
+    if (!session->indication_sent) {
       // Get elapsed time
-      time_elapsed = sl_sleeptimer_get_tick_count64() - time_start;
-      peripheral_state.count = operation_count;
+      uint64_t time_elapsed = sl_sleeptimer_get_tick_count64() - session->time_start;
+      uint8_t result[sizeof(session->throughput) + THROUGHPUT_SEQUENCE_PACKED_SIZE
+                     + THROUGHPUT_DUPLEX_PACKED_SIZE + THROUGHPUT_LATENCY_PACKED_SIZE];
+      size_t result_len = sizeof(session->throughput);
+      size_t stats_len = result_len + THROUGHPUT_SEQUENCE_PACKED_SIZE;
+      size_t down_len = stats_len + THROUGHPUT_DUPLEX_PACKED_SIZE;
+      session->count = session->operation_count;
+
+      // Holes still in the window of a receiving link are final now
+      throughput_sequence_rx_finish(&session->sequence_rx);
+      if (session->central_test || session->duplex || session->upload) {
+        session->packet_lost = session->sequence_rx.stats.lost;
+      }
 
-      peripheral_state.time  = (throughput_time_t)((float)time_elapsed
-                                                   / sl_sleeptimer_get_timer_frequency());
+      session->time  = (throughput_time_t)((float)time_elapsed
+                                           / sl_sleeptimer_get_timer_frequency());
 
       // Calculate throughput
-      peripheral_state.throughput = (throughput_value_t)((float)bytes_sent
-                                                         * 8
-                                                         / ((float)time_elapsed
-                                                            / sl_sleeptimer_get_timer_frequency()));
-
-      indication_confirmed = false;
-      indication_timer_rised = false;
+      session->throughput = (throughput_value_t)((float)session->bytes_sent
+                                                 * 8
+                                                 / ((float)time_elapsed
+                                                    / sl_sleeptimer_get_timer_frequency()));
+
+      session->indication_confirmed = false;
+      session->indication_timer_rised = false;
+
+      memset(&session->down_result, 0, sizeof(session->down_result));
+      if (session->duplex || session->upload) {
+        session->down_result.throughput = (uint32_t)((float)session->down_bytes
+                                                     * 8
+                                                     / ((float)time_elapsed
+                                                        / sl_sleeptimer_get_timer_frequency()));
+        session->down_result.latency_mean = throughput_duplex_latency_mean(&session->down_latency);
+        session->down_result.latency_max = session->down_latency.excess_max;
+      }
+      throughput_latency_summarize(&session->down_histogram, &session->down_summary);
+      // Nothing is sent in an upload, its result is the rate received
+      if (session->upload) {
+        session->throughput = session->down_result.throughput;
+      }
 
-      sc = sl_bt_gatt_server_send_indication(connection,
+      // The receive statistics follow the throughput if the MTU allows, then
+      // the downstream results of a duplex or upload test and their latency
+      memcpy(result, &session->throughput, sizeof(session->throughput));
+      if (session->mtu_size >= stats_len + INDICATION_GATT_HEADER) {
+        throughput_sequence_pack(&session->sequence_rx.stats,
+                                 result + sizeof(session->throughput));
+        result_len = stats_len;
+        if ((session->duplex || session->upload)
+            && session->mtu_size >= down_len + INDICATION_GATT_HEADER) {
+          throughput_duplex_pack(&session->down_result, result + stats_len);
+          result_len = down_len;
+          if (session->mtu_size >= sizeof(result) + INDICATION_GATT_HEADER) {
+            throughput_latency_pack(&session->down_summary, result + down_len);
+            result_len = sizeof(result);
+          }
+        }
+      }
+      sc = sl_bt_gatt_server_send_indication(session->connection,
                                              gattdb_throughput_result,
-                                             sizeof(peripheral_state.throughput),
-                                             (uint8_t *) &(peripheral_state.throughput));
+                                             result_len,
+                                             result);
       if (sc == SL_STATUS_OK) {
-        indication_sent = true;
-        sc = sl_simple_timer_start(&indication_timer,
-                                   THROUGHPUT_TX_INDICATION_TIMEOUT,
-                                   throughput_peripheral_on_indication_timer_rise,
-                                   NULL,
-                                   false);
-        app_assert_status(sc);
+        session->indication_sent = true;
+        session->indication_time = (uint32_t)throughput_peripheral_local_time();
+        throughput_peripheral_indication_timer_start(session);
       }
     } else {
-      if (indication_confirmed || indication_timer_rised) {
-        if (!deep_sleep_enabled) {
+      if (session->indication_confirmed
+          || (session->indication_timer_rised
+              && throughput_peripheral_indication_timeout(session))) {
+        if (session->em1_requested) {
           // Enable sleep
           sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+          session->em1_requested = false;
         }
         // Set mode
-        throughput_peripheral_refresh_connected_state();
+        throughput_peripheral_refresh_connected_state(session);
 
-        notification_sent = false;
-        indication_sent = false;
-        indication_confirmed = false;
-        send_timer_rised = false;
-        indication_timer_rised = false;
+        session->notification_sent = false;
+        session->indication_sent = false;
+        session->indication_confirmed = false;
+        session->send_timer_rised = false;
+        session->indication_timer_rised = false;
 
-        // Start refresh timer
-        sl_simple_timer_start(&refresh_timer,
-                              THROUGHPUT_TX_REFRESH_TIMER_PERIOD,
-                              throughput_peripheral_on_refresh_timer_rise,
-                              NULL,
-                              true);
-
-        // Indicate the state change
-        if (central_test) {
-          throughput_peripheral_on_finish(peripheral_state.throughput,
-                                          peripheral_state.count);
-        } else {
-          throughput_peripheral_on_finish_reception(peripheral_state.throughput,
-                                                    peripheral_state.count,
-                                                    peripheral_state.packet_lost,
-                                                    peripheral_state.packet_error,
-                                                    peripheral_state.time);
-        }
+        throughput_peripheral_finish_session(session);
       }
     }
   }
@@ -648,95 +1853,245 @@ static void handle_throughput_peripheral_stop(bool send_transmission_on)
 /**************************************************************************//**
  * Starts throughput test.
  *****************************************************************************/
-static void handle_throughput_peripheral_start(bool send_transmission_on)
+static void handle_throughput_peripheral_start(throughput_peripheral_session_t *session,
+                                               bool send_transmission_on)
 {
   sl_status_t sc;
+  uint8_t transmission_on;
+
+  // The side starting the test selects the integrity trailer and the
+  // encryption, the packet sizes leave room for them
+  if (send_transmission_on) {
+    session->integrity = integrity_type;
+    session->encrypted = crypto_enabled && throughput_crypto_supported();
+  }
+  // Pipelined and channel tests are sent in the clear
+  session->pipeline_active = THROUGHPUT_PERIPHERAL_PIPELINE_ENABLE
+                             && (session->test_type & sl_bt_gatt_indication)
+                             && (session->pipeline & sl_bt_gatt_notification);
+  if (!session->central_test
+      && (session->pipeline_active || (session->test_type & THROUGHPUT_TEST_L2CAP))) {
+    session->encrypted = false;
+  }
+  if (session->encrypted) {
+    // Without a random epoch the nonces could repeat, nothing is sent
+    sc = throughput_crypto_epoch(&session->crypto_epoch);
+    if (sc != SL_STATUS_OK) {
+      app_log_warning("Test not started, no epoch for the encryption: 0x%04lx" APP_LOG_NEW_LINE,
+                      (unsigned long)sc);
+      return;
+    }
+  }
+  throughput_peripheral_calculate_data_size(session);
+  memset(&session->integrity_stats, 0, sizeof(session->integrity_stats));
+  memset(&session->crypto_stats, 0, sizeof(session->crypto_stats));
 
   // Clear transmission variables
-  bytes_sent = 0;
-  send_counter = 0;
-  peripheral_state.throughput = 0;
-  peripheral_state.count = 0;
-  operation_count = 0;
+  session->bytes_sent = 0;
+  session->send_sequence = 0;
+  session->frame_sequence = 0;
+
+  // Clear pacing
+  throughput_peripheral_tx_pacing_stop(session);
+  session->tx_attempts = 0;
+  session->tx_fail_no_buffer = 0;
+  session->tx_fail_busy = 0;
+  session->tx_fail_other = 0;
+  session->tx_last_error = SL_STATUS_OK;
+  session->tx_idle_ticks = 0;
+  session->throughput = 0;
+
+  // Clear pipeline, an indication test pipelines if the client subscribed to it
+  session->pipe_base = 0;
+  session->pipe_next = 0;
+  session->pipe_acked = 0;
+  session->pipe_retransmits = 0;
+  session->pipe_acks = 0;
+  session->l2cap_sdu_offset = 0;
+  session->l2cap_pdus = 0;
+  session->l2cap_credit_stalls = 0;
+  if (session->pipeline_active) {
+    session->data_size = session->notification_data_size;
+  }
+  session->count = 0;
+  session->operation_count = 0;
 
   // Clear reception variables
-  received_counter = 0;
-  first_packet = true;
-  peripheral_state.packet_error = 0;
-  peripheral_state.packet_lost = 0;
+  throughput_sequence_rx_reset(&session->sequence_rx);
+  memset(&session->pattern_stats, 0, sizeof(session->pattern_stats));
+  session->packet_error = 0;
+  session->packet_lost = 0;
+  session->down_bytes = 0;
+  session->down_packets = 0;
+  throughput_duplex_latency_reset(&session->down_latency);
+  throughput_latency_reset(&session->down_histogram);
+  session->clock_synced = session->clock.valid;
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  memset(&session->history_last, 0, sizeof(session->history_last));
+#endif
 
   // Clear flags
-  indication_timer_rised = false;
-  indication_sent = false;
-  indication_confirmed = false;
+  session->indication_timer_rised = false;
+  session->indication_sent = false;
+  session->indication_confirmed = false;
 
-  send_timer_rised = false;
+  session->send_timer_rised = false;
 
   // Stop timers
-  sl_simple_timer_stop(&indication_timer);
-  sl_simple_timer_stop(&send_timer);
-  sl_simple_timer_stop(&refresh_timer);
-
-  // Generate data to send
-  if (peripheral_state.test_type & sl_bt_gatt_notification) {
-    throughput_peripheral_generate_notifications_data();
+  sl_simple_timer_stop(&session->indication_timer);
+  sl_simple_timer_stop(&session->send_timer);
+
+  // Generate data to send, a test whose first packet cannot be built does
+  // not start
+  sc = SL_STATUS_OK;
+  if (session->test_type & sl_bt_gatt_notification) {
+    if (SAMPLE_QUEUE_ENABLED && session->frames_per_notification > 0) {
+      throughput_peripheral_sampler_start(session);
+    } else {
+      sc = throughput_peripheral_generate_notifications_data(session);
+    }
+  }
+  if (sc == SL_STATUS_OK && (session->test_type & sl_bt_gatt_indication)) {
+    sc = throughput_peripheral_generate_indications_data(session);
   }
-  if (peripheral_state.test_type & sl_bt_gatt_indication) {
-    throughput_peripheral_generate_indications_data();
+  if (sc != SL_STATUS_OK) {
+    throughput_peripheral_sampler_stop(session);
+    app_log_warning("Test not started, the first packet failed: 0x%04lx" APP_LOG_NEW_LINE,
+                    (unsigned long)sc);
+    return;
   }
   if (send_transmission_on) {
-    sc = sl_bt_gatt_server_send_notification(connection,
+    // The flag alone starts an upload
+    transmission_on = (session->upload ? 0 : TRANSMISSION_ON)
+                      | throughput_integrity_encode(session->integrity)
+                      | (session->encrypted ? THROUGHPUT_CRYPTO_FLAG : 0)
+                      | ((session->duplex || session->upload) ? THROUGHPUT_DUPLEX_FLAG : 0);
+    sc = sl_bt_gatt_server_send_notification(session->connection,
                                              gattdb_transmission_on,
                                              1,
-                                             &TRANSMISSION_ON);
+                                             &transmission_on);
     app_assert_status(sc);
   }
 
   if (peripheral_state.mode == THROUGHPUT_MODE_FIXED_TIME) {
-    sc = sl_simple_timer_start(&send_timer,
+    sc = sl_simple_timer_start(&session->send_timer,
                                fixed_time,
                                throughput_peripheral_on_send_timer_rise,
-                               NULL,
+                               session,
                                false);
     app_assert_status(sc);
   }
-  if (!deep_sleep_enabled) {
+  if (!deep_sleep_enabled && !session->em1_requested) {
     // Disable sleep
     sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+    session->em1_requested = true;
   }
 
-  peripheral_state.state = THROUGHPUT_STATE_TEST;
-  throughput_peripheral_on_state_change(peripheral_state.state);
-  throughput_peripheral_on_start();
+  // Only the first link starting a run notifies the application
+  bool run_started = !throughput_peripheral_is_testing();
+
+  session->state = THROUGHPUT_STATE_TEST;
+  throughput_peripheral_update_state();
+  if (run_started) {
+    throughput_peripheral_on_start();
+  }
 
   // Start timer
-  time_start = sl_sleeptimer_get_tick_count64();
+  session->time_start = sl_sleeptimer_get_tick_count64();
+}
+
+/**************************************************************************//**
+ * Sends the oldest frame batch of the sample queue, straight from the queue
+ * unless it needs an integrity trailer appended or encrypting. The batch stays
+ * queued, in the clear, if the stack cannot take it.
+ *****************************************************************************/
+static void throughput_peripheral_send_sample_batch(throughput_peripheral_session_t *session)
+{
+  sl_status_t sc;
+  const uint8_t *batch;
+  uint16_t len;
+
+  batch = throughput_ring_peek(&session->sample_queue, &len);
+  if (batch == NULL || !throughput_peripheral_tx_ready(session)) {
+    return;
+  }
+  if (session->integrity != THROUGHPUT_INTEGRITY_NONE || session->encrypted) {
+    uint8_t *packet = throughput_peripheral_tx_data();
+    uint8_t *data_ptr = packet + throughput_peripheral_content_offset(session);
+    throughput_frame_batch_header_t header = { 0 };
+    size_t packet_len;
+    memcpy(data_ptr, batch, len);
+    (void)throughput_frame_batch_parse(data_ptr, len, &header);
+    // The batch stays queued if its trailer or encryption fails, it is
+    // tried again
+    sc = throughput_integrity_append(session->integrity,
+                                     data_ptr,
+                                     len,
+                                     &session->integrity_stats,
+                                     &packet_len);
+    if (sc != SL_STATUS_OK) {
+      return;
+    }
+    len = throughput_peripheral_seal(session,
+                                     packet,
+                                     (uint16_t)packet_len,
+                                     header.sequence);
+    if (len == 0) {
+      return;
+    }
+    batch = packet;
+  }
+  sc = sl_bt_gatt_server_send_notification(session->connection,
+                                           gattdb_throughput_notifications,
+                                           len,
+                                           batch);
+  throughput_peripheral_tx_result(session, sc);
+  if (sc != SL_STATUS_OK) {
+    throughput_ring_backpressure(&session->sample_queue);
+    return;
+  }
+  throughput_ring_commit(&session->sample_queue);
+  session->bytes_sent += len;
+  session->operation_count++;
+  if ( (peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
+       && (session->bytes_sent >= (fixed_data_size))) {
+    handle_throughput_peripheral_stop(session, true);
+  }
 }
 
 /**************************************************************************//**
  * Sends out single notification for the test.
  *****************************************************************************/
-static void throughput_peripheral_send_notification(void)
+static void throughput_peripheral_send_notification(throughput_peripheral_session_t *session)
 {
   sl_status_t sc;
-  if (finish_test) {
-    handle_throughput_peripheral_stop(true);
+  if (session->finish_test) {
+    handle_throughput_peripheral_stop(session, true);
   } else {
-    if (send_timer_rised) {
-      send_timer_rised = false;
-      handle_throughput_peripheral_stop(true);
-    } else {
-      sc = sl_bt_gatt_server_send_notification(connection,
+    if (session->send_timer_rised) {
+      session->send_timer_rised = false;
+      handle_throughput_peripheral_stop(session, true);
+    } else if (session->sampling) {
+      throughput_peripheral_send_sample_batch(session);
+    } else if (throughput_peripheral_tx_ready(session)
+               && (tx_data_session == session
+                   || throughput_peripheral_generate_notifications_data(session) == SL_STATUS_OK)) {
+      // A packet whose trailer or encryption failed is built again in the
+      // next pass
+      sc = sl_bt_gatt_server_send_notification(session->connection,
                                                gattdb_throughput_notifications,
-                                               notification_data_size,
-                                               notification_data);
+                                               session->notification_data_size,
+                                               tx_data);
+      throughput_peripheral_tx_result(session, sc);
       if (sc == SL_STATUS_OK) {
-        bytes_sent += (notification_data_size);
-        operation_count++;
-        throughput_peripheral_generate_notifications_data();
+        tx_data_session = NULL;
+        session->bytes_sent += (session->notification_data_size);
+        session->operation_count++;
+        session->frame_sequence += session->frames_per_notification;
+        session->send_sequence++;
         if ( (peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
-             && (bytes_sent >= (fixed_data_size))) {
-          handle_throughput_peripheral_stop(true);
+             && (session->bytes_sent >= (fixed_data_size))) {
+          handle_throughput_peripheral_stop(session, true);
         }
       }
     }
@@ -746,65 +2101,445 @@ static void throughput_peripheral_send_notification(void)
 /**************************************************************************//**
  * Indication confirmed callback.
  *****************************************************************************/
-static void throughput_peripheral_indication_confirm(void)
+static void throughput_peripheral_indication_confirm(throughput_peripheral_session_t *session)
 {
-  indication_confirmed = true;
+  if (session->indication_sent && !session->indication_confirmed) {
+    throughput_rtt_sample(&session->rtt,
+                          (uint32_t)throughput_peripheral_local_time() - session->indication_time);
+  }
+  session->indication_confirmed = true;
 }
 
 /**************************************************************************//**
  * Sends out single indication for the test.
  *****************************************************************************/
-static void throughput_peripheral_send_indication(void)
+static void throughput_peripheral_send_indication(throughput_peripheral_session_t *session)
 {
   sl_status_t sc;
 
-  if (indication_sent) {
-    if (indication_confirmed) {
+  if (session->indication_sent) {
+    if (session->indication_confirmed) {
       // move on.
-      bytes_sent += (indication_data_size);
-      operation_count++;
+      session->bytes_sent += (session->indication_data_size);
+      session->operation_count++;
+      session->send_sequence++;
 
-      sl_simple_timer_stop(&indication_timer);
+      sl_simple_timer_stop(&session->indication_timer);
 
-      indication_sent = false;
-      indication_confirmed = false;
+      session->indication_sent = false;
+      session->indication_confirmed = false;
 
       if ( (peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
-           && (bytes_sent >= (fixed_data_size))) {
-        handle_throughput_peripheral_stop(true);
-      } else if (send_timer_rised) {
-        send_timer_rised = false;
-        handle_throughput_peripheral_stop(true);
+           && (session->bytes_sent >= (fixed_data_size))) {
+        handle_throughput_peripheral_stop(session, true);
+      } else if (session->send_timer_rised) {
+        session->send_timer_rised = false;
+        handle_throughput_peripheral_stop(session, true);
       }
     } else {
-      if (indication_timer_rised) {
-        handle_throughput_peripheral_stop(true);
+      if (session->indication_timer_rised
+          && throughput_peripheral_indication_timeout(session)) {
+        handle_throughput_peripheral_stop(session, true);
       }
     }
   } else {
     // No indication sent, send it out
-    if (finish_test) {
-      handle_throughput_peripheral_stop(true);
-    } else {
-      throughput_peripheral_generate_indications_data();
+    if (session->finish_test) {
+      handle_throughput_peripheral_stop(session, true);
+    } else if (throughput_peripheral_generate_indications_data(session) == SL_STATUS_OK) {
+      session->indication_confirmed = false;
+
+      sl_simple_timer_stop(&session->indication_timer);
+
+      sc = sl_bt_gatt_server_send_indication(session->connection,
+                                             gattdb_throughput_indications,
+                                             session->indication_data_size,
+                                             tx_data);
+      // A refused indication is sent again in the next pass instead of
+      // waiting for a confirmation that cannot come
+      if (sc == SL_STATUS_OK) {
+        session->indication_sent = true;
+        session->indication_time = (uint32_t)throughput_peripheral_local_time();
+        throughput_peripheral_indication_timer_start(session);
+      }
+    }
+  }
+}
+
+/**************************************************************************//**
+ * Sends out a single pipeline segment. The oldest segment that was not
+ * acknowledged in time is sent again, otherwise a new segment if the window
+ * has room.
+ *****************************************************************************/
+static void throughput_peripheral_send_pipeline(throughput_peripheral_session_t *session)
+{
+  sl_status_t sc;
+  uint32_t now;
+  uint32_t timeout;
+  uint32_t sequence;
+  uint32_t in_flight;
+  uint16_t len;
+  size_t packet_len;
+  bool retransmit = false;
+
+  if (session->finish_test) {
+    handle_throughput_peripheral_stop(session, true);
+    return;
+  }
+  if (session->send_timer_rised) {
+    session->send_timer_rised = false;
+    handle_throughput_peripheral_stop(session, true);
+    return;
+  }
+
+  now = sl_sleeptimer_get_tick_count();
+  timeout = (uint32_t)(((uint64_t)THROUGHPUT_PERIPHERAL_PIPELINE_TIMEOUT
+                        * sl_sleeptimer_get_timer_frequency()) / 1000);
+  in_flight = session->pipe_next - session->pipe_base;
+  sequence = session->pipe_next;
+  for (uint32_t i = 0; i < in_flight; i++) {
+    uint32_t candidate = session->pipe_base + i;
+    if (!(session->pipe_acked & (1UL << i))
+        && (now - session->pipe_sent_tick[candidate % THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW]) >= timeout) {
+      sequence = candidate;
+      retransmit = true;
+      break;
+    }
+  }
+  if (!retransmit && in_flight >= THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW) {
+    return;
+  }
+  if (!throughput_peripheral_tx_ready(session)) {
+    return;
+  }
+
+  len = throughput_peripheral_content_size(session, session->notification_data_size);
+  throughput_pipeline_write_segment(throughput_peripheral_tx_data(), len, sequence);
+  if (throughput_integrity_append(session->integrity,
+                                  tx_data,
+                                  len,
+                                  &session->integrity_stats,
+                                  &packet_len) != SL_STATUS_OK) {
+    return;
+  }
+  sc = sl_bt_gatt_server_send_notification(session->connection,
+                                           gattdb_throughput_pipeline,
+                                           session->notification_data_size,
+                                           tx_data);
+  throughput_peripheral_tx_result(session, sc);
+  if (sc != SL_STATUS_OK) {
+    return;
+  }
+  session->pipe_sent_tick[sequence % THROUGHPUT_PERIPHERAL_PIPELINE_WINDOW] = now;
+  if (retransmit) {
+    session->pipe_retransmits++;
+  } else {
+    session->pipe_next++;
+  }
+}
+
+/**************************************************************************//**
+ * Handles an acknowledgement of pipeline segments. Acknowledged segments are
+ * counted as sent and the window slides past the oldest ones.
+ * @param[in] session session of the pipeline
+ * @param[in] data acknowledgement payload
+ * @param[in] len length of the payload
+ *****************************************************************************/
+static void throughput_peripheral_pipeline_ack(throughput_peripheral_session_t *session,
+                                               const uint8_t *data,
+                                               uint16_t len)
+{
+  uint32_t cumulative;
+  uint32_t bitmap;
+  uint32_t in_flight;
+  uint32_t acked = 0;
+  uint32_t offset;
+
+  if (!session->pipeline_active
+      || session->state != THROUGHPUT_STATE_TEST
+      || !throughput_pipeline_read_ack(data, len, &cumulative, &bitmap)) {
+    return;
+  }
+  session->pipe_acks++;
+
+  in_flight = session->pipe_next - session->pipe_base;
+  offset = cumulative - session->pipe_base;
+  if (offset > in_flight) {
+    // Stale or bogus acknowledgement
+    return;
+  }
+
+  // Everything below the cumulative sequence has arrived
+  for (uint32_t i = 0; i < offset; i++) {
+    if (!(session->pipe_acked & (1UL << i))) {
+      acked++;
+    }
+  }
+  session->pipe_acked = (offset < 32) ? (session->pipe_acked >> offset) : 0;
+  session->pipe_base = cumulative;
+  in_flight -= offset;
+
+  // Selectively acknowledged segments behind the gap
+  for (uint32_t i = 0; i + 1 < in_flight && i < 31; i++) {
+    if ((bitmap & (1UL << i)) && !(session->pipe_acked & (1UL << (i + 1)))) {
+      session->pipe_acked |= 1UL << (i + 1);
+      acked++;
+    }
+  }
+
+  session->bytes_sent += acked * session->notification_data_size;
+  session->operation_count += acked;
+  if ( (peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
+       && (session->bytes_sent >= (fixed_data_size))) {
+    handle_throughput_peripheral_stop(session, true);
+  }
+}
+
+/**************************************************************************//**
+ * Generates the SDU the link is sending into the shared SDU buffer. The
+ * content only depends on the session, so the SDU can be generated again for
+ * each of its PDUs.
+ * @param[in] session session of the channel
+ * @return SL_STATUS_FAIL if the integrity trailer could not be computed, the
+ *         SDU must not be sent
+ *****************************************************************************/
+#if THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+static sl_status_t throughput_peripheral_generate_l2cap_sdu(throughput_peripheral_session_t *session)
+{
+  const float float_values[7] = THROUGHPUT_FRAME_TEST_VALUES;
+  uint16_t len = throughput_peripheral_content_size(session, session->l2cap_sdu_size);
+  uint8_t frames = 0;
+  size_t packet_len;
+
+  if (THROUGHPUT_PERIPHERAL_FRAME_BATCHING) {
+    frames = throughput_frame_batch_capacity(len);
+  }
+  if (frames > 0) {
+    throughput_frame_t frame;
+    frame.timestamp = session->l2cap_sdu_timestamp;
+    memcpy(frame.values, float_values, sizeof(frame.values));
+    throughput_frame_batch_write_header(l2cap_sdu,
+                                        frames,
+                                        session->send_sequence,
+                                        session->frame_sequence);
+    for (uint8_t i = 0; i < frames; i++) {
+      throughput_frame_batch_write_frame(l2cap_sdu, i, &frame);
+    }
+    len = throughput_frame_batch_size(frames);
+  } else {
+    throughput_sequence_write_packet(l2cap_sdu,
+                                     len,
+                                     session->send_sequence,
+                                     &tx_pattern);
+  }
+
+  // The trailer covers the whole SDU, it is only computed for its first PDU
+  if (session->l2cap_sdu_offset == 0) {
+    if (throughput_integrity_append(session->integrity,
+                                    l2cap_sdu,
+                                    len,
+                                    &session->integrity_stats,
+                                    &packet_len) != SL_STATUS_OK) {
+      return SL_STATUS_FAIL;
+    }
+    memcpy(session->l2cap_trailer, l2cap_sdu + len, throughput_integrity_size(session->integrity));
+  } else {
+    memcpy(l2cap_sdu + len, session->l2cap_trailer, throughput_integrity_size(session->integrity));
+  }
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sends the next PDU of the current SDU over the L2CAP channel. Each PDU
+ * takes one credit of the client, the link waits for more credits when it
+ * ran out.
+ *****************************************************************************/
+static void throughput_peripheral_send_l2cap(throughput_peripheral_session_t *session)
+{
+  sl_status_t sc;
+  uint16_t consumed;
+  uint16_t pdu_len;
+
+  if (session->finish_test) {
+    handle_throughput_peripheral_stop(session, true);
+    return;
+  }
+  if (session->send_timer_rised) {
+    session->send_timer_rised = false;
+    handle_throughput_peripheral_stop(session, true);
+    return;
+  }
+  if (session->l2cap_credits == 0 || !throughput_peripheral_tx_ready(session)) {
+    return;
+  }
+
+  if (session->l2cap_sdu_offset == 0) {
+    session->l2cap_sdu_timestamp = sl_sleeptimer_get_tick_count();
+  }
+  if (throughput_peripheral_generate_l2cap_sdu(session) != SL_STATUS_OK) {
+    return;
+  }
+  consumed = throughput_l2cap_segment(l2cap_sdu,
+                                      session->l2cap_sdu_size,
+                                      session->l2cap_sdu_offset,
+                                      session->l2cap_mps,
+                                      throughput_peripheral_tx_data(),
+                                      &pdu_len);
+  sc = sl_bt_l2cap_coc_send_data(session->connection,
+                                 session->l2cap_cid,
+                                 pdu_len,
+                                 tx_data);
+  throughput_peripheral_tx_result(session, sc);
+  if (sc != SL_STATUS_OK) {
+    return;
+  }
+
+  session->l2cap_pdus++;
+  session->l2cap_credits--;
+  if (session->l2cap_credits == 0) {
+    session->l2cap_credit_stalls++;
+  }
+  session->l2cap_sdu_offset += consumed;
+  if (session->l2cap_sdu_offset < session->l2cap_sdu_size) {
+    return;
+  }
+
+  // SDU complete
+  session->l2cap_sdu_offset = 0;
+  session->bytes_sent += session->l2cap_sdu_size;
+  session->operation_count++;
+  if (THROUGHPUT_PERIPHERAL_FRAME_BATCHING) {
+    session->frame_sequence += throughput_frame_batch_capacity(
+      throughput_peripheral_content_size(session, session->l2cap_sdu_size));
+  }
+  session->send_sequence++;
+  if ( (peripheral_state.mode == THROUGHPUT_MODE_FIXED_LENGTH)
+       && (session->bytes_sent >= (fixed_data_size))) {
+    handle_throughput_peripheral_stop(session, true);
+  }
+}
+#endif // THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+
+/**************************************************************************//**
+ * Answers a channel request of a client. A single channel on the throughput
+ * PSM is accepted per link, the peripheral only sends on it.
+ * @param[in] request connection request event
+ *****************************************************************************/
+static void throughput_peripheral_l2cap_request(sl_bt_evt_l2cap_coc_connection_request_t *request)
+{
+  sl_status_t sc;
+  uint16_t result = sl_bt_l2cap_connection_successful;
+  throughput_peripheral_session_t *session;
+
+  session = throughput_peripheral_find_session(request->connection);
+  if (!THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+      || request->le_psm != THROUGHPUT_L2CAP_PSM) {
+    result = sl_bt_l2cap_le_psm_not_supported;
+  } else if (session == NULL
+             || session->l2cap_cid != 0
+             || request->mtu < THROUGHPUT_L2CAP_MIN_SIZE
+             || request->mps < THROUGHPUT_L2CAP_MIN_SIZE) {
+    result = sl_bt_l2cap_no_resources_available;
+  }
 
-      indication_confirmed = false;
+  // Nothing is received on the channel, so no credits are given
+  sc = sl_bt_l2cap_coc_send_connection_response(request->connection,
+                                                request->source_cid,
+                                                THROUGHPUT_L2CAP_MIN_SIZE,
+                                                THROUGHPUT_L2CAP_MIN_SIZE,
+                                                0,
+                                                result);
+  if (sc != SL_STATUS_OK || result != sl_bt_l2cap_connection_successful) {
+    return;
+  }
+
+  session->l2cap_cid = request->source_cid;
+  session->l2cap_mtu = request->mtu;
+  throughput_peripheral_calculate_l2cap_size(session);
+  session->l2cap_mps = request->mps;
+  if (session->l2cap_mps > THROUGHPUT_L2CAP_MAX_MPS) {
+    session->l2cap_mps = THROUGHPUT_L2CAP_MAX_MPS;
+  }
+  session->l2cap_credits = request->initial_credit;
+  session->l2cap_sdu_offset = 0;
+}
 
-      sl_simple_timer_stop(&indication_timer);
+/**************************************************************************//**
+ * Selects the test type of a link for a start request.
+ * @param[in] session session to start
+ * @param[in] type requested test type
+ * @return true if the link supports the requested test
+ *****************************************************************************/
+static bool throughput_peripheral_select_test_type(throughput_peripheral_session_t *session,
+                                                   throughput_notification_t type)
+{
+  session->test_type = sl_bt_gatt_disable;
+  // An upload only needs the client to write to the sink
+  session->upload = (type == THROUGHPUT_TEST_UPLOAD);
+  if (session->upload) {
+    session->test_type = THROUGHPUT_TEST_UPLOAD;
+    session->duplex = false;
+    return true;
+  }
+  // A duplex test runs on top of the notification test
+  session->duplex = (type == THROUGHPUT_TEST_DUPLEX);
+  if (session->duplex) {
+    type = sl_bt_gatt_notification;
+  }
+  if ((session->indications & sl_bt_gatt_indication)
+      && (session->notifications & sl_bt_gatt_notification)
+      && (type != sl_bt_gatt_disable) ) {
+    session->test_type = sl_bt_gatt_notification;
+  }
+  if (type == THROUGHPUT_TEST_L2CAP && session->l2cap_cid != 0) {
+    session->test_type = THROUGHPUT_TEST_L2CAP;
+    session->data_size = session->l2cap_sdu_size;
+  } else if (type == sl_bt_gatt_indication
+      && (session->indications & sl_bt_gatt_indication) ) {
+    session->test_type = sl_bt_gatt_indication;
+  } else if (type == sl_bt_gatt_notification
+             && (session->notifications & sl_bt_gatt_notification) ) {
+    session->test_type = sl_bt_gatt_notification;
+  }
+  if (session->test_type & sl_bt_gatt_notification) {
+    session->data_size = session->notification_data_size;
+  }
+  if (session->test_type & sl_bt_gatt_indication) {
+    session->data_size = session->indication_data_size;
+  }
+  session->duplex = session->duplex && (session->test_type == sl_bt_gatt_notification);
+  return session->test_type != sl_bt_gatt_disable;
+}
 
-      sc = sl_bt_gatt_server_send_indication(connection,
-                                             gattdb_throughput_indications,
-                                             indication_data_size,
-                                             indication_data);
-      (void) sc;
-      indication_sent = true;
-      sc = sl_simple_timer_start(&indication_timer,
-                                 THROUGHPUT_TX_INDICATION_TIMEOUT,
-                                 throughput_peripheral_on_indication_timer_rise,
-                                 NULL,
-                                 false);
-      app_assert_status(sc);
+/**************************************************************************//**
+ * Runs the test state machine of a single link.
+ * @param[in] session session to serve
+ *****************************************************************************/
+static void throughput_peripheral_session_step(throughput_peripheral_session_t *session)
+{
+  // Skip, if the central started a test on this link
+  if (session->central_test) {
+    return;
+  }
+  if (session->state == THROUGHPUT_STATE_TEST) {
+    if (session->pipeline_active) {
+      throughput_peripheral_send_pipeline(session);
+    } else if (session->test_type & sl_bt_gatt_indication) {
+      throughput_peripheral_send_indication(session);
+    }
+    if (session->test_type & sl_bt_gatt_notification) {
+      throughput_peripheral_send_notification(session);
+    }
+#if THROUGHPUT_PERIPHERAL_L2CAP_ENABLE
+    if (session->test_type & THROUGHPUT_TEST_L2CAP) {
+      throughput_peripheral_send_l2cap(session);
+    }
+#endif
+    if (session->upload) {
+      throughput_peripheral_check_upload(session);
     }
+  } else if (session->state == THROUGHPUT_STATE_TEST_FINISH) {
+    handle_throughput_peripheral_stop(session, session->send_transmission_state);
   }
 }
 
@@ -823,8 +2558,26 @@ void throughput_peripheral_enable(void)
   // Enable UI
   throughput_ui_init();
 
-  memset(notification_data, 0, THROUGHPUT_TX_DATA_SIZE);
-  memset(indication_data, 0, THROUGHPUT_TX_DATA_SIZE);
+  memset(sessions, 0, sizeof(sessions));
+  session_next = 0;
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  throughput_history_init(&history, history_records, THROUGHPUT_PERIPHERAL_HISTORY_RECORDS);
+#endif
+
+  // Build the generator tables, the receiver follows the packets it gets
+  (void)throughput_pattern_select(&tx_pattern, THROUGHPUT_PERIPHERAL_PATTERN);
+  (void)throughput_pattern_select(&rx_pattern, THROUGHPUT_PERIPHERAL_PATTERN);
+
+  // Count cycles to measure the cost of the integrity trailer and encryption
+  throughput_integrity_cycles_init();
+
+  // Load the configured key, an invalid one leaves encryption unavailable
+  uint8_t key[THROUGHPUT_CRYPTO_KEY_SIZE];
+  if (throughput_crypto_parse_key(THROUGHPUT_PERIPHERAL_CRYPTO_KEY, key)) {
+    throughput_crypto_set_key(&crypto_key, key);
+  } else {
+    crypto_enabled = false;
+  }
 
   peripheral_state.role          = THROUGHPUT_ROLE_PERIPHERAL;
   peripheral_state.state         = THROUGHPUT_STATE_DISCONNECTED;
@@ -859,47 +2612,94 @@ void throughput_peripheral_enable(void)
   peripheral_state.tx_power = tx_power_max / 10;
   throughput_peripheral_on_power_change(peripheral_state.tx_power);
 
-  sc = sl_bt_gatt_server_set_max_mtu(peripheral_state.mtu_size, &(peripheral_state.mtu_size));
+  sc = sl_bt_gatt_server_set_max_mtu(peripheral_state.mtu_size, &max_mtu_size);
+  app_assert_status(sc);
+  peripheral_state.mtu_size = max_mtu_size;
+
+  // Receive only the events the peripheral handles
+  sc = throughput_event_subscribe(peripheral_events,
+                                  sizeof(peripheral_events) / sizeof(peripheral_events[0]),
+                                  throughput_peripheral_on_event);
   app_assert_status(sc);
 
+  #ifdef SL_CATALOG_CLI_PRESENT
+  throughput_peripheral_cli_add();
+  #endif // SL_CATALOG_CLI_PRESENT
+
   // Start advertising
   throughput_peripheral_advertising_start();
 
   enabled = true;
 
   throughput_ui_set_all(peripheral_state);
-  central_test = false;
 }
 
 /**************************************************************************//**
- * Process step for throughput peripheral.
+ * Disables the transmission.
  *****************************************************************************/
-void throughput_peripheral_step(void)
+void throughput_peripheral_disable(void)
 {
-  // Return early, if the central started a test
-  if (central_test) {
+  if (!enabled) {
     return;
   }
-  if (peripheral_state.state == THROUGHPUT_STATE_TEST) {
-    if (peripheral_state.test_type & sl_bt_gatt_indication) {
-      throughput_peripheral_send_indication();
+  enabled = false;
+
+  sl_bt_advertiser_stop(advertising_set_handle);
+  sl_bt_advertiser_stop(coded_advertising_set_handle);
+  sl_simple_timer_stop(&refresh_timer);
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection != 0) {
+      (void)sl_bt_connection_close(sessions[i].connection);
+      throughput_peripheral_close_session(&sessions[i]);
     }
-    if (peripheral_state.test_type & sl_bt_gatt_notification) {
-      throughput_peripheral_send_notification();
+  }
+  throughput_peripheral_update_state();
+
+  throughput_event_unsubscribe(peripheral_events,
+                               sizeof(peripheral_events) / sizeof(peripheral_events[0]),
+                               throughput_peripheral_on_event);
+
+  #ifdef SL_CATALOG_CLI_PRESENT
+  throughput_peripheral_cli_remove();
+  #endif // SL_CATALOG_CLI_PRESENT
+}
+
+/**************************************************************************//**
+ * Process step for throughput peripheral.
+ *****************************************************************************/
+void throughput_peripheral_step(void)
+{
+  // Serve every link once, starting with a different one in each pass, so
+  // no link starves when the stack runs out of buffers.
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session
+      = &sessions[(session_next + i) % THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS];
+    if (session->connection != 0) {
+      throughput_peripheral_session_step(session);
     }
-  } else if (peripheral_state.state == THROUGHPUT_STATE_TEST_FINISH) {
-    handle_throughput_peripheral_stop(send_transmission_state);
   }
+  session_next = (session_next + 1) % THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS;
 }
 
 /**************************************************************************//**
- * Bluetooth stack event handler.
+ * Bluetooth stack event handler called with every event.
+ * The subscribed events arrive through throughput_event_dispatch() instead.
  *****************************************************************************/
 void throughput_peripheral_on_bt_event(sl_bt_msg_t *evt)
+{
+  (void)evt;
+}
+
+/**************************************************************************//**
+ * Bluetooth stack event handler of the subscribed events.
+ *****************************************************************************/
+static void throughput_peripheral_on_event(sl_bt_msg_t *evt)
 {
   bool response;
   sl_status_t sc;
   uint8_t data;
+  uint32_t credits;
+  throughput_peripheral_session_t *session;
 
   if (!enabled) {
     return;
@@ -908,279 +2708,372 @@ void throughput_peripheral_on_bt_event(sl_bt_msg_t *evt)
   // Handle stack events
   switch (SL_BT_MSG_ID(evt->header)) {
     case sl_bt_evt_gatt_server_attribute_value_id:
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_server_attribute_value.connection);
+      if (session == NULL) {
+        break;
+      }
       if (gattdb_transmission_on == evt->data.evt_gatt_server_attribute_value.attribute) {
         response = false;
         data = evt->data.evt_gatt_server_attribute_value.value.data[0];
         if (data > 0) {
-          if (peripheral_state.state == THROUGHPUT_STATE_SUBSCRIBED) {
-            peripheral_state.test_type = sl_bt_gatt_disable;
-            if (peripheral_state.notifications && peripheral_state.indications ) {
-              if ( (peripheral_state.notifications & sl_bt_gatt_notification)
+          if (session->state == THROUGHPUT_STATE_SUBSCRIBED) {
+            session->integrity = throughput_integrity_decode(data);
+            session->encrypted = throughput_crypto_decode(data);
+            session->duplex = false;
+            session->upload = throughput_duplex_is_upload(data);
+            session->test_type = sl_bt_gatt_disable;
+            if (session->upload) {
+              session->test_type = THROUGHPUT_TEST_UPLOAD;
+            } else if ((data & THROUGHPUT_TEST_L2CAP) && session->l2cap_cid != 0) {
+              session->test_type = THROUGHPUT_TEST_L2CAP;
+            } else if (session->notifications && session->indications ) {
+              if ( (session->notifications & sl_bt_gatt_notification)
                    && (data & sl_bt_gatt_notification) ) {
-                peripheral_state.test_type = sl_bt_gatt_notification;
-              } else if ( (peripheral_state.indications & sl_bt_gatt_indication)
+                session->test_type = sl_bt_gatt_notification;
+              } else if ( (session->indications & sl_bt_gatt_indication)
                           && (data & sl_bt_gatt_indication) ) {
-                peripheral_state.test_type = sl_bt_gatt_indication;
+                session->test_type = sl_bt_gatt_indication;
               }
-            } else if (peripheral_state.indications & sl_bt_gatt_indication) {
-              peripheral_state.test_type = sl_bt_gatt_indication;
-            } else if (peripheral_state.notifications & sl_bt_gatt_notification) {
-              peripheral_state.test_type = sl_bt_gatt_notification;
+            } else if (session->indications & sl_bt_gatt_indication) {
+              session->test_type = sl_bt_gatt_indication;
+            } else if (session->notifications & sl_bt_gatt_notification) {
+              session->test_type = sl_bt_gatt_notification;
             }
-            if (peripheral_state.test_type & sl_bt_gatt_indication) {
-              throughput_peripheral_generate_indications_data();
+            // The first packet is built again, and checked, when the test
+            // starts
+            if (session->test_type & sl_bt_gatt_indication) {
+              (void)throughput_peripheral_generate_indications_data(session);
               response = true;
-            } else if (peripheral_state.test_type & sl_bt_gatt_notification) {
-              throughput_peripheral_generate_notifications_data();
+            } else if (session->test_type & sl_bt_gatt_notification) {
+              session->duplex = (data & THROUGHPUT_DUPLEX_FLAG) != 0;
+              (void)throughput_peripheral_generate_notifications_data(session);
+              response = true;
+            } else if (session->test_type & THROUGHPUT_TEST_L2CAP) {
+              session->data_size = session->l2cap_sdu_size;
+              response = true;
+            } else if (session->upload) {
               response = true;
             }
             if (response) {
-              handle_throughput_peripheral_start(false);
+              handle_throughput_peripheral_start(session, false);
             }
           }
         } else {
-          if (peripheral_state.state == THROUGHPUT_STATE_TEST) {
-            handle_throughput_peripheral_stop(false);
+          if (session->state == THROUGHPUT_STATE_TEST) {
+            handle_throughput_peripheral_stop(session, false);
             response = true;
           }
         }
-        sl_bt_gatt_server_send_user_write_response(connection,
+        sl_bt_gatt_server_send_user_write_response(session->connection,
                                                    gattdb_transmission_on,
                                                    response);
+      } else if (gattdb_throughput_pipeline_ack == evt->data.evt_gatt_server_attribute_value.attribute) {
+        throughput_peripheral_pipeline_ack(session,
+                                           evt->data.evt_gatt_server_attribute_value.value.data,
+                                           evt->data.evt_gatt_server_attribute_value.value.len);
+      } else if (gattdb_throughput_sink == evt->data.evt_gatt_server_attribute_value.attribute) {
+        throughput_peripheral_sink_write(session,
+                                         evt->data.evt_gatt_server_attribute_value.value.data,
+                                         evt->data.evt_gatt_server_attribute_value.value.len);
+      } else if (gattdb_throughput_echo == evt->data.evt_gatt_server_attribute_value.attribute) {
+        throughput_peripheral_echo(session,
+                                   evt->data.evt_gatt_server_attribute_value.value.data,
+                                   evt->data.evt_gatt_server_attribute_value.value.len);
+      }
+      break;
+
+    case sl_bt_evt_l2cap_coc_connection_request_id:
+      throughput_peripheral_l2cap_request(&evt->data.evt_l2cap_coc_connection_request);
+      break;
+
+    case sl_bt_evt_l2cap_coc_le_flow_control_credit_id:
+      session = throughput_peripheral_find_session(evt->data.evt_l2cap_coc_le_flow_control_credit.connection);
+      if (session == NULL || session->l2cap_cid == 0) {
+        break;
+      }
+      credits = (uint32_t)session->l2cap_credits
+                + evt->data.evt_l2cap_coc_le_flow_control_credit.credits;
+      session->l2cap_credits = (credits > 0xFFFF) ? 0xFFFF : (uint16_t)credits;
+      break;
+
+    case sl_bt_evt_l2cap_coc_channel_disconnected_id:
+      session = throughput_peripheral_find_session(evt->data.evt_l2cap_coc_channel_disconnected.connection);
+      if (session == NULL || session->l2cap_cid == 0) {
+        break;
+      }
+      session->l2cap_cid = 0;
+      session->l2cap_credits = 0;
+      if (session->state == THROUGHPUT_STATE_TEST
+          && (session->test_type & THROUGHPUT_TEST_L2CAP)) {
+        session->finish_test = true;
       }
       break;
 
     case sl_bt_evt_connection_tx_power_id:
-      if (peripheral_state.state != THROUGHPUT_STATE_TEST) {
+      session = throughput_peripheral_find_session(evt->data.evt_connection_tx_power.connection);
+      if (session != NULL
+          && session->state != THROUGHPUT_STATE_TEST
+          && session->state != THROUGHPUT_STATE_TEST_FINISH) {
         peripheral_state.tx_power = evt->data.evt_connection_tx_power.power_level;
         throughput_peripheral_on_power_change(peripheral_state.tx_power);
       }
       break;
 
     case sl_bt_evt_connection_rssi_id:
-      peripheral_state.rssi = evt->data.evt_connection_rssi.rssi;
+      session = throughput_peripheral_find_session(evt->data.evt_connection_rssi.connection);
+      if (session == NULL) {
+        break;
+      }
+      session->rssi = evt->data.evt_connection_rssi.rssi;
+      // Refreshed for the history during tests, reported between them
+      if (session->state == THROUGHPUT_STATE_TEST
+          || session->state == THROUGHPUT_STATE_TEST_FINISH) {
+        break;
+      }
+      peripheral_state.rssi = session->rssi;
       throughput_peripheral_on_rssi_change(peripheral_state.rssi);
       break;
 
     case sl_bt_evt_gatt_mtu_exchanged_id:
-      peripheral_state.mtu_size = evt->data.evt_gatt_mtu_exchanged.mtu;
-      throughput_peripheral_calculate_data_size();
-
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_mtu_size,
-                                                   0,
-                                                   1,
-                                                   (uint8_t *)&peripheral_state.mtu_size);
-      app_assert_status(sc);
-
-      sc = sl_bt_gatt_server_notify_all(gattdb_mtu_size,
-                                        1,
-                                        (uint8_t *)&peripheral_state.mtu_size);
-      app_assert_status(sc);
-
-      throughput_peripheral_on_connection_settings_change(peripheral_state.interval,
-                                                          peripheral_state.pdu_size,
-                                                          peripheral_state.mtu_size,
-                                                          peripheral_state.data_size);
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_mtu_exchanged.connection);
+      if (session == NULL) {
+        break;
+      }
+      session->mtu_size = evt->data.evt_gatt_mtu_exchanged.mtu;
+      throughput_peripheral_calculate_data_size(session);
+
+      throughput_peripheral_publish_value(session,
+                                          gattdb_mtu_size,
+                                          1,
+                                          (uint8_t *)&session->mtu_size);
+
+      throughput_peripheral_on_connection_settings_change(session->interval,
+                                                          session->pdu_size,
+                                                          session->mtu_size,
+                                                          session->data_size);
       break;
 
     case sl_bt_evt_connection_parameters_id:
-      peripheral_state.interval = evt->data.evt_connection_parameters.interval;
-      peripheral_state.connection_responder_latency
-        = evt->data.evt_connection_parameters.latency;
-      peripheral_state.connection_timeout
-        = evt->data.evt_connection_parameters.timeout;
-
-      sc = sl_bt_gatt_server_get_mtu(evt->data.evt_connection_parameters.connection,
-                                     &(peripheral_state.mtu_size));
-      app_assert_status(sc);
-
-      peripheral_state.pdu_size = evt->data.evt_connection_parameters.txsize;
-      throughput_peripheral_calculate_data_size();
-
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_pdu_size,
-                                                   0,
-                                                   1,
-                                                   (uint8_t *)&peripheral_state.pdu_size);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_mtu_size,
-                                                   0,
-                                                   1,
-                                                   (uint8_t *)&peripheral_state.mtu_size);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_connection_interval,
-                                                   0,
-                                                   4,
-                                                   (uint8_t *)&peripheral_state.interval);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_responder_latency,
-                                                   0,
-                                                   4,
-                                                   (uint8_t *)&peripheral_state.connection_responder_latency);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_supervision_timeout,
-                                                   0,
-                                                   4,
-                                                   (uint8_t *)&peripheral_state.connection_timeout);
-      app_assert_status(sc);
-
-      sc = sl_bt_gatt_server_notify_all(gattdb_pdu_size,
-                                        1,
-                                        (uint8_t *)&peripheral_state.pdu_size);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_notify_all(gattdb_mtu_size,
-                                        1,
-                                        (uint8_t *)&peripheral_state.mtu_size);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_notify_all(gattdb_connection_interval,
-                                        4,
-                                        (uint8_t *)&peripheral_state.interval);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_notify_all(gattdb_responder_latency,
-                                        4,
-                                        (uint8_t *)&peripheral_state.connection_responder_latency);
-      app_assert_status(sc);
-      sc = sl_bt_gatt_server_notify_all(gattdb_supervision_timeout,
-                                        4,
-                                        (uint8_t *)&peripheral_state.connection_timeout);
+      session = throughput_peripheral_find_session(evt->data.evt_connection_parameters.connection);
+      if (session == NULL) {
+        break;
+      }
+      session->interval = evt->data.evt_connection_parameters.interval;
+      session->responder_latency = evt->data.evt_connection_parameters.latency;
+      session->timeout = evt->data.evt_connection_parameters.timeout;
+      // A confirmation arrives one connection event after the indication
+      // at the earliest
+      throughput_rtt_set_floor(&session->rtt,
+                               2 * (uint32_t)session->interval * CONNECTION_INTERVAL_UNIT_US,
+                               THROUGHPUT_PERIPHERAL_RTO_MIN_MS * 1000);
+      peripheral_state.interval = session->interval;
+      peripheral_state.connection_responder_latency = session->responder_latency;
+      peripheral_state.connection_timeout = session->timeout;
+
+      sc = sl_bt_gatt_server_get_mtu(session->connection,
+                                     &(session->mtu_size));
       app_assert_status(sc);
 
-      throughput_peripheral_on_connection_settings_change(peripheral_state.interval,
-                                                          peripheral_state.pdu_size,
-                                                          peripheral_state.mtu_size,
-                                                          peripheral_state.data_size);
+      session->pdu_size = evt->data.evt_connection_parameters.txsize;
+      throughput_peripheral_calculate_data_size(session);
+
+      throughput_peripheral_publish_value(session,
+                                          gattdb_pdu_size,
+                                          1,
+                                          (uint8_t *)&session->pdu_size);
+      throughput_peripheral_publish_value(session,
+                                          gattdb_mtu_size,
+                                          1,
+                                          (uint8_t *)&session->mtu_size);
+      throughput_peripheral_publish_value(session,
+                                          gattdb_connection_interval,
+                                          4,
+                                          (uint8_t *)&session->interval);
+      throughput_peripheral_publish_value(session,
+                                          gattdb_responder_latency,
+                                          4,
+                                          (uint8_t *)&session->responder_latency);
+      throughput_peripheral_publish_value(session,
+                                          gattdb_supervision_timeout,
+                                          4,
+                                          (uint8_t *)&session->timeout);
+
+      throughput_peripheral_on_connection_settings_change(session->interval,
+                                                          session->pdu_size,
+                                                          session->mtu_size,
+                                                          session->data_size);
       break;
 
     case sl_bt_evt_connection_phy_status_id:
-      peripheral_state.phy = (throughput_phy_t)evt->data.evt_connection_phy_status.phy;
-
-      sc = sl_bt_gatt_server_write_attribute_value(gattdb_connection_phy,
-                                                   0,
-                                                   1,
-                                                   (uint8_t *)&peripheral_state.phy);
-      app_assert_status(sc);
+      session = throughput_peripheral_find_session(evt->data.evt_connection_phy_status.connection);
+      if (session == NULL) {
+        break;
+      }
+      session->phy = (throughput_phy_t)evt->data.evt_connection_phy_status.phy;
+      peripheral_state.phy = session->phy;
 
-      sc = sl_bt_gatt_server_notify_all(gattdb_connection_phy,
-                                        1,
-                                        (uint8_t *)&peripheral_state.phy);
-      app_assert_status(sc);
+      throughput_peripheral_publish_value(session,
+                                          gattdb_connection_phy,
+                                          1,
+                                          (uint8_t *)&session->phy);
 
       throughput_peripheral_on_phy_change(peripheral_state.phy);
       break;
 
     case sl_bt_evt_connection_closed_id:
-      connection = 0;
-      // Delete the connection, reset variables and start advertising
-      peripheral_state.state = THROUGHPUT_STATE_DISCONNECTED;
-      sl_simple_timer_stop(&refresh_timer);
-      sl_simple_timer_stop(&send_timer);
-      peripheral_state.notifications = sl_bt_gatt_disable;
-      peripheral_state.indications = sl_bt_gatt_disable;
-      result_indicated = sl_bt_gatt_disable;
-      transmission_indicated = sl_bt_gatt_disable;
-      throughput_peripheral_on_state_change(peripheral_state.state);
+      session = throughput_peripheral_find_session(evt->data.evt_connection_closed.connection);
+      if (session == NULL) {
+        break;
+      }
+      // Delete the session, reset variables and start advertising
+      throughput_peripheral_close_session(session);
+      if (throughput_peripheral_session_count() == 0) {
+        sl_simple_timer_stop(&refresh_timer);
+        peripheral_state.notifications = sl_bt_gatt_disable;
+        peripheral_state.indications = sl_bt_gatt_disable;
+      }
+      throughput_peripheral_update_state();
+      // A dropped link may have been the last one of a running test
+      throughput_peripheral_check_run_finished();
       throughput_peripheral_advertising_start();
       break;
 
     case sl_bt_evt_connection_opened_id:
-      if (peripheral_state.state == THROUGHPUT_STATE_DISCONNECTED) {
-        // Store the connection and disable advertising
-        connection = evt->data.evt_connection_opened.connection;
+      session = throughput_peripheral_open_session(evt->data.evt_connection_opened.connection);
+      if (session == NULL) {
+        // Session table is full
+        sc = sl_bt_connection_close(evt->data.evt_connection_opened.connection);
+        app_assert_status(sc);
+        break;
+      }
+      if (throughput_peripheral_session_count() < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS) {
+        // Keep accepting further centrals
+        throughput_peripheral_advertising_start();
+      } else {
         sc = sl_bt_advertiser_stop(advertising_set_handle);
         app_assert_status(sc);
 
         sc = sl_bt_advertiser_stop(coded_advertising_set_handle);
         app_assert_status(sc);
+      }
 
-        peripheral_state.state = THROUGHPUT_STATE_CONNECTED;
-        throughput_peripheral_refresh_connected_state();
+      throughput_peripheral_refresh_connected_state(session);
+      if (throughput_peripheral_session_count() == 1) {
         sl_simple_timer_start(&refresh_timer,
                               THROUGHPUT_TX_REFRESH_TIMER_PERIOD,
                               throughput_peripheral_on_refresh_timer_rise,
                               NULL,
                               true);
+      }
 
-        // Set remote connection power reporting - needed for Power Control
-        sc = sl_bt_connection_set_remote_power_reporting(connection,
-                                                         power_control_enabled);
-        app_assert_status(sc);
+      // Set remote connection power reporting - needed for Power Control
+      sc = sl_bt_connection_set_remote_power_reporting(session->connection,
+                                                       power_control_enabled);
+      app_assert_status(sc);
 
-        // Subscribe to service provided by the mobile app
-        sc = sl_bt_gatt_discover_primary_services_by_uuid(connection,
-                                                          UUID_LEN,
-                                                          peripheral_service_uuid);
-        app_assert_status(sc);
-      }
+      // Subscribe to service provided by the mobile app
+      sc = sl_bt_gatt_discover_primary_services_by_uuid(session->connection,
+                                                        UUID_LEN,
+                                                        peripheral_service_uuid);
+      app_assert_status(sc);
       break;
 
     case sl_bt_evt_gatt_server_characteristic_status_id:
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_server_characteristic_status.connection);
+      if (session == NULL) {
+        break;
+      }
       if ( (gattdb_throughput_result == evt->data.evt_gatt_server_characteristic_status.characteristic)
            && (sl_bt_gatt_server_confirmation == evt->data.evt_gatt_server_characteristic_status.status_flags) ) {
         // Result confirmed
-        throughput_peripheral_indication_confirm();
+        throughput_peripheral_indication_confirm(session);
       } else if ( (gattdb_throughput_indications == evt->data.evt_gatt_server_characteristic_status.characteristic)
                   && (sl_bt_gatt_server_confirmation == evt->data.evt_gatt_server_characteristic_status.status_flags) ) {
-        throughput_peripheral_indication_confirm();
+        throughput_peripheral_indication_confirm(session);
       } else {
         if (sl_bt_gatt_server_client_config == evt->data.evt_gatt_server_characteristic_status.status_flags ) {
           if (gattdb_throughput_result == evt->data.evt_gatt_server_characteristic_status.characteristic) {
-            result_indicated = (throughput_notification_t)evt->data.evt_gatt_server_characteristic_status.client_config_flags;
+            session->result_indicated = (throughput_notification_t)evt->data.evt_gatt_server_characteristic_status.client_config_flags;
           }
           if (gattdb_transmission_on == evt->data.evt_gatt_server_characteristic_status.characteristic) {
-            transmission_indicated = (throughput_notification_t)evt->data.evt_gatt_server_characteristic_status.client_config_flags;
+            session->transmission_indicated = (throughput_notification_t)evt->data.evt_gatt_server_characteristic_status.client_config_flags;
           }
           if (gattdb_throughput_indications == evt->data.evt_gatt_server_characteristic_status.characteristic) {
-            peripheral_state.indications = (throughput_notification_t)(evt->data.evt_gatt_server_characteristic_status.client_config_flags
-                                                                       & sl_bt_gatt_indication);
-            throughput_peripheral_on_indication_change(peripheral_state.indications);
+            session->indications = (throughput_notification_t)(evt->data.evt_gatt_server_characteristic_status.client_config_flags
+                                                               & sl_bt_gatt_indication);
+            throughput_peripheral_on_indication_change(session->indications);
           }
           if (gattdb_throughput_notifications == evt->data.evt_gatt_server_characteristic_status.characteristic) {
-            peripheral_state.notifications = (throughput_notification_t)(evt->data.evt_gatt_server_characteristic_status.client_config_flags
-                                                                         & sl_bt_gatt_notification);
-            throughput_peripheral_on_notification_change(peripheral_state.notifications);
+            session->notifications = (throughput_notification_t)(evt->data.evt_gatt_server_characteristic_status.client_config_flags
+                                                                 & sl_bt_gatt_notification);
+            throughput_peripheral_on_notification_change(session->notifications);
           }
-          throughput_peripheral_refresh_connected_state();
+          if (gattdb_throughput_pipeline == evt->data.evt_gatt_server_characteristic_status.characteristic) {
+            session->pipeline = (throughput_notification_t)(evt->data.evt_gatt_server_characteristic_status.client_config_flags
+                                                            & sl_bt_gatt_notification);
+          }
+          throughput_peripheral_refresh_connected_state(session);
         }
       }
       break;
     case sl_bt_evt_gatt_procedure_completed_id:
-      process_procedure_complete_event(evt);
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_procedure_completed.connection);
+      if (session != NULL) {
+        process_procedure_complete_event(session, evt);
+      }
       break;
     case sl_bt_evt_gatt_characteristic_id:
-      check_characteristic_uuid(evt);
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_characteristic.connection);
+      if (session != NULL) {
+        check_characteristic_uuid(session, evt);
+      }
       break;
     case sl_bt_evt_gatt_service_id:
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_service.connection);
+      if (session == NULL) {
+        break;
+      }
       if (evt->data.evt_gatt_service.uuid.len == UUID_LEN) {
         if (memcmp(peripheral_service_uuid, evt->data.evt_gatt_service.uuid.data, UUID_LEN) == 0) {
-          service_handle = evt->data.evt_gatt_service.service;
-          action = act_discover_service;
+          session->service_handle = evt->data.evt_gatt_service.service;
+          session->action = act_discover_service;
         }
       }
       break;
     case sl_bt_evt_gatt_characteristic_value_id:
+      session = throughput_peripheral_find_session(evt->data.evt_gatt_characteristic_value.connection);
+      if (session == NULL) {
+        break;
+      }
       // Handle remote start/stop event
-      if (evt->data.evt_gatt_characteristic_value.characteristic == transmission_handle) {
+      if (evt->data.evt_gatt_characteristic_value.characteristic == session->transmission_handle) {
         if (evt->data.evt_gatt_characteristic_value.value.data[0]) {
-          central_test = true;
-          handle_throughput_peripheral_start(false);
+          session->central_test = true;
+          session->duplex = false;
+          session->upload = false;
+          session->integrity = throughput_integrity_decode(evt->data.evt_gatt_characteristic_value.value.data[0]);
+          session->encrypted = throughput_crypto_decode(evt->data.evt_gatt_characteristic_value.value.data[0]);
+          handle_throughput_peripheral_start(session, false);
         } else {
-          handle_throughput_peripheral_stop(false);
-          central_test = false;
+          handle_throughput_peripheral_stop(session, false);
+          session->central_test = false;
         }
-      } else if (evt->data.evt_gatt_characteristic_value.characteristic == indications_handle
-                 || evt->data.evt_gatt_characteristic_value.characteristic == notifications_handle) {
+      } else if (evt->data.evt_gatt_characteristic_value.characteristic == session->indications_handle
+                 || evt->data.evt_gatt_characteristic_value.characteristic == session->notifications_handle) {
         // Handle received data
         // Send confirmation if needed
-        if (evt->data.evt_gatt_characteristic_value.characteristic == indications_handle) {
+        if (evt->data.evt_gatt_characteristic_value.characteristic == session->indications_handle) {
           if (evt->data.evt_gatt_characteristic_value.att_opcode == gatt_handle_value_indication) {
-            sl_bt_gatt_send_characteristic_confirmation(evt->data.evt_gatt_characteristic_value.connection);
+            sl_bt_gatt_send_characteristic_confirmation(session->connection);
           }
         }
         // Check data for loss or error
-        check_received_data(evt->data.evt_gatt_characteristic_value.value.data,
+        check_received_data(session,
+                            evt->data.evt_gatt_characteristic_value.value.data,
                             evt->data.evt_gatt_characteristic_value.value.len);
         // Count bytes and operation
-        bytes_sent += (evt->data.evt_gatt_characteristic_value.value.len);
-        operation_count++;
+        session->bytes_sent += (evt->data.evt_gatt_characteristic_value.value.len);
+        session->operation_count++;
       }
       // We silently ignore other data.
       break;
@@ -1191,52 +3084,53 @@ void throughput_peripheral_on_bt_event(sl_bt_msg_t *evt)
 
 // Helper function to make the discovery and subscribing flow correct.
 // Action enum values indicate which procedure was completed.
-static void process_procedure_complete_event(sl_bt_msg_t *evt)
+static void process_procedure_complete_event(throughput_peripheral_session_t *session,
+                                             sl_bt_msg_t *evt)
 {
   uint16_t procedure_result =  evt->data.evt_gatt_procedure_completed.result;
   sl_status_t sc;
 
-  switch (action) {
+  switch (session->action) {
     case act_discover_service:
-      action = act_none;
+      session->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
         // Discover successful, start characteristic discovery.
-        sc = sl_bt_gatt_discover_characteristics(connection, service_handle);
+        sc = sl_bt_gatt_discover_characteristics(session->connection, session->service_handle);
         app_assert_status(sc);
-        action = act_discover_characteristics;
+        session->action = act_discover_characteristics;
       }
       break;
     case act_discover_characteristics:
-      action = act_none;
+      session->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
-        if (characteristic_found.all == THROUGHPUT_PERIPHERAL_CHARACTERISTICS_ALL) {
-          sc = sl_bt_gatt_set_characteristic_notification(connection, notifications_handle, sl_bt_gatt_notification);
+        if (session->characteristic_found.all == THROUGHPUT_PERIPHERAL_CHARACTERISTICS_ALL) {
+          sc = sl_bt_gatt_set_characteristic_notification(session->connection, session->notifications_handle, sl_bt_gatt_notification);
           app_assert_status(sc);
-          action = act_enable_notification;
+          session->action = act_enable_notification;
         }
       }
       break;
     case act_enable_notification:
-      action = act_none;
+      session->action = act_none;
       app_assert_status(procedure_result);
       if (!procedure_result) {
-        sl_bt_gatt_set_characteristic_notification(connection, indications_handle, sl_bt_gatt_indication);
-        action = act_enable_indication;
+        sl_bt_gatt_set_characteristic_notification(session->connection, session->indications_handle, sl_bt_gatt_indication);
+        session->action = act_enable_indication;
       }
       break;
     case act_enable_indication:
-      action = act_enable_indication;
+      session->action = act_enable_indication;
       app_assert_status(procedure_result);
       if (!procedure_result) {
-        sc = sl_bt_gatt_set_characteristic_notification(connection, transmission_handle, sl_bt_gatt_notification);
+        sc = sl_bt_gatt_set_characteristic_notification(session->connection, session->transmission_handle, sl_bt_gatt_notification);
         app_assert_status(sc);
         // Clear the display
         throughput_ui_set_throughput(0);
         throughput_ui_set_count(0);
         throughput_ui_update();
-        action = act_none;
+        session->action = act_none;
       }
       break;
     case act_none:
@@ -1247,18 +3141,19 @@ static void process_procedure_complete_event(sl_bt_msg_t *evt)
 }
 
 // Check if found characteristic matches the UUIDs that we are searching for.
-static void check_characteristic_uuid(sl_bt_msg_t *evt)
+static void check_characteristic_uuid(throughput_peripheral_session_t *session,
+                                      sl_bt_msg_t *evt)
 {
   if (evt->data.evt_gatt_characteristic.uuid.len == UUID_LEN) {
     if (memcmp(peripheral_notifications_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      notifications_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.notification = true;
+      session->notifications_handle = evt->data.evt_gatt_characteristic.characteristic;
+      session->characteristic_found.characteristic.notification = true;
     } else if (memcmp(peripheral_indications_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      indications_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.indication = true;
+      session->indications_handle = evt->data.evt_gatt_characteristic.characteristic;
+      session->characteristic_found.characteristic.indication = true;
     } else if (memcmp(peripheral_transmission_characteristic_uuid, evt->data.evt_gatt_characteristic.uuid.data, UUID_LEN) == 0) {
-      transmission_handle = evt->data.evt_gatt_characteristic.characteristic;
-      characteristic_found.characteristic.transmission_on = true;
+      session->transmission_handle = evt->data.evt_gatt_characteristic.characteristic;
+      session->characteristic_found.characteristic.transmission_on = true;
     }
   }
 }
@@ -1271,7 +3166,7 @@ sl_status_t throughput_peripheral_set_tx_power(throughput_tx_power_t tx_power,
                                                bool deep_sleep)
 {
   sl_status_t res = SL_STATUS_OK;
-  if (enabled && peripheral_state.state != THROUGHPUT_STATE_TEST) {
+  if (enabled && !throughput_peripheral_is_testing()) {
     peripheral_state.tx_power_requested = tx_power;
     deep_sleep_enabled = deep_sleep;
 
@@ -1282,9 +3177,16 @@ sl_status_t throughput_peripheral_set_tx_power(throughput_tx_power_t tx_power,
     }
 
     // Reconnect if required
-    if (peripheral_state.state != THROUGHPUT_STATE_DISCONNECTED) {
-      // Close connection and apply power
-      res = sl_bt_connection_close(connection);
+    if (throughput_peripheral_session_count() > 0) {
+      // Close connections, power is applied once the last one is closed
+      for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+        if (sessions[i].connection != 0) {
+          sl_status_t sc = sl_bt_connection_close(sessions[i].connection);
+          if (res == SL_STATUS_OK) {
+            res = sc;
+          }
+        }
+      }
     } else {
       // Restart advertising and apply power
       throughput_peripheral_advertising_start();
@@ -1303,22 +3205,25 @@ sl_status_t throughput_peripheral_set_data_size(uint8_t mtu,
                                                 uint8_t not_data)
 {
   sl_status_t res = SL_STATUS_OK;
-  if (enabled && peripheral_state.state != THROUGHPUT_STATE_TEST) {
-    peripheral_state.mtu_size = mtu;
-    res = sl_bt_gatt_server_set_max_mtu(peripheral_state.mtu_size, &(peripheral_state.mtu_size));
+  if (enabled && !throughput_peripheral_is_testing()) {
+    res = sl_bt_gatt_server_set_max_mtu(mtu, &max_mtu_size);
 
     if (res == SL_STATUS_OK) {
+      peripheral_state.mtu_size = max_mtu_size;
       requested_indication_size = ind_data;
       requested_notification_size = not_data;
-      throughput_peripheral_calculate_data_size();
+      for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+        if (sessions[i].connection != 0) {
+          sessions[i].mtu_size = max_mtu_size;
+          throughput_peripheral_calculate_data_size(&sessions[i]);
+          // Reconnect to renegotiate
+          sl_bt_connection_close(sessions[i].connection);
+        }
+      }
       throughput_peripheral_on_connection_settings_change(peripheral_state.interval,
                                                           peripheral_state.pdu_size,
                                                           peripheral_state.mtu_size,
                                                           peripheral_state.data_size);
-      // Reconnect if required
-      if (peripheral_state.state != THROUGHPUT_STATE_DISCONNECTED) {
-        sl_bt_connection_close(connection);
-      }
     }
   } else {
     res = SL_STATUS_INVALID_STATE;
@@ -1326,6 +3231,99 @@ sl_status_t throughput_peripheral_set_data_size(uint8_t mtu,
   return res;
 }
 
+/**************************************************************************//**
+ * Sets the payload pattern.
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_pattern(throughput_pattern_type_t type,
+                                              const uint8_t *user,
+                                              uint8_t user_len)
+{
+  if (!enabled || throughput_peripheral_is_testing()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (user_len > 0) {
+    // The receiver needs the same user pattern to check the packets
+    if (!throughput_pattern_set_user(&tx_pattern, user, user_len)) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    (void)throughput_pattern_set_user(&rx_pattern, user, user_len);
+  }
+  if (!throughput_pattern_select(&tx_pattern, type)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the integrity trailer.
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_integrity(throughput_integrity_type_t type)
+{
+  if (!enabled || throughput_peripheral_is_testing()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (!throughput_integrity_supported(type)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  integrity_type = type;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the encryption.
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_crypto(bool enable, const uint8_t *key)
+{
+  if (!enabled || throughput_peripheral_is_testing()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  if (enable && !throughput_crypto_supported()) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  if (key != NULL) {
+    throughput_crypto_set_key(&crypto_key, key);
+  }
+  crypto_enabled = enable;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Sets the window of the history.
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_history_window(uint32_t window)
+{
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  if (!enabled || throughput_peripheral_is_testing()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  history_window = window;
+  return SL_STATUS_OK;
+#else
+  (void)window;
+  return SL_STATUS_NOT_SUPPORTED;
+#endif
+}
+
+/**************************************************************************//**
+ * Time in the base of the central of a connection.
+ *****************************************************************************/
+uint64_t throughput_peripheral_get_time(uint8_t connection, bool *synchronized)
+{
+  throughput_peripheral_session_t *session = throughput_peripheral_find_session(connection);
+  uint64_t local = throughput_peripheral_local_time();
+
+  if (session == NULL || !session->clock.valid) {
+    if (synchronized != NULL) {
+      *synchronized = false;
+    }
+    return local;
+  }
+  if (synchronized != NULL) {
+    *synchronized = true;
+  }
+  return throughput_clock_convert(&session->clock, local);
+}
+
 /**************************************************************************//**
  * Sets the the transmission mode.
  *****************************************************************************/
@@ -1333,7 +3331,7 @@ sl_status_t throughput_peripheral_set_mode(throughput_mode_t mode,
                                            uint32_t amount)
 {
   sl_status_t res = SL_STATUS_OK;
-  if (enabled && peripheral_state.state != THROUGHPUT_STATE_TEST) {
+  if (enabled && !throughput_peripheral_is_testing()) {
     if (mode == THROUGHPUT_MODE_FIXED_LENGTH) {
       fixed_data_size = amount;
     } else if (mode == THROUGHPUT_MODE_FIXED_TIME) {
@@ -1351,37 +3349,29 @@ sl_status_t throughput_peripheral_set_mode(throughput_mode_t mode,
  *****************************************************************************/
 sl_status_t throughput_peripheral_start(throughput_notification_t type)
 {
-  sl_status_t res = SL_STATUS_OK;
-  if (enabled && peripheral_state.state == THROUGHPUT_STATE_SUBSCRIBED) {
-    if ((peripheral_state.indications & sl_bt_gatt_indication)
-        && (peripheral_state.notifications & sl_bt_gatt_notification)
-        && (type != sl_bt_gatt_disable) ) {
-      peripheral_state.test_type = sl_bt_gatt_notification;
-    }
-    if (type == sl_bt_gatt_indication
-        && (peripheral_state.indications & sl_bt_gatt_indication) ) {
-      peripheral_state.test_type = sl_bt_gatt_indication;
-    } else if (type == sl_bt_gatt_notification
-               && (peripheral_state.notifications & sl_bt_gatt_notification) ) {
-      peripheral_state.test_type = sl_bt_gatt_notification;
-    }
-    if (peripheral_state.test_type != sl_bt_gatt_disable) {
-      if (peripheral_state.test_type & sl_bt_gatt_notification) {
-        peripheral_state.data_size = notification_data_size;
-      }
-      if (peripheral_state.test_type & sl_bt_gatt_indication) {
-        peripheral_state.data_size = indication_data_size;
-      }
-      throughput_peripheral_on_connection_settings_change(peripheral_state.interval,
-                                                          peripheral_state.pdu_size,
-                                                          peripheral_state.mtu_size,
-                                                          peripheral_state.data_size);
-      handle_throughput_peripheral_start(true);
-    } else {
+  sl_status_t res = SL_STATUS_INVALID_STATE;
+  if (!enabled) {
+    return res;
+  }
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session = &sessions[i];
+    if (session->connection == 0
+        || session->state != THROUGHPUT_STATE_SUBSCRIBED) {
+      continue;
+    }
+    if (res != SL_STATUS_OK) {
       res = SL_STATUS_INVALID_TYPE;
     }
-  } else {
-    res = SL_STATUS_INVALID_STATE;
+    if (throughput_peripheral_select_test_type(session, type)) {
+      peripheral_state.test_type = session->test_type;
+      peripheral_state.data_size = session->data_size;
+      throughput_peripheral_on_connection_settings_change(session->interval,
+                                                          session->pdu_size,
+                                                          session->mtu_size,
+                                                          session->data_size);
+      handle_throughput_peripheral_start(session, true);
+      res = SL_STATUS_OK;
+    }
   }
   return res;
 }
@@ -1391,11 +3381,16 @@ sl_status_t throughput_peripheral_start(throughput_notification_t type)
  *****************************************************************************/
 sl_status_t throughput_peripheral_stop(void)
 {
-  sl_status_t res = SL_STATUS_OK;
-  if (enabled && peripheral_state.state == THROUGHPUT_STATE_TEST) {
-    finish_test = true;
-  } else {
-    res = SL_STATUS_INVALID_STATE;
+  sl_status_t res = SL_STATUS_INVALID_STATE;
+  if (!enabled) {
+    return res;
+  }
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection != 0
+        && sessions[i].state == THROUGHPUT_STATE_TEST) {
+      sessions[i].finish_test = true;
+      res = SL_STATUS_OK;
+    }
   }
   return res;
 }
@@ -1406,7 +3401,7 @@ sl_status_t throughput_peripheral_stop(void)
 bool throughput_peripheral_is_ok_to_sleep(void)
 {
   bool ret = true;
-  if (enabled && !deep_sleep_enabled && (peripheral_state.state == THROUGHPUT_STATE_TEST)) {
+  if (enabled && !deep_sleep_enabled && throughput_peripheral_is_busy()) {
     ret = false;
   }
   return ret;
@@ -1417,7 +3412,7 @@ bool throughput_peripheral_is_ok_to_sleep(void)
 sl_power_manager_on_isr_exit_t throughput_peripheral_sleep_on_isr_exit(void)
 {
   sl_power_manager_on_isr_exit_t ret = SL_POWER_MANAGER_IGNORE;
-  if (enabled && !deep_sleep_enabled && (peripheral_state.state == THROUGHPUT_STATE_TEST)) {
+  if (enabled && !deep_sleep_enabled && throughput_peripheral_is_busy()) {
     ret = SL_POWER_MANAGER_WAKEUP;
   }
   return ret;
@@ -1487,6 +3482,27 @@ SL_WEAK void throughput_peripheral_on_finish_reception(throughput_value_t throug
   app_log_info(THROUGHPUT_UI_TIME_FORMAT APP_LOG_NEW_LINE, ((int)time));
 }
 
+/**************************************************************************//**
+ * Weak implementation of callback to handle the result of a single link.
+ *****************************************************************************/
+SL_WEAK void throughput_peripheral_on_link_finish(uint8_t connection,
+                                                  throughput_value_t throughput,
+                                                  throughput_count_t count,
+                                                  throughput_count_t lost,
+                                                  throughput_count_t error,
+                                                  throughput_time_t time)
+{
+  app_log_info("LINK %d: " THROUGHPUT_UI_TH_FORMAT " " THROUGHPUT_UI_CNT_FORMAT
+               " " THROUGHPUT_UI_LOST_FORMAT " " THROUGHPUT_UI_ERROR_FORMAT
+               " " THROUGHPUT_UI_TIME_FORMAT APP_LOG_NEW_LINE,
+               (int)connection,
+               (int)throughput,
+               (int)count,
+               (int)lost,
+               (int)error,
+               (int)time);
+}
+
 /**************************************************************************//**
  * Weak implementation of callback to handle TX power changed event.
  *****************************************************************************/
@@ -1510,48 +3526,218 @@ SL_WEAK void throughput_peripheral_on_rssi_change(throughput_rssi_t rssi)
  *****************************************************************************/
 SL_WEAK void throughput_peripheral_on_phy_change(throughput_phy_t phy)
 {
-  throughput_ui_set_phy(phy);
-  throughput_ui_update();
+  throughput_ui_set_phy(phy);
+  throughput_ui_update();
+}
+
+/**************************************************************************//**
+ * Weak implementation of callback to handle connection settings changes.
+ *****************************************************************************/
+SL_WEAK void throughput_peripheral_on_connection_settings_change(throughput_time_t interval,
+                                                                 throughput_pdu_size_t pdu,
+                                                                 throughput_mtu_size_t mtu,
+                                                                 throughput_data_size_t data)
+{
+  throughput_ui_set_connection_interval(interval);
+  throughput_ui_set_pdu_size(pdu);
+  throughput_ui_set_mtu_size(mtu);
+  throughput_ui_set_data_size(data);
+  throughput_ui_update();
+}
+
+/**************************************************************************//**
+ * Weak implementation of callback to handle notification changed event.
+ *****************************************************************************/
+SL_WEAK void throughput_peripheral_on_notification_change(throughput_notification_t notification)
+{
+  throughput_ui_set_notifications(notification);
+  throughput_ui_update();
+}
+
+/**************************************************************************//**
+ * Weak implementation of callback to handle indication changed event.
+ *****************************************************************************/
+SL_WEAK void throughput_peripheral_on_indication_change(throughput_notification_t indication)
+{
+  throughput_ui_set_indications(indication);
+  throughput_ui_update();
+}
+
+/*******************************************************************************
+ **************************** CLI RELATED FUNCTIONS ****************************
+ ******************************************************************************/
+
+#ifdef SL_CATALOG_CLI_PRESENT
+/***************************************************************************//**
+ * Prints the text of a test state
+ * @param[in] state state to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_state(throughput_state_t state)
+{
+  switch (state) {
+    case THROUGHPUT_STATE_CONNECTED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_CONNECTED_TEXT);
+      break;
+    case THROUGHPUT_STATE_DISCONNECTED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_DISCONNECTED_TEXT);
+      break;
+    case THROUGHPUT_STATE_SUBSCRIBED:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_SUBSCRIBED_TEXT);
+      break;
+    case THROUGHPUT_STATE_TEST:
+    case THROUGHPUT_STATE_TEST_FINISH:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_TEST_TEXT);
+      break;
+    default:
+      CLI_RESPONSE(THROUGHPUT_UI_STATE_UNKNOWN_TEXT);
+      break;
+  }
+}
+
+/***************************************************************************//**
+ * Prints the loss statistics of a receiving link
+ * @param[in] label line label
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_sequence(const char *label,
+                                                     const throughput_sequence_stats_t *stats)
+{
+  CLI_RESPONSE("  %s: %lu received, %lu lost, %lu reordered, %lu duplicates, %lu late" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)stats->received,
+               (unsigned long)stats->lost,
+               (unsigned long)stats->reordered,
+               (unsigned long)stats->duplicates,
+               (unsigned long)stats->late);
+  CLI_RESPONSE("  %s BURSTS: 1:%lu 2:%lu 3-4:%lu 5-8:%lu 9-16:%lu 17-32:%lu 33-64:%lu 65+:%lu" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)stats->bursts[0],
+               (unsigned long)stats->bursts[1],
+               (unsigned long)stats->bursts[2],
+               (unsigned long)stats->bursts[3],
+               (unsigned long)stats->bursts[4],
+               (unsigned long)stats->bursts[5],
+               (unsigned long)stats->bursts[6],
+               (unsigned long)stats->bursts[7]);
+}
+
+/***************************************************************************//**
+ * Prints the bit errors of a receiving link
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_pattern(const throughput_pattern_stats_t *stats)
+{
+  CLI_RESPONSE("  BER: %lu errors in %lu kbit (%lu ppb), %lu errored packets, last at bit %lu" APP_LOG_NEW_LINE,
+               (unsigned long)stats->errors,
+               (unsigned long)(stats->bits / 1000),
+               (unsigned long)(((uint64_t)stats->errors * 1000000000ULL) / stats->bits),
+               (unsigned long)stats->errored_packets,
+               (unsigned long)stats->last_offset);
+  CLI_RESPONSE("  BER LANES: %lu %lu %lu %lu %lu %lu %lu %lu" APP_LOG_NEW_LINE,
+               (unsigned long)stats->lanes[0],
+               (unsigned long)stats->lanes[1],
+               (unsigned long)stats->lanes[2],
+               (unsigned long)stats->lanes[3],
+               (unsigned long)stats->lanes[4],
+               (unsigned long)stats->lanes[5],
+               (unsigned long)stats->lanes[6],
+               (unsigned long)stats->lanes[7]);
 }
 
-/**************************************************************************//**
- * Weak implementation of callback to handle connection settings changes.
- *****************************************************************************/
-SL_WEAK void throughput_peripheral_on_connection_settings_change(throughput_time_t interval,
-                                                                 throughput_pdu_size_t pdu,
-                                                                 throughput_mtu_size_t mtu,
-                                                                 throughput_data_size_t data)
+/***************************************************************************//**
+ * Prints the integrity checks and their cost of a link.
+ * @param[in] type integrity mode of the link
+ * @param[in] stats statistics to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_integrity(throughput_integrity_type_t type,
+                                                      const throughput_integrity_stats_t *stats)
 {
-  throughput_ui_set_connection_interval(interval);
-  throughput_ui_set_pdu_size(pdu);
-  throughput_ui_set_mtu_size(mtu);
-  throughput_ui_set_data_size(data);
-  throughput_ui_update();
+  CLI_RESPONSE("  INTEGRITY: %s, %lu packets, %lu failed, %lu not computed, %lu.%02lu cycles/byte" APP_LOG_NEW_LINE,
+               throughput_integrity_name(type),
+               (unsigned long)stats->packets,
+               (unsigned long)stats->failures,
+               (unsigned long)stats->errors,
+               (unsigned long)(stats->bytes ? stats->cycles / stats->bytes : 0),
+               (unsigned long)(stats->bytes ? (stats->cycles * 100 / stats->bytes) % 100 : 0));
 }
 
-/**************************************************************************//**
- * Weak implementation of callback to handle notification changed event.
- *****************************************************************************/
-SL_WEAK void throughput_peripheral_on_notification_change(throughput_notification_t notification)
+/***************************************************************************//**
+ * Prints the encryption of a link and its cost, with the throughput of the
+ * plaintext next to the one of the packets.
+ * @param[in] stats statistics to print
+ * @param[in] throughput throughput of the packets
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_crypto(const throughput_crypto_stats_t *stats,
+                                                   throughput_value_t throughput)
 {
-  throughput_ui_set_notifications(notification);
-  throughput_ui_update();
+  CLI_RESPONSE("  CRYPTO: AES-CCM, %lu packets, %lu failed, %lu.%02lu cycles/byte,"
+               " plaintext %lu of %lu bps" APP_LOG_NEW_LINE,
+               (unsigned long)stats->packets,
+               (unsigned long)stats->failures,
+               (unsigned long)(stats->plaintext_bytes ? stats->cycles / stats->plaintext_bytes : 0),
+               (unsigned long)(stats->plaintext_bytes
+                               ? (stats->cycles * 100 / stats->plaintext_bytes) % 100 : 0),
+               (unsigned long)(stats->bytes ? throughput * stats->plaintext_bytes / stats->bytes : 0),
+               (unsigned long)throughput);
 }
 
-/**************************************************************************//**
- * Weak implementation of callback to handle indication changed event.
- *****************************************************************************/
-SL_WEAK void throughput_peripheral_on_indication_change(throughput_notification_t indication)
+/***************************************************************************//**
+ * Prints a latency histogram summary
+ * @param[in] label name of the latency
+ * @param[in] summary summary to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_latency(const char *label,
+                                                    const throughput_latency_summary_t *summary)
 {
-  throughput_ui_set_indications(indication);
-  throughput_ui_update();
+  CLI_RESPONSE("  %s: %lu samples, p50 %lu us, p90 %lu us, p99 %lu us, p99.9 %lu us,"
+               " max %lu us, jitter %lu us" APP_LOG_NEW_LINE,
+               label,
+               (unsigned long)summary->count,
+               (unsigned long)summary->p50,
+               (unsigned long)summary->p90,
+               (unsigned long)summary->p99,
+               (unsigned long)summary->p999,
+               (unsigned long)summary->max,
+               (unsigned long)summary->jitter);
 }
 
-/*******************************************************************************
- **************************** CLI RELATED FUNCTIONS ****************************
+/***************************************************************************//**
+ * Prints the per direction results of the last duplex test of a link
+ * @param[in] session session to print
  ******************************************************************************/
+static void cli_throughput_peripheral_print_duplex(throughput_peripheral_session_t *session)
+{
+  float utilization = throughput_duplex_utilization(session->phy,
+                                                    session->throughput,
+                                                    session->down_result.throughput);
+
+  CLI_RESPONSE("  DUPLEX: up %lu bps, down %lu bps (%lu packets),"
+               " down latency avg %lu us max %lu us, utilization %lu.%01lu%%" APP_LOG_NEW_LINE,
+               (unsigned long)session->throughput,
+               (unsigned long)session->down_result.throughput,
+               (unsigned long)session->down_packets,
+               (unsigned long)session->down_result.latency_mean,
+               (unsigned long)session->down_result.latency_max,
+               (unsigned long)utilization,
+               (unsigned long)(utilization * 10) % 10);
+}
+
+/***************************************************************************//**
+ * Prints the results of the last upload of a link
+ * @param[in] session session to print
+ ******************************************************************************/
+static void cli_throughput_peripheral_print_upload(throughput_peripheral_session_t *session)
+{
+  CLI_RESPONSE("  UPLOAD: %lu bps (%lu B/s), %lu bytes in %lu packets,"
+               " latency avg %lu us max %lu us" APP_LOG_NEW_LINE,
+               (unsigned long)session->down_result.throughput,
+               (unsigned long)(session->down_result.throughput / 8),
+               (unsigned long)session->down_bytes,
+               (unsigned long)session->down_packets,
+               (unsigned long)session->down_result.latency_mean,
+               (unsigned long)session->down_result.latency_max);
+}
 
-#ifdef SL_CATALOG_CLI_PRESENT
 /***************************************************************************//**
  * CLI command for peripheral stop
  * @param[in] arguments command line argument list
@@ -1587,14 +3773,11 @@ void cli_throughput_peripheral_start(sl_cli_command_arg_t *arguments)
     return;
   }
   sl_status_t sc;
-  if (peripheral_state.state == THROUGHPUT_STATE_SUBSCRIBED) {
-    uint8_t test = sl_cli_get_argument_uint8(arguments, 0);
-    sc = throughput_peripheral_start((throughput_notification_t)test);
-    if (sc == SL_STATUS_OK) {
-      CLI_RESPONSE(CLI_OK);
-    } else {
-      CLI_RESPONSE(CLI_ERROR);
-    }
+  // Starts every subscribed link, fails if there is none
+  uint8_t test = sl_cli_get_argument_uint8(arguments, 0);
+  sc = throughput_peripheral_start((throughput_notification_t)test);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
   } else {
     CLI_RESPONSE(CLI_ERROR);
   }
@@ -1611,23 +3794,7 @@ void cli_throughput_peripheral_status(sl_cli_command_arg_t *arguments)
     CLI_RESPONSE(CLI_ERROR);
     return;
   }
-  switch (peripheral_state.state) {
-    case THROUGHPUT_STATE_CONNECTED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_CONNECTED_TEXT);
-      break;
-    case THROUGHPUT_STATE_DISCONNECTED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_DISCONNECTED_TEXT);
-      break;
-    case THROUGHPUT_STATE_SUBSCRIBED:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_SUBSCRIBED_TEXT);
-      break;
-    case THROUGHPUT_STATE_TEST:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_TEST_TEXT);
-      break;
-    default:
-      CLI_RESPONSE(THROUGHPUT_UI_STATE_UNKNOWN_TEXT);
-      break;
-  }
+  cli_throughput_peripheral_print_state(peripheral_state.state);
   CLI_RESPONSE(APP_LOG_NEW_LINE);
 
   if (peripheral_state.role == THROUGHPUT_ROLE_PERIPHERAL) {
@@ -1637,6 +3804,120 @@ void cli_throughput_peripheral_status(sl_cli_command_arg_t *arguments)
   }
   CLI_RESPONSE(APP_LOG_NEW_LINE);
 
+  // Per link status and the result of its last test
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session = &sessions[i];
+    if (session->connection == 0) {
+      continue;
+    }
+    CLI_RESPONSE("LINK %d: ", (int)session->connection);
+    cli_throughput_peripheral_print_state(session->state);
+    CLI_RESPONSE(" " THROUGHPUT_UI_DATA_SIZE_FORMAT
+                 " " THROUGHPUT_UI_TH_FORMAT
+                 " " THROUGHPUT_UI_CNT_FORMAT
+                 " " THROUGHPUT_UI_LOST_FORMAT
+                 " " THROUGHPUT_UI_ERROR_FORMAT APP_LOG_NEW_LINE,
+                 (int)session->data_size,
+                 (int)session->throughput,
+                 (int)session->count,
+                 (int)session->packet_lost,
+                 (int)session->packet_error);
+    CLI_RESPONSE("  TX: %lu attempts, failed: %lu no buffer %lu busy %lu other"
+                 " (last 0x%04lx), idle: %lu ms" APP_LOG_NEW_LINE,
+                 (unsigned long)session->tx_attempts,
+                 (unsigned long)session->tx_fail_no_buffer,
+                 (unsigned long)session->tx_fail_busy,
+                 (unsigned long)session->tx_fail_other,
+                 (unsigned long)session->tx_last_error,
+                 (unsigned long)(((uint64_t)session->tx_idle_ticks * 1000)
+                                 / sl_sleeptimer_get_timer_frequency()));
+    if (SAMPLE_QUEUE_ENABLED) {
+      CLI_RESPONSE("  QUEUE: %lu/%d HIGH: %lu OVERRUN: %lu BACKPRESSURE: %lu" APP_LOG_NEW_LINE,
+                   (unsigned long)throughput_ring_level(&session->sample_queue),
+                   THROUGHPUT_PERIPHERAL_SAMPLE_QUEUE_SLOTS,
+                   (unsigned long)session->sample_queue.high_water,
+                   (unsigned long)session->sample_queue.overruns,
+                   (unsigned long)session->sample_queue.backpressure);
+    }
+    if (session->pipeline & sl_bt_gatt_notification) {
+      CLI_RESPONSE("  PIPELINE: %lu in flight, %lu acks, %lu retransmits" APP_LOG_NEW_LINE,
+                   (unsigned long)(session->pipe_next - session->pipe_base),
+                   (unsigned long)session->pipe_acks,
+                   (unsigned long)session->pipe_retransmits);
+    }
+    if (session->sequence_rx.stats.received > 0) {
+      cli_throughput_peripheral_print_sequence("RX", &session->sequence_rx.stats);
+    }
+    if (session->pattern_stats.bits > 0) {
+      cli_throughput_peripheral_print_pattern(&session->pattern_stats);
+    }
+    if (session->integrity_stats.packets > 0 || session->integrity_stats.errors > 0) {
+      cli_throughput_peripheral_print_integrity(session->integrity, &session->integrity_stats);
+    }
+    if (session->crypto_stats.packets > 0) {
+      cli_throughput_peripheral_print_crypto(&session->crypto_stats, session->throughput);
+    }
+    if (session->upload) {
+      cli_throughput_peripheral_print_upload(session);
+    } else if (session->duplex) {
+      cli_throughput_peripheral_print_duplex(session);
+    }
+    if ((session->upload || session->duplex) && session->down_summary.count > 0) {
+      cli_throughput_peripheral_print_latency("DOWN LATENCY", &session->down_summary);
+    }
+    if (session->echoes > 0 || session->echo_failures > 0) {
+      CLI_RESPONSE("  ECHO: %lu echoed, %lu failed" APP_LOG_NEW_LINE,
+                   (unsigned long)session->echoes,
+                   (unsigned long)session->echo_failures);
+    }
+    if (session->rtt.samples > 0 || session->rtt.timeouts > 0) {
+      CLI_RESPONSE("  RTT: srtt %lu us, rttvar %lu us, min %lu max %lu us, timeout %lu ms,"
+                   " %lu samples, %lu timeouts" APP_LOG_NEW_LINE,
+                   (unsigned long)session->rtt.srtt,
+                   (unsigned long)session->rtt.rttvar,
+                   (unsigned long)session->rtt.min,
+                   (unsigned long)session->rtt.max,
+                   (unsigned long)throughput_rtt_timeout_ms(&session->rtt, 1),
+                   (unsigned long)session->rtt.samples,
+                   (unsigned long)session->rtt.timeouts);
+    }
+    if (session->clock.valid) {
+      CLI_RESPONSE("  CLOCK: offset %ld ms, drift %ld ppb, %lu updates%s" APP_LOG_NEW_LINE,
+                   (long)(session->clock.offset / 1000),
+                   (long)session->clock.drift,
+                   (unsigned long)session->clock_updates,
+                   session->clock_synced ? ", latency synchronized" : "");
+    }
+    if (session->l2cap_cid != 0) {
+      CLI_RESPONSE("  L2CAP: SDU %d MPS %d, %lu PDUs, %d credits, %lu stalls" APP_LOG_NEW_LINE,
+                   (int)session->l2cap_sdu_size,
+                   (int)session->l2cap_mps,
+                   (unsigned long)session->l2cap_pdus,
+                   (int)session->l2cap_credits,
+                   (unsigned long)session->l2cap_credit_stalls);
+    }
+  }
+
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  if (history.windows > 0) {
+    CLI_RESPONSE("HISTORY: %lu windows of %lu ms, min %lu max %lu mean %lu stddev %lu bps" APP_LOG_NEW_LINE,
+                 (unsigned long)history.windows,
+                 (unsigned long)history_window,
+                 (unsigned long)history.min,
+                 (unsigned long)history.max,
+                 (unsigned long)history.mean,
+                 (unsigned long)throughput_history_stddev(&history));
+  }
+#endif
+
+  // Aggregate result of the last test run
+  CLI_RESPONSE("LINKS: %d/%d " THROUGHPUT_UI_TH_FORMAT
+               " " THROUGHPUT_UI_CNT_FORMAT APP_LOG_NEW_LINE,
+               (int)throughput_peripheral_session_count(),
+               THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS,
+               (int)peripheral_state.throughput,
+               (int)peripheral_state.count);
+
   CLI_RESPONSE(CLI_OK);
 }
 
@@ -1775,8 +4056,463 @@ void cli_throughput_peripheral_data_get(sl_cli_command_arg_t *arguments)
   }
   CLI_RESPONSE("cli_throughput_peripheral_data_get\n");
   CLI_RESPONSE("%d %d %d\n",
-               (int)peripheral_state.mtu_size,
-               (int)indication_data_size,
-               (int)notification_data_size);
+               (int)max_mtu_size,
+               (int)requested_indication_size,
+               (int)requested_notification_size);
+  // Sizes in effect on each link
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    if (sessions[i].connection != 0) {
+      CLI_RESPONSE("%d: %d %d %d\n",
+                   (int)sessions[i].connection,
+                   (int)sessions[i].mtu_size,
+                   (int)sessions[i].indication_data_size,
+                   (int)sessions[i].notification_data_size);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for setting the payload pattern
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_pattern_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t type = sl_cli_get_argument_uint8(arguments, 0);
+  uint8_t *user = NULL;
+  size_t user_len = 0;
+  sl_status_t sc;
+  if (sl_cli_get_argument_count(arguments) > 1) {
+    user = sl_cli_get_argument_hex(arguments, 1, &user_len);
+  }
+  if (user_len > THROUGHPUT_PATTERN_USER_MAX) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  sc = throughput_peripheral_set_pattern((throughput_pattern_type_t)type,
+                                         user,
+                                         (uint8_t)user_len);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the payload pattern
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_pattern_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("cli_throughput_peripheral_pattern_get\n");
+  CLI_RESPONSE("%d %s %d\n",
+               (int)tx_pattern.type,
+               throughput_pattern_name(tx_pattern.type),
+               (int)tx_pattern.user_len);
+}
+
+/***************************************************************************//**
+ * CLI command for setting the integrity trailer
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_integrity_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t type = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_peripheral_set_integrity((throughput_integrity_type_t)type);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the integrity trailer
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_integrity_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("cli_throughput_peripheral_integrity_get\n");
+  CLI_RESPONSE("%d %s %d\n",
+               (int)integrity_type,
+               throughput_integrity_name(integrity_type),
+               (int)throughput_integrity_size(integrity_type));
+}
+
+/***************************************************************************//**
+ * CLI command for enabling the encryption
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_crypto_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t enable = sl_cli_get_argument_uint8(arguments, 0);
+  sl_status_t sc = throughput_peripheral_set_crypto(enable != 0, NULL);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for setting the encryption key
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_crypto_key(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint8_t key[THROUGHPUT_CRYPTO_KEY_SIZE];
+  if (!throughput_crypto_parse_key(sl_cli_get_argument_string(arguments, 0), key)) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  sl_status_t sc = throughput_peripheral_set_crypto(crypto_enabled, key);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the encryption
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_crypto_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("cli_throughput_peripheral_crypto_get\n");
+  CLI_RESPONSE("%d %d\n",
+               (int)crypto_enabled,
+               (int)throughput_crypto_supported());
+}
+
+/***************************************************************************//**
+ * CLI command for dumping the history of the last test run
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_history_dump(sl_cli_command_arg_t *arguments)
+{
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  uint8_t buffer[THROUGHPUT_HISTORY_PACKED_SIZE];
+  uint8_t format;
+
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  format = sl_cli_get_argument_uint8(arguments, 0);
+  if (format > 1) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("history %u %lu %lu\n",
+               (unsigned int)history.count,
+               (unsigned long)history_window,
+               (unsigned long)history.overwritten);
+  if (format == 0) {
+    CLI_RESPONSE("time,bytes,packets,retries,lost,rssi,phy,throughput\n");
+  }
+  for (uint16_t i = 0; i < history.count; i++) {
+    const throughput_history_record_t *record = throughput_history_get(&history, i);
+    uint32_t duration;
+    if (format == 1) {
+      // Packed records as hexadecimal, one per line
+      throughput_history_pack(record, buffer);
+      for (uint8_t j = 0; j < sizeof(buffer); j++) {
+        CLI_RESPONSE("%02x", buffer[j]);
+      }
+      CLI_RESPONSE("\n");
+      continue;
+    }
+    if (i > 0) {
+      duration = record->time - throughput_history_get(&history, i - 1)->time;
+    } else if (history.overwritten > 0) {
+      duration = history_window;
+    } else {
+      duration = record->time;
+    }
+    CLI_RESPONSE("%lu,%lu,%u,%u,%u,%d,%u,%lu\n",
+                 (unsigned long)record->time,
+                 (unsigned long)record->bytes,
+                 (unsigned int)record->packets,
+                 (unsigned int)record->retries,
+                 (unsigned int)record->lost,
+                 (int)record->rssi,
+                 (unsigned int)record->phy,
+                 (unsigned long)(duration > 0 ? (uint64_t)record->bytes * 8 * 1000 / duration : 0));
+  }
+  CLI_RESPONSE(CLI_OK);
+#else
+  (void)arguments;
+  CLI_RESPONSE(CLI_ERROR);
+#endif
+}
+
+/***************************************************************************//**
+ * CLI command for setting the history window
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_history_set(sl_cli_command_arg_t *arguments)
+{
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  uint32_t window = sl_cli_get_argument_uint32(arguments, 0);
+  sl_status_t sc = throughput_peripheral_set_history_window(window);
+  if (sc == SL_STATUS_OK) {
+    CLI_RESPONSE(CLI_OK);
+  } else {
+    CLI_RESPONSE(CLI_ERROR);
+  }
+}
+
+/***************************************************************************//**
+ * CLI command for reading the history window
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_history_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+#if THROUGHPUT_PERIPHERAL_HISTORY_ENABLE
+  CLI_RESPONSE("cli_throughput_peripheral_history_get\n");
+  CLI_RESPONSE("%lu %u\n",
+               (unsigned long)history_window,
+               (unsigned int)THROUGHPUT_PERIPHERAL_HISTORY_RECORDS);
+#else
+  CLI_RESPONSE(CLI_ERROR);
+#endif
+}
+
+/***************************************************************************//**
+ * CLI command for reading the round trip statistics of the sessions
+ * @param[in] arguments command line argument list
+ ******************************************************************************/
+void cli_throughput_peripheral_rtt_get(sl_cli_command_arg_t *arguments)
+{
+  (void)arguments;
+  if (!enabled) {
+    CLI_RESPONSE(CLI_ERROR);
+    return;
+  }
+  CLI_RESPONSE("cli_throughput_peripheral_rtt_get\n");
+  for (uint8_t i = 0; i < THROUGHPUT_PERIPHERAL_MAX_CONNECTIONS; i++) {
+    throughput_peripheral_session_t *session = &sessions[i];
+    if (session->connection == 0) {
+      continue;
+    }
+    CLI_RESPONSE("%d %lu %lu %lu %lu %lu %lu %lu %lu\n",
+                 (int)session->connection,
+                 (unsigned long)session->rtt.srtt,
+                 (unsigned long)session->rtt.rttvar,
+                 (unsigned long)session->rtt.rto,
+                 (unsigned long)session->rtt.min,
+                 (unsigned long)session->rtt.max,
+                 (unsigned long)session->rtt.last,
+                 (unsigned long)session->rtt.samples,
+                 (unsigned long)session->rtt.timeouts);
+  }
+}
+
+/***************************************************************************//**
+ * CLI commands of the test features, in their own command group next to the
+ * generated throughput_peripheral group
+ ******************************************************************************/
+
+static const sl_cli_command_info_t cli_cmd_peripheral_pattern_set = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_pattern_set,
+                 "Set payload pattern",
+                  "Pattern: 0: PRBS9, 1: PRBS15, 2: PRBS23, 3: counter, 4: user" SL_CLI_UNIT_SEPARATOR "User pattern, 1-16 bytes" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_HEXOPT, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_pattern_get = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_pattern_get,
+                 "Read payload pattern",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_integrity_set = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_integrity_set,
+                 "Set integrity trailer",
+                  "Trailer: 0: none, 1: CRC32, 2: SHA-256" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_integrity_get = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_integrity_get,
+                 "Read integrity trailer",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_crypto_set = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_crypto_set,
+                 "Set AES-CCM encryption",
+                  "Encryption: 0: off, 1: on" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_crypto_key = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_crypto_key,
+                 "Set AES-128 key",
+                  "Key as 32 hexadecimal digits" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_STRING, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_crypto_get = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_crypto_get,
+                 "Read AES-CCM encryption",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_history_dump = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_history_dump,
+                 "Dump time series",
+                  "Format: 0: CSV, 1: binary as hexadecimal" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT8, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_history_set = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_history_set,
+                 "Set time series window",
+                  "Window in ms, 0: off" SL_CLI_UNIT_SEPARATOR,
+                 {SL_CLI_ARG_UINT32, SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_history_get = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_history_get,
+                 "Read time series window",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_info_t cli_cmd_peripheral_rtt_get = \
+  SL_CLI_COMMAND(cli_throughput_peripheral_rtt_get,
+                 "Read round trip statistics",
+                  "",
+                 {SL_CLI_ARG_END, });
+
+static const sl_cli_command_entry_t peripheral_pattern_group_table[] = {
+  { "set", &cli_cmd_peripheral_pattern_set, false },
+  { "s", &cli_cmd_peripheral_pattern_set, true },
+  { "get", &cli_cmd_peripheral_pattern_get, false },
+  { "g", &cli_cmd_peripheral_pattern_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_pattern = \
+  SL_CLI_COMMAND_GROUP(peripheral_pattern_group_table, "Payload pattern");
+
+static const sl_cli_command_entry_t peripheral_integrity_group_table[] = {
+  { "set", &cli_cmd_peripheral_integrity_set, false },
+  { "s", &cli_cmd_peripheral_integrity_set, true },
+  { "get", &cli_cmd_peripheral_integrity_get, false },
+  { "g", &cli_cmd_peripheral_integrity_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_integrity = \
+  SL_CLI_COMMAND_GROUP(peripheral_integrity_group_table, "Integrity trailer");
+
+static const sl_cli_command_entry_t peripheral_crypto_group_table[] = {
+  { "set", &cli_cmd_peripheral_crypto_set, false },
+  { "s", &cli_cmd_peripheral_crypto_set, true },
+  { "key", &cli_cmd_peripheral_crypto_key, false },
+  { "k", &cli_cmd_peripheral_crypto_key, true },
+  { "get", &cli_cmd_peripheral_crypto_get, false },
+  { "g", &cli_cmd_peripheral_crypto_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_crypto = \
+  SL_CLI_COMMAND_GROUP(peripheral_crypto_group_table, "Packet encryption");
+
+static const sl_cli_command_entry_t peripheral_history_group_table[] = {
+  { "dump", &cli_cmd_peripheral_history_dump, false },
+  { "d", &cli_cmd_peripheral_history_dump, true },
+  { "set", &cli_cmd_peripheral_history_set, false },
+  { "s", &cli_cmd_peripheral_history_set, true },
+  { "get", &cli_cmd_peripheral_history_get, false },
+  { "g", &cli_cmd_peripheral_history_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_history = \
+  SL_CLI_COMMAND_GROUP(peripheral_history_group_table, "Throughput time series");
+
+static const sl_cli_command_entry_t peripheral_rtt_group_table[] = {
+  { "get", &cli_cmd_peripheral_rtt_get, false },
+  { "g", &cli_cmd_peripheral_rtt_get, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_rtt = \
+  SL_CLI_COMMAND_GROUP(peripheral_rtt_group_table, "Indication round trip");
+
+static const sl_cli_command_entry_t peripheral_test_group_table[] = {
+  { "pattern", &cli_cmd_grp_peripheral_pattern, false },
+  { "a", &cli_cmd_grp_peripheral_pattern, true },
+  { "integrity", &cli_cmd_grp_peripheral_integrity, false },
+  { "i", &cli_cmd_grp_peripheral_integrity, true },
+  { "crypto", &cli_cmd_grp_peripheral_crypto, false },
+  { "e", &cli_cmd_grp_peripheral_crypto, true },
+  { "history", &cli_cmd_grp_peripheral_history, false },
+  { "h", &cli_cmd_grp_peripheral_history, true },
+  { "rtt", &cli_cmd_grp_peripheral_rtt, false },
+  { "r", &cli_cmd_grp_peripheral_rtt, true },
+  { NULL, NULL, false },
+};
+static const sl_cli_command_info_t cli_cmd_grp_peripheral_test = \
+  SL_CLI_COMMAND_GROUP(peripheral_test_group_table, "Throughput Peripheral tests");
+
+static const sl_cli_command_entry_t peripheral_command_table[] = {
+  { "throughput_peripheral_test", &cli_cmd_grp_peripheral_test, false },
+  { "pt", &cli_cmd_grp_peripheral_test, true },
+  { NULL, NULL, false },
+};
+
+/// Command group of the test features, added while the peripheral is enabled
+static sl_cli_command_group_t peripheral_command_group = {
+  { NULL },
+  false,
+  peripheral_command_table
+};
+
+/***************************************************************************//**
+ * Adds the commands of the test features to the CLI.
+ ******************************************************************************/
+static void throughput_peripheral_cli_add(void)
+{
+  (void)sl_cli_command_add_command_group(sl_cli_default_handle, &peripheral_command_group);
+}
+
+/***************************************************************************//**
+ * Removes the commands of the test features from the CLI.
+ ******************************************************************************/
+static void throughput_peripheral_cli_remove(void)
+{
+  (void)sl_cli_command_remove_command_group(sl_cli_default_handle, &peripheral_command_group);
 }
 #endif // SL_CATALOG_CLI_PRESENT
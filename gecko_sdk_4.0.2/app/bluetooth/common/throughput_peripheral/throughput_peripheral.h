@@ -31,6 +31,9 @@
 #define THROUGHPUT_PERIPHERAL_H
 
 #include "throughput_types.h"
+#include "throughput_pattern.h"
+#include "throughput_integrity.h"
+#include "throughput_crypto.h"
 #include "sl_power_manager.h"
 
 /*******************************************************************************
@@ -64,6 +67,12 @@ typedef union {
  *****************************************************************************/
 void throughput_peripheral_enable(void);
 
+/**************************************************************************//**
+ * Disables the the transmission. Advertising stops and the connections are
+ * closed.
+ *****************************************************************************/
+void throughput_peripheral_disable(void);
+
 /**************************************************************************//**
  * Sets the the transmission mode.
  * @param[in] mode the transmission mode is either of:
@@ -76,6 +85,52 @@ void throughput_peripheral_enable(void);
 sl_status_t throughput_peripheral_set_mode(throughput_mode_t mode,
                                            uint32_t amount);
 
+/**************************************************************************//**
+ * Sets the payload pattern of the packets that do not carry frames.
+ * @param[in] type pattern
+ * @param[in] user user pattern, repeated over the payload, may be NULL
+ * @param[in] user_len length of the user pattern, 0 to keep the current one
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_pattern(throughput_pattern_type_t type,
+                                              const uint8_t *user,
+                                              uint8_t user_len);
+
+/**************************************************************************//**
+ * Sets the integrity trailer of the tests started by the peripheral. Tests
+ * started by the central use the trailer it selects.
+ * @param[in] type integrity mode
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_integrity(throughput_integrity_type_t type);
+
+/**************************************************************************//**
+ * Sets the encryption of the tests started by the peripheral. Tests started
+ * by the central are encrypted if it selects it.
+ * @param[in] enable true to encrypt the notification and indication tests
+ * @param[in] key AES-128 key, NULL to keep the current one
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_crypto(bool enable, const uint8_t *key);
+
+/**************************************************************************//**
+ * Sets the window of the time series recorded during the tests.
+ * @param[in] window window in ms, 0 to stop recording
+ * @return status of the operation
+ *****************************************************************************/
+sl_status_t throughput_peripheral_set_history_window(uint32_t window);
+
+/**************************************************************************//**
+ * Time of the peripheral in the time base of a connected central. The central
+ * synchronizes the clocks over the echo characteristic, timestamps of all its
+ * peripherals are comparable once synchronized.
+ * @param[in] connection connection handle of the central
+ * @param[out] synchronized true if converted to the time base of the central,
+ *                          false if the local time is returned; may be NULL
+ * @return time in microseconds
+ *****************************************************************************/
+uint64_t throughput_peripheral_get_time(uint8_t connection, bool *synchronized);
+
 /**************************************************************************//**
  * Sets the the transmission sizes.
  * @param[in] mtu MTU size in bytes
@@ -99,20 +154,22 @@ sl_status_t throughput_peripheral_set_tx_power(throughput_tx_power_t tx_power,
                                                bool deep_sleep);
 
 /**************************************************************************//**
- * Starts the the transmission.
- * @param[in] type type of the test (notification or indication)
+ * Starts the the transmission on every subscribed link.
+ * @param[in] type type of the test (notification, indication, L2CAP, upload or duplex)
  * @return status of the operation
  *****************************************************************************/
 sl_status_t throughput_peripheral_start(throughput_notification_t type);
 
 /**************************************************************************//**
- * Stops the transmission.
+ * Stops the transmission on every link that is testing.
  * @return status of the operation
  *****************************************************************************/
 sl_status_t throughput_peripheral_stop(void);
 
 /**************************************************************************//**
- * Bluetooth stack event handler.
+ * Bluetooth stack event handler, called with every event.
+ * The enabled transmitter subscribes to the events it handles through
+ * throughput_event_subscribe() instead, and this handler ignores them.
  * @param[in] evt Event coming from the Bluetooth stack.
  *****************************************************************************/
 void throughput_peripheral_on_bt_event(sl_bt_msg_t *evt);
@@ -167,6 +224,8 @@ void throughput_peripheral_on_start(void);
 
 /**************************************************************************//**
  * Callback to handle transmission finished event.
+ * Called once all links of a test run finished, with the results summed up
+ * over the links.
  * @param[in] throughput throughput value in bits/second (bps)
  * @param[in] count data volume transmitted, in bytes
  * @note To be implemented in user code.
@@ -189,6 +248,23 @@ void throughput_peripheral_on_finish_reception(throughput_value_t throughput,
                                                throughput_count_t error,
                                                throughput_time_t time);
 
+/**************************************************************************//**
+ * Callback to handle the finished test of a single link.
+ * @param[in] connection connection handle of the link
+ * @param[in] throughput throughput value in bits/second (bps)
+ * @param[in] count number of operations
+ * @param[in] lost number of packets lost
+ * @param[in] error number of wrong packets
+ * @param[in] time total measurement time
+ * @note To be implemented in user code.
+ *****************************************************************************/
+void throughput_peripheral_on_link_finish(uint8_t connection,
+                                          throughput_value_t throughput,
+                                          throughput_count_t count,
+                                          throughput_count_t lost,
+                                          throughput_count_t error,
+                                          throughput_time_t time);
+
 /**************************************************************************//**
  * Callback to handle TX power changed event.
  * @param[in] power TX power in dBm
@@ -126,6 +126,20 @@ typedef struct {
   bool xon;                                 ///< Transmitter enabled
   bool remote_xon;                          ///< Remote Transmitter enabled
   IRQn_Type rx_irq_number;                  ///< Receive IRQ Number
+  uint32_t (*rx_dma_position)(void *context); ///< Index in rx_buffer the DMA writes next, NULL to receive byte by byte
+  uint32_t rx_dropped;                      ///< Bytes overwritten by the DMA before they were read
+  void (*tx_dma_start)(void *context, const uint8_t *data, size_t length); ///< Starts a DMA transfer of the tx ring, NULL to transmit byte by byte
+  void (*tx_dma_poll)(void *context);       ///< Completes a finished DMA transfer while interrupts are blocked
+  size_t tx_dma_max;                        ///< Longest DMA transfer
+  uint8_t *tx_buffer;                       ///< Ring of the data to transmit
+  size_t tx_buffer_length;                  ///< tx_buffer_length
+  uint32_t tx_read_index;                   ///< Index in tx_buffer of the next byte to transmit
+  uint32_t tx_write_index;                  ///< Index in tx_buffer to be written to
+  volatile uint32_t tx_count;               ///< Bytes in tx_buffer, including the DMA transfer in flight
+  volatile uint32_t tx_dma_count;           ///< Bytes of the DMA transfer in flight
+  bool tx_drop_when_full;                   ///< Drop the data that does not fit in tx_buffer instead of waiting
+  uint32_t tx_high_water;                   ///< Highest tx_count seen
+  uint32_t tx_dropped;                      ///< Bytes dropped because tx_buffer was full
 #if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
   IRQn_Type tx_irq_number;                  ///< Transmit IRQ Number
   volatile bool tx_idle;                    ///< tx_idle. Available only when Power Manager present.
@@ -146,6 +160,14 @@ typedef struct {
 #endif
 } sl_iostream_uart_context_t;
 
+/// @brief I/O Stream UART transmit ring statistics
+typedef struct {
+  size_t size;          ///< Size of the ring, 0 if the stream transmits byte by byte
+  uint32_t used;        ///< Bytes waiting in the ring
+  uint32_t high_water;  ///< Highest number of bytes waiting in the ring
+  uint32_t dropped;     ///< Bytes dropped because the ring was full
+} sl_iostream_uart_tx_statistics_t;
+
 // -----------------------------------------------------------------------------
 // Prototypes
 
@@ -186,6 +208,49 @@ __STATIC_INLINE bool sl_iostream_uart_get_auto_cr_lf(sl_iostream_uart_t *iostrea
   return iostream_uart->get_auto_cr_lf(iostream_uart->stream.context);
 }
 
+/***************************************************************************//**
+ * Get the statistics of the transmit ring.
+ *
+ * @param[in] iostream_uart  UART context.
+ *
+ * @param[out] statistics  Statistics of the ring.
+ ******************************************************************************/
+__STATIC_INLINE void sl_iostream_uart_get_tx_statistics(sl_iostream_uart_t *iostream_uart,
+                                                        sl_iostream_uart_tx_statistics_t *statistics)
+{
+  sl_iostream_uart_context_t *context = (sl_iostream_uart_context_t *)iostream_uart->stream.context;
+
+  statistics->size = (context->tx_dma_start != NULL) ? context->tx_buffer_length : 0;
+  statistics->used = context->tx_count;
+  statistics->high_water = context->tx_high_water;
+  statistics->dropped = context->tx_dropped;
+}
+
+/***************************************************************************//**
+ * Get the number of received bytes overwritten before they were read.
+ *
+ * @param[in] iostream_uart  UART context.
+ *
+ * @return Bytes lost, always 0 if the stream receives byte by byte.
+ ******************************************************************************/
+__STATIC_INLINE uint32_t sl_iostream_uart_get_rx_dropped(sl_iostream_uart_t *iostream_uart)
+{
+  return ((sl_iostream_uart_context_t *)iostream_uart->stream.context)->rx_dropped;
+}
+
+/***************************************************************************//**
+ * Reset the high-water mark and the dropped bytes of the transmit ring.
+ *
+ * @param[in] iostream_uart  UART context.
+ ******************************************************************************/
+__STATIC_INLINE void sl_iostream_uart_reset_tx_statistics(sl_iostream_uart_t *iostream_uart)
+{
+  sl_iostream_uart_context_t *context = (sl_iostream_uart_context_t *)iostream_uart->stream.context;
+
+  context->tx_high_water = context->tx_count;
+  context->tx_dropped = 0;
+}
+
 #if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
 /***************************************************************************//**
  * Add or remove energy mode restriction to enable/disable reception when the
@@ -94,6 +94,29 @@ extern "C" {
  *
  *       SL_IOSTREAM_USART_<instance_name>_RESTRICT_ENERGY_MODE_TO_ALLOW_RECEPTION
  *
+ * ## Transfers through the LDMA
+ *
+ *   Once the instance is initialized, sl_iostream_usart_enable_dma() can move
+ *   its transfers to the LDMA, e.g. with the SL_IOSTREAM_USART_<instance_name>
+ *   DMA settings of the instance configuration.
+ *
+ *   If the DMA config provides a tx buffer, a write copies the data in the
+ *   buffer and returns. An LDMA channel sends the buffer to the USART, and its
+ *   interrupt starts the next transfer. A write only waits if the buffer is
+ *   full, unless the DMA config asks to drop the data in that case.
+ *
+ *   If the DMA config enables the rx DMA, an LDMA channel writes the rx buffer
+ *   circularly instead of an interrupt per received character. The data is
+ *   handed to the read when the line is idle for some bit times, when half of
+ *   the buffer is filled, and on each read. Data the DMA overwrites before it
+ *   is read is counted by sl_iostream_uart_get_rx_dropped(). Not available
+ *   with software or RTS flow control.
+ *
+ *   With the DMADRV component, the channels are allocated by DMADRV and the
+ *   configured channel numbers are ignored. Otherwise the stream provides a
+ *   weak LDMA_IRQHandler(). An application defining its own handler for other
+ *   channels must call sl_iostream_usart_ldma_irq_dispatch() from it.
+ *
  * @{
  ******************************************************************************/
 
@@ -124,6 +147,39 @@ typedef struct {
 #endif
 } sl_iostream_usart_config_t;
 
+#if defined(LDMA_PRESENT)
+/// @brief I/O Stream USART LDMA configuration
+typedef struct {
+  uint8_t *tx_buffer;         ///< Ring of the data to transmit, NULL to transmit byte by byte
+  size_t tx_buffer_length;    ///< tx_buffer_length
+  bool tx_drop_when_full;     ///< Drop the data that does not fit in tx_buffer instead of waiting
+  uint8_t tx_dma_channel;     ///< LDMA channel used to transmit
+  uint32_t tx_dma_signal;     ///< LDMA request of the USART TXBL signal
+  bool rx_dma_enable;         ///< Receive in the rx buffer of the UART config through the LDMA
+  uint8_t rx_dma_channel;     ///< LDMA channel used to receive
+  uint32_t rx_dma_signal;     ///< LDMA request of the USART RXDATAV signal
+  uint8_t rx_idle_bits;       ///< Bit times without reception that hand the received data to the read
+} sl_iostream_usart_dma_config_t;
+
+#define SL_IOSTREAM_USART_DMA_CONCAT_PASTER(first, second, third)  first ## second ## third
+
+#if defined(LDMAXBAR_PRESENT)
+/// LDMA request of the TXBL signal of a USART instance number
+#define SL_IOSTREAM_USART_TX_DMA_SIGNAL(periph_nbr)  (SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMAXBAR_CH_REQSEL_SOURCESEL_, USART, periph_nbr) \
+                                                      | SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMAXBAR_CH_REQSEL_SIGSEL_USART, periph_nbr, TXBL))
+/// LDMA request of the RXDATAV signal of a USART instance number
+#define SL_IOSTREAM_USART_RX_DMA_SIGNAL(periph_nbr)  (SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMAXBAR_CH_REQSEL_SOURCESEL_, USART, periph_nbr) \
+                                                      | SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMAXBAR_CH_REQSEL_SIGSEL_USART, periph_nbr, RXDATAV))
+#else
+/// LDMA request of the TXBL signal of a USART instance number
+#define SL_IOSTREAM_USART_TX_DMA_SIGNAL(periph_nbr)  (SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMA_CH_REQSEL_SOURCESEL_, USART, periph_nbr) \
+                                                      | SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMA_CH_REQSEL_SIGSEL_USART, periph_nbr, TXBL))
+/// LDMA request of the RXDATAV signal of a USART instance number
+#define SL_IOSTREAM_USART_RX_DMA_SIGNAL(periph_nbr)  (SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMA_CH_REQSEL_SOURCESEL_, USART, periph_nbr) \
+                                                      | SL_IOSTREAM_USART_DMA_CONCAT_PASTER(LDMA_CH_REQSEL_SIGSEL_USART, periph_nbr, RXDATAV))
+#endif
+#endif
+
 /// @brief I/O Stream USART context
 typedef struct {
   sl_iostream_uart_context_t context; ///< usart_location
@@ -140,6 +196,17 @@ typedef struct {
   uint8_t rts_pin;            ///< Flow control, RTS pin
   uint8_t flags;
 #endif
+#if defined(LDMA_PRESENT)
+  uint8_t tx_dma_channel;     ///< LDMA channel used to transmit
+  uint8_t rx_dma_channel;     ///< LDMA channel used to receive
+  uint32_t rx_dma_descriptors[2][4]; ///< LDMA descriptors of the two halves of the rx buffer
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  uint32_t tx_dma_signal;     ///< LDMA request of the USART TXBL signal
+  uint32_t tx_dma_descriptor[4]; ///< LDMA descriptor of the transfer in flight
+#else
+  void *ldma_next;            ///< Next stream served by sl_iostream_usart_ldma_irq_dispatch()
+#endif
+#endif
 } sl_iostream_usart_context_t;
 
 // -----------------------------------------------------------------------------
@@ -173,6 +240,39 @@ sl_status_t sl_iostream_usart_init(sl_iostream_uart_t *iostream_uart,
  ******************************************************************************/
 void sl_iostream_usart_irq_handler(void *stream_context);
 
+#if defined(LDMA_PRESENT)
+/*******************************************************************************
+ * Move the transfers of an initialized USART stream to the LDMA.
+ *
+ * @param[in] iostream_uart   I/O Stream UART handle.
+ *
+ * @param[in] config          LDMA configuration.
+ *
+ * @return  Status result
+ ******************************************************************************/
+sl_status_t sl_iostream_usart_enable_dma(sl_iostream_uart_t *iostream_uart,
+                                         const sl_iostream_usart_dma_config_t *config);
+
+/*******************************************************************************
+ * LDMA interrupt handler of a USART stream transferring through the LDMA.
+ *
+ * Only clears the interrupt flags of the channels of the stream.
+ *
+ * @param[in] stream_context   Usart stream context.
+ ******************************************************************************/
+void sl_iostream_usart_ldma_irq_handler(void *stream_context);
+
+#if !defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+/*******************************************************************************
+ * Run the LDMA interrupt handler of every USART stream using the LDMA.
+ *
+ * Called by the weak LDMA_IRQHandler() of the stream, or by the one of the
+ * application if it overrides it.
+ ******************************************************************************/
+void sl_iostream_usart_ldma_irq_dispatch(void);
+#endif
+#endif
+
 /** @} (end addtogroup iostream_usart) */
 /** @} (end addtogroup iostream) */
 
@@ -63,6 +63,21 @@ sl_status_t sli_iostream_uart_context_init(sl_iostream_uart_t *uart,
                                            uint8_t rx_em_req,
                                            uint8_t tx_em_req);
 
+void sli_iostream_uart_set_tx_dma(sl_iostream_uart_context_t *context,
+                                  uint8_t *buffer,
+                                  size_t buffer_length,
+                                  bool drop_when_full,
+                                  void (*start)(void *context, const uint8_t *data, size_t length),
+                                  void (*poll)(void *context),
+                                  size_t max_length);
+
+void sli_uart_tx_dma_done(void *context);
+
+void sli_iostream_uart_set_rx_dma(sl_iostream_uart_context_t *context,
+                                  uint32_t (*position)(void *context));
+
+void sli_uart_rx_dma_update(void *context);
+
 bool sli_uart_is_rx_space_avail(void *context);
 
 void sli_uart_push_rxd_data(void *context,
@@ -94,6 +94,10 @@ static bool get_rx_energy_mode_restriction(void *context);
 static uint32_t pop_byte_from_read_fifo(sl_iostream_uart_context_t *uart_context,
                                         uint8_t *c);
 
+static size_t pop_from_read_ring(sl_iostream_uart_context_t *uart_context,
+                                 uint8_t *buffer,
+                                 size_t length);
+
 #if defined(SL_CATALOG_KERNEL_PRESENT)
 static void set_read_block(void *context,
                            bool on);
@@ -107,6 +111,17 @@ static sl_status_t nolock_uart_write(void *context,
                                      const void *buffer,
                                      size_t buffer_length);
 
+static sl_status_t ring_uart_write(sl_iostream_uart_context_t *uart_context,
+                                   const uint8_t *buffer,
+                                   size_t buffer_length,
+                                   bool cr_to_crlf);
+
+static sl_status_t push_to_tx_ring(sl_iostream_uart_context_t *uart_context,
+                                   const uint8_t *data,
+                                   size_t length);
+
+static void start_tx_transfer(sl_iostream_uart_context_t *uart_context);
+
 /*******************************************************************************
  **************************   GLOBAL FUNCTIONS   *******************************
  ******************************************************************************/
@@ -208,6 +223,127 @@ sl_status_t sli_iostream_uart_context_init(sl_iostream_uart_t *uart,
   return SL_STATUS_OK;
 }
 
+/***************************************************************************//**
+ * Transmit through the ring and a DMA instead of byte by byte.
+ *
+ * Called by the UART stream type after sli_iostream_uart_context_init(), with
+ * interrupts blocked.
+ ******************************************************************************/
+void sli_iostream_uart_set_tx_dma(sl_iostream_uart_context_t *context,
+                                  uint8_t *buffer,
+                                  size_t buffer_length,
+                                  bool drop_when_full,
+                                  void (*start)(void *context, const uint8_t *data, size_t length),
+                                  void (*poll)(void *context),
+                                  size_t max_length)
+{
+  EFM_ASSERT(buffer != NULL);
+  EFM_ASSERT(buffer_length != 0);
+  EFM_ASSERT(max_length != 0);
+
+  context->tx_buffer = buffer;
+  context->tx_buffer_length = buffer_length;
+  context->tx_drop_when_full = drop_when_full;
+  context->tx_read_index = 0;
+  context->tx_write_index = 0;
+  context->tx_count = 0;
+  context->tx_dma_count = 0;
+  context->tx_high_water = 0;
+  context->tx_dropped = 0;
+  context->tx_dma_max = max_length;
+  context->tx_dma_poll = poll;
+  context->tx_dma_start = start;
+}
+
+/***************************************************************************//**
+ * Release the data of the finished DMA transfer and start the next one.
+ *
+ * Called from the DMA interrupt, or from tx_dma_poll.
+ ******************************************************************************/
+void sli_uart_tx_dma_done(void *context)
+{
+  sl_iostream_uart_context_t *uart_context = (sl_iostream_uart_context_t *)context;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (uart_context->tx_dma_count != 0) {
+    // Transfers never wrap, the one after the end of the ring starts at 0
+    uart_context->tx_read_index += uart_context->tx_dma_count;
+    if (uart_context->tx_read_index == uart_context->tx_buffer_length) {
+      uart_context->tx_read_index = 0;
+    }
+    uart_context->tx_count -= uart_context->tx_dma_count;
+    uart_context->tx_dma_count = 0;
+    start_tx_transfer(uart_context);
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * Receive through a DMA writing rx_buffer circularly instead of byte by byte.
+ *
+ * Called by the UART stream type after sli_iostream_uart_context_init(). The
+ * DMA must call sli_uart_rx_dma_update() at least twice per turn of the buffer
+ * and when the line goes idle. Software flow control is not supported since
+ * XON and XOFF cannot be taken out of the data.
+ ******************************************************************************/
+void sli_iostream_uart_set_rx_dma(sl_iostream_uart_context_t *context,
+                                  uint32_t (*position)(void *context))
+{
+  EFM_ASSERT(context->sw_flow_control == false);
+
+  context->rx_read_index = 0;
+  context->rx_write_index = 0;
+  context->rx_count = 0;
+  context->rx_dropped = 0;
+  context->rx_dma_position = position;
+}
+
+/***************************************************************************//**
+ * Account for the data the DMA wrote in rx_buffer since the last update.
+ *
+ * Called from the interrupts of the DMA and of the idle line detection, and
+ * by the read. If the DMA overwrote data that was not read yet, the oldest
+ * data is dropped.
+ ******************************************************************************/
+void sli_uart_rx_dma_update(void *context)
+{
+  sl_iostream_uart_context_t *uart_context = (sl_iostream_uart_context_t *)context;
+  uint32_t write_index;
+  uint32_t received;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  write_index = uart_context->rx_dma_position(uart_context);
+  if (write_index >= uart_context->rx_buffer_length) {
+    write_index = 0;
+  }
+  received = (write_index + uart_context->rx_buffer_length - uart_context->rx_write_index)
+             % uart_context->rx_buffer_length;
+  uart_context->rx_write_index = write_index;
+  uart_context->rx_count += received;
+  if (uart_context->rx_count > uart_context->rx_buffer_length) {
+    uart_context->rx_dropped += uart_context->rx_count - uart_context->rx_buffer_length;
+    uart_context->rx_count = uart_context->rx_buffer_length;
+    uart_context->rx_read_index = write_index;
+  }
+  CORE_EXIT_ATOMIC();
+
+  if (received == 0) {
+    return;
+  }
+#if defined(SL_CATALOG_KERNEL_PRESENT)
+  {
+    osKernelState_t state = osKernelGetState();
+    if ((state == osKernelRunning) || (state == osKernelLocked)) {
+      set_rx_sem_count(uart_context);
+    }
+  }
+#elif defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  uart_context->sleep = SL_POWER_MANAGER_WAKEUP;
+#endif
+}
+
 /**************************************************************************//**
  * @brief On ISR exit
  *****************************************************************************/
@@ -348,6 +484,9 @@ void sli_uart_push_rxd_data(void *context,
       return;
     } else if (c == XON) {
       uart_context->xon = true;
+      if (uart_context->tx_dma_start != NULL) {
+        start_tx_transfer(uart_context);
+      }
       CORE_EXIT_ATOMIC();
       return;
     }
@@ -387,6 +526,11 @@ void sli_uart_txc(void *context)
 {
   sl_iostream_uart_context_t *uart_context = (sl_iostream_uart_context_t *)context;
 
+  // The USART may run dry between two DMA transfers
+  if (uart_context->tx_count != 0) {
+    return;
+  }
+
   if (uart_context->tx_idle == false) {
     EFM_ASSERT(uart_context->tx_completed != NULL);
     uart_context->tx_completed(context, false);
@@ -431,6 +575,13 @@ static sl_status_t uart_deinit(void *stream)
     sl_iostream_set_system_default(NULL);
   }
 
+  // Let the DMA send what is left in the ring
+  if (uart_context->tx_dma_start != NULL) {
+    while (uart_context->tx_count != 0) {
+      uart_context->tx_dma_poll(uart_context);
+    }
+  }
+
   NVIC_ClearPendingIRQ(uart_context->rx_irq_number);
   NVIC_DisableIRQ(uart_context->rx_irq_number);
 
@@ -486,7 +637,9 @@ static sl_status_t nolock_uart_write(void *context,
   CORE_EXIT_ATOMIC();
 #endif
 
-  if (cr_to_crlf == false) {
+  if (uart_context->tx_dma_start != NULL) {
+    status = ring_uart_write(uart_context, (const uint8_t *)buffer, buffer_length, cr_to_crlf);
+  } else if (cr_to_crlf == false) {
     uint32_t i = 0;
     while (i < buffer_length) {
       bool xon = false;
@@ -523,6 +676,124 @@ static sl_status_t nolock_uart_write(void *context,
   return status;
 }
 
+/***************************************************************************//**
+ * Copy data in the tx ring, converting LF to CRLF if requested
+ ******************************************************************************/
+static sl_status_t ring_uart_write(sl_iostream_uart_context_t *uart_context,
+                                   const uint8_t *buffer,
+                                   size_t buffer_length,
+                                   bool cr_to_crlf)
+{
+  const uint8_t cr = '\r';
+  size_t start = 0;
+  sl_status_t status = SL_STATUS_OK;
+
+  if (cr_to_crlf) {
+    for (size_t i = 0; (i < buffer_length) && (status == SL_STATUS_OK); i++) {
+      if (buffer[i] == '\n') {
+        status = push_to_tx_ring(uart_context, &buffer[start], i - start);
+        if (status == SL_STATUS_OK) {
+          status = push_to_tx_ring(uart_context, &cr, sizeof(cr));
+        }
+        start = i;
+      }
+    }
+  }
+  if (status == SL_STATUS_OK) {
+    status = push_to_tx_ring(uart_context, &buffer[start], buffer_length - start);
+  }
+
+  return status;
+}
+
+/***************************************************************************//**
+ * Copy data in the tx ring and start the DMA if it is idle
+ *
+ * If the ring is full, either drops the rest of the data or waits for the DMA
+ * to make room. The DMA interrupt cannot run while interrupts are blocked, the
+ * transfer is polled then.
+ ******************************************************************************/
+static sl_status_t push_to_tx_ring(sl_iostream_uart_context_t *uart_context,
+                                   const uint8_t *data,
+                                   size_t length)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  while (length > 0) {
+    size_t space;
+    size_t chunk;
+
+    CORE_ENTER_ATOMIC();
+    space = uart_context->tx_buffer_length - uart_context->tx_count;
+    if (space == 0) {
+      if (uart_context->tx_drop_when_full) {
+        uart_context->tx_dropped += length;
+        CORE_EXIT_ATOMIC();
+        return SL_STATUS_FULL;
+      }
+      CORE_EXIT_ATOMIC();
+      if (CORE_InIrqContext() || CORE_IrqIsDisabled()) {
+        uart_context->tx_dma_poll(uart_context);
+      }
+      continue;
+    }
+
+    // Copy up to the end of the ring. The copy is done with interrupts
+    // blocked since an interrupt handler may write too, e.g. XOFF.
+    chunk = uart_context->tx_buffer_length - uart_context->tx_write_index;
+    if (chunk > space) {
+      chunk = space;
+    }
+    if (chunk > length) {
+      chunk = length;
+    }
+    memcpy(&uart_context->tx_buffer[uart_context->tx_write_index], data, chunk);
+    uart_context->tx_write_index += chunk;
+    if (uart_context->tx_write_index == uart_context->tx_buffer_length) {
+      uart_context->tx_write_index = 0;
+    }
+    uart_context->tx_count += chunk;
+    if (uart_context->tx_count > uart_context->tx_high_water) {
+      uart_context->tx_high_water = uart_context->tx_count;
+    }
+    start_tx_transfer(uart_context);
+    CORE_EXIT_ATOMIC();
+
+    data += chunk;
+    length -= chunk;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Start a DMA transfer of the tx ring if none is in flight.
+ *
+ * Must be called with interrupts blocked. A transfer ends at the end of the
+ * ring, the data after the wrap is sent by the next one while the ring fills
+ * up behind it. The transfer in flight is finished even if XOFF is received.
+ ******************************************************************************/
+static void start_tx_transfer(sl_iostream_uart_context_t *uart_context)
+{
+  size_t length;
+
+  if ((uart_context->tx_dma_count != 0)
+      || (uart_context->tx_count == 0)
+      || (uart_context->xon == false)) {
+    return;
+  }
+
+  length = uart_context->tx_buffer_length - uart_context->tx_read_index;
+  if (length > uart_context->tx_count) {
+    length = uart_context->tx_count;
+  }
+  if (length > uart_context->tx_dma_max) {
+    length = uart_context->tx_dma_max;
+  }
+  uart_context->tx_dma_count = length;
+  uart_context->tx_dma_start(uart_context, &uart_context->tx_buffer[uart_context->tx_read_index], length);
+}
+
 /***************************************************************************//**
  * Internal stream write implementation
  ******************************************************************************/
@@ -582,6 +853,13 @@ static sl_status_t uart_read(void *context,
 #endif
 
   *bytes_read = 0;
+  if (uart_context->rx_dma_position != NULL) {
+    // Take the data received since the last idle line
+    sli_uart_rx_dma_update(uart_context);
+    *bytes_read = pop_from_read_ring(uart_context, c, buffer_length);
+    goto exit;
+  }
+
   while ((*bytes_read < buffer_length)) {
     rx_count = pop_byte_from_read_fifo(uart_context, c);
     if (rx_count == 0) {
@@ -648,6 +926,39 @@ static uint32_t pop_byte_from_read_fifo(sl_iostream_uart_context_t *uart_context
   return rx_count;
 }
 
+/***************************************************************************//**
+ * Copy up to length bytes from the read FIFO filled by the DMA
+ ******************************************************************************/
+static size_t pop_from_read_ring(sl_iostream_uart_context_t *uart_context,
+                                 uint8_t *buffer,
+                                 size_t length)
+{
+  size_t copied = 0;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  while ((copied < length) && (uart_context->rx_count != 0)) {
+    size_t chunk = uart_context->rx_buffer_length - uart_context->rx_read_index;
+
+    if (chunk > uart_context->rx_count) {
+      chunk = uart_context->rx_count;
+    }
+    if (chunk > length - copied) {
+      chunk = length - copied;
+    }
+    memcpy(&buffer[copied], &uart_context->rx_buffer[uart_context->rx_read_index], chunk);
+    uart_context->rx_read_index += chunk;
+    if (uart_context->rx_read_index == uart_context->rx_buffer_length) {
+      uart_context->rx_read_index = 0;
+    }
+    uart_context->rx_count -= chunk;
+    copied += chunk;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return copied;
+}
+
 /***************************************************************************//**
  * Set receive semaphore count
  ******************************************************************************/
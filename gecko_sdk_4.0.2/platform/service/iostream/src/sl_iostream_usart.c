@@ -53,6 +53,10 @@
 #include "em_usart.h"
 #include "em_gpio.h"
 
+#if defined(LDMA_PRESENT) && defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+#include "dmadrv.h"
+#endif
+
 /*******************************************************************************
  *********************   LOCAL FUNCTION PROTOTYPES   ***************************
  ******************************************************************************/
@@ -68,6 +72,43 @@ static void usart_enable_rx(void *context);
 
 static sl_status_t usart_deinit(void *context);
 
+#if defined(LDMA_PRESENT)
+// Longest transfer of an LDMA descriptor
+#define USART_DMA_MAX_LENGTH  ((_LDMA_CH_CTRL_XFERCNT_MASK >> _LDMA_CH_CTRL_XFERCNT_SHIFT) + 1)
+
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+static bool usart_dma_callback(unsigned int channel,
+                               unsigned int sequenceNo,
+                               void *userParam);
+#else
+static void usart_ldma_channel_init(uint8_t ch,
+                                    uint32_t signal);
+
+static void usart_ldma_channel_deinit(uint8_t ch);
+#endif
+
+static sl_status_t usart_tx_dma_init(sl_iostream_usart_context_t *usart_context,
+                                     const sl_iostream_usart_dma_config_t *config);
+
+static void usart_tx_dma_start(void *context,
+                               const uint8_t *data,
+                               size_t length);
+
+static void usart_tx_dma_poll(void *context);
+
+#if defined(_USART_TIMECMP1_MASK)
+static sl_status_t usart_rx_dma_init(sl_iostream_usart_context_t *usart_context,
+                                     const sl_iostream_usart_dma_config_t *config);
+
+static uint32_t usart_rx_dma_position(void *context);
+#endif
+
+#if !defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+// Streams served by sl_iostream_usart_ldma_irq_dispatch()
+static sl_iostream_usart_context_t *ldma_streams = NULL;
+#endif
+#endif
+
 /*******************************************************************************
  **************************   GLOBAL FUNCTIONS   *******************************
  ******************************************************************************/
@@ -226,7 +267,15 @@ void sl_iostream_usart_irq_handler(void *stream_context)
 {
   sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)stream_context;
 
-  if (usart_context->usart->STATUS & USART_STATUS_RXDATAV) {
+#if defined(LDMA_PRESENT) && defined(_USART_TIMECMP1_MASK)
+  if (usart_context->usart->IF & USART_IF_TCMP1) {
+    // The line is idle, hand the received data to the read
+    USART_IntClear(usart_context->usart, USART_IF_TCMP1);
+    sli_uart_rx_dma_update(stream_context);
+  }
+#endif
+  if ((usart_context->context.rx_dma_position == NULL)
+      && (usart_context->usart->STATUS & USART_STATUS_RXDATAV)) {
     if (sli_uart_is_rx_space_avail(stream_context)) {
       // There is room for data in the RX buffer so we store the data
       uint8_t c = USART_Rx(usart_context->usart);
@@ -251,6 +300,117 @@ void sl_iostream_usart_irq_handler(void *stream_context)
 #endif
 }
 
+#if defined(LDMA_PRESENT)
+/***************************************************************************//**
+ * Move the transfers of a USART stream to the LDMA
+ ******************************************************************************/
+sl_status_t sl_iostream_usart_enable_dma(sl_iostream_uart_t *iostream_uart,
+                                         const sl_iostream_usart_dma_config_t *config)
+{
+  sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)iostream_uart->stream.context;
+  sl_status_t status = SL_STATUS_OK;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((usart_context->context.tx_dma_start != NULL)
+      || (usart_context->context.rx_dma_position != NULL)) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  // XON/XOFF cannot be taken out of the data, and the LDMA empties the USART
+  // as soon as a character arrives, so RTS would never hold the remote back
+  if (config->rx_dma_enable
+      && (usart_context->context.sw_flow_control
+#if (_SILICON_LABS_32B_SERIES > 0)
+          || (usart_context->flags & SLI_IOSTREAM_UART_FLAG_RTS)
+#endif
+          )) {
+    EFM_ASSERT(false);
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  {
+    Ecode_t ecode = DMADRV_Init();
+
+    if ((ecode != ECODE_EMDRV_DMADRV_OK) && (ecode != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED)) {
+      return SL_STATUS_INITIALIZATION;
+    }
+  }
+#endif
+
+  CORE_ENTER_ATOMIC();
+  if (config->tx_buffer != NULL) {
+    status = usart_tx_dma_init(usart_context, config);
+  }
+#if defined(_USART_TIMECMP1_MASK)
+  if ((status == SL_STATUS_OK) && config->rx_dma_enable) {
+    status = usart_rx_dma_init(usart_context, config);
+  }
+#endif
+#if !defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  if ((usart_context->context.tx_dma_start != NULL)
+      || (usart_context->context.rx_dma_position != NULL)) {
+    usart_context->ldma_next = ldma_streams;
+    ldma_streams = usart_context;
+  }
+#endif
+  CORE_EXIT_ATOMIC();
+
+  return status;
+}
+
+/**************************************************************************//**
+ * @brief LDMA IRQ Handler
+ *****************************************************************************/
+void sl_iostream_usart_ldma_irq_handler(void *stream_context)
+{
+  sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)stream_context;
+  uint32_t tx_mask = 1UL << usart_context->tx_dma_channel;
+  uint32_t rx_mask = 1UL << usart_context->rx_dma_channel;
+
+  if ((usart_context->context.tx_dma_start != NULL) && (LDMA->IF & tx_mask)) {
+#if defined(_SILICON_LABS_32B_SERIES_2)
+    LDMA->IF_CLR = tx_mask;
+#else
+    LDMA->IFC = tx_mask;
+#endif
+    sli_uart_tx_dma_done(stream_context);
+  }
+  if ((usart_context->context.rx_dma_position != NULL) && (LDMA->IF & rx_mask)) {
+    // Half of the rx buffer was filled
+#if defined(_SILICON_LABS_32B_SERIES_2)
+    LDMA->IF_CLR = rx_mask;
+#else
+    LDMA->IFC = rx_mask;
+#endif
+    sli_uart_rx_dma_update(stream_context);
+  }
+}
+
+#if !defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+/**************************************************************************//**
+ * @brief LDMA IRQ Handler of every stream using the LDMA
+ *****************************************************************************/
+void sl_iostream_usart_ldma_irq_dispatch(void)
+{
+  sl_iostream_usart_context_t *usart_context = ldma_streams;
+
+  while (usart_context != NULL) {
+    sl_iostream_usart_ldma_irq_handler(usart_context);
+    usart_context = (sl_iostream_usart_context_t *)usart_context->ldma_next;
+  }
+}
+
+/**************************************************************************//**
+ * @brief LDMA IRQ Handler, overridden by an application using other channels
+ *****************************************************************************/
+SL_WEAK void LDMA_IRQHandler(void)
+{
+  sl_iostream_usart_ldma_irq_dispatch();
+}
+#endif
+#endif
+
 /*******************************************************************************
  **************************   LOCAL FUNCTIONS   ********************************
  ******************************************************************************/
@@ -298,9 +458,259 @@ static void usart_tx_completed(void *context, bool enable)
 static void usart_enable_rx(void *context)
 {
   sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)context;
+
+  if (usart_context->context.rx_dma_position != NULL) {
+    return;
+  }
   USART_IntEnable(usart_context->usart, USART_IF_RXDATAV);
 }
 
+#if defined(LDMA_PRESENT)
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+/***************************************************************************//**
+ * DMADRV callback of the channels of a stream, the interrupt flag is cleared
+ ******************************************************************************/
+static bool usart_dma_callback(unsigned int channel,
+                               unsigned int sequenceNo,
+                               void *userParam)
+{
+  sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)userParam;
+
+  (void)sequenceNo;
+  if ((usart_context->context.tx_dma_start != NULL) && (channel == usart_context->tx_dma_channel)) {
+    sli_uart_tx_dma_done(usart_context);
+  } else if ((usart_context->context.rx_dma_position != NULL) && (channel == usart_context->rx_dma_channel)) {
+    // Half of the rx buffer was filled
+    sli_uart_rx_dma_update(usart_context);
+  }
+
+  // Never let DMADRV stop the channel, the next transfer may already run
+  return true;
+}
+#else
+/***************************************************************************//**
+ * Route a USART request to an idle LDMA channel and enable its interrupt
+ ******************************************************************************/
+static void usart_ldma_channel_init(uint8_t ch,
+                                    uint32_t signal)
+{
+  uint32_t mask = 1UL << ch;
+
+  EFM_ASSERT(ch < DMA_CHAN_COUNT);
+
+  // The LDMA may already be used by other channels
+  CMU_ClockEnable(cmuClock_LDMA, true);
+#if defined(LDMAXBAR_PRESENT)
+  CMU_ClockEnable(cmuClock_LDMAXBAR, true);
+  LDMA->EN_SET = LDMA_EN_EN;
+  LDMAXBAR->CH[ch].REQSEL = signal;
+#else
+  LDMA->CH[ch].REQSEL = signal;
+#endif
+  LDMA->CH[ch].CFG = 0;
+  LDMA->CH[ch].LOOP = 0;
+#if defined(_SILICON_LABS_32B_SERIES_2)
+  LDMA->CHDIS = mask;
+  LDMA->IF_CLR = mask;
+  LDMA->IEN_SET = mask;
+#else
+  LDMA->CHEN &= ~mask;
+  LDMA->IFC = mask;
+  LDMA->IEN |= mask;
+#endif
+  NVIC_ClearPendingIRQ(LDMA_IRQn);
+  NVIC_EnableIRQ(LDMA_IRQn);
+}
+
+/***************************************************************************//**
+ * Stop an LDMA channel and its interrupt
+ ******************************************************************************/
+static void usart_ldma_channel_deinit(uint8_t ch)
+{
+  uint32_t mask = 1UL << ch;
+
+#if defined(_SILICON_LABS_32B_SERIES_2)
+  LDMA->IEN_CLR = mask;
+  LDMA->CHDIS = mask;
+#else
+  LDMA->IEN &= ~mask;
+  LDMA->CHEN &= ~mask;
+#endif
+}
+#endif
+
+/***************************************************************************//**
+ * Set up the LDMA channel transmitting the tx buffer
+ ******************************************************************************/
+static sl_status_t usart_tx_dma_init(sl_iostream_usart_context_t *usart_context,
+                                     const sl_iostream_usart_dma_config_t *config)
+{
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  unsigned int ch;
+
+  if (DMADRV_AllocateChannel(&ch, NULL) != ECODE_EMDRV_DMADRV_OK) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  usart_context->tx_dma_channel = (uint8_t)ch;
+  usart_context->tx_dma_signal = config->tx_dma_signal;
+#else
+  usart_context->tx_dma_channel = config->tx_dma_channel;
+  usart_ldma_channel_init(config->tx_dma_channel, config->tx_dma_signal);
+#endif
+
+  sli_iostream_uart_set_tx_dma(&usart_context->context,
+                               config->tx_buffer,
+                               config->tx_buffer_length,
+                               config->tx_drop_when_full,
+                               usart_tx_dma_start,
+                               usart_tx_dma_poll,
+                               USART_DMA_MAX_LENGTH);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Transmit a segment of the tx buffer, byte by byte on each TXBL request
+ ******************************************************************************/
+static void usart_tx_dma_start(void *context,
+                               const uint8_t *data,
+                               size_t length)
+{
+  sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)context;
+  uint8_t ch = usart_context->tx_dma_channel;
+  uint32_t ctrl = LDMA_CH_CTRL_STRUCTTYPE_TRANSFER
+                  | ((uint32_t)(length - 1) << _LDMA_CH_CTRL_XFERCNT_SHIFT)
+                  | LDMA_CH_CTRL_BLOCKSIZE_UNIT1
+                  | LDMA_CH_CTRL_DONEIEN
+                  | LDMA_CH_CTRL_REQMODE_BLOCK
+                  | LDMA_CH_CTRL_SRCINC_ONE
+                  | LDMA_CH_CTRL_SIZE_BYTE
+                  | LDMA_CH_CTRL_DSTINC_NONE;
+
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  LDMA_TransferCfg_t transfer = LDMA_TRANSFER_CFG_PERIPHERAL(usart_context->tx_dma_signal);
+  uint32_t *descriptor = usart_context->tx_dma_descriptor;
+
+  descriptor[0] = ctrl;
+  descriptor[1] = (uint32_t)data;
+  descriptor[2] = (uint32_t)&usart_context->usart->TXDATA;
+  descriptor[3] = 0;
+  DMADRV_LdmaStartTransfer(ch, &transfer, (LDMA_Descriptor_t *)descriptor,
+                           usart_dma_callback, usart_context);
+#else
+  LDMA->CH[ch].CTRL = ctrl;
+  LDMA->CH[ch].SRC = (uint32_t)data;
+  LDMA->CH[ch].DST = (uint32_t)&usart_context->usart->TXDATA;
+  LDMA->CH[ch].LINK = 0;
+#if defined(_SILICON_LABS_32B_SERIES_2)
+  LDMA->CHEN_SET = 1UL << ch;
+#else
+  LDMA->CHEN |= 1UL << ch;
+#endif
+#endif
+}
+
+/***************************************************************************//**
+ * Complete a finished transfer while the LDMA interrupt cannot run
+ ******************************************************************************/
+static void usart_tx_dma_poll(void *context)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  sl_iostream_usart_ldma_irq_handler(context);
+  CORE_EXIT_ATOMIC();
+}
+
+#if defined(_USART_TIMECMP1_MASK)
+/***************************************************************************//**
+ * Set up the LDMA channel receiving in the rx buffer and the idle line timer
+ ******************************************************************************/
+static sl_status_t usart_rx_dma_init(sl_iostream_usart_context_t *usart_context,
+                                     const sl_iostream_usart_dma_config_t *config)
+{
+  uint8_t *buffer = usart_context->context.rx_buffer;
+  size_t half = usart_context->context.rx_buffer_length / 2;
+  uint8_t ch;
+
+  EFM_ASSERT((usart_context->context.rx_buffer_length % 2) == 0);
+  EFM_ASSERT((half != 0) && (half <= USART_DMA_MAX_LENGTH));
+
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  {
+    unsigned int allocated;
+
+    if (DMADRV_AllocateChannel(&allocated, NULL) != ECODE_EMDRV_DMADRV_OK) {
+      return SL_STATUS_ALLOCATION_FAILED;
+    }
+    ch = (uint8_t)allocated;
+  }
+#else
+  ch = config->rx_dma_channel;
+  EFM_ASSERT((usart_context->context.tx_dma_start == NULL) || (ch != usart_context->tx_dma_channel));
+#endif
+  usart_context->rx_dma_channel = ch;
+
+  // Each half of the buffer is a descriptor linked to the other one, the
+  // LDMA interrupts whenever it moves to the other half
+  for (uint8_t i = 0; i < 2; i++) {
+    uint32_t *descriptor = usart_context->rx_dma_descriptors[i];
+
+    descriptor[0] = LDMA_CH_CTRL_STRUCTTYPE_TRANSFER
+                    | ((uint32_t)(half - 1) << _LDMA_CH_CTRL_XFERCNT_SHIFT)
+                    | LDMA_CH_CTRL_BLOCKSIZE_UNIT1
+                    | LDMA_CH_CTRL_DONEIEN
+                    | LDMA_CH_CTRL_REQMODE_BLOCK
+                    | LDMA_CH_CTRL_SRCINC_NONE
+                    | LDMA_CH_CTRL_SIZE_BYTE
+                    | LDMA_CH_CTRL_DSTINC_ONE;
+    descriptor[1] = (uint32_t)&usart_context->usart->RXDATA;
+    descriptor[2] = (uint32_t)&buffer[i * half];
+    descriptor[3] = ((uint32_t)usart_context->rx_dma_descriptors[1 - i] & _LDMA_CH_LINK_LINKADDR_MASK)
+                    | LDMA_CH_LINK_LINKMODE_ABSOLUTE
+                    | LDMA_CH_LINK_LINK;
+  }
+
+  // The received characters are no longer taken by the USART interrupt
+  USART_IntDisable(usart_context->usart, USART_IF_RXDATAV);
+  sli_iostream_uart_set_rx_dma(&usart_context->context, usart_rx_dma_position);
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  {
+    LDMA_TransferCfg_t transfer = LDMA_TRANSFER_CFG_PERIPHERAL(config->rx_dma_signal);
+
+    DMADRV_LdmaStartTransfer(ch, &transfer, (LDMA_Descriptor_t *)usart_context->rx_dma_descriptors[0],
+                             usart_dma_callback, usart_context);
+  }
+#else
+  usart_ldma_channel_init(ch, config->rx_dma_signal);
+  LDMA->CH[ch].LINK = (uint32_t)usart_context->rx_dma_descriptors[0] & _LDMA_CH_LINK_LINKADDR_MASK;
+  LDMA->LINKLOAD = 1UL << ch;
+#endif
+
+  // The timer starts at the end of each received frame and stops when the
+  // next frame starts, it expires once the line is idle
+  usart_context->usart->TIMECMP1 = USART_TIMECMP1_TSTART_RXEOF
+                                   | USART_TIMECMP1_TSTOP_RXACT
+                                   | USART_TIMECMP1_RESTARTEN
+                                   | ((uint32_t)config->rx_idle_bits << _USART_TIMECMP1_TCMPVAL_SHIFT);
+  USART_IntClear(usart_context->usart, USART_IF_TCMP1);
+  USART_IntEnable(usart_context->usart, USART_IF_TCMP1);
+
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Index in the rx buffer the LDMA writes next
+ ******************************************************************************/
+static uint32_t usart_rx_dma_position(void *context)
+{
+  sl_iostream_usart_context_t *usart_context = (sl_iostream_usart_context_t *)context;
+
+  return LDMA->CH[usart_context->rx_dma_channel].DST - (uint32_t)usart_context->context.rx_buffer;
+}
+#endif
+#endif
+
 /***************************************************************************//**
  * USART Stream De-init.
  ******************************************************************************/
@@ -312,6 +722,45 @@ static sl_status_t usart_deinit(void *context)
   while (!(USART_StatusGet(usart_context->usart) & USART_STATUS_TXBL)) {
   }
 
+#if defined(LDMA_PRESENT)
+  if (usart_context->context.tx_dma_start != NULL) {
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+    DMADRV_StopTransfer(usart_context->tx_dma_channel);
+    DMADRV_FreeChannel(usart_context->tx_dma_channel);
+#else
+    usart_ldma_channel_deinit(usart_context->tx_dma_channel);
+#endif
+    usart_context->context.tx_dma_start = NULL;
+  }
+  if (usart_context->context.rx_dma_position != NULL) {
+#if defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+    DMADRV_StopTransfer(usart_context->rx_dma_channel);
+    DMADRV_FreeChannel(usart_context->rx_dma_channel);
+#else
+    usart_ldma_channel_deinit(usart_context->rx_dma_channel);
+#endif
+#if defined(_USART_TIMECMP1_MASK)
+    usart_context->usart->TIMECMP1 = 0;
+#endif
+    usart_context->context.rx_dma_position = NULL;
+  }
+#if !defined(SL_CATALOG_EMDRV_DMADRV_PRESENT)
+  {
+    sl_iostream_usart_context_t **link = &ldma_streams;
+    CORE_DECLARE_IRQ_STATE;
+
+    CORE_ENTER_ATOMIC();
+    while ((*link != NULL) && (*link != usart_context)) {
+      link = (sl_iostream_usart_context_t **)&(*link)->ldma_next;
+    }
+    if (*link != NULL) {
+      *link = (sl_iostream_usart_context_t *)usart_context->ldma_next;
+    }
+    CORE_EXIT_ATOMIC();
+  }
+#endif
+#endif
+
   // De-Configure TX and RX GPIOs
   GPIO_PinModeSet(usart_context->tx_port, usart_context->tx_pin, gpioModeDisabled, 0);
   GPIO_PinModeSet(usart_context->rx_port, usart_context->rx_pin, gpioModeDisabled, 0);
@@ -0,0 +1,317 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host decoder of the binary export of the throughput central
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Turns the export stream of the central into files, one set per connection:
+ *
+ *   conn<N>.csv         timestamp_us,sequence,length,lost for every packet
+ *   conn<N>.bin         the payloads, back to back
+ *   conn<N>_frames.csv  sequence,timestamp,value0..value6 of every sensor
+ *                       frame, if the packets carry frame batches
+ *
+ * The stream is read from a file, or from standard input if none is given,
+ * e.g. a capture of the serial port. Text of the log between the frames is
+ * skipped. The format is described in throughput_export.h.
+ *
+ * Build: g++ -std=c++17 -O2 -o throughput_export_decoder throughput_export_decoder.cpp
+ * Usage: throughput_export_decoder [-o directory] [capture]
+ ******************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Record layout, see throughput_export.h
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kCrcSize = 4;
+// Longest frame accepted before the decoder resynchronizes
+constexpr size_t kFrameMax = 4096;
+
+// Frame batch layout, see throughput_frame.h
+constexpr uint8_t kBatchMagic = 0xB7;
+constexpr size_t kBatchHeaderSize = 10;
+constexpr size_t kFrameValues = 7;
+constexpr size_t kFrameSize = 4 + 4 * kFrameValues;
+
+uint32_t crc32(const uint8_t *data, size_t len)
+{
+  static uint32_t table[256];
+  static bool ready = false;
+
+  if (!ready) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+    ready = true;
+  }
+  uint32_t crc = 0xFFFFFFFFUL;
+  while (len--) {
+    crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+uint32_t read_u32(const uint8_t *p)
+{
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+uint64_t read_u64(const uint8_t *p)
+{
+  return uint64_t(read_u32(p)) | uint64_t(read_u32(p + 4)) << 32;
+}
+
+float read_float(const uint8_t *p)
+{
+  uint32_t bits = read_u32(p);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Decodes a COBS frame without its delimiters, false if it is malformed
+bool cobs_decode(const std::vector<uint8_t> &frame, std::vector<uint8_t> &record)
+{
+  record.clear();
+  size_t i = 0;
+  while (i < frame.size()) {
+    uint8_t code = frame[i++];
+    if (code == 0 || i + code - 1 > frame.size()) {
+      return false;
+    }
+    record.insert(record.end(), frame.begin() + i, frame.begin() + i + code - 1);
+    i += code - 1;
+    if (code != 0xFF && i < frame.size()) {
+      record.push_back(0);
+    }
+  }
+  return true;
+}
+
+// Output files and sequence tracking of a connection
+struct Connection {
+  std::ofstream index;
+  std::ofstream payloads;
+  std::ofstream frames;
+  bool started = false;
+  uint32_t next_sequence = 0;
+  uint64_t packets = 0;
+  uint64_t lost = 0;
+};
+
+struct Stats {
+  uint64_t frames = 0;
+  uint64_t bytes = 0;
+  uint64_t malformed = 0;
+  uint64_t crc_errors = 0;
+  uint64_t skipped = 0;
+};
+
+class Decoder {
+public:
+  explicit Decoder(std::string directory) : directory_(std::move(directory)) {}
+
+  void feed(const uint8_t *data, size_t len)
+  {
+    for (size_t i = 0; i < len; i++) {
+      stats_.bytes++;
+      if (data[i] != 0) {
+        if (frame_.size() < kFrameMax) {
+          frame_.push_back(data[i]);
+        } else {
+          overflow_ = true;
+        }
+        continue;
+      }
+      if (!frame_.empty()) {
+        if (overflow_) {
+          stats_.skipped += frame_.size();
+        } else {
+          handle_frame();
+        }
+      }
+      frame_.clear();
+      overflow_ = false;
+    }
+  }
+
+  void report() const
+  {
+    std::cerr << stats_.frames << " packets, " << stats_.crc_errors << " CRC errors, "
+              << stats_.malformed << " malformed, " << stats_.skipped << " bytes skipped\n";
+    for (const auto &entry : connections_) {
+      std::cerr << "connection " << int(entry.first) << ": " << entry.second->packets
+                << " packets, " << entry.second->lost << " lost\n";
+    }
+  }
+
+private:
+  void handle_frame()
+  {
+    if (!cobs_decode(frame_, record_) || record_.size() < kHeaderSize + kCrcSize) {
+      // Text of the log or a frame cut short
+      stats_.skipped += frame_.size();
+      return;
+    }
+    size_t size = record_.size() - kCrcSize;
+    if (crc32(record_.data(), size) != read_u32(record_.data() + size)) {
+      stats_.crc_errors++;
+      stats_.skipped += frame_.size();
+      return;
+    }
+    uint16_t len = uint16_t(record_[2] | record_[3] << 8);
+    if (record_[0] != kVersion || kHeaderSize + len != size) {
+      stats_.malformed++;
+      return;
+    }
+    stats_.frames++;
+    write(record_[1],
+          read_u32(record_.data() + 4),
+          read_u64(record_.data() + 8),
+          record_.data() + kHeaderSize,
+          len);
+  }
+
+  Connection &connection(uint8_t handle)
+  {
+    auto &slot = connections_[handle];
+    if (!slot) {
+      slot = std::make_unique<Connection>();
+      std::string base = directory_ + "/conn" + std::to_string(handle);
+      slot->index.open(base + ".csv");
+      slot->index << "timestamp_us,sequence,length,lost\n";
+      slot->payloads.open(base + ".bin", std::ios::binary);
+    }
+    return *slot;
+  }
+
+  void write(uint8_t handle, uint32_t sequence, uint64_t timestamp, const uint8_t *payload, uint16_t len)
+  {
+    Connection &conn = connection(handle);
+    uint32_t lost = 0;
+
+    // A sequence at or below the expected one starts a new test
+    if (conn.started && sequence > conn.next_sequence) {
+      lost = sequence - conn.next_sequence;
+    }
+    conn.started = true;
+    conn.next_sequence = sequence + 1;
+    conn.packets++;
+    conn.lost += lost;
+    conn.index << timestamp << ',' << sequence << ',' << len << ',' << lost << '\n';
+    conn.payloads.write(reinterpret_cast<const char *>(payload), len);
+    write_frames(handle, conn, payload, len);
+  }
+
+  void write_frames(uint8_t handle, Connection &conn, const uint8_t *payload, uint16_t len)
+  {
+    if (len < kBatchHeaderSize || payload[4] != kBatchMagic || payload[5] == 0
+        || len != kBatchHeaderSize + payload[5] * kFrameSize) {
+      return;
+    }
+    if (!conn.frames.is_open()) {
+      conn.frames.open(directory_ + "/conn" + std::to_string(handle) + "_frames.csv");
+      conn.frames << "sequence,timestamp";
+      for (size_t v = 0; v < kFrameValues; v++) {
+        conn.frames << ",value" << v;
+      }
+      conn.frames << '\n';
+    }
+    uint32_t first = read_u32(payload + 6);
+    for (uint8_t f = 0; f < payload[5]; f++) {
+      const uint8_t *frame = payload + kBatchHeaderSize + f * kFrameSize;
+      conn.frames << first + f << ',' << read_u32(frame);
+      for (size_t v = 0; v < kFrameValues; v++) {
+        conn.frames << ',' << read_float(frame + 4 + 4 * v);
+      }
+      conn.frames << '\n';
+    }
+  }
+
+  std::string directory_;
+  std::vector<uint8_t> frame_;
+  std::vector<uint8_t> record_;
+  bool overflow_ = false;
+  std::map<uint8_t, std::unique_ptr<Connection> > connections_;
+  Stats stats_;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::string directory = ".";
+  const char *path = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      directory = argv[++i];
+    } else if (path == nullptr && argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [-o directory] [capture]\n";
+      return 2;
+    }
+  }
+
+  FILE *input = stdin;
+  if (path != nullptr) {
+    input = std::fopen(path, "rb");
+    if (input == nullptr) {
+      std::perror(path);
+      return 1;
+    }
+  }
+
+  Decoder decoder(directory);
+  uint8_t buffer[4096];
+  size_t len;
+  while ((len = std::fread(buffer, 1, sizeof(buffer), input)) > 0) {
+    decoder.feed(buffer, len);
+  }
+  if (input != stdin) {
+    std::fclose(input);
+  }
+  decoder.report();
+  return 0;
+}
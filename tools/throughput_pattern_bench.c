@@ -0,0 +1,163 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host benchmark of the throughput payload patterns
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Checks the generated PRBS tables of throughput_pattern.h against a bitwise
+ * Galois LFSR, including its full period, then measures fill plus check of
+ * payloads for every pattern. A link at 2M PHY needs well under 1 MB/s.
+ *
+ * Build and run:
+ *   cc -std=c11 -O2 -I../gecko_sdk_4.0.2/app/bluetooth/common/throughput \
+ *      -o throughput_pattern_bench throughput_pattern_bench.c \
+ *      ../gecko_sdk_4.0.2/app/bluetooth/common/throughput/throughput_pattern_tables.c
+ *   ./throughput_pattern_bench [payload size]
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "throughput_pattern.h"
+
+#define PAYLOAD_MAX      1024
+#define BENCH_BYTES      (64UL * 1024 * 1024)
+
+/// Taps of the polynomials, in the order of throughput_pattern_type_t
+static const uint32_t taps[THROUGHPUT_PATTERN_PRBS_COUNT] = {
+  (1UL << 5) | 1,
+  (1UL << 14) | 1,
+  (1UL << 18) | 1,
+};
+
+// One step of the bitwise LFSR, returns the output bit
+static uint32_t lfsr_step(uint32_t *state, uint8_t width, uint32_t taps_mask)
+{
+  uint32_t bit = (*state >> (width - 1)) & 1;
+  *state = ((*state << 1) & ((1UL << width) - 1)) ^ (bit ? taps_mask : 0);
+  return bit;
+}
+
+// Compare the table-driven generator with the bitwise LFSR over a full period
+static int check_prbs(throughput_pattern_type_t type)
+{
+  const throughput_pattern_lfsr_t *lfsr = &throughput_pattern_lfsr[type];
+  throughput_pattern_t pattern = { 0 };
+  throughput_pattern_stream_t stream;
+  uint32_t period = (1UL << lfsr->width) - 1;
+  uint32_t state;
+  uint32_t steps = 0;
+  uint32_t word = 0;
+
+  (void)throughput_pattern_select(&pattern, type);
+  throughput_pattern_start(&pattern, 1, &stream);
+  state = stream.state;
+  // Every output byte of the tables must match 8 bitwise steps
+  for (uint32_t byte = 0; byte < period; byte++) {
+    uint8_t expected = 0;
+    if (byte % 4 == 0) {
+      word = throughput_pattern_next(&pattern, &stream);
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+      expected = (uint8_t)((expected << 1) | lfsr_step(&state, lfsr->width, taps[type]));
+    }
+    if ((uint8_t)(word >> (8 * (byte % 4))) != expected) {
+      printf("%s: byte %lu differs\n", throughput_pattern_name(type), (unsigned long)byte);
+      return 1;
+    }
+  }
+  // The polynomial must be maximal length
+  state = 1;
+  do {
+    (void)lfsr_step(&state, lfsr->width, taps[type]);
+    steps++;
+  } while (state != 1 && steps <= period);
+  if (steps != period) {
+    printf("%s: period %lu, expected %lu\n", throughput_pattern_name(type),
+           (unsigned long)steps, (unsigned long)period);
+    return 1;
+  }
+  printf("%s: tables match, period %lu\n", throughput_pattern_name(type), (unsigned long)period);
+  return 0;
+}
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Fill and check payloads, one seed per packet like the senders do
+static int bench(throughput_pattern_type_t type, uint16_t size)
+{
+  static const uint8_t user[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x55 };
+  static uint8_t payload[PAYLOAD_MAX];
+  throughput_pattern_t pattern = { 0 };
+  throughput_pattern_stats_t stats = { 0 };
+  uint32_t packets = (uint32_t)(BENCH_BYTES / size);
+  double start;
+  double elapsed;
+
+  (void)throughput_pattern_set_user(&pattern, user, sizeof(user));
+  (void)throughput_pattern_select(&pattern, type);
+  start = seconds();
+  for (uint32_t seed = 0; seed < packets; seed++) {
+    throughput_pattern_fill(&pattern, seed, payload, size);
+    (void)throughput_pattern_check(&pattern, seed, payload, size, &stats);
+  }
+  elapsed = seconds() - start;
+  printf("%-8s %4u bytes: %7.1f MB/s fill + check, %lu bit errors\n",
+         throughput_pattern_name(type), (unsigned)size,
+         (double)packets * size / elapsed / 1e6, (unsigned long)stats.errors);
+  return stats.errors != 0;
+}
+
+int main(int argc, char **argv)
+{
+  uint16_t size = 244;
+  int failures = 0;
+
+  if (argc > 1) {
+    size = (uint16_t)strtoul(argv[1], NULL, 0);
+    if (size == 0 || size > PAYLOAD_MAX) {
+      printf("payload size must be 1 to %u bytes\n", PAYLOAD_MAX);
+      return 2;
+    }
+  }
+  for (int type = 0; type < THROUGHPUT_PATTERN_PRBS_COUNT; type++) {
+    failures += check_prbs((throughput_pattern_type_t)type);
+  }
+  for (int type = 0; type < THROUGHPUT_PATTERN_COUNT; type++) {
+    failures += bench((throughput_pattern_type_t)type, size);
+  }
+  return failures ? 1 : 0;
+}
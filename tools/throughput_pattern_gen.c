@@ -0,0 +1,132 @@
+/***************************************************************************//**
+ * @file
+ * @brief Generator of the PRBS pattern tables
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Writes throughput_pattern_tables.c, the byte-wise LFSR tables of the PRBS
+ * patterns of throughput_pattern.h. Each table entry runs the Galois LFSR for
+ * 8 steps from a top byte: the output byte it shifts out and the state it
+ * leaves. The lower bits of the state only reach the output after 8 steps,
+ * they are just shifted, see throughput_pattern_next().
+ *
+ * Regenerate after changing a polynomial:
+ *   cc -std=c11 -O2 -o throughput_pattern_gen throughput_pattern_gen.c
+ *   ./throughput_pattern_gen \
+ *     > ../gecko_sdk_4.0.2/app/bluetooth/common/throughput/throughput_pattern_tables.c
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+
+/// Polynomials in the order of throughput_pattern_type_t
+static const struct {
+  const char *name;
+  const char *polynomial;
+  uint8_t width;
+  uint32_t taps;
+} polynomials[] = {
+  { "PRBS9", "x^9 + x^5 + 1", 9, (1UL << 5) | 1 },
+  { "PRBS15", "x^15 + x^14 + 1", 15, (1UL << 14) | 1 },
+  { "PRBS23", "x^23 + x^18 + 1", 23, (1UL << 18) | 1 },
+};
+
+static const char license[] =
+  "/***************************************************************************//**\n"
+  " * @file\n"
+  " * @brief Throughput PRBS pattern tables\n"
+  " *******************************************************************************\n"
+  " * # License\n"
+  " * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>\n"
+  " *******************************************************************************\n"
+  " *\n"
+  " * SPDX-License-Identifier: Zlib\n"
+  " *\n"
+  " * The licensor of this software is Silicon Laboratories Inc.\n"
+  " *\n"
+  " * This software is provided 'as-is', without any express or implied\n"
+  " * warranty. In no event will the authors be held liable for any damages\n"
+  " * arising from the use of this software.\n"
+  " *\n"
+  " * Permission is granted to anyone to use this software for any purpose,\n"
+  " * including commercial applications, and to alter it and redistribute it\n"
+  " * freely, subject to the following restrictions:\n"
+  " *\n"
+  " * 1. The origin of this software must not be misrepresented; you must not\n"
+  " *    claim that you wrote the original software. If you use this software\n"
+  " *    in a product, an acknowledgment in the product documentation would be\n"
+  " *    appreciated but is not required.\n"
+  " * 2. Altered source versions must be plainly marked as such, and must not be\n"
+  " *    misrepresented as being the original software.\n"
+  " * 3. This notice may not be removed or altered from any source distribution.\n"
+  " *\n"
+  " ******************************************************************************/\n";
+
+int main(void)
+{
+  printf("%s\n", license);
+  printf("// Generated by tools/throughput_pattern_gen.c, do not edit.\n\n");
+  printf("#include \"throughput_pattern.h\"\n\n");
+  printf("const throughput_pattern_lfsr_t throughput_pattern_lfsr[THROUGHPUT_PATTERN_PRBS_COUNT] = {\n");
+  for (size_t p = 0; p < sizeof(polynomials) / sizeof(polynomials[0]); p++) {
+    uint8_t width = polynomials[p].width;
+    uint32_t mask = (1UL << width) - 1;
+    uint8_t output[256];
+    uint32_t feedback[256];
+
+    for (uint16_t top = 0; top < 256; top++) {
+      uint32_t state = (uint32_t)top << (width - 8);
+      uint8_t byte = 0;
+      for (uint8_t step = 0; step < 8; step++) {
+        uint32_t bit = (state >> (width - 1)) & 1;
+        byte = (uint8_t)((byte << 1) | bit);
+        state = ((state << 1) & mask) ^ (bit ? polynomials[p].taps : 0);
+      }
+      output[top] = byte;
+      feedback[top] = state;
+    }
+
+    printf("  // %s, %s\n", polynomials[p].name, polynomials[p].polynomial);
+    printf("  {\n");
+    printf("    .width = %u,\n", (unsigned)width);
+    printf("    .mask = 0x%06lXUL,\n", (unsigned long)mask);
+    printf("    .output = {");
+    for (uint16_t i = 0; i < 256; i++) {
+      printf("%s0x%02X,", (i % 12 == 0) ? "\n      " : " ", output[i]);
+    }
+    printf("\n    },\n");
+    printf("    .feedback = {");
+    for (uint16_t i = 0; i < 256; i++) {
+      printf("%s0x%06lXUL,", (i % 6 == 0) ? "\n      " : " ", (unsigned long)feedback[i]);
+    }
+    printf("\n    },\n");
+    printf("  },\n");
+  }
+  printf("};\n");
+  return 0;
+}
@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stress test of the throughput slot queue
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2021 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+/*******************************************************************************
+ * Runs throughput_ring.h with a producer and a consumer thread, the way the
+ * sampler interrupt and the transmit path of the peripheral use it. The
+ * producer fills slots of varying length with a pattern derived from their
+ * sequence number, the consumer checks every slot and now and then keeps one
+ * back to exercise the backpressure path. Any lost, duplicated or corrupted
+ * slot fails the run.
+ *
+ * Build and run under ThreadSanitizer:
+ *   cc -std=c11 -O2 -g -pthread -fsanitize=thread \
+ *      -I../gecko_sdk_4.0.2/app/bluetooth/common/throughput \
+ *      -o throughput_ring_stress throughput_ring_stress.c
+ *   ./throughput_ring_stress [slots]
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "throughput_ring.h"
+
+#define SLOT_SIZE   64
+#define SLOT_COUNT  8
+#define SLOTS_DEFAULT  2000000UL
+
+static throughput_ring_t ring;
+static uint8_t storage[THROUGHPUT_RING_STORAGE_SIZE(SLOT_SIZE, SLOT_COUNT)]
+__attribute__((aligned(4)));
+static unsigned long slots = SLOTS_DEFAULT;
+
+// Length and content of a slot follow from its sequence number
+static uint16_t slot_length(uint32_t sequence)
+{
+  return (uint16_t)(4 + (sequence * 7u) % (SLOT_SIZE - 3));
+}
+
+static uint8_t slot_byte(uint32_t sequence, uint16_t i)
+{
+  return (uint8_t)(sequence * 31u + i * 17u);
+}
+
+static void *producer(void *arg)
+{
+  (void)arg;
+  for (uint32_t sequence = 0; sequence < slots; ) {
+    uint8_t *slot = throughput_ring_reserve(&ring);
+    if (slot == NULL) {
+      sched_yield();
+      continue;
+    }
+    uint16_t len = slot_length(sequence);
+    memcpy(slot, &sequence, sizeof(sequence));
+    for (uint16_t i = sizeof(sequence); i < len; i++) {
+      slot[i] = slot_byte(sequence, i);
+    }
+    throughput_ring_produce(&ring, len);
+    sequence++;
+  }
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  unsigned long *errors = (unsigned long *)arg;
+  uint32_t expected = 0;
+  uint32_t rng = 1;
+
+  while (expected < slots) {
+    uint16_t len;
+    const uint8_t *slot = throughput_ring_peek(&ring, &len);
+    uint32_t sequence;
+
+    if (slot == NULL) {
+      sched_yield();
+      continue;
+    }
+    memcpy(&sequence, slot, sizeof(sequence));
+    if (sequence != expected || len != slot_length(sequence)) {
+      (*errors)++;
+    } else {
+      for (uint16_t i = sizeof(sequence); i < len; i++) {
+        if (slot[i] != slot_byte(sequence, i)) {
+          (*errors)++;
+          break;
+        }
+      }
+    }
+    // Keep about one slot in 16 for another peek
+    rng = rng * 1103515245u + 12345u;
+    if (((rng >> 16) & 0x0F) == 0) {
+      throughput_ring_backpressure(&ring);
+      continue;
+    }
+    throughput_ring_commit(&ring);
+    expected = sequence + 1;
+  }
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  pthread_t threads[2];
+  unsigned long errors = 0;
+
+  if (argc > 1) {
+    slots = strtoul(argv[1], NULL, 0);
+  }
+  if (!throughput_ring_init(&ring, storage, SLOT_SIZE, SLOT_COUNT)) {
+    fprintf(stderr, "init failed\n");
+    return 2;
+  }
+  pthread_create(&threads[0], NULL, consumer, &errors);
+  pthread_create(&threads[1], NULL, producer, NULL);
+  pthread_join(threads[1], NULL);
+  pthread_join(threads[0], NULL);
+
+  printf("%lu slots, %lu errors, high water %lu, overruns %lu, backpressure %lu\n",
+         slots, errors,
+         (unsigned long)ring.high_water,
+         (unsigned long)ring.overruns,
+         (unsigned long)ring.backpressure);
+  return (errors == 0 && throughput_ring_level(&ring) == 0) ? 0 : 1;
+}